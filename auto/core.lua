@@ -54,8 +54,15 @@ project("AssetPipelineCore")
 	
 	includedirs {
 		path.join(RootPath, "public"),
+		-- stb_image decodes textures in Processor.
+		path.join(RootPath, "external"),
 	}
 
+	filter { "system:linux" }
+		-- std::thread used by parallel processing utilities.
+		links { "pthread" }
+	filter {}
+
 	filter { "action:vs*" }
 		disablewarnings {
 			-- MSVC : "needs to have dll-interface to be used by clients of class".
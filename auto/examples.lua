@@ -8,6 +8,11 @@ local function MakeExample(exampleProjectPath)
 		return
 	end
 
+	if string.contains(exampleProject, "Terrain") and not BUILD_TERRAIN then
+		print("Skip example "..exampleProject)
+		return
+	end
+
 	if string.contains(exampleProject, "Physx") and not CheckSDKExists("PHYSX_SDK_DIR") then
 		print("PHYSX_SDK_DIR not found, Skip example "..exampleProject)
 		return
@@ -24,6 +29,7 @@ local function MakeExample(exampleProjectPath)
 	local doUseCDConsumer = string.contains(exampleProject, "ToCD")
 	local doUseGenericProducer = string.contains(exampleProject, "GenericTo")
 	local doUseGenericConsumer = string.contains(exampleProject, "ToGeneric")
+	local doUseGltfProducer = string.contains(exampleProject, "GltfTo")
 	
 	local doUseTerrainProducer = string.contains(exampleProject, "TerrainTo")
 	local doUseEffekseerProducer = string.contains(exampleProject, "EffekseerTo")
@@ -92,6 +98,14 @@ local function MakeExample(exampleProjectPath)
 			print("Using CDConsumer")
 		end
 
+		if doUseGltfProducer then
+			table.insert(extraIncludeDirs, path.join(RootPath, "public/Producers/GltfProducer"))
+			table.insert(extraLinkDebugLibs, path.join(RootPath, "build/bin/Debug/GltfProducer"))
+			table.insert(extraLinkReleaseLibs, path.join(RootPath, "build/bin/Release/GltfProducer"))
+			dependson { "GltfProducer" }
+			print("Using GltfProducer")
+		end
+
 		if doUseGenericProducer then
 			table.insert(extraIncludeDirs, path.join(RootPath, "public/Producers/GenericProducer"))
 			table.insert(extraLinkDebugLibs, path.join(RootPath, "build/bin/Debug/GenericProducer"))
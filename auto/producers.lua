@@ -1,5 +1,6 @@
 group("Producers")
 dofile("producers/cd_producer.lua")
+dofile("producers/gltf_producer.lua")
 
 if BUILD_ASSIMP then
 	dofile("producers/generic_producer.lua")
@@ -0,0 +1,21 @@
+--------------------------------------------------------------
+-- GltfProducer
+--------------------------------------------------------------
+print("[GltfProducer] Generate project...")
+
+project("GltfProducer")
+	kind("SharedLib")
+	Platform_SetCppDialect()
+	Tool_InitProject()
+
+	files {
+		path.join(RootPath, "public/Producers/GltfProducer/**.*"),
+		path.join(RootPath, "private/Producers/GltfProducer/**.*"),
+	}
+	
+	vpaths {
+		["Source/*"] = { 
+			path.join(RootPath, "public/Producers/GltfProducer/**.*"),
+			path.join(RootPath, "private/Producers/GltfProducer/**.*"),
+		},
+	}
\ No newline at end of file
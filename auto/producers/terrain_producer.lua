@@ -16,4 +16,9 @@ project("TerrainProducer")
 			path.join(RootPath, "public/Producers/TerrainProducer/**.*"),
 			path.join(RootPath, "private/Producers/TerrainProducer/**.*"),
 		},
-	}
\ No newline at end of file
+	}
+
+	filter { "system:linux" }
+		-- std::thread used to generate sectors in parallel.
+		links { "pthread" }
+	filter {}
\ No newline at end of file
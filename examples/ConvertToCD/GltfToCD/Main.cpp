@@ -0,0 +1,33 @@
+#include "CDConsumer.h"
+#include "Framework/Processor.h"
+#include "GltfProducer.h"
+#include "Utilities/PerformanceProfiler.h"
+
+int main(int argc, char** argv)
+{
+	// argv[0] : exe name
+	// argv[1] : input file path
+	// argv[2] : output file path
+	if(argc != 3)
+	{
+		return 1;
+	}
+
+	using namespace cdtools;
+
+	PerformanceProfiler profiler("AssetPipeline");
+
+	const char* pInputFilePath = argv[1];
+	const char* pOutputFilePath = argv[2];
+	GltfProducer producer(pInputFilePath);
+	producer.EnableOption(GltfProducerOptions::ImportMaterial);
+	producer.EnableOption(GltfProducerOptions::ImportTexture);
+	producer.EnableOption(GltfProducerOptions::ImportSkeleton);
+	producer.EnableOption(GltfProducerOptions::ImportAnimation);
+	producer.EnableOption(GltfProducerOptions::GenerateTangentSpace);
+	CDConsumer consumer(pOutputFilePath);
+	Processor processor(&producer, &consumer);
+	processor.Run();
+
+	return 0;
+}
\ No newline at end of file
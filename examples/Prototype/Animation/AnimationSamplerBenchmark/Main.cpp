@@ -0,0 +1,203 @@
+#include "Scene/AnimationSampler.h"
+#include "Scene/SceneDatabase.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// Reference sampling which binary searches KeyFrame arrays of every track.
+template<typename KeyFrame, typename LerpFunc>
+auto ReferenceSample(const std::vector<KeyFrame>& keyFrames, float time, LerpFunc&& lerp)
+{
+	if (keyFrames.empty())
+	{
+		return KeyFrame::Identitiy();
+	}
+
+	auto itNext = std::upper_bound(keyFrames.begin(), keyFrames.end(), time, [](float value, const KeyFrame& keyFrame) { return value < keyFrame.GetTime(); });
+	if (itNext == keyFrames.begin())
+	{
+		return keyFrames.front().GetValue();
+	}
+	if (itNext == keyFrames.end())
+	{
+		return keyFrames.back().GetValue();
+	}
+
+	const KeyFrame& previous = *(itNext - 1);
+	float interval = itNext->GetTime() - previous.GetTime();
+	float factor = interval > 0.0f ? (time - previous.GetTime()) / interval : 0.0f;
+	return lerp(previous.GetValue(), itNext->GetValue(), factor);
+}
+
+template<typename Func>
+double MeasureSeconds(Func&& func)
+{
+	std::chrono::steady_clock::time_point startTimePoint = std::chrono::steady_clock::now();
+	func();
+	std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTimePoint;
+	return elapsedTime.count();
+}
+
+float MaxError(const std::vector<cd::Transform>& lhs, const std::vector<cd::Transform>& rhs)
+{
+	float maxError = 0.0f;
+	for (std::size_t transformIndex = 0U; transformIndex < lhs.size(); ++transformIndex)
+	{
+		for (int index = 0; index < static_cast<int>(cd::Transform::Size); ++index)
+		{
+			maxError = std::max(maxError, std::abs(*(lhs[transformIndex].begin() + index) - *(rhs[transformIndex].begin() + index)));
+		}
+	}
+	return maxError;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	// argv[0] : exe name
+	// argv[1] : optional bone count, default is 256
+	// argv[2] : optional clip length in seconds baked at 30 keys per second, default is 10
+	uint32_t boneCount = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 256U;
+	float clipSeconds = argc > 2 ? static_cast<float>(std::atof(argv[2])) : 10.0f;
+	if (0U == boneCount || !(clipSeconds > 0.0f))
+	{
+		return 1;
+	}
+
+	// Every bone has a baked track. Key counts differ per bone like reduced tracks.
+	std::mt19937 generator(12345U);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	cd::SceneDatabase sceneDatabase;
+	cd::Animation animation(cd::AnimationID(0U), "Clip");
+	animation.SetDuration(clipSeconds);
+	animation.SetTicksPerSecond(30.0f);
+	std::vector<const cd::Track*> boneTracks;
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		std::string boneName = "Bone" + std::to_string(boneIndex);
+		cd::Bone bone;
+		bone.SetID(cd::BoneID(boneIndex));
+		bone.SetName(boneName.c_str());
+		bone.SetTransform(cd::Transform::Identity());
+		sceneDatabase.AddBone(cd::MoveTemp(bone));
+
+		uint32_t keyCount = static_cast<uint32_t>(clipSeconds * (10.0f + 20.0f * static_cast<float>(boneIndex % 3U) / 2.0f)) + 1U;
+		cd::Track track(cd::TrackID(boneIndex), animation.GetName() + boneName);
+		track.SetTranslationKeyCount(keyCount);
+		track.SetRotationKeyCount(keyCount);
+		track.SetScaleKeyCount(1U);
+		cd::Vec3f axis = cd::Vec3f(distribution(generator), distribution(generator), distribution(generator)).Normalize();
+		for (uint32_t keyIndex = 0U; keyIndex < keyCount; ++keyIndex)
+		{
+			float time = clipSeconds * static_cast<float>(keyIndex) / static_cast<float>(keyCount - 1U);
+			track.GetTranslationKeys()[keyIndex] = cd::TranslationKey(time, cd::Vec3f(std::sin(time), std::cos(time), distribution(generator)));
+			track.GetRotationKeys()[keyIndex] = cd::RotationKey(time, cd::Quaternion::FromAxisAngle(axis, std::sin(time + static_cast<float>(boneIndex))));
+		}
+		track.GetScaleKeys()[0] = cd::ScaleKey(0.0f, cd::Vec3f::One());
+		animation.AddBoneTrackID(track.GetID());
+		sceneDatabase.AddTrack(cd::MoveTemp(track));
+	}
+	sceneDatabase.AddAnimation(cd::MoveTemp(animation));
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		boneTracks.push_back(&sceneDatabase.GetTrack(boneIndex));
+	}
+
+	cd::AnimationSampler sampler(sceneDatabase, cd::AnimationID(0U));
+
+	// Playback at 120 frames per second, then random seeking.
+	constexpr uint32_t repeatCount = 4U;
+	std::vector<float> playbackTimes;
+	for (float time = 0.0f; time <= clipSeconds; time += 1.0f / 120.0f)
+	{
+		playbackTimes.push_back(time);
+	}
+	std::vector<float> seekTimes(playbackTimes.size());
+	std::uniform_real_distribution<float> timeDistribution(0.0f, clipSeconds);
+	std::generate(seekTimes.begin(), seekTimes.end(), [&]() { return timeDistribution(generator); });
+
+	std::vector<cd::Transform> referencePose(boneCount);
+	std::vector<cd::Transform> pose(boneCount);
+	float maxError = 0.0f;
+	auto SampleReference = [&](float time)
+	{
+		for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+		{
+			const cd::Track* pTrack = boneTracks[boneIndex];
+			referencePose[boneIndex] = cd::Transform(
+				ReferenceSample(pTrack->GetTranslationKeys(), time, &cd::Vec3f::Lerp),
+				ReferenceSample(pTrack->GetRotationKeys(), time, &cd::Quaternion::LerpNormalized),
+				ReferenceSample(pTrack->GetScaleKeys(), time, &cd::Vec3f::Lerp));
+		}
+	};
+
+	double referencePlaybackTime = MeasureSeconds([&]()
+	{
+		for (uint32_t repeatIndex = 0U; repeatIndex < repeatCount; ++repeatIndex)
+		{
+			for (float time : playbackTimes)
+			{
+				SampleReference(time);
+			}
+		}
+	});
+	double playbackTime = MeasureSeconds([&]()
+	{
+		for (uint32_t repeatIndex = 0U; repeatIndex < repeatCount; ++repeatIndex)
+		{
+			for (float time : playbackTimes)
+			{
+				sampler.Sample(time, pose);
+			}
+		}
+	});
+	double referenceSeekTime = MeasureSeconds([&]()
+	{
+		for (float time : seekTimes)
+		{
+			SampleReference(time);
+		}
+	});
+	double seekTime = MeasureSeconds([&]()
+	{
+		for (float time : seekTimes)
+		{
+			sampler.Sample(time, pose);
+		}
+	});
+
+	// Results are compared at every playback frame and seek time.
+	sampler.ResetCursors();
+	for (float time : playbackTimes)
+	{
+		SampleReference(time);
+		sampler.Sample(time, pose);
+		maxError = std::max(maxError, MaxError(referencePose, pose));
+	}
+	for (float time : seekTimes)
+	{
+		SampleReference(time);
+		sampler.Sample(time, pose);
+		maxError = std::max(maxError, MaxError(referencePose, pose));
+	}
+
+	// Bones per microsecond.
+	const double playbackBoneCount = static_cast<double>(boneCount) * playbackTimes.size() * repeatCount / 1000000.0;
+	const double seekBoneCount = static_cast<double>(boneCount) * seekTimes.size() / 1000000.0;
+	printf("BoneCount = %u, ClipSeconds = %.1f, Frames = %zu\n", boneCount, clipSeconds, playbackTimes.size());
+	printf("Playback : reference %.2f bones/us, sampler %.2f bones/us\n", playbackBoneCount / referencePlaybackTime, playbackBoneCount / playbackTime);
+	printf("Seek : reference %.2f bones/us, sampler %.2f bones/us\n", seekBoneCount / referenceSeekTime, seekBoneCount / seekTime);
+	printf("Max error = %g\n", maxError);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "GltfProducer.h"
+#include "Scene/SceneDatabase.h"
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr uint32_t AttributeElementCount = 1000U;
+
+// One triangle whose NORMAL, TEXCOORD_0 and TANGENT accessors have more elements than POSITION.
+std::string MakeDocument(const std::string& bufferUri, const std::string& meshName, const std::string& extras)
+{
+	const std::string count = std::to_string(AttributeElementCount);
+	return "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"mesh\":0}],"
+		"\"meshes\":[{\"name\":\"" + meshName + "\",\"extras\":" + extras + ","
+		"\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2,\"TANGENT\":3}}]}],"
+		"\"accessors\":[{\"bufferView\":0,\"componentType\":5126,\"count\":3,\"type\":\"VEC3\",\"min\":[0,0,0],\"max\":[1,1,0]},"
+		"{\"bufferView\":1,\"componentType\":5126,\"count\":" + count + ",\"type\":\"VEC3\"},"
+		"{\"bufferView\":1,\"componentType\":5126,\"count\":" + count + ",\"type\":\"VEC2\"},"
+		"{\"bufferView\":1,\"componentType\":5126,\"count\":" + count + ",\"type\":\"VEC4\"}],"
+		"\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":36},{\"buffer\":0,\"byteOffset\":36,\"byteLength\":" + std::to_string(AttributeElementCount * 16U) + "}],"
+		"\"buffers\":[{\"uri\":\"" + bufferUri + "\",\"byteLength\":" + std::to_string(36U + AttributeElementCount * 16U) + "}]}";
+}
+
+void WriteFile(const std::filesystem::path& filePath, const void* pData, std::size_t size)
+{
+	std::ofstream file(filePath, std::ios::binary);
+	file.write(static_cast<const char*>(pData), static_cast<std::streamsize>(size));
+}
+
+cd::SceneDatabase Import(const std::filesystem::path& folderPath, const std::string& document)
+{
+	const std::filesystem::path filePath = folderPath / "Triangle.gltf";
+	WriteFile(filePath, document.data(), document.size());
+
+	cd::SceneDatabase sceneDatabase;
+	cdtools::GltfProducer producer(filePath.string().c_str());
+	producer.Execute(&sceneDatabase);
+	return sceneDatabase;
+}
+
+}
+
+int main()
+{
+	const std::filesystem::path folderPath = std::filesystem::temp_directory_path() / "GltfToMalformedFiles";
+	std::filesystem::create_directories(folderPath);
+
+	// Attribute data is (1, 0, 0, 1) so read normals differ from computed ones.
+	std::vector<float> bufferData = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f };
+	for (uint32_t elementIndex = 0U; elementIndex < AttributeElementCount; ++elementIndex)
+	{
+		bufferData.insert(bufferData.end(), { 1.0f, 0.0f, 0.0f, 1.0f });
+	}
+	WriteFile(folderPath / "Triangle.bin", bufferData.data(), bufferData.size() * sizeof(float));
+
+	uint32_t failedCount = 0U;
+	auto Check = [&failedCount](bool passed, const char* pCaseName)
+	{
+		printf("%s : %s\n", pCaseName, passed ? "passed" : "failed");
+		failedCount += passed ? 0U : 1U;
+	};
+
+	{
+		// Attributes of other counts than POSITION are ignored. Normals are computed instead.
+		cd::SceneDatabase sceneDatabase = Import(folderPath, MakeDocument("Triangle.bin", "Triangle", "{}"));
+		bool passed = 1U == sceneDatabase.GetMeshCount();
+		if (passed)
+		{
+			const cd::Mesh& mesh = sceneDatabase.GetMesh(0U);
+			passed = 3U == mesh.GetVertexCount() && 0U == mesh.GetVertexUVSetCount() && std::abs(mesh.GetVertexNormals()[0].z() - 1.0f) < 0.001f;
+		}
+		Check(passed, "Mismatched attribute counts");
+	}
+
+	Check(0U == Import(folderPath, MakeDocument("Triangle%2.bin", "Triangle", "{}")).GetMeshCount(), "Truncated uri escape");
+	Check(0U == Import(folderPath, MakeDocument("Triangle%G0.bin", "Triangle", "{}")).GetMeshCount(), "Invalid uri escape");
+	Check(1U == Import(folderPath, MakeDocument("Tri%61ngle.bin", "Triangle", "{}")).GetMeshCount(), "Valid uri escape");
+	Check(0U == Import(folderPath, MakeDocument("Triangle.bin", "Triangle", "{}") + " }").GetMeshCount(), "Trailing content");
+	Check(0U == Import(folderPath, MakeDocument("Triangle.bin", "\\uD800\\u0041", "{}")).GetMeshCount(), "Invalid low surrogate");
+	Check(0U == Import(folderPath, MakeDocument("Triangle.bin", "\\uDC00", "{}")).GetMeshCount(), "Unpaired low surrogate");
+	Check(1U == Import(folderPath, MakeDocument("Triangle.bin", "\\uD83D\\uDE00", "{}")).GetMeshCount(), "Surrogate pair");
+	Check(0U == Import(folderPath, MakeDocument("Triangle.bin", "Triangle", std::string(1000000U, '[') + std::string(1000000U, ']'))).GetMeshCount(), "Deep nesting");
+
+	{
+		// Accessors of missing buffer views have no elements.
+		std::string document = MakeDocument("Triangle.bin", "Triangle", "{}");
+		document.replace(document.find("\"bufferView\":0"), 14U, "\"bufferView\":5000000");
+		cd::SceneDatabase sceneDatabase = Import(folderPath, document);
+		Check(0U == sceneDatabase.GetMeshCount() || 0U == sceneDatabase.GetMesh(0U).GetVertexCount(), "Invalid buffer view");
+	}
+
+	std::filesystem::remove_all(folderPath);
+
+	return 0U == failedCount ? 0 : 1;
+}
\ No newline at end of file
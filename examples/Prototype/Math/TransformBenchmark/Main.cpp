@@ -0,0 +1,240 @@
+#include "Math/Transform.hpp"
+#include "Math/TransformBatch.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+// Reference implementations are written in generic scalar codes which don't go through SIMD paths.
+cd::Matrix4x4 ReferenceMultiply(const cd::Matrix4x4& lhs, const cd::Matrix4x4& rhs)
+{
+	cd::Matrix4x4 result;
+	for (int row = 0; row < 4; ++row)
+	{
+		for (int col = 0; col < 4; ++col)
+		{
+			result.Data(row, col) = lhs.Data(row, 0) * rhs.Data(0, col) + lhs.Data(row, 1) * rhs.Data(1, col) +
+				lhs.Data(row, 2) * rhs.Data(2, col) + lhs.Data(row, 3) * rhs.Data(3, col);
+		}
+	}
+	return result;
+}
+
+cd::Quaternion ReferenceMultiply(const cd::Quaternion& lhs, const cd::Quaternion& rhs)
+{
+	return cd::Quaternion(
+		lhs.w() * rhs.w() - lhs.x() * rhs.x() - lhs.y() * rhs.y() - lhs.z() * rhs.z(),
+		lhs.w() * rhs.x() + lhs.x() * rhs.w() + lhs.y() * rhs.z() - lhs.z() * rhs.y(),
+		lhs.w() * rhs.y() - lhs.x() * rhs.z() + lhs.y() * rhs.w() + lhs.z() * rhs.x(),
+		lhs.w() * rhs.z() + lhs.x() * rhs.y() - lhs.y() * rhs.x() + lhs.z() * rhs.w());
+}
+
+cd::Vec3f ReferenceTransform(const cd::Matrix4x4& matrix, const cd::Vec3f& point)
+{
+	return cd::Vec3f(
+		matrix.Data(0, 0) * point.x() + matrix.Data(0, 1) * point.y() + matrix.Data(0, 2) * point.z() + matrix.Data(0, 3),
+		matrix.Data(1, 0) * point.x() + matrix.Data(1, 1) * point.y() + matrix.Data(1, 2) * point.z() + matrix.Data(1, 3),
+		matrix.Data(2, 0) * point.x() + matrix.Data(2, 1) * point.y() + matrix.Data(2, 2) * point.z() + matrix.Data(2, 3));
+}
+
+cd::AABB ReferenceTransform(const cd::Matrix4x4& matrix, const cd::AABB& box)
+{
+	cd::Vec3f extent = (box.Max() - box.Min()) * 0.5f;
+	cd::Vec3f center = ReferenceTransform(matrix, box.Min() + extent);
+	cd::Vec3f newExtent;
+	for (int row = 0; row < 3; ++row)
+	{
+		newExtent[row] = std::abs(matrix.Data(row, 0)) * extent.x() + std::abs(matrix.Data(row, 1)) * extent.y() + std::abs(matrix.Data(row, 2)) * extent.z();
+	}
+	return cd::AABB(center - newExtent, center + newExtent);
+}
+
+template<typename Func>
+double MeasureSeconds(uint32_t repeatCount, Func&& func)
+{
+	std::chrono::steady_clock::time_point startTimePoint = std::chrono::steady_clock::now();
+	for (uint32_t repeatIndex = 0U; repeatIndex < repeatCount; ++repeatIndex)
+	{
+		func();
+	}
+	std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTimePoint;
+	return elapsedTime.count();
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	// argv[0] : exe name
+	// argv[1] : optional element count, default is 1M
+	uint32_t elementCount = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 1000000U;
+	if (0U == elementCount)
+	{
+		return 1;
+	}
+
+	constexpr uint32_t repeatCount = 8U;
+	std::mt19937 generator(12345U);
+	std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+
+	cd::Matrix4x4 transform = cd::Transform(cd::Vec3f(1.0f, 2.0f, 3.0f), cd::Quaternion::FromAxisAngle(cd::Vec3f(1.0f, 1.0f, 0.0f).Normalize(), 0.7f), cd::Vec3f(2.0f, 0.5f, 1.5f)).GetMatrix();
+
+	std::vector<cd::Matrix4x4> matrices(elementCount);
+	std::vector<cd::Quaternion> quaternions(elementCount);
+	std::vector<cd::Vec3f> points(elementCount);
+	for (uint32_t elementIndex = 0U; elementIndex < elementCount; ++elementIndex)
+	{
+		quaternions[elementIndex] = cd::Quaternion(distribution(generator), distribution(generator), distribution(generator), distribution(generator)).Normalize();
+
+		// Scale is kept away from zero so that inverse matrices are well conditioned.
+		cd::Vec3f translation(distribution(generator), distribution(generator), distribution(generator));
+		cd::Vec3f scale(std::abs(distribution(generator)) * 0.2f + 0.5f, std::abs(distribution(generator)) * 0.2f + 0.5f, std::abs(distribution(generator)) * 0.2f + 0.5f);
+		matrices[elementIndex] = cd::Transform(translation, quaternions[elementIndex], scale).GetMatrix();
+		points[elementIndex] = cd::Vec3f(distribution(generator), distribution(generator), distribution(generator));
+	}
+
+	// Matrix4x4 * Matrix4x4
+	std::vector<cd::Matrix4x4> referenceMatrices(elementCount);
+	std::vector<cd::Matrix4x4> outputMatrices(elementCount);
+	double referenceMatrixTime = MeasureSeconds(repeatCount, [&]()
+	{
+		for (uint32_t elementIndex = 0U; elementIndex < elementCount; ++elementIndex)
+		{
+			referenceMatrices[elementIndex] = ReferenceMultiply(transform, matrices[elementIndex]);
+		}
+	});
+	double matrixTime = MeasureSeconds(repeatCount, [&]()
+	{
+		cd::TransformBatch::MultiplyMatrices(transform, matrices, outputMatrices);
+	});
+
+	// Matrix4x4::Inverse
+	std::vector<cd::Matrix4x4> inverseMatrices(elementCount);
+	double inverseTime = MeasureSeconds(repeatCount, [&]()
+	{
+		for (uint32_t elementIndex = 0U; elementIndex < elementCount; ++elementIndex)
+		{
+			inverseMatrices[elementIndex] = matrices[elementIndex].Inverse();
+		}
+	});
+
+	// Quaternion * Quaternion
+	std::vector<cd::Quaternion> referenceQuaternions(elementCount);
+	std::vector<cd::Quaternion> outputQuaternions(elementCount);
+	double referenceQuaternionTime = MeasureSeconds(repeatCount, [&]()
+	{
+		for (uint32_t elementIndex = 0U; elementIndex + 1U < elementCount; ++elementIndex)
+		{
+			referenceQuaternions[elementIndex] = ReferenceMultiply(quaternions[elementIndex], quaternions[elementIndex + 1U]);
+		}
+	});
+	double quaternionTime = MeasureSeconds(repeatCount, [&]()
+	{
+		for (uint32_t elementIndex = 0U; elementIndex + 1U < elementCount; ++elementIndex)
+		{
+			outputQuaternions[elementIndex] = quaternions[elementIndex] * quaternions[elementIndex + 1U];
+		}
+	});
+
+	// Transform points
+	std::vector<cd::Vec3f> referencePoints(elementCount);
+	std::vector<cd::Vec3f> outputPoints(elementCount);
+	double referencePointTime = MeasureSeconds(repeatCount, [&]()
+	{
+		for (uint32_t elementIndex = 0U; elementIndex < elementCount; ++elementIndex)
+		{
+			referencePoints[elementIndex] = ReferenceTransform(transform, points[elementIndex]);
+		}
+	});
+	double pointTime = MeasureSeconds(repeatCount, [&]()
+	{
+		cd::TransformBatch::TransformPoints(transform, points, outputPoints);
+	});
+
+	// Transform AABBs by matrix array
+	std::vector<cd::AABB> boxes(elementCount);
+	for (uint32_t elementIndex = 0U; elementIndex < elementCount; ++elementIndex)
+	{
+		cd::Vec3f halfSize(std::abs(distribution(generator)), std::abs(distribution(generator)), std::abs(distribution(generator)));
+		boxes[elementIndex] = cd::AABB(points[elementIndex] - halfSize, points[elementIndex] + halfSize);
+	}
+	std::vector<cd::AABB> referenceBoxes(elementCount);
+	std::vector<cd::AABB> outputBoxes(elementCount);
+	double referenceBoxTime = MeasureSeconds(repeatCount, [&]()
+	{
+		for (uint32_t elementIndex = 0U; elementIndex < elementCount; ++elementIndex)
+		{
+			referenceBoxes[elementIndex] = ReferenceTransform(matrices[elementIndex], boxes[elementIndex]);
+		}
+	});
+	double boxTime = MeasureSeconds(repeatCount, [&]()
+	{
+		cd::TransformBatch::TransformAABBs(matrices, boxes, outputBoxes);
+	});
+
+	// Merge AABBs
+	cd::AABB referenceMergedBox(FLT_MAX, -FLT_MAX);
+	cd::AABB mergedBox;
+	double referenceMergeTime = MeasureSeconds(repeatCount, [&]()
+	{
+		referenceMergedBox = cd::AABB(FLT_MAX, -FLT_MAX);
+		for (const cd::AABB& box : outputBoxes)
+		{
+			referenceMergedBox.Merge(box);
+		}
+	});
+	double mergeTime = MeasureSeconds(repeatCount, [&]()
+	{
+		mergedBox = cd::TransformBatch::MergeAABBs(outputBoxes);
+	});
+
+	float matrixMaxError = 0.0f;
+	float inverseMaxError = 0.0f;
+	float quaternionMaxError = 0.0f;
+	float pointMaxError = 0.0f;
+	float boxMaxError = 0.0f;
+	for (uint32_t elementIndex = 0U; elementIndex < elementCount; ++elementIndex)
+	{
+		cd::Matrix4x4 identity = ReferenceMultiply(matrices[elementIndex], inverseMatrices[elementIndex]);
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int col = 0; col < 4; ++col)
+			{
+				matrixMaxError = std::max(matrixMaxError, std::abs(outputMatrices[elementIndex].Data(row, col) - referenceMatrices[elementIndex].Data(row, col)));
+				inverseMaxError = std::max(inverseMaxError, std::abs(identity.Data(row, col) - (row == col ? 1.0f : 0.0f)));
+			}
+		}
+
+		for (int index = 0; index < 4; ++index)
+		{
+			quaternionMaxError = std::max(quaternionMaxError, std::abs(outputQuaternions[elementIndex].Data(index) - referenceQuaternions[elementIndex].Data(index)));
+		}
+
+		for (int index = 0; index < 3; ++index)
+		{
+			pointMaxError = std::max(pointMaxError, std::abs(outputPoints[elementIndex][index] - referencePoints[elementIndex][index]));
+			boxMaxError = std::max(boxMaxError, std::abs(outputBoxes[elementIndex].Min()[index] - referenceBoxes[elementIndex].Min()[index]));
+			boxMaxError = std::max(boxMaxError, std::abs(outputBoxes[elementIndex].Max()[index] - referenceBoxes[elementIndex].Max()[index]));
+		}
+	}
+	bool isMergedBoxSame = mergedBox.Min() == referenceMergedBox.Min() && mergedBox.Max() == referenceMergedBox.Max();
+
+	const double operationCount = static_cast<double>(elementCount) * repeatCount / 1000000.0;
+	printf("ElementCount = %u, RepeatCount = %u\n", elementCount, repeatCount);
+	printf("Matrix4x4 multiply : reference %.2f M/s, batch %.2f M/s, max error = %g\n", operationCount / referenceMatrixTime, operationCount / matrixTime, matrixMaxError);
+	printf("Matrix4x4 inverse : %.2f M/s, max |M * inverse(M) - I| = %g\n", operationCount / inverseTime, inverseMaxError);
+	printf("Quaternion multiply : reference %.2f M/s, operator* %.2f M/s, max error = %g\n", operationCount / referenceQuaternionTime, operationCount / quaternionTime, quaternionMaxError);
+	printf("Transform points : reference %.2f M/s, batch %.2f M/s, max error = %g\n", operationCount / referencePointTime, operationCount / pointTime, pointMaxError);
+	printf("Transform AABBs : reference %.2f M/s, batch %.2f M/s, max error = %g\n", operationCount / referenceBoxTime, operationCount / boxTime, boxMaxError);
+	printf("Merge AABBs : reference %.2f M/s, batch %.2f M/s, same result = %d\n", operationCount / referenceMergeTime, operationCount / mergeTime, isMergedBoxSame);
+
+	return 0;
+}
\ No newline at end of file
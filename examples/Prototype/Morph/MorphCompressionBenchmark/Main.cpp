@@ -0,0 +1,194 @@
+#include "IO/InputArchive.hpp"
+#include "IO/OutputArchive.hpp"
+#include "Scene/Mesh.h"
+#include "Scene/Morph.h"
+#include "Scene/MorphCompressor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+template<typename Func>
+double MeasureSeconds(Func&& func)
+{
+	std::chrono::steady_clock::time_point startTimePoint = std::chrono::steady_clock::now();
+	func();
+	std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTimePoint;
+	return elapsedTime.count();
+}
+
+std::size_t GetSerializedSize(const std::vector<cd::Morph>& morphs)
+{
+	std::ostringstream stream;
+	cd::OutputArchive outputArchive(&stream);
+	for (const cd::Morph& morph : morphs)
+	{
+		morph >> outputArchive;
+	}
+	return stream.str().size();
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	// argv[0] : exe name
+	// argv[1] : optional mesh vertex count, default is 20000
+	// argv[2] : optional morph count, default is 200
+	uint32_t vertexCount = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 20000U;
+	uint32_t morphCount = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 200U;
+	if (vertexCount < 2U || 0U == morphCount)
+	{
+		return 1;
+	}
+
+	// Source mesh is a curved grid in 0.2 unit size like a face.
+	std::mt19937 generator(12345U);
+	std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+	cd::Mesh mesh;
+	mesh.Init(vertexCount);
+	const uint32_t rowVertexCount = static_cast<uint32_t>(std::sqrt(static_cast<float>(vertexCount)));
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		float x = static_cast<float>(vertexIndex % rowVertexCount) / static_cast<float>(rowVertexCount) * 0.2f;
+		float y = static_cast<float>(vertexIndex / rowVertexCount) / static_cast<float>(rowVertexCount) * 0.2f;
+		mesh.SetVertexPosition(vertexIndex, cd::Point(x, y, std::sin(x * 10.0f) * 0.02f));
+	}
+
+	// Every morph stores all vertices as exported by DCC tools. A region of about 5% vertices moves by up to 1cm
+	// and the rest only has float noise from the export.
+	std::vector<cd::Morph> morphs(morphCount);
+	std::vector<float> weights(morphCount);
+	for (uint32_t morphIndex = 0U; morphIndex < morphCount; ++morphIndex)
+	{
+		cd::Morph& morph = morphs[morphIndex];
+		morph.SetID(cd::MorphID(morphIndex));
+		morph.SetWeight(0.0f);
+		morph.SetVertexSourceIDCount(vertexCount);
+		morph.SetVertexPositionCount(vertexCount);
+
+		const uint32_t regionBegin = static_cast<uint32_t>((distribution(generator) * 0.5f + 0.5f) * static_cast<float>(vertexCount) * 0.95f);
+		const uint32_t regionEnd = std::min(vertexCount, regionBegin + vertexCount / 20U);
+		for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+		{
+			cd::Point offset(distribution(generator), distribution(generator), distribution(generator));
+			offset *= vertexIndex >= regionBegin && vertexIndex < regionEnd ? 0.01f : 0.000001f;
+			morph.GetVertexSourceIDs()[vertexIndex] = cd::VertexID(vertexIndex);
+			morph.GetVertexPositions()[vertexIndex] = mesh.GetVertexPosition(vertexIndex) + offset;
+		}
+		weights[morphIndex] = distribution(generator) * 0.5f + 0.5f;
+	}
+
+	// Reference evaluation walks every stored vertex of absolute target positions.
+	constexpr uint32_t repeatCount = 10U;
+	std::vector<cd::Point> referencePositions;
+	double referenceTime = MeasureSeconds([&]()
+	{
+		for (uint32_t repeatIndex = 0U; repeatIndex < repeatCount; ++repeatIndex)
+		{
+			referencePositions = mesh.GetVertexPositions();
+			for (uint32_t morphIndex = 0U; morphIndex < morphCount; ++morphIndex)
+			{
+				const cd::Morph& morph = morphs[morphIndex];
+				for (uint32_t vertexIndex = 0U; vertexIndex < morph.GetVertexCount(); ++vertexIndex)
+				{
+					const uint32_t sourceID = morph.GetVertexSourceID(vertexIndex).Data();
+					referencePositions[sourceID] += (morph.GetVertexPosition(vertexIndex) - mesh.GetVertexPosition(sourceID)) * weights[morphIndex];
+				}
+			}
+		}
+	});
+
+	const std::size_t sourceSize = GetSerializedSize(morphs);
+	double compressTime = MeasureSeconds([&]()
+	{
+		for (cd::Morph& morph : morphs)
+		{
+			cd::MorphCompressor::SparsifyDeltas(morph, mesh, 0.0001f);
+			cd::MorphCompressor::QuantizeDeltas(morph);
+		}
+	});
+	const std::size_t compressedSize = GetSerializedSize(morphs);
+
+	// Quantized deltas are reloaded to check that .cd files keep in memory values.
+	std::ostringstream outputStream;
+	cd::OutputArchive outputArchive(&outputStream);
+	for (const cd::Morph& morph : morphs)
+	{
+		morph >> outputArchive;
+	}
+	std::istringstream inputStream(outputStream.str());
+	cd::InputArchive inputArchive(&inputStream);
+	float maxReloadError = 0.0f;
+	for (const cd::Morph& morph : morphs)
+	{
+		cd::Morph reloadedMorph(inputArchive);
+		for (uint32_t vertexIndex = 0U; vertexIndex < morph.GetVertexCount(); ++vertexIndex)
+		{
+			const cd::Point difference = reloadedMorph.GetVertexPosition(vertexIndex) - morph.GetVertexPosition(vertexIndex);
+			maxReloadError = std::max(maxReloadError, std::max(std::abs(difference.x()), std::max(std::abs(difference.y()), std::abs(difference.z()))));
+		}
+	}
+
+	std::vector<cd::Point> scalarPositions;
+	double scalarTime = MeasureSeconds([&]()
+	{
+		for (uint32_t repeatIndex = 0U; repeatIndex < repeatCount; ++repeatIndex)
+		{
+			scalarPositions = mesh.GetVertexPositions();
+			for (uint32_t morphIndex = 0U; morphIndex < morphCount; ++morphIndex)
+			{
+				const cd::Morph& morph = morphs[morphIndex];
+				for (uint32_t vertexIndex = 0U; vertexIndex < morph.GetVertexCount(); ++vertexIndex)
+				{
+					scalarPositions[morph.GetVertexSourceID(vertexIndex).Data()] += morph.GetVertexPosition(vertexIndex) * weights[morphIndex];
+				}
+			}
+		}
+	});
+
+	std::vector<cd::Point> positions;
+	double applyTime = MeasureSeconds([&]()
+	{
+		for (uint32_t repeatIndex = 0U; repeatIndex < repeatCount; ++repeatIndex)
+		{
+			positions = mesh.GetVertexPositions();
+			for (uint32_t morphIndex = 0U; morphIndex < morphCount; ++morphIndex)
+			{
+				cd::MorphCompressor::ApplyDeltas(morphs[morphIndex], weights[morphIndex], positions);
+			}
+		}
+	});
+
+	float maxError = 0.0f;
+	float maxKernelError = 0.0f;
+	uint32_t keptVertexCount = 0U;
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const cd::Point difference = positions[vertexIndex] - referencePositions[vertexIndex];
+		const cd::Point kernelDifference = positions[vertexIndex] - scalarPositions[vertexIndex];
+		maxError = std::max(maxError, std::max(std::abs(difference.x()), std::max(std::abs(difference.y()), std::abs(difference.z()))));
+		maxKernelError = std::max(maxKernelError, std::max(std::abs(kernelDifference.x()), std::max(std::abs(kernelDifference.y()), std::abs(kernelDifference.z()))));
+	}
+	for (const cd::Morph& morph : morphs)
+	{
+		keptVertexCount += morph.GetVertexCount();
+	}
+
+	printf("VertexCount = %u, MorphCount = %u, KeptMorphVertices = %u / %u\n", vertexCount, morphCount, keptVertexCount, vertexCount * morphCount);
+	printf("Serialized size : %.2f MB -> %.2f MB (%.1fx), compress %.2f ms\n", sourceSize / 1048576.0, compressedSize / 1048576.0,
+		static_cast<double>(sourceSize) / static_cast<double>(compressedSize), compressTime * 1000.0);
+	printf("Evaluate all morphs : dense %.3f ms, sparse scalar %.3f ms, sparse kernel %.3f ms\n",
+		referenceTime * 1000.0 / repeatCount, scalarTime * 1000.0 / repeatCount, applyTime * 1000.0 / repeatCount);
+	printf("Max error = %g, kernel vs scalar = %g, reload = %g\n", maxError, maxKernelError, maxReloadError);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "Math/NoiseGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+template<typename Func>
+double MeasureSamplesPerSecond(uint32_t rowCount, uint32_t rowLength, Func&& func)
+{
+	std::chrono::steady_clock::time_point startTimePoint = std::chrono::steady_clock::now();
+	for (uint32_t row = 0U; row < rowCount; ++row)
+	{
+		func(row);
+	}
+	std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTimePoint;
+	return static_cast<double>(rowCount) * rowLength / elapsedTime.count();
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	// argv[0] : exe name
+	// argv[1] : optional tile size, default is 2048 which evaluates about 4M samples per test
+	uint32_t tileSize = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 2048U;
+	if (0U == tileSize)
+	{
+		return 1;
+	}
+
+	constexpr int64_t seed = 12345;
+	const double step = 1.0 / 64.0;
+	std::vector<float> scalarTile(tileSize * tileSize);
+	std::vector<float> doubleTile(tileSize * tileSize);
+	std::vector<float> floatTile(tileSize * tileSize);
+
+	double scalarSpeed = MeasureSamplesPerSecond(tileSize, tileSize, [&](uint32_t row)
+	{
+		float* pRow = scalarTile.data() + row * tileSize;
+		for (uint32_t col = 0U; col < tileSize; ++col)
+		{
+			pRow[col] = cd::NoiseGenerator::SimplexNoise2D(seed, col * step, row * step);
+		}
+	});
+
+	double doubleSpeed = MeasureSamplesPerSecond(tileSize, tileSize, [&](uint32_t row)
+	{
+		cd::NoiseGenerator::SimplexNoise2DRow(seed, 0.0, row * step, step, tileSize, doubleTile.data() + row * tileSize);
+	});
+
+	double floatSpeed = MeasureSamplesPerSecond(tileSize, tileSize, [&](uint32_t row)
+	{
+		cd::NoiseGenerator::SimplexNoise2DRow(seed, 0.0f, static_cast<float>(row * step), static_cast<float>(step), tileSize, floatTile.data() + row * tileSize);
+	});
+
+	float doubleMaxError = 0.0f;
+	float floatMaxError = 0.0f;
+	for (uint32_t sampleIndex = 0U; sampleIndex < scalarTile.size(); ++sampleIndex)
+	{
+		doubleMaxError = std::max(doubleMaxError, std::abs(doubleTile[sampleIndex] - scalarTile[sampleIndex]));
+		floatMaxError = std::max(floatMaxError, std::abs(floatTile[sampleIndex] - scalarTile[sampleIndex]));
+	}
+
+	printf("SampleCount = %u\n", tileSize * tileSize);
+	printf("SimplexNoise2D : %.2f M samples/s\n", scalarSpeed / 1000000.0);
+	printf("SimplexNoise2DRow(double) : %.2f M samples/s, max error = %g\n", doubleSpeed / 1000000.0, doubleMaxError);
+	printf("SimplexNoise2DRow(float) : %.2f M samples/s, max error = %g\n", floatSpeed / 1000000.0, floatMaxError);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "ProgressiveMesh/ProgressiveMesh.h"
+#include "Scene/Mesh.h"
+#include "Utilities/PerformanceProfiler.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// FNV-1a hash of collapse operations which is compared between versions to check that ordering is unchanged.
+uint64_t HashCollapseOperations(const std::pair<std::vector<uint32_t>, std::vector<uint32_t>>& collapseOperations)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (const std::vector<uint32_t>* pValues : { &collapseOperations.first, &collapseOperations.second })
+	{
+		for (uint32_t value : *pValues)
+		{
+			hash = (hash ^ value) * 1099511628211ULL;
+		}
+	}
+	return hash;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	// argv[0] : exe name
+	// argv[1] : optional grid size, default is 1000 which generates about 1M vertices
+	uint32_t gridSize = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 1000U;
+	if (0U == gridSize)
+	{
+		return 1;
+	}
+
+	// Generate a bumpy grid so that collapse costs are different and connectivity changes are similar to real meshes.
+	uint32_t rowVertexCount = gridSize + 1U;
+	std::vector<cd::Point> vertices;
+	vertices.reserve(rowVertexCount * rowVertexCount);
+	for (uint32_t z = 0U; z < rowVertexCount; ++z)
+	{
+		for (uint32_t x = 0U; x < rowVertexCount; ++x)
+		{
+			float height = static_cast<float>((x * 7U + z * 13U + x * z) % 17U) * 0.05f;
+			vertices.emplace_back(static_cast<float>(x), height, static_cast<float>(z));
+		}
+	}
+
+	cd::PolygonGroup polygonGroup;
+	polygonGroup.reserve(gridSize * gridSize * 2U);
+	for (uint32_t z = 0U; z < gridSize; ++z)
+	{
+		for (uint32_t x = 0U; x < gridSize; ++x)
+		{
+			uint32_t v0 = z * rowVertexCount + x;
+			uint32_t v1 = v0 + 1U;
+			uint32_t v2 = v0 + rowVertexCount;
+			uint32_t v3 = v2 + 1U;
+			polygonGroup.push_back({ cd::VertexID(v0), cd::VertexID(v2), cd::VertexID(v1) });
+			polygonGroup.push_back({ cd::VertexID(v1), cd::VertexID(v2), cd::VertexID(v3) });
+		}
+	}
+
+	std::vector<cd::PolygonGroup> polygonGroups;
+	polygonGroups.push_back(cd::MoveTemp(polygonGroup));
+	printf("VertexCount = %u, FaceCount = %u\n", static_cast<uint32_t>(vertices.size()), gridSize * gridSize * 2U);
+
+	using namespace cdtools;
+	PerformanceProfiler profiler("ProgressiveMeshBenchmark");
+
+	cd::ProgressiveMesh progressiveMesh;
+	{
+		PerformanceProfiler buildProfiler("FromIndexedFaces");
+		progressiveMesh = cd::ProgressiveMesh::FromIndexedFaces(vertices, polygonGroups);
+	}
+
+	{
+		PerformanceProfiler collapseProfiler("BuildCollapseOperations");
+		auto collapseOperations = progressiveMesh.BuildCollapseOperations();
+		printf("Collapse operation count = %u, hash = %016llx\n", static_cast<uint32_t>(collapseOperations.first.size()),
+			static_cast<unsigned long long>(HashCollapseOperations(collapseOperations)));
+	}
+
+	{
+		// Vertices in a corner of the grid are boundary vertices whose collapse costs have a penalty.
+		PerformanceProfiler boundaryProfiler("BuildCollapseOperationsWithBoundary");
+		cd::ProgressiveMesh boundaryMesh = cd::ProgressiveMesh::FromIndexedFaces(vertices, polygonGroups);
+		const float gridExtent = static_cast<float>(gridSize);
+		boundaryMesh.InitBoundary(cd::AABB(cd::Point(-0.5f, -1.0f, -0.5f), cd::Point(gridExtent * 0.5f, 10.0f, gridExtent * 0.3f)));
+		auto collapseOperations = boundaryMesh.BuildCollapseOperations();
+		printf("Collapse operation count with boundary = %u, hash = %016llx\n", static_cast<uint32_t>(collapseOperations.first.size()),
+			static_cast<unsigned long long>(HashCollapseOperations(collapseOperations)));
+	}
+
+	{
+		PerformanceProfiler lodProfiler("GenerateLodChain");
+		std::vector<float> lodPercents = { 0.5f, 0.25f, 0.125f, 0.0625f };
+		std::vector<cd::Mesh> lodMeshes = progressiveMesh.GenerateLodChain(lodPercents);
+		for (uint32_t lodIndex = 0U; lodIndex < lodMeshes.size(); ++lodIndex)
+		{
+			printf("LOD%u FaceCount = %u\n", lodIndex + 1U, lodMeshes[lodIndex].GetPolygonCount());
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "Producers/TerrainProducer/AlphaMapBlend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+using namespace cdtools;
+
+// Straightforward per texel version to compare with.
+float ReferenceBlendWeight(AlphaMapBlendFunction blendFunction, float elevation, const AlphaMapBlendRegion<int32_t>& region)
+{
+	if (AlphaMapBlendFunction::Step == blendFunction)
+	{
+		return elevation >= static_cast<float>(region.blendEnd) ? 1.0f : 0.0f;
+	}
+
+	const float range = static_cast<float>(region.blendEnd - region.blendStart);
+	float t = range > 0.0f ? (elevation - static_cast<float>(region.blendStart)) / range : (elevation >= static_cast<float>(region.blendEnd) ? 1.0f : 0.0f);
+	t = std::clamp(t, 0.0f, 1.0f);
+	switch (blendFunction)
+	{
+	case AlphaMapBlendFunction::SmoothStep:
+		return t * t * (3.0f - 2.0f * t);
+	case AlphaMapBlendFunction::SmoothStepHigh:
+		return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+	default:
+		return t;
+	}
+}
+
+void ReferenceConvert(std::byte* pTexels, uint32_t texelCount, const ElevationAlphaMapDef& alphaMapDef)
+{
+	for (uint32_t texelIndex = 0U; texelIndex < texelCount; ++texelIndex)
+	{
+		int32_t elevation;
+		std::memcpy(&elevation, pTexels + texelIndex * sizeof(int32_t), sizeof(elevation));
+		const float elevationValue = static_cast<float>(elevation);
+		const int32_t w0 = static_cast<int32_t>(ReferenceBlendWeight(alphaMapDef.blendFunction, elevationValue, alphaMapDef.redGreenBlendRegion) * 255.0f + 0.5f);
+		const int32_t w1 = static_cast<int32_t>(ReferenceBlendWeight(alphaMapDef.blendFunction, elevationValue, alphaMapDef.greenBlueBlendRegion) * 255.0f + 0.5f);
+		const int32_t w2 = static_cast<int32_t>(ReferenceBlendWeight(alphaMapDef.blendFunction, elevationValue, alphaMapDef.blueAlphaBlendRegion) * 255.0f + 0.5f);
+		std::byte* pTexel = pTexels + texelIndex * sizeof(int32_t);
+		pTexel[0] = static_cast<std::byte>(0xFF - w0);
+		pTexel[1] = static_cast<std::byte>(w0 - w1);
+		pTexel[2] = static_cast<std::byte>(w1 - w2);
+		pTexel[3] = static_cast<std::byte>(w2);
+	}
+}
+
+template<typename Func>
+double MeasureTexelsPerSecond(const std::vector<std::byte>& elevationMap, std::vector<std::byte>& alphaMap, uint32_t repeatCount, Func&& func)
+{
+	double totalSeconds = 0.0;
+	for (uint32_t repeatIndex = 0U; repeatIndex < repeatCount; ++repeatIndex)
+	{
+		// Conversion is in place so restore elevations every time. Copy is not measured.
+		alphaMap = elevationMap;
+		std::chrono::steady_clock::time_point startTimePoint = std::chrono::steady_clock::now();
+		func(alphaMap.data(), static_cast<uint32_t>(alphaMap.size() / sizeof(int32_t)));
+		std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTimePoint;
+		totalSeconds += elapsedTime.count();
+	}
+	return static_cast<double>(repeatCount) * (elevationMap.size() / sizeof(int32_t)) / totalSeconds;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	// argv[0] : exe name
+	// argv[1] : optional tile size, default is 1024 which converts 1M texels per test
+	uint32_t tileSize = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 1024U;
+	if (0U == tileSize)
+	{
+		return 1;
+	}
+
+	constexpr uint32_t repeatCount = 16U;
+	constexpr int32_t minElevation = -100;
+	constexpr int32_t maxElevation = 1000;
+
+	// Elevations sweep through all blend regions.
+	std::vector<std::byte> elevationMap(tileSize * tileSize * sizeof(int32_t));
+	for (uint32_t texelIndex = 0U; texelIndex < tileSize * tileSize; ++texelIndex)
+	{
+		const int32_t elevation = minElevation + static_cast<int32_t>((static_cast<uint64_t>(texelIndex) * 7919U) % (maxElevation - minElevation));
+		std::memcpy(elevationMap.data() + texelIndex * sizeof(int32_t), &elevation, sizeof(elevation));
+	}
+
+	ElevationAlphaMapDef alphaMapDef;
+	alphaMapDef.redGreenBlendRegion = { 0, 50 };
+	alphaMapDef.greenBlueBlendRegion = { 200, 400 };
+	alphaMapDef.blueAlphaBlendRegion = { 600, 900 };
+
+	constexpr const char* blendFunctionNames[] = { "Step", "Linear", "SmoothStep", "SmoothStepHigh" };
+	static_assert(std::size(blendFunctionNames) == static_cast<size_t>(AlphaMapBlendFunction::Count));
+
+	printf("TexelCount = %u\n", tileSize * tileSize);
+
+	std::vector<std::byte> referenceAlphaMap;
+	std::vector<std::byte> alphaMap;
+	int exitCode = 0;
+	for (uint8_t blendIndex = 0U; blendIndex < static_cast<uint8_t>(AlphaMapBlendFunction::Count); ++blendIndex)
+	{
+		alphaMapDef.blendFunction = static_cast<AlphaMapBlendFunction>(blendIndex);
+
+		double referenceSpeed = MeasureTexelsPerSecond(elevationMap, referenceAlphaMap, repeatCount, [&](std::byte* pTexels, uint32_t texelCount)
+		{
+			ReferenceConvert(pTexels, texelCount, alphaMapDef);
+		});
+
+		double kernelSpeed = MeasureTexelsPerSecond(elevationMap, alphaMap, repeatCount, [&](std::byte* pTexels, uint32_t texelCount)
+		{
+			ConvertElevationToAlphaMap(pTexels, texelCount, alphaMapDef);
+		});
+
+		int maxError = 0;
+		for (size_t byteIndex = 0U; byteIndex < alphaMap.size(); ++byteIndex)
+		{
+			maxError = std::max(maxError, std::abs(static_cast<int>(alphaMap[byteIndex]) - static_cast<int>(referenceAlphaMap[byteIndex])));
+		}
+
+		printf("%s : reference %.2f M texels/s, kernel %.2f M texels/s, max channel error = %d\n",
+			blendFunctionNames[blendIndex], referenceSpeed / 1000000.0, kernelSpeed / 1000000.0, maxError);
+
+		if (maxError > 1)
+		{
+			exitCode = 1;
+		}
+	}
+
+	return exitCode;
+}
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "Scene/TextureCompressor.h"
+#include "Scene/TextureMipGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+template<typename Func>
+double MeasureSeconds(Func&& func)
+{
+	std::chrono::steady_clock::time_point startTimePoint = std::chrono::steady_clock::now();
+	func();
+	std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTimePoint;
+	return elapsedTime.count();
+}
+
+uint64_t ReadBits(const uint8_t* pBlock, uint32_t byteCount)
+{
+	uint64_t bits = 0U;
+	for (uint32_t byteIndex = 0U; byteIndex < byteCount; ++byteIndex)
+	{
+		bits |= static_cast<uint64_t>(pBlock[byteIndex]) << (byteIndex * 8U);
+	}
+	return bits;
+}
+
+// Reference decoders to measure errors. Palettes are rounded as the encoder assumes.
+void DecodeColorBlock(const uint8_t* pBlock, uint8_t (*pPixels)[4])
+{
+	int palette[4][3];
+	for (uint32_t endpointIndex = 0U; endpointIndex < 2U; ++endpointIndex)
+	{
+		const uint32_t color = static_cast<uint32_t>(ReadBits(pBlock + endpointIndex * 2U, 2U));
+		const int red = (color >> 11U) & 0x1F;
+		const int green = (color >> 5U) & 0x3F;
+		const int blue = color & 0x1F;
+		palette[endpointIndex][0] = (red << 3) | (red >> 2);
+		palette[endpointIndex][1] = (green << 2) | (green >> 4);
+		palette[endpointIndex][2] = (blue << 3) | (blue >> 2);
+	}
+	for (uint32_t channelIndex = 0U; channelIndex < 3U; ++channelIndex)
+	{
+		palette[2][channelIndex] = (2 * palette[0][channelIndex] + palette[1][channelIndex] + 1) / 3;
+		palette[3][channelIndex] = (palette[0][channelIndex] + 2 * palette[1][channelIndex] + 1) / 3;
+	}
+
+	const uint64_t indexBits = ReadBits(pBlock + 4U, 4U);
+	for (uint32_t pixelIndex = 0U; pixelIndex < 16U; ++pixelIndex)
+	{
+		const uint32_t index = (indexBits >> (pixelIndex * 2U)) & 0x3U;
+		for (uint32_t channelIndex = 0U; channelIndex < 3U; ++channelIndex)
+		{
+			pPixels[pixelIndex][channelIndex] = static_cast<uint8_t>(palette[index][channelIndex]);
+		}
+	}
+}
+
+void DecodeChannelBlock(const uint8_t* pBlock, uint8_t (*pPixels)[4], uint32_t channelIndex)
+{
+	const int value0 = pBlock[0];
+	const int value1 = pBlock[1];
+	const uint64_t indexBits = ReadBits(pBlock + 2U, 6U);
+	for (uint32_t pixelIndex = 0U; pixelIndex < 16U; ++pixelIndex)
+	{
+		const int index = static_cast<int>((indexBits >> (pixelIndex * 3U)) & 0x7U);
+		const int value = index < 2 ? (0 == index ? value0 : value1) : ((8 - index) * value0 + (index - 1) * value1 + 3) / 7;
+		pPixels[pixelIndex][channelIndex] = static_cast<uint8_t>(value);
+	}
+}
+
+// Decodes mode 6 and mode 5 without rotation which are the modes TextureCompressor writes.
+void DecodeBC7Block(const uint8_t* pBlock, uint8_t (*pPixels)[4])
+{
+	constexpr uint32_t weights[16] = { 0U, 4U, 9U, 13U, 17U, 21U, 26U, 30U, 34U, 38U, 43U, 47U, 51U, 55U, 60U, 64U };
+	constexpr uint32_t twoBitsWeights[4] = { 0U, 21U, 43U, 64U };
+	const uint64_t bits[2] = { ReadBits(pBlock, 8U), ReadBits(pBlock + 8U, 8U) };
+	uint32_t bitOffset = 0U;
+	auto ReadValue = [&bits, &bitOffset](uint32_t bitCount)
+	{
+		uint32_t value = 0U;
+		for (uint32_t bitIndex = 0U; bitIndex < bitCount; ++bitIndex, ++bitOffset)
+		{
+			value |= static_cast<uint32_t>((bits[bitOffset / 64U] >> (bitOffset % 64U)) & 1U) << bitIndex;
+		}
+		return value;
+	};
+	auto Interpolate = [](uint32_t value0, uint32_t value1, uint32_t weight)
+	{
+		return static_cast<uint8_t>(((64U - weight) * value0 + weight * value1 + 32U) >> 6U);
+	};
+
+	uint32_t endpoints[2][4];
+	if (1U << 6U == ReadValue(7U))
+	{
+		for (uint32_t channelIndex = 0U; channelIndex < 4U; ++channelIndex)
+		{
+			endpoints[0][channelIndex] = ReadValue(7U) << 1U;
+			endpoints[1][channelIndex] = ReadValue(7U) << 1U;
+		}
+		const uint32_t pBit0 = ReadValue(1U);
+		const uint32_t pBit1 = ReadValue(1U);
+		for (uint32_t pixelIndex = 0U; pixelIndex < 16U; ++pixelIndex)
+		{
+			const uint32_t weight = weights[ReadValue(0U == pixelIndex ? 3U : 4U)];
+			for (uint32_t channelIndex = 0U; channelIndex < 4U; ++channelIndex)
+			{
+				pPixels[pixelIndex][channelIndex] = Interpolate(endpoints[0][channelIndex] | pBit0, endpoints[1][channelIndex] | pBit1, weight);
+			}
+		}
+		return;
+	}
+
+	bitOffset = 8U;
+	for (uint32_t channelIndex = 0U; channelIndex < 4U; ++channelIndex)
+	{
+		const uint32_t bitCount = channelIndex < 3U ? 7U : 8U;
+		for (uint32_t endpointIndex = 0U; endpointIndex < 2U; ++endpointIndex)
+		{
+			const uint32_t value = ReadValue(bitCount);
+			endpoints[endpointIndex][channelIndex] = 7U == bitCount ? (value << 1U) | (value >> 6U) : value;
+		}
+	}
+	for (uint32_t channelIndex = 0U; channelIndex < 4U; channelIndex += 3U)
+	{
+		for (uint32_t pixelIndex = 0U; pixelIndex < 16U; ++pixelIndex)
+		{
+			const uint32_t weight = twoBitsWeights[ReadValue(0U == pixelIndex ? 1U : 2U)];
+			for (uint32_t colorChannelIndex = channelIndex; colorChannelIndex < (0U == channelIndex ? 3U : 4U); ++colorChannelIndex)
+			{
+				pPixels[pixelIndex][colorChannelIndex] = Interpolate(endpoints[0][colorChannelIndex], endpoints[1][colorChannelIndex], weight);
+			}
+		}
+	}
+}
+
+double GetPSNR(const std::vector<uint8_t>& pixels, const std::vector<std::byte>& blocks, cd::TextureFormat format, uint32_t textureSize)
+{
+	const uint32_t blockCount = textureSize / 4U;
+	const std::size_t blockSize = cd::TextureMipGenerator::GetMipSize(format, 4U, 4U);
+	uint32_t channelCount = 4U;
+	double squaredErrorSum = 0.0;
+	for (uint32_t blockIndex = 0U; blockIndex < blockCount * blockCount; ++blockIndex)
+	{
+		const uint8_t* pBlock = reinterpret_cast<const uint8_t*>(blocks.data()) + blockIndex * blockSize;
+		uint8_t decodedPixels[16][4] = {};
+		switch (format)
+		{
+		case cd::TextureFormat::BC1:
+			DecodeColorBlock(pBlock, decodedPixels);
+			channelCount = 3U;
+			break;
+		case cd::TextureFormat::BC3:
+			DecodeChannelBlock(pBlock, decodedPixels, 3U);
+			DecodeColorBlock(pBlock + 8U, decodedPixels);
+			break;
+		case cd::TextureFormat::BC4:
+			DecodeChannelBlock(pBlock, decodedPixels, 0U);
+			channelCount = 1U;
+			break;
+		case cd::TextureFormat::BC5:
+			DecodeChannelBlock(pBlock, decodedPixels, 0U);
+			DecodeChannelBlock(pBlock + 8U, decodedPixels, 1U);
+			channelCount = 2U;
+			break;
+		default:
+			DecodeBC7Block(pBlock, decodedPixels);
+			break;
+		}
+
+		for (uint32_t pixelIndex = 0U; pixelIndex < 16U; ++pixelIndex)
+		{
+			const uint32_t x = (blockIndex % blockCount) * 4U + pixelIndex % 4U;
+			const uint32_t y = (blockIndex / blockCount) * 4U + pixelIndex / 4U;
+			for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+			{
+				const double difference = static_cast<double>(decodedPixels[pixelIndex][channelIndex]) -
+					static_cast<double>(pixels[(static_cast<std::size_t>(y) * textureSize + x) * 4U + channelIndex]);
+				squaredErrorSum += difference * difference;
+			}
+		}
+	}
+
+	const double meanSquaredError = squaredErrorSum / (static_cast<double>(textureSize) * textureSize * channelCount);
+	return meanSquaredError > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / meanSquaredError) : 99.0;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	// argv[0] : exe name
+	// argv[1] : optional texture size, default is 1024
+	uint32_t textureSize = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 1024U;
+	if (textureSize < 4U || textureSize % 4U != 0U)
+	{
+		return 1;
+	}
+
+	// Waves with noise, hard edged stripes in red and a cutout alpha like foliage textures.
+	std::mt19937 generator(12345U);
+	std::uniform_real_distribution<float> distribution(-20.0f, 20.0f);
+	std::vector<uint8_t> pixels(static_cast<std::size_t>(textureSize) * textureSize * 4U);
+	for (uint32_t y = 0U; y < textureSize; ++y)
+	{
+		for (uint32_t x = 0U; x < textureSize; ++x)
+		{
+			const float u = static_cast<float>(x) / static_cast<float>(textureSize);
+			const float v = static_cast<float>(y) / static_cast<float>(textureSize);
+			const float stripe = (x / 9U + y / 5U) % 4U == 0U ? -60.0f : 0.0f;
+			uint8_t* pPixel = pixels.data() + (static_cast<std::size_t>(y) * textureSize + x) * 4U;
+			pPixel[0] = static_cast<uint8_t>(std::clamp(127.0f + 100.0f * std::sin(u * 80.0f + std::sin(v * 53.0f) * 2.0f) + distribution(generator) + stripe, 0.0f, 255.0f));
+			pPixel[1] = static_cast<uint8_t>(std::clamp(100.0f + 80.0f * std::cos(v * 17.0f) + u * 60.0f + distribution(generator) * 0.5f, 0.0f, 255.0f));
+			pPixel[2] = static_cast<uint8_t>(255.0f * u * v);
+			pPixel[3] = (x / 37U + y / 23U) % 3U != 0U ? 255U : static_cast<uint8_t>(255.0f * u);
+		}
+	}
+
+	const std::size_t sourceSize = pixels.size();
+	printf("TextureSize = %u, RGBA8 size = %.2f MB\n", textureSize, sourceSize / 1048576.0);
+	for (cd::TextureFormat format : { cd::TextureFormat::BC1, cd::TextureFormat::BC3, cd::TextureFormat::BC4, cd::TextureFormat::BC5, cd::TextureFormat::BC7 })
+	{
+		for (cd::TextureCompressionQuality quality : { cd::TextureCompressionQuality::Fast, cd::TextureCompressionQuality::Normal, cd::TextureCompressionQuality::High })
+		{
+			std::vector<std::byte> blocks(cd::TextureMipGenerator::GetMipSize(format, textureSize, textureSize));
+			double compressTime = MeasureSeconds([&]()
+			{
+				cd::TextureCompressor::CompressLevel(reinterpret_cast<const std::byte*>(pixels.data()), cd::TextureFormat::RGBA8, textureSize, textureSize,
+					format, quality, blocks.data());
+			});
+
+			const char* pQualityName = cd::TextureCompressionQuality::Fast == quality ? "Fast" : (cd::TextureCompressionQuality::Normal == quality ? "Normal" : "High");
+			printf("BC%u %-6s : %.2f ms, %.1f MPixels/s, %.0fx smaller, PSNR = %.2f dB\n", static_cast<uint32_t>(format) + 1U, pQualityName,
+				compressTime * 1000.0, static_cast<double>(textureSize) * textureSize / compressTime / 1000000.0,
+				static_cast<double>(sourceSize) / static_cast<double>(blocks.size()), GetPSNR(pixels, blocks, format, textureSize));
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "Scene/TextureMipGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+template<typename Func>
+double MeasureSeconds(Func&& func)
+{
+	std::chrono::steady_clock::time_point startTimePoint = std::chrono::steady_clock::now();
+	func();
+	std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTimePoint;
+	return elapsedTime.count();
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	// argv[0] : exe name
+	// argv[1] : optional texture size, default is 2048
+	uint32_t textureSize = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 2048U;
+	if (textureSize < 2U)
+	{
+		return 1;
+	}
+
+	// Noisy RGBA8 image with linear alpha.
+	std::mt19937 generator(12345U);
+	std::uniform_int_distribution<uint32_t> distribution(0U, 255U);
+	std::vector<std::byte> sourcePixels(static_cast<std::size_t>(textureSize) * textureSize * 4U);
+	for (std::byte& value : sourcePixels)
+	{
+		value = static_cast<std::byte>(distribution(generator));
+	}
+
+	// Reference level 1 is a plain 2x2 average in 8 bits space.
+	const uint32_t halfSize = textureSize / 2U;
+	std::vector<uint8_t> referenceLevel(static_cast<std::size_t>(halfSize) * halfSize * 4U);
+	double referenceTime = MeasureSeconds([&]()
+	{
+		for (uint32_t y = 0U; y < halfSize; ++y)
+		{
+			for (uint32_t x = 0U; x < halfSize; ++x)
+			{
+				for (uint32_t channelIndex = 0U; channelIndex < 4U; ++channelIndex)
+				{
+					auto Sample = [&](uint32_t sourceX, uint32_t sourceY)
+					{
+						return static_cast<uint32_t>(sourcePixels[(static_cast<std::size_t>(sourceY) * textureSize + sourceX) * 4U + channelIndex]);
+					};
+					uint32_t sum = Sample(x * 2U, y * 2U) + Sample(x * 2U + 1U, y * 2U) + Sample(x * 2U, y * 2U + 1U) + Sample(x * 2U + 1U, y * 2U + 1U);
+					referenceLevel[(static_cast<std::size_t>(y) * halfSize + x) * 4U + channelIndex] = static_cast<uint8_t>((sum + 2U) / 4U);
+				}
+			}
+		}
+	});
+
+	printf("TextureSize = %u, MipCount = %u, ChainSize = %.2f MB\n", textureSize, cd::TextureMipGenerator::GetMipCount(textureSize, textureSize),
+		cd::TextureMipGenerator::GetMipChainSize(cd::TextureFormat::RGBA8, textureSize, textureSize,
+			cd::TextureMipGenerator::GetMipCount(textureSize, textureSize)) / 1048576.0);
+	printf("Scalar level 1 box : %.2f ms\n", referenceTime * 1000.0);
+
+	for (cd::TextureMipFilter filter : { cd::TextureMipFilter::Box, cd::TextureMipFilter::Kaiser })
+	{
+		for (bool isSRGB : { false, true })
+		{
+			std::vector<std::byte> pixels = sourcePixels;
+			double generateTime = MeasureSeconds([&]()
+			{
+				cd::TextureMipGenerator::GenerateMipChain(pixels, cd::TextureFormat::RGBA8, textureSize, textureSize, isSRGB, filter);
+			});
+
+			// Linear box level 1 should match the reference up to rounding.
+			uint32_t maxError = 0U;
+			if (cd::TextureMipFilter::Box == filter && !isSRGB)
+			{
+				for (std::size_t valueIndex = 0U; valueIndex < referenceLevel.size(); ++valueIndex)
+				{
+					const int32_t difference = static_cast<int32_t>(pixels[sourcePixels.size() + valueIndex]) - static_cast<int32_t>(referenceLevel[valueIndex]);
+					maxError = std::max(maxError, static_cast<uint32_t>(std::abs(difference)));
+				}
+			}
+
+			printf("%s %s : full chain %.2f ms, level 1 max error = %u\n", cd::TextureMipFilter::Box == filter ? "Box" : "Kaiser",
+				isSRGB ? "sRGB" : "linear", generateTime * 1000.0, maxError);
+		}
+	}
+
+	return 0;
+}
\ No newline at end of file
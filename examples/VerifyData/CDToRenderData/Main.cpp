@@ -29,6 +29,12 @@ int main(int argc, char** argv)
 		auto vb = cd::BuildVertexBufferForStaticMesh(mesh, mesh.GetVertexFormat());
 		assert(vb.has_value());
 
+		auto compactVB = cd::BuildVertexBufferForStaticMesh(mesh, cd::GetCompactVertexFormat(mesh.GetVertexFormat()));
+		assert(compactVB.has_value() && compactVB->size() <= vb->size());
+
+		auto vertexStreams = cd::BuildVertexStreamsForStaticMesh(mesh, cd::GetPositionSplitVertexFormat(mesh.GetVertexFormat()));
+		assert(vertexStreams.has_value());
+
 		auto ibs = cd::BuildIndexBufferesForMesh(mesh);
 		for (const auto& ib : ibs)
 		{
@@ -0,0 +1,172 @@
+#include "BVH/BVH.h"
+#include "BVHImpl.h"
+
+#include "Scene/SceneDatabase.h"
+
+#include <cassert>
+
+namespace cd
+{
+
+BVH BVH::FromMesh(const cd::Mesh& mesh, uint32_t maxLeafPrimitiveCount)
+{
+	std::vector<uint32_t> indices;
+	indices.reserve(mesh.GetPolygonCount() * 3U);
+	for (const auto& polygonGroup : mesh.GetPolygonGroups())
+	{
+		for (const auto& polygon : polygonGroup)
+		{
+			for (std::size_t cornerIndex = 2U; cornerIndex < polygon.size(); ++cornerIndex)
+			{
+				indices.push_back(polygon[0].Data());
+				indices.push_back(polygon[cornerIndex - 1U].Data());
+				indices.push_back(polygon[cornerIndex].Data());
+			}
+		}
+	}
+
+	return FromTriangles(mesh.GetVertexPositions(), indices, maxLeafPrimitiveCount);
+}
+
+BVH BVH::FromTriangles(std::span<const cd::Vec3f> vertices, std::span<const uint32_t> indices, uint32_t maxLeafPrimitiveCount)
+{
+	BVH bvh;
+	bvh.m_pBVHImpl->BuildFromTriangles(vertices, indices, maxLeafPrimitiveCount);
+	return bvh;
+}
+
+BVH BVH::FromAABBs(std::span<const cd::AABB> aabbs, uint32_t maxLeafPrimitiveCount)
+{
+	BVH bvh;
+	bvh.m_pBVHImpl->BuildFromAABBs(aabbs, maxLeafPrimitiveCount);
+	return bvh;
+}
+
+BVH BVH::FromSceneDatabase(const cd::SceneDatabase& sceneDatabase, uint32_t maxLeafPrimitiveCount)
+{
+	// Meshes which are not referenced by any node are already in world space.
+	uint32_t meshCount = sceneDatabase.GetMeshCount();
+	std::vector<cd::AABB> meshAABBs(meshCount);
+	std::vector<bool> isMeshInstanced(meshCount, false);
+	for (uint32_t meshIndex = 0U; meshIndex < meshCount; ++meshIndex)
+	{
+		meshAABBs[meshIndex] = sceneDatabase.GetMesh(meshIndex).GetAABB();
+	}
+
+	// A mesh referenced by multiple nodes uses the merged AABB of all instances.
+	std::vector<cd::Matrix4x4> worldTransforms = sceneDatabase.CalculateNodeWorldTransforms();
+	for (uint32_t nodeIndex = 0U; nodeIndex < sceneDatabase.GetNodeCount(); ++nodeIndex)
+	{
+		for (cd::MeshID meshID : sceneDatabase.GetNode(nodeIndex).GetMeshIDs())
+		{
+			assert(meshID.Data() < meshCount);
+			cd::AABB meshAABB = sceneDatabase.GetMesh(meshID.Data()).GetAABB();
+			cd::AABB worldAABB = meshAABB.Transform(worldTransforms[nodeIndex]);
+			if (isMeshInstanced[meshID.Data()])
+			{
+				meshAABBs[meshID.Data()].Merge(worldAABB);
+			}
+			else
+			{
+				meshAABBs[meshID.Data()] = worldAABB;
+				isMeshInstanced[meshID.Data()] = true;
+			}
+		}
+	}
+
+	return FromAABBs(meshAABBs, maxLeafPrimitiveCount);
+}
+
+BVH::BVH()
+{
+	m_pBVHImpl = new BVHImpl();
+}
+
+BVH::BVH(BVH&& rhs)
+{
+	*this = cd::MoveTemp(rhs);
+}
+
+BVH& BVH::operator=(BVH&& rhs)
+{
+	std::swap(m_pBVHImpl, rhs.m_pBVHImpl);
+	return *this;
+}
+
+BVH::~BVH()
+{
+	if (m_pBVHImpl)
+	{
+		delete m_pBVHImpl;
+		m_pBVHImpl = nullptr;
+	}
+}
+
+BVHPrimitiveType BVH::GetPrimitiveType() const
+{
+	return m_pBVHImpl->GetPrimitiveType();
+}
+
+uint32_t BVH::GetPrimitiveCount() const
+{
+	return m_pBVHImpl->GetPrimitiveCount();
+}
+
+const std::vector<BVHNode>& BVH::GetNodes() const
+{
+	return m_pBVHImpl->GetNodes();
+}
+
+const std::vector<uint32_t>& BVH::GetPrimitiveIndices() const
+{
+	return m_pBVHImpl->GetPrimitiveIndices();
+}
+
+cd::AABB BVH::GetAABB() const
+{
+	return m_pBVHImpl->GetAABB();
+}
+
+bool BVH::Intersect(const cd::Ray& ray, float maxDistance, BVHRayHit& hit) const
+{
+	return m_pBVHImpl->Intersect(ray, maxDistance, hit);
+}
+
+bool BVH::IntersectAny(const cd::Ray& ray, float maxDistance) const
+{
+	return m_pBVHImpl->IntersectAny(ray, maxDistance);
+}
+
+void BVH::QueryAABB(const cd::AABB& aabb, std::vector<uint32_t>& outPrimitiveIndices) const
+{
+	m_pBVHImpl->QueryAABB(aabb, outPrimitiveIndices);
+}
+
+///////////////////////////////////////////////////////////////////
+// Operators
+///////////////////////////////////////////////////////////////////
+BVH& BVH::operator<<(InputArchive& inputArchive)
+{
+	*m_pBVHImpl << inputArchive;
+	return *this;
+}
+
+BVH& BVH::operator<<(InputArchiveSwapBytes& inputArchive)
+{
+	*m_pBVHImpl << inputArchive;
+	return *this;
+}
+
+const BVH& BVH::operator>>(OutputArchive& outputArchive) const
+{
+	*m_pBVHImpl >> outputArchive;
+	return *this;
+}
+
+const BVH& BVH::operator>>(OutputArchiveSwapBytes& outputArchive) const
+{
+	*m_pBVHImpl >> outputArchive;
+	return *this;
+}
+
+}
\ No newline at end of file
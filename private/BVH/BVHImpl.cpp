@@ -0,0 +1,590 @@
+#include "BVHImpl.h"
+
+#include "Container/DynamicArray.hpp"
+#include "Utilities/ParallelFor.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+
+namespace
+{
+
+constexpr uint32_t BinCount = 16U;
+
+// Cost of visiting an inner node relative to testing one primitive.
+constexpr float TraversalCost = 1.0f;
+
+// Subtrees with fewer primitives are built as independent tasks in parallel. It is a fixed number
+// instead of derived from thread count so that the same input always generates the same tree.
+constexpr uint32_t ParallelSubtreePrimitiveCount = 4096U;
+
+// Primitives are partitioned in place so that build loops read memory sequentially.
+struct BuildPrimitive
+{
+	cd::AABB aabb;
+	cd::Vec3f centroid;
+	uint32_t index;
+};
+
+struct BuildTask
+{
+	uint32_t nodeIndex;
+	uint32_t begin;
+	uint32_t end;
+};
+
+struct TraversalEntry
+{
+	uint32_t nodeIndex;
+	float distance;
+};
+
+cd::AABB MakeInvalidAABB()
+{
+	return cd::AABB(cd::Vec3f(FLT_MAX), cd::Vec3f(-FLT_MAX));
+}
+
+CD_FORCEINLINE void ExpandAABB(cd::AABB& aabb, const cd::Vec3f& point)
+{
+	for (uint32_t axis = 0U; axis < 3U; ++axis)
+	{
+		aabb.Min()[axis] = std::min(aabb.Min()[axis], point[axis]);
+		aabb.Max()[axis] = std::max(aabb.Max()[axis], point[axis]);
+	}
+}
+
+CD_FORCEINLINE void ExpandAABB(cd::AABB& aabb, const cd::AABB& other)
+{
+	for (uint32_t axis = 0U; axis < 3U; ++axis)
+	{
+		aabb.Min()[axis] = std::min(aabb.Min()[axis], other.Min()[axis]);
+		aabb.Max()[axis] = std::max(aabb.Max()[axis], other.Max()[axis]);
+	}
+}
+
+// Half surface area is enough to compare SAH costs.
+CD_FORCEINLINE float GetHalfArea(const cd::AABB& aabb)
+{
+	cd::Vec3f size = aabb.Max() - aabb.Min();
+	return std::max(0.0f, size.x() * size.y() + size.y() * size.z() + size.z() * size.x());
+}
+
+CD_FORCEINLINE bool Overlaps(const cd::AABB& a, const cd::AABB& b)
+{
+	for (uint32_t axis = 0U; axis < 3U; ++axis)
+	{
+		if (a.Max()[axis] < b.Min()[axis] || a.Min()[axis] > b.Max()[axis])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Slab test. Returns entry distance clamped to 0 when ray starts inside.
+CD_FORCEINLINE bool IntersectAABB(const cd::AABB& aabb, const cd::Vec3f& origin, const cd::Vec3f& inverseDirection, float maxDistance, float& distance)
+{
+	float tMin = 0.0f;
+	float tMax = maxDistance;
+	for (uint32_t axis = 0U; axis < 3U; ++axis)
+	{
+		float t0 = (aabb.Min()[axis] - origin[axis]) * inverseDirection[axis];
+		float t1 = (aabb.Max()[axis] - origin[axis]) * inverseDirection[axis];
+		if (inverseDirection[axis] < 0.0f)
+		{
+			std::swap(t0, t1);
+		}
+		tMin = t0 > tMin ? t0 : tMin;
+		tMax = t1 < tMax ? t1 : tMax;
+	}
+
+	distance = tMin;
+	return tMin <= tMax;
+}
+
+// Moller-Trumbore ray triangle intersection without back face culling.
+CD_FORCEINLINE bool IntersectTriangle(const cd::Ray& ray, const cd::Vec3f& v0, const cd::Vec3f& v1, const cd::Vec3f& v2, float maxDistance, float& distance, float& u, float& v)
+{
+	cd::Vec3f edge1 = v1 - v0;
+	cd::Vec3f edge2 = v2 - v0;
+	cd::Vec3f p = ray.Direction().Cross(edge2);
+	float determinant = edge1.Dot(p);
+	if (std::abs(determinant) < FLT_MIN)
+	{
+		return false;
+	}
+
+	float inverseDeterminant = 1.0f / determinant;
+	cd::Vec3f s = ray.Origin() - v0;
+	u = s.Dot(p) * inverseDeterminant;
+	if (u < 0.0f || u > 1.0f)
+	{
+		return false;
+	}
+
+	cd::Vec3f q = s.Cross(edge1);
+	v = ray.Direction().Dot(q) * inverseDeterminant;
+	if (v < 0.0f || u + v > 1.0f)
+	{
+		return false;
+	}
+
+	distance = edge2.Dot(q) * inverseDeterminant;
+	return distance >= 0.0f && distance <= maxDistance;
+}
+
+class BVHBuilder
+{
+public:
+	explicit BVHBuilder(std::vector<BuildPrimitive>& primitives, uint32_t maxLeafPrimitiveCount)
+		: m_primitives(primitives)
+		, m_maxLeafPrimitiveCount(std::max(1U, maxLeafPrimitiveCount))
+	{
+	}
+
+	// Builds the subtree of rootTask whose node already exists. If pDeferredTasks is not null, small subtrees
+	// are collected to it instead of being built.
+	void Build(std::vector<cd::BVHNode>& nodes, BuildTask rootTask, std::vector<BuildTask>* pDeferredTasks) const
+	{
+		std::vector<BuildTask> tasks{ rootTask };
+		while (!tasks.empty())
+		{
+			BuildTask task = tasks.back();
+			tasks.pop_back();
+
+			uint32_t primitiveCount = task.end - task.begin;
+			if (pDeferredTasks && primitiveCount <= ParallelSubtreePrimitiveCount)
+			{
+				pDeferredTasks->push_back(task);
+				continue;
+			}
+
+			cd::AABB nodeAABB = MakeInvalidAABB();
+			cd::AABB centroidAABB = MakeInvalidAABB();
+			for (uint32_t index = task.begin; index < task.end; ++index)
+			{
+				const BuildPrimitive& primitive = m_primitives[index];
+				ExpandAABB(nodeAABB, primitive.aabb);
+				ExpandAABB(centroidAABB, primitive.centroid);
+			}
+			nodes[task.nodeIndex].aabb = nodeAABB;
+
+			uint32_t middle = Split(task, nodeAABB, centroidAABB);
+			if (middle == task.begin)
+			{
+				nodes[task.nodeIndex].childIndex = task.begin;
+				nodes[task.nodeIndex].primitiveCount = primitiveCount;
+				continue;
+			}
+
+			uint32_t leftNodeIndex = static_cast<uint32_t>(nodes.size());
+			nodes.resize(nodes.size() + 2U);
+			nodes[task.nodeIndex].childIndex = leftNodeIndex;
+			nodes[task.nodeIndex].primitiveCount = 0U;
+
+			// Left subtree is built first so nodes are stored in depth first order.
+			tasks.push_back(BuildTask{ leftNodeIndex + 1U, middle, task.end });
+			tasks.push_back(BuildTask{ leftNodeIndex, task.begin, middle });
+		}
+	}
+
+private:
+	// Partitions primitives by the best binned SAH split. Returns task.begin to make a leaf.
+	uint32_t Split(const BuildTask& task, const cd::AABB& nodeAABB, const cd::AABB& centroidAABB) const
+	{
+		uint32_t primitiveCount = task.end - task.begin;
+		if (1U == primitiveCount)
+		{
+			return task.begin;
+		}
+
+		// Bin primitives on all axes in one pass. Small nodes use fewer bins as sweeping bins costs more than binning then.
+		uint32_t binCount = std::min(BinCount, primitiveCount);
+		uint32_t binCounts[3][BinCount] = {};
+		cd::AABB binAABBs[3][BinCount];
+		cd::Vec3f binScales;
+		for (uint32_t axis = 0U; axis < 3U; ++axis)
+		{
+			std::fill(binAABBs[axis], binAABBs[axis] + binCount, MakeInvalidAABB());
+			float extent = centroidAABB.Max()[axis] - centroidAABB.Min()[axis];
+			binScales[axis] = extent > 0.0f ? binCount / extent : 0.0f;
+		}
+
+		for (uint32_t index = task.begin; index < task.end; ++index)
+		{
+			const BuildPrimitive& primitive = m_primitives[index];
+			for (uint32_t axis = 0U; axis < 3U; ++axis)
+			{
+				uint32_t binIndex = GetBinIndex(primitive.centroid[axis], centroidAABB.Min()[axis], binScales[axis], binCount);
+				++binCounts[axis][binIndex];
+				ExpandAABB(binAABBs[axis][binIndex], primitive.aabb);
+			}
+		}
+
+		float bestCost = FLT_MAX;
+		uint32_t bestAxis = UINT32_MAX;
+		uint32_t bestBin = 0U;
+		for (uint32_t axis = 0U; axis < 3U; ++axis)
+		{
+			if (0.0f == binScales[axis])
+			{
+				continue;
+			}
+
+			// Sweep from right to left to get right side costs of every split plane, then from left to right.
+			float rightCosts[BinCount];
+			cd::AABB rightAABB = MakeInvalidAABB();
+			uint32_t rightCount = 0U;
+			for (uint32_t binIndex = binCount - 1U; binIndex > 0U; --binIndex)
+			{
+				ExpandAABB(rightAABB, binAABBs[axis][binIndex]);
+				rightCount += binCounts[axis][binIndex];
+				rightCosts[binIndex] = rightCount > 0U ? rightCount * GetHalfArea(rightAABB) : FLT_MAX;
+			}
+
+			cd::AABB leftAABB = MakeInvalidAABB();
+			uint32_t leftCount = 0U;
+			for (uint32_t binIndex = 1U; binIndex < binCount; ++binIndex)
+			{
+				ExpandAABB(leftAABB, binAABBs[axis][binIndex - 1U]);
+				leftCount += binCounts[axis][binIndex - 1U];
+				if (0U == leftCount || FLT_MAX == rightCosts[binIndex])
+				{
+					continue;
+				}
+
+				float cost = leftCount * GetHalfArea(leftAABB) + rightCosts[binIndex];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestBin = binIndex;
+				}
+			}
+		}
+
+		if (UINT32_MAX == bestAxis)
+		{
+			// All centroids are the same. Split in the middle if it is too many for one leaf.
+			return primitiveCount <= m_maxLeafPrimitiveCount ? task.begin : task.begin + primitiveCount / 2U;
+		}
+
+		// Costs are not divided by node area as it is the same for both. It also works for flat nodes.
+		float nodeArea = GetHalfArea(nodeAABB);
+		float leafCost = primitiveCount * nodeArea;
+		float splitCost = TraversalCost * nodeArea + bestCost;
+		if (primitiveCount <= m_maxLeafPrimitiveCount && leafCost <= splitCost)
+		{
+			return task.begin;
+		}
+
+		float axisMin = centroidAABB.Min()[bestAxis];
+		float binScale = binScales[bestAxis];
+		auto itMiddle = std::partition(m_primitives.begin() + task.begin, m_primitives.begin() + task.end, [&](const BuildPrimitive& primitive)
+		{
+			return GetBinIndex(primitive.centroid[bestAxis], axisMin, binScale, binCount) < bestBin;
+		});
+		return static_cast<uint32_t>(itMiddle - m_primitives.begin());
+	}
+
+	static CD_FORCEINLINE uint32_t GetBinIndex(float value, float axisMin, float binScale, uint32_t binCount)
+	{
+		return std::min(binCount - 1U, static_cast<uint32_t>((value - axisMin) * binScale));
+	}
+
+private:
+	std::vector<BuildPrimitive>& m_primitives;
+	uint32_t m_maxLeafPrimitiveCount;
+};
+
+// Top levels are built on this thread until subtrees are small enough. Subtrees work on disjoint
+// ranges of primitives so they are built in parallel into their own node arrays.
+void BuildInParallel(std::vector<cd::BVHNode>& outNodes, const BVHBuilder& builder, uint32_t primitiveCount)
+{
+	std::vector<BuildTask> subtreeTasks;
+	builder.Build(outNodes, BuildTask{ 0U, 0U, primitiveCount }, &subtreeTasks);
+
+	std::vector<std::vector<cd::BVHNode>> subtreeNodes(subtreeTasks.size());
+	cd::ParallelFor(static_cast<uint32_t>(subtreeTasks.size()), [&](uint32_t taskIndex)
+	{
+		const BuildTask& task = subtreeTasks[taskIndex];
+		std::vector<cd::BVHNode>& nodes = subtreeNodes[taskIndex];
+		nodes.reserve((task.end - task.begin) * 2U);
+		nodes.emplace_back();
+		builder.Build(nodes, BuildTask{ 0U, task.begin, task.end }, nullptr);
+	});
+
+	// Subtree root replaces its placeholder node. Other nodes are appended so child indices shift by the base.
+	for (uint32_t taskIndex = 0U; taskIndex < subtreeTasks.size(); ++taskIndex)
+	{
+		const std::vector<cd::BVHNode>& nodes = subtreeNodes[taskIndex];
+		uint32_t baseIndex = static_cast<uint32_t>(outNodes.size()) - 1U;
+		auto RelocateNode = [baseIndex](cd::BVHNode node)
+		{
+			if (!node.IsLeaf())
+			{
+				node.childIndex += baseIndex;
+			}
+			return node;
+		};
+
+		outNodes[subtreeTasks[taskIndex].nodeIndex] = RelocateNode(nodes.front());
+		for (std::size_t nodeIndex = 1U; nodeIndex < nodes.size(); ++nodeIndex)
+		{
+			outNodes.push_back(RelocateNode(nodes[nodeIndex]));
+		}
+	}
+}
+
+}
+
+namespace cd
+{
+
+void BVHImpl::BuildFromTriangles(std::span<const cd::Vec3f> vertices, std::span<const uint32_t> indices, uint32_t maxLeafPrimitiveCount)
+{
+	assert(0U == indices.size() % 3U);
+	uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3U);
+
+	std::vector<cd::AABB> triangleAABBs(triangleCount);
+	for (uint32_t triangleIndex = 0U; triangleIndex < triangleCount; ++triangleIndex)
+	{
+		cd::AABB aabb = MakeInvalidAABB();
+		for (uint32_t cornerIndex = 0U; cornerIndex < 3U; ++cornerIndex)
+		{
+			ExpandAABB(aabb, vertices[indices[triangleIndex * 3U + cornerIndex]]);
+		}
+		triangleAABBs[triangleIndex] = aabb;
+	}
+
+	m_primitiveType = BVHPrimitiveType::Triangle;
+	Build(triangleAABBs, maxLeafPrimitiveCount);
+
+	m_primitiveAABBs.clear();
+	m_triangleVertices.resize(triangleCount * 3U);
+	for (uint32_t sortedIndex = 0U; sortedIndex < triangleCount; ++sortedIndex)
+	{
+		uint32_t triangleIndex = m_primitiveIndices[sortedIndex];
+		for (uint32_t cornerIndex = 0U; cornerIndex < 3U; ++cornerIndex)
+		{
+			m_triangleVertices[sortedIndex * 3U + cornerIndex] = vertices[indices[triangleIndex * 3U + cornerIndex]];
+		}
+	}
+}
+
+void BVHImpl::BuildFromAABBs(std::span<const cd::AABB> aabbs, uint32_t maxLeafPrimitiveCount)
+{
+	std::vector<cd::AABB> primitiveAABBs(aabbs.begin(), aabbs.end());
+	m_primitiveType = BVHPrimitiveType::AABB;
+	Build(primitiveAABBs, maxLeafPrimitiveCount);
+
+	m_triangleVertices.clear();
+	m_primitiveAABBs.resize(primitiveAABBs.size());
+	for (uint32_t sortedIndex = 0U; sortedIndex < m_primitiveIndices.size(); ++sortedIndex)
+	{
+		m_primitiveAABBs[sortedIndex] = primitiveAABBs[m_primitiveIndices[sortedIndex]];
+	}
+}
+
+void BVHImpl::Build(const std::vector<cd::AABB>& primitiveAABBs, uint32_t maxLeafPrimitiveCount)
+{
+	uint32_t primitiveCount = static_cast<uint32_t>(primitiveAABBs.size());
+	m_nodes.clear();
+	m_primitiveIndices.clear();
+	if (0U == primitiveCount)
+	{
+		return;
+	}
+
+	std::vector<BuildPrimitive> primitives(primitiveCount);
+	for (uint32_t primitiveIndex = 0U; primitiveIndex < primitiveCount; ++primitiveIndex)
+	{
+		primitives[primitiveIndex] = BuildPrimitive{ primitiveAABBs[primitiveIndex], primitiveAABBs[primitiveIndex].Center(), primitiveIndex };
+	}
+
+	BVHBuilder builder(primitives, maxLeafPrimitiveCount);
+	m_nodes.reserve(primitiveCount * 2U);
+	m_nodes.emplace_back();
+	if (primitiveCount <= ParallelSubtreePrimitiveCount)
+	{
+		builder.Build(m_nodes, BuildTask{ 0U, 0U, primitiveCount }, nullptr);
+	}
+	else
+	{
+		BuildInParallel(m_nodes, builder, primitiveCount);
+	}
+
+	m_primitiveIndices.resize(primitiveCount);
+	for (uint32_t sortedIndex = 0U; sortedIndex < primitiveCount; ++sortedIndex)
+	{
+		m_primitiveIndices[sortedIndex] = primitives[sortedIndex].index;
+	}
+}
+
+bool BVHImpl::IntersectPrimitive(uint32_t sortedIndex, const cd::Ray& ray, const cd::Vec3f& inverseDirection, float maxDistance, BVHRayHit& hit) const
+{
+	float distance;
+	float u = 0.0f;
+	float v = 0.0f;
+	if (BVHPrimitiveType::Triangle == m_primitiveType)
+	{
+		const cd::Vec3f* pTriangle = &m_triangleVertices[sortedIndex * 3U];
+		if (!IntersectTriangle(ray, pTriangle[0], pTriangle[1], pTriangle[2], maxDistance, distance, u, v))
+		{
+			return false;
+		}
+	}
+	else if (!IntersectAABB(m_primitiveAABBs[sortedIndex], ray.Origin(), inverseDirection, maxDistance, distance))
+	{
+		return false;
+	}
+
+	hit.primitiveIndex = m_primitiveIndices[sortedIndex];
+	hit.distance = distance;
+	hit.u = u;
+	hit.v = v;
+	return true;
+}
+
+template<bool AnyHit>
+bool BVHImpl::Traverse(const cd::Ray& ray, float maxDistance, BVHRayHit& hit) const
+{
+	if (m_nodes.empty())
+	{
+		return false;
+	}
+
+	const cd::Vec3f& origin = ray.Origin();
+	cd::Vec3f inverseDirection(1.0f / ray.Direction().x(), 1.0f / ray.Direction().y(), 1.0f / ray.Direction().z());
+
+	float closestDistance = maxDistance;
+	bool isHit = false;
+
+	float rootDistance;
+	if (!IntersectAABB(m_nodes.front().aabb, origin, inverseDirection, closestDistance, rootDistance))
+	{
+		return false;
+	}
+
+	cd::DynamicArray<TraversalEntry, 64> stack;
+	stack.Add(TraversalEntry{ 0U, rootDistance });
+	while (!stack.Empty())
+	{
+		TraversalEntry entry = stack[stack.Size() - 1U];
+		stack.RemoveByIndex(stack.Size() - 1U);
+		if (entry.distance > closestDistance)
+		{
+			continue;
+		}
+
+		const BVHNode& node = m_nodes[entry.nodeIndex];
+		if (node.IsLeaf())
+		{
+			for (uint32_t sortedIndex = node.childIndex; sortedIndex < node.childIndex + node.primitiveCount; ++sortedIndex)
+			{
+				if (IntersectPrimitive(sortedIndex, ray, inverseDirection, closestDistance, hit))
+				{
+					if constexpr (AnyHit)
+					{
+						return true;
+					}
+					closestDistance = hit.distance;
+					isHit = true;
+				}
+			}
+			continue;
+		}
+
+		// Push the far child first so the near one is visited first and shrinks closestDistance earlier.
+		float leftDistance;
+		float rightDistance;
+		bool isLeftHit = IntersectAABB(m_nodes[node.childIndex].aabb, origin, inverseDirection, closestDistance, leftDistance);
+		bool isRightHit = IntersectAABB(m_nodes[node.childIndex + 1U].aabb, origin, inverseDirection, closestDistance, rightDistance);
+		if (isLeftHit && isRightHit)
+		{
+			bool isLeftNear = leftDistance <= rightDistance;
+			stack.Add(isLeftNear ? TraversalEntry{ node.childIndex + 1U, rightDistance } : TraversalEntry{ node.childIndex, leftDistance });
+			stack.Add(isLeftNear ? TraversalEntry{ node.childIndex, leftDistance } : TraversalEntry{ node.childIndex + 1U, rightDistance });
+		}
+		else if (isLeftHit)
+		{
+			stack.Add(TraversalEntry{ node.childIndex, leftDistance });
+		}
+		else if (isRightHit)
+		{
+			stack.Add(TraversalEntry{ node.childIndex + 1U, rightDistance });
+		}
+	}
+
+	return isHit;
+}
+
+bool BVHImpl::Intersect(const cd::Ray& ray, float maxDistance, BVHRayHit& hit) const
+{
+	BVHRayHit closestHit;
+	if (!Traverse<false>(ray, maxDistance, closestHit))
+	{
+		return false;
+	}
+
+	hit = closestHit;
+	return true;
+}
+
+bool BVHImpl::IntersectAny(const cd::Ray& ray, float maxDistance) const
+{
+	BVHRayHit anyHit;
+	return Traverse<true>(ray, maxDistance, anyHit);
+}
+
+void BVHImpl::QueryAABB(const cd::AABB& aabb, std::vector<uint32_t>& outPrimitiveIndices) const
+{
+	if (m_nodes.empty() || !Overlaps(m_nodes.front().aabb, aabb))
+	{
+		return;
+	}
+
+	cd::DynamicArray<uint32_t, 64> stack;
+	stack.Add(0U);
+	while (!stack.Empty())
+	{
+		const BVHNode& node = m_nodes[stack[stack.Size() - 1U]];
+		stack.RemoveByIndex(stack.Size() - 1U);
+		if (!node.IsLeaf())
+		{
+			for (uint32_t childIndex = node.childIndex; childIndex < node.childIndex + 2U; ++childIndex)
+			{
+				if (Overlaps(m_nodes[childIndex].aabb, aabb))
+				{
+					stack.Add(childIndex);
+				}
+			}
+			continue;
+		}
+
+		for (uint32_t sortedIndex = node.childIndex; sortedIndex < node.childIndex + node.primitiveCount; ++sortedIndex)
+		{
+			cd::AABB primitiveAABB;
+			if (BVHPrimitiveType::Triangle == m_primitiveType)
+			{
+				primitiveAABB = MakeInvalidAABB();
+				for (uint32_t cornerIndex = 0U; cornerIndex < 3U; ++cornerIndex)
+				{
+					ExpandAABB(primitiveAABB, m_triangleVertices[sortedIndex * 3U + cornerIndex]);
+				}
+			}
+			else
+			{
+				primitiveAABB = m_primitiveAABBs[sortedIndex];
+			}
+
+			if (Overlaps(primitiveAABB, aabb))
+			{
+				outPrimitiveIndices.push_back(m_primitiveIndices[sortedIndex]);
+			}
+		}
+	}
+}
+
+}
\ No newline at end of file
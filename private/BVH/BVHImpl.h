@@ -0,0 +1,101 @@
+#pragma once
+
+#include "BVH/BVH.h"
+
+#include <span>
+#include <vector>
+
+namespace cd
+{
+
+class BVHImpl final
+{
+public:
+	BVHImpl() = default;
+	BVHImpl(const BVHImpl&) = default;
+	BVHImpl& operator=(const BVHImpl&) = default;
+	BVHImpl(BVHImpl&&) = default;
+	BVHImpl& operator=(BVHImpl&&) = default;
+	~BVHImpl() = default;
+
+	void BuildFromTriangles(std::span<const cd::Vec3f> vertices, std::span<const uint32_t> indices, uint32_t maxLeafPrimitiveCount);
+	void BuildFromAABBs(std::span<const cd::AABB> aabbs, uint32_t maxLeafPrimitiveCount);
+
+	BVHPrimitiveType GetPrimitiveType() const { return m_primitiveType; }
+	uint32_t GetPrimitiveCount() const { return static_cast<uint32_t>(m_primitiveIndices.size()); }
+	const std::vector<BVHNode>& GetNodes() const { return m_nodes; }
+	const std::vector<uint32_t>& GetPrimitiveIndices() const { return m_primitiveIndices; }
+	cd::AABB GetAABB() const { return m_nodes.empty() ? cd::AABB::Empty() : m_nodes.front().aabb; }
+
+	bool Intersect(const cd::Ray& ray, float maxDistance, BVHRayHit& hit) const;
+	bool IntersectAny(const cd::Ray& ray, float maxDistance) const;
+	void QueryAABB(const cd::AABB& aabb, std::vector<uint32_t>& outPrimitiveIndices) const;
+
+	template<bool SwapBytesOrder>
+	BVHImpl& operator<<(TInputArchive<SwapBytesOrder>& inputArchive)
+	{
+		uint8_t primitiveType;
+		uint32_t nodeCount;
+		uint32_t primitiveCount;
+		inputArchive >> primitiveType >> nodeCount >> primitiveCount;
+
+		m_primitiveType = static_cast<BVHPrimitiveType>(primitiveType);
+		m_nodes.resize(nodeCount);
+		inputArchive.ImportBuffer(m_nodes.data());
+		m_primitiveIndices.resize(primitiveCount);
+		inputArchive.ImportBuffer(m_primitiveIndices.data());
+
+		m_triangleVertices.clear();
+		m_primitiveAABBs.clear();
+		if (BVHPrimitiveType::Triangle == m_primitiveType)
+		{
+			m_triangleVertices.resize(primitiveCount * 3U);
+			inputArchive.ImportBuffer(m_triangleVertices.data());
+		}
+		else
+		{
+			m_primitiveAABBs.resize(primitiveCount);
+			inputArchive.ImportBuffer(m_primitiveAABBs.data());
+		}
+
+		return *this;
+	}
+
+	template<bool SwapBytesOrder>
+	const BVHImpl& operator>>(TOutputArchive<SwapBytesOrder>& outputArchive) const
+	{
+		outputArchive << static_cast<uint8_t>(m_primitiveType) << static_cast<uint32_t>(m_nodes.size()) << GetPrimitiveCount();
+		outputArchive.ExportBuffer(m_nodes.data(), m_nodes.size());
+		outputArchive.ExportBuffer(m_primitiveIndices.data(), m_primitiveIndices.size());
+		if (BVHPrimitiveType::Triangle == m_primitiveType)
+		{
+			outputArchive.ExportBuffer(m_triangleVertices.data(), m_triangleVertices.size());
+		}
+		else
+		{
+			outputArchive.ExportBuffer(m_primitiveAABBs.data(), m_primitiveAABBs.size());
+		}
+
+		return *this;
+	}
+
+private:
+	void Build(const std::vector<cd::AABB>& primitiveAABBs, uint32_t maxLeafPrimitiveCount);
+
+	// Returns distance to the primitive if ray hits it closer than maxDistance.
+	bool IntersectPrimitive(uint32_t sortedIndex, const cd::Ray& ray, const cd::Vec3f& inverseDirection, float maxDistance, BVHRayHit& hit) const;
+
+	template<bool AnyHit>
+	bool Traverse(const cd::Ray& ray, float maxDistance, BVHRayHit& hit) const;
+
+private:
+	BVHPrimitiveType m_primitiveType = BVHPrimitiveType::Triangle;
+	std::vector<BVHNode> m_nodes;
+
+	// Primitive data is sorted in leaf order. m_primitiveIndices maps it back to source primitives.
+	std::vector<uint32_t> m_primitiveIndices;
+	std::vector<cd::Vec3f> m_triangleVertices;
+	std::vector<cd::AABB> m_primitiveAABBs;
+};
+
+}
\ No newline at end of file
@@ -38,6 +38,16 @@ void CDConsumer::SetTargetEndian(cd::EndianType endian)
 	m_pCDConsumerImpl->SetTargetEndian(endian);
 }
 
+uint32_t CDConsumer::GetInvalidVertexBoneIndex() const
+{
+	return m_pCDConsumerImpl->GetInvalidVertexBoneIndex();
+}
+
+void CDConsumer::SetInvalidVertexBoneIndex(uint32_t boneIndex)
+{
+	m_pCDConsumerImpl->SetInvalidVertexBoneIndex(boneIndex);
+}
+
 void CDConsumer::Execute(const cd::SceneDatabase* pSceneDatabase)
 {
 	m_pCDConsumerImpl->Execute(pSceneDatabase);
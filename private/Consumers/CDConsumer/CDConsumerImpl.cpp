@@ -6,6 +6,7 @@
 #include "Scene/Mesh.h"
 #include "Scene/SceneDatabase.h"
 #include "Scene/Texture.h"
+#include "Utilities/MeshUtils.hpp"
 
 #include <rapidxml/rapidxml.hpp>
 #include <rapidxml/rapidxml_print.hpp>
@@ -14,6 +15,7 @@ using XmlNode = rapidxml::xml_node<char>;
 using XmlAttribute = rapidxml::xml_attribute<char>;
 
 #include <algorithm>
+#include <cstdio>
 #include <filesystem>
 #include <fstream>
 #include <memory>
@@ -71,6 +73,24 @@ std::unique_ptr<XmlDocument> CreateXmlDocumentWithDeclaration()
 	return pDocument;
 }
 
+// Binary layout of a .cdvb file after the endian byte : stream vertex format, vertex count and vertex buffer.
+// Vertex buffer is the last part so that it is loaded by one read.
+struct VertexStreamFile
+{
+	const cd::VertexFormat& vertexFormat;
+	uint32_t vertexCount;
+	const cd::VertexBuffer& vertexBuffer;
+
+	template<bool SwapBytesOrder>
+	const VertexStreamFile& operator>>(cd::TOutputArchive<SwapBytesOrder>& outputArchive) const
+	{
+		vertexFormat >> outputArchive;
+		outputArchive << vertexCount;
+		outputArchive.ExportBuffer(vertexBuffer.data(), vertexBuffer.size());
+		return *this;
+	}
+};
+
 template<typename T>
 void SaveBinaryFile(std::string filePath, const T& data, cd::EndianType targetEndian)
 {
@@ -122,6 +142,14 @@ void SaveInformationFile(std::string filePath, const std::filesystem::path& bina
 	{
 		WriteMetaDataItem(pMetaDataNode, "VertexCount", data.GetVertexCount());
 		WriteMetaDataItem(pMetaDataNode, "TriangleCount", data.GetPolygonCount());
+		WriteMetaDataItem(pMetaDataNode, "VertexStreamCount", data.GetVertexFormat().GetStreamCount());
+		WriteMetaDataItem(pMetaDataNode, "LodCount", data.GetLodMeshIDCount());
+		for (uint32_t lodIndex = 0U; lodIndex < data.GetLodMeshIDCount(); ++lodIndex)
+		{
+			std::string lodKey = "LOD" + std::to_string(lodIndex + 1);
+			WriteMetaDataItem(pMetaDataNode, lodKey + "MeshID", data.GetLodMeshID(lodIndex).Data());
+			WriteMetaDataItem(pMetaDataNode, lodKey + "ScreenSize", data.GetLodScreenSize(lodIndex));
+		}
 	}
 	else if constexpr (std::is_same_v<cd::Material, T>)
 	{
@@ -150,9 +178,16 @@ void CDConsumerImpl::Execute(const cd::SceneDatabase* pSceneDatabase)
 	switch (GetExportMode())
 	{
 	case ExportMode::XmlBinary:
-		return ExportXmlBinary(pSceneDatabase);
+		ExportXmlBinary(pSceneDatabase);
+		break;
 	case ExportMode::PureBinary:
-		return ExportPureBinary(pSceneDatabase);
+		ExportPureBinary(pSceneDatabase);
+		break;
+	}
+
+	if (IsOptionEnabled(CDConsumerOptions::ExportVertexStreams))
+	{
+		ExportVertexStreams(pSceneDatabase);
 	}
 }
 
@@ -200,4 +235,59 @@ void CDConsumerImpl::ExportXmlBinary(const cd::SceneDatabase* pSceneDatabase)
 	}
 }
 
+void CDConsumerImpl::ExportVertexStreams(const cd::SceneDatabase* pSceneDatabase)
+{
+	std::filesystem::path exportFolderPath = m_filePath;
+	exportFolderPath = exportFolderPath.parent_path();
+
+	for (const auto& mesh : pSceneDatabase->GetMeshes())
+	{
+		const cd::VertexFormat& vertexFormat = mesh.GetVertexFormat();
+		std::optional<std::vector<cd::VertexBuffer>> optVertexStreams;
+		if (mesh.GetSkinIDCount() > 0U)
+		{
+			const cd::Skin& skin = pSceneDatabase->GetSkin(mesh.GetSkinID(0).Data());
+			if (IsOptionEnabled(CDConsumerOptions::ExportPaletteBoneIndices))
+			{
+				optVertexStreams = cd::BuildVertexStreamsForSkeletalMesh(mesh, vertexFormat, skin, nullptr, m_invalidVertexBoneIndex);
+			}
+			else
+			{
+				const cd::Skeleton& skeleton = pSceneDatabase->GetSkeleton(skin.GetSkeletonID().Data());
+				std::vector<const cd::Bone*> skeletonBones;
+				skeletonBones.reserve(skeleton.GetBoneIDCount());
+				for (cd::BoneID boneID : skeleton.GetBoneIDs())
+				{
+					skeletonBones.push_back(&pSceneDatabase->GetBone(boneID.Data()));
+				}
+				optVertexStreams = cd::BuildVertexStreamsForSkeletalMesh(mesh, vertexFormat, skin, &skeletonBones, m_invalidVertexBoneIndex);
+			}
+		}
+		else
+		{
+			optVertexStreams = cd::BuildVertexStreamsForStaticMesh(mesh, vertexFormat);
+		}
+
+		if (!optVertexStreams.has_value())
+		{
+			const bool missSkinAttributes = mesh.GetSkinIDCount() > 0U &&
+				(!vertexFormat.GetVertexAttributeLayout(cd::VertexAttributeType::BoneIndex) || !vertexFormat.GetVertexAttributeLayout(cd::VertexAttributeType::BoneWeight));
+			printf("ExportVertexStreams : skip mesh %s because %s.\n", mesh.GetName(),
+				missSkinAttributes ? "its vertex format has no bone index or bone weight attribute" : "it misses data required by its vertex format");
+			continue;
+		}
+
+		std::string fileName = mesh.GetName();
+		std::replace(fileName.begin(), fileName.end(), '.', '_');
+		const uint32_t vertexCount = cd::VertexBufferWriter::GetVertexCount(mesh);
+		for (uint32_t streamIndex = 0U; streamIndex < optVertexStreams->size(); ++streamIndex)
+		{
+			std::filesystem::path streamFilePath = exportFolderPath / (fileName + "_stream" + std::to_string(streamIndex) + ".cdvb");
+			cd::VertexFormat streamVertexFormat = vertexFormat.GetStreamVertexFormat(streamIndex);
+			VertexStreamFile streamFile{ streamVertexFormat, vertexCount, (*optVertexStreams)[streamIndex] };
+			SaveBinaryFile(streamFilePath.string(), streamFile, m_targetEndian);
+		}
+	}
+}
+
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "Base/Template.h"
 #include "Consumers/CDConsumer/CDConsumerOptions.h"
 #include "Consumers/CDConsumer/ExportMode.h"
+#include "Scene/Skin.h"
 
 #include <string>
 
@@ -36,8 +37,12 @@ public:
 	cd::EndianType GetTargetEndian() const { return m_targetEndian; }
 	void SetTargetEndian(cd::EndianType endian) { m_targetEndian = endian; }
 
+	uint32_t GetInvalidVertexBoneIndex() const { return m_invalidVertexBoneIndex; }
+	void SetInvalidVertexBoneIndex(uint32_t boneIndex) { m_invalidVertexBoneIndex = boneIndex; }
+
 	void ExportPureBinary(const cd::SceneDatabase* pSceneDatabase);
 	void ExportXmlBinary(const cd::SceneDatabase* pSceneDatabase);
+	void ExportVertexStreams(const cd::SceneDatabase* pSceneDatabase);
 
 	cd::BitFlags<CDConsumerOptions>& GetOptions() { return m_options; }
 	const cd::BitFlags<CDConsumerOptions>& GetOptions() const { return m_options; }
@@ -48,6 +53,7 @@ private:
 	cd::BitFlags<CDConsumerOptions> m_options;
 
 	cd::EndianType m_targetEndian = cd::Endian::GetNative();
+	uint32_t m_invalidVertexBoneIndex = cd::DefaultInvalidVertexBoneIndex;
 	std::string m_filePath;
 };
 
@@ -38,6 +38,51 @@ void Processor::AddExtraTextureSearchFolder(const char* pFolderPath)
 	m_pProcessorImpl->AddExtraTextureSearchFolder(pFolderPath);
 }
 
+void Processor::AddLodPercentTarget(float percent)
+{
+	m_pProcessorImpl->AddLodPercentTarget(percent);
+}
+
+void Processor::AddLodScreenSizeTarget(float screenSize)
+{
+	m_pProcessorImpl->AddLodScreenSizeTarget(screenSize);
+}
+
+void Processor::SetMaxBoneInfluenceCount(uint32_t count)
+{
+	m_pProcessorImpl->SetMaxBoneInfluenceCount(count);
+}
+
+void Processor::SetBoneWeightValueType(cd::AttributeValueType valueType)
+{
+	m_pProcessorImpl->SetBoneWeightValueType(valueType);
+}
+
+void Processor::SetMaxSkinPaletteBoneCount(uint32_t count)
+{
+	m_pProcessorImpl->SetMaxSkinPaletteBoneCount(count);
+}
+
+void Processor::SetAnimationKeyTolerances(float translationTolerance, float rotationToleranceDegree, float scaleTolerance)
+{
+	m_pProcessorImpl->SetAnimationKeyTolerances(translationTolerance, rotationToleranceDegree, scaleTolerance);
+}
+
+void Processor::SetMorphDeltaThreshold(float threshold)
+{
+	m_pProcessorImpl->SetMorphDeltaThreshold(threshold);
+}
+
+void Processor::SetTextureMipFilter(cd::TextureMipFilter filter)
+{
+	m_pProcessorImpl->SetTextureMipFilter(filter);
+}
+
+void Processor::SetTextureCompressionQuality(cd::TextureCompressionQuality quality)
+{
+	m_pProcessorImpl->SetTextureCompressionQuality(quality);
+}
+
 void Processor::EnableOption(ProcessorOptions option)
 {
 	m_pProcessorImpl->GetOptions().Enable(option);
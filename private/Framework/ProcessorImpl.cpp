@@ -2,36 +2,28 @@
 
 #include "Framework/IConsumer.h"
 #include "Framework/IProducer.h"
+#include "Math/TransformBatch.h"
+#include "ProgressiveMesh/ProgressiveMesh.h"
+#include "Scene/MorphCompressor.h"
 #include "Scene/SceneDatabase.h"
-
+#include "Scene/SkinOptimizer.h"
+#include "Scene/TextureCompressor.h"
+#include "Scene/TextureDecoder.h"
+#include "Scene/TextureMipGenerator.h"
+#include "Scene/TrackCompressor.h"
+#include "Utilities/ParallelFor.h"
+
+#include <algorithm>
 #include <cassert>
+#include <cstdio>
 #include <filesystem>
 #include <fstream>
+#include <set>
+#include <string>
 
 namespace details
 {
 
-void CalculateNodeTransforms(std::vector<cd::Matrix4x4>& nodeFinalTransforms, const cd::SceneDatabase* pSceneDatabase, const cd::Node& node)
-{
-	// DFS gurantees that parent node's transform will be calculated before child nodes.
-	cd::Matrix4x4 parentTransform = cd::Matrix4x4::Identity();
-	if (node.GetParentID().IsValid())
-	{
-		parentTransform = nodeFinalTransforms[node.GetParentID().Data()];
-	}
-
-	const cd::Transform& sourceTransform = node.GetTransform();
-	cd::Matrix4x4 localTransform = sourceTransform.GetMatrix();
-	nodeFinalTransforms[node.GetID().Data()] = parentTransform * localTransform;
-
-	const std::vector<cd::NodeID>& childIDs = node.GetChildIDs();
-	for (uint32_t childIndex = 0U; childIndex < node.GetChildIDCount(); ++childIndex)
-	{
-		cd::NodeID childNodeID = childIDs[childIndex];
-		CalculateNodeTransforms(nodeFinalTransforms, pSceneDatabase, pSceneDatabase->GetNode(childNodeID.Data()));
-	}
-};
-
 class SceneDatabaseValidator
 {
 public:
@@ -82,6 +74,75 @@ std::vector<std::byte> LoadFile(const char* pFilePath)
 	return fileData;
 }
 
+// Flags textures which materials use as any of the texture types. Invalid or out of range texture IDs are skipped.
+std::vector<bool> GetTexturesUsedAs(const cd::SceneDatabase& sceneDatabase, std::initializer_list<cd::MaterialTextureType> textureTypes)
+{
+	std::vector<bool> usedTextures(sceneDatabase.GetTextureCount(), false);
+	for (const auto& material : sceneDatabase.GetMaterials())
+	{
+		for (cd::MaterialTextureType textureType : textureTypes)
+		{
+			if (!material.IsTextureSetup(textureType))
+			{
+				continue;
+			}
+
+			cd::TextureID textureID = material.GetTextureID(textureType);
+			if (textureID.IsValid() && textureID.Data() < usedTextures.size())
+			{
+				usedTextures[textureID.Data()] = true;
+			}
+		}
+	}
+
+	return usedTextures;
+}
+
+// Keeps morph vertices whose source vertex is in a skin partition and renumbers them to partition vertices.
+void PartitionMorph(const cd::Morph& morph, const std::vector<uint32_t>& partitionVertexIndices, cd::Morph& partitionMorph)
+{
+	std::vector<cd::VertexID> vertexSourceIDs;
+	std::vector<cd::Point> vertexPositions;
+	for (uint32_t vertexIndex = 0U; vertexIndex < morph.GetVertexSourceIDCount(); ++vertexIndex)
+	{
+		const uint32_t sourceVertexIndex = morph.GetVertexSourceID(vertexIndex).Data();
+		if (sourceVertexIndex < partitionVertexIndices.size() && partitionVertexIndices[sourceVertexIndex] != cd::VertexID::InvalidID)
+		{
+			vertexSourceIDs.push_back(cd::VertexID(partitionVertexIndices[sourceVertexIndex]));
+			vertexPositions.push_back(morph.GetVertexPosition(vertexIndex));
+		}
+	}
+
+	partitionMorph.SetName(morph.GetName());
+	partitionMorph.SetWeight(morph.GetWeight());
+	partitionMorph.SetMorphEncoding(morph.GetMorphEncoding());
+	partitionMorph.SetVertexSourceIDs(cd::MoveTemp(vertexSourceIDs));
+	partitionMorph.SetVertexPositions(cd::MoveTemp(vertexPositions));
+}
+
+bool IsLodEligibleMesh(const cd::Mesh& mesh)
+{
+	// Lod mesh is generated by vertex index so vertex instance attributes, skin weights and morph targets
+	// which refer to source vertex indexes are not supported.
+	if (mesh.GetVertexInstanceToIDCount() > 0U || mesh.GetSkinIDCount() > 0U || mesh.GetBlendShapeIDCount() > 0U)
+	{
+		return false;
+	}
+
+	for (const auto& polygonGroup : mesh.GetPolygonGroups())
+	{
+		for (const auto& polygon : polygonGroup)
+		{
+			if (polygon.size() != 3U || polygon[0] == polygon[1] || polygon[0] == polygon[2] || polygon[1] == polygon[2])
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
 }
 
 namespace cdtools
@@ -127,6 +188,13 @@ void ProcessorImpl::Run()
 	{
 		details::SceneDatabaseValidator validator(this);
 
+		// Morph source vertex IDs refer to producer meshes so deltas are taken before passes which rebuild meshes.
+		// Axis conversion then only walks kept offsets.
+		if (m_options.IsEnabled(ProcessorOptions::CompressMorphs))
+		{
+			CompressMorphs();
+		}
+
 		if (m_options.IsEnabled(ProcessorOptions::ConvertAxisSystem))
 		{
 			ConvertAxisSystem();
@@ -137,6 +205,26 @@ void ProcessorImpl::Run()
 			FlattenSceneDatabase();
 		}
 
+		if (m_options.IsEnabled(ProcessorOptions::GenerateLODs))
+		{
+			GenerateLODs();
+		}
+
+		if (m_options.IsEnabled(ProcessorOptions::LimitBoneInfluences))
+		{
+			LimitBoneInfluences();
+		}
+
+		if (m_options.IsEnabled(ProcessorOptions::PartitionSkins))
+		{
+			PartitionSkins();
+		}
+
+		if (m_options.IsEnabled(ProcessorOptions::CompressAnimations))
+		{
+			CompressAnimations();
+		}
+
 		if (m_options.IsEnabled(ProcessorOptions::CalculateAABB))
 		{
 			CalculateAABBForSceneDatabase();
@@ -151,6 +239,16 @@ void ProcessorImpl::Run()
 		{
 			EmbedTextureFiles();
 		}
+
+		if (m_options.IsEnabled(ProcessorOptions::DecodeTextures))
+		{
+			DecodeTextures();
+		}
+
+		if (m_options.IsEnabled(ProcessorOptions::CompressTextures))
+		{
+			CompressTextures();
+		}
 	}
 
 	// Dump all information finally.
@@ -255,8 +353,7 @@ void ProcessorImpl::FlattenSceneDatabase()
 	}
 
 	// Init every node's final transform matrix after removing node hierarchy.
-	std::vector<cd::Matrix4x4> nodeFinalTransforms;
-	nodeFinalTransforms.reserve(totalNodeCount);
+	std::vector<cd::Matrix4x4> nodeFinalTransforms = m_pCurrentSceneDatabase->CalculateNodeWorldTransforms();
 	std::map<uint32_t, uint32_t> mapMeshIDToAssociatedNodeID;
 	for (uint32_t nodeIndex = 0U; nodeIndex < totalNodeCount; ++nodeIndex)
 	{
@@ -266,13 +363,8 @@ void ProcessorImpl::FlattenSceneDatabase()
 		{
 			mapMeshIDToAssociatedNodeID[nodeMeshIDs[nodeMeshIndex].Data()] = nodeIndex;
 		}
-
-		nodeFinalTransforms.push_back(cd::Transform::Identity().GetMatrix());
 	}
 
-	const cd::Node& rootNode = m_pCurrentSceneDatabase->GetNode(0);
-	details::CalculateNodeTransforms(nodeFinalTransforms, m_pCurrentSceneDatabase, rootNode);
-
 	std::vector<cd::Mesh>& meshes = m_pCurrentSceneDatabase->GetMeshes();
 	for (uint32_t meshIndex = 0U; meshIndex < m_pCurrentSceneDatabase->GetMeshCount(); ++meshIndex)
 	{
@@ -293,12 +385,8 @@ void ProcessorImpl::FlattenSceneDatabase()
 
 		uint32_t nodeIndex = itNodeIndex->second;
 		const cd::Matrix4x4& finalTransform = nodeFinalTransforms[nodeIndex];
-		for (uint32_t vertexIndex = 0U; vertexIndex < mesh.GetVertexCount(); ++vertexIndex)
-		{
-			const cd::Point& position = mesh.GetVertexPosition(vertexIndex);
-			cd::Vec4f newPosition = finalTransform * cd::Vec4f(position.x(), position.y(), position.z(), 1.0f);
-			mesh.SetVertexPosition(vertexIndex, cd::Point(newPosition.x(), newPosition.y(), newPosition.z()));
-		}
+		std::vector<cd::Point>& vertexPositions = mesh.GetVertexPositions();
+		cd::TransformBatch::TransformPoints(finalTransform, vertexPositions, vertexPositions);
 	}
 
 	// Delete all nodes.
@@ -334,7 +422,7 @@ void ProcessorImpl::EmbedTextureFiles()
 {
 	for (auto& texture : m_pCurrentSceneDatabase->GetTextures())
 	{
-		if (texture.GetRawData().empty())
+		if (!texture.GetRawData().empty())
 		{
 			continue;
 		}
@@ -350,4 +438,325 @@ void ProcessorImpl::EmbedTextureFiles()
 	}
 }
 
+void ProcessorImpl::DecodeTextures()
+{
+	// Color textures are authored in sRGB so their mip chains are filtered in linear space.
+	const std::vector<bool> srgbTextures = details::GetTexturesUsedAs(*m_pCurrentSceneDatabase, { cd::MaterialTextureType::BaseColor, cd::MaterialTextureType::Emissive });
+
+	// Textures which producers already filled in pixels have known formats. Others have embedded or external image files.
+	auto& textures = m_pCurrentSceneDatabase->GetTextures();
+	cd::ParallelFor(static_cast<uint32_t>(textures.size()), [this, &textures, &srgbTextures](uint32_t textureIndex)
+	{
+		cd::Texture& texture = textures[textureIndex];
+		if (texture.GetFormat() != cd::TextureFormat::Count)
+		{
+			return;
+		}
+
+		if (texture.GetRawData().empty() && std::filesystem::exists(texture.GetPath()))
+		{
+			texture.SetRawData(details::LoadFile(texture.GetPath()));
+		}
+
+		if (!cd::TextureDecoder::Decode(texture) || !texture.GetUseMipMap())
+		{
+			return;
+		}
+
+		cd::TextureMipGenerator::GenerateMipChain(texture.GetRawData(), texture.GetFormat(), static_cast<uint32_t>(texture.GetWidth()),
+			static_cast<uint32_t>(texture.GetHeight()), srgbTextures[textureIndex], m_textureMipFilter);
+	});
+}
+
+void ProcessorImpl::CompressTextures()
+{
+	// Normal maps keep x and y in BC5 and shaders rebuild z.
+	const std::vector<bool> normalTextures = details::GetTexturesUsedAs(*m_pCurrentSceneDatabase, { cd::MaterialTextureType::Normal });
+
+	// Textures are compressed one by one as every level is already encoded in block rows on multiple threads.
+	auto& textures = m_pCurrentSceneDatabase->GetTextures();
+	for (uint32_t textureIndex = 0U; textureIndex < textures.size(); ++textureIndex)
+	{
+		cd::Texture& texture = textures[textureIndex];
+		cd::TextureFormat targetFormat;
+		if (cd::TextureFormat::R8 == texture.GetFormat())
+		{
+			targetFormat = cd::TextureFormat::BC4;
+		}
+		else if (cd::TextureFormat::RGBA8 != texture.GetFormat())
+		{
+			continue;
+		}
+		else if (normalTextures[textureIndex])
+		{
+			targetFormat = cd::TextureFormat::BC5;
+		}
+		else if (cd::TextureCompressionQuality::High == m_textureCompressionQuality)
+		{
+			targetFormat = cd::TextureFormat::BC7;
+		}
+		else
+		{
+			// Level 0 decides whether alpha needs BC3. Smaller levels are filtered from it.
+			const std::vector<std::byte>& pixels = texture.GetRawData();
+			const std::size_t levelSize = cd::TextureMipGenerator::GetMipSize(cd::TextureFormat::RGBA8,
+				static_cast<uint32_t>(texture.GetWidth()), static_cast<uint32_t>(texture.GetHeight()));
+			bool hasAlpha = false;
+			for (std::size_t alphaOffset = 3U; alphaOffset < std::min(levelSize, pixels.size()) && !hasAlpha; alphaOffset += 4U)
+			{
+				hasAlpha = pixels[alphaOffset] != std::byte{ 0xFF };
+			}
+			targetFormat = hasAlpha ? cd::TextureFormat::BC3 : cd::TextureFormat::BC1;
+		}
+
+		cd::TextureCompressor::Compress(texture, targetFormat, m_textureCompressionQuality);
+	}
+}
+
+void ProcessorImpl::GenerateLODs()
+{
+	constexpr uint32_t MinLodFaceCount = 32U;
+
+	std::vector<float> lodScreenSizes = m_lodScreenSizes;
+	if (lodScreenSizes.empty())
+	{
+		// Default lod chain keeps 1/2, 1/4 and 1/8 faces.
+		lodScreenSizes = { std::sqrt(0.5f), std::sqrt(0.25f), std::sqrt(0.125f) };
+	}
+	// Lower detail lods are used at smaller screen sizes.
+	std::sort(lodScreenSizes.begin(), lodScreenSizes.end(), std::greater<float>());
+
+	// Meshes which are lods of other meshes or already have lods don't need to generate again.
+	std::set<uint32_t> skipMeshIndexes;
+	for (const auto& mesh : m_pCurrentSceneDatabase->GetMeshes())
+	{
+		if (mesh.GetLodMeshIDCount() > 0U)
+		{
+			skipMeshIndexes.insert(mesh.GetID().Data());
+		}
+
+		for (cd::MeshID lodMeshID : mesh.GetLodMeshIDs())
+		{
+			skipMeshIndexes.insert(lodMeshID.Data());
+		}
+	}
+
+	// Every mesh simplifies independently. Only read source meshes here and add lod meshes to SceneDatabase
+	// later by source mesh order so that mesh ids are deterministic.
+	uint32_t sourceMeshCount = m_pCurrentSceneDatabase->GetMeshCount();
+	std::vector<std::vector<cd::Mesh>> meshLods(sourceMeshCount);
+	std::vector<std::vector<float>> meshLodScreenSizes(sourceMeshCount);
+	const cd::SceneDatabase* pSceneDatabase = m_pCurrentSceneDatabase;
+	cd::ParallelFor(sourceMeshCount, [&](uint32_t meshIndex)
+	{
+		const cd::Mesh& mesh = pSceneDatabase->GetMesh(meshIndex);
+		if (skipMeshIndexes.contains(meshIndex) || !details::IsLodEligibleMesh(mesh))
+		{
+			return;
+		}
+
+		uint32_t faceCount = mesh.GetPolygonCount();
+		auto progressiveMesh = cd::ProgressiveMesh::FromIndexedMesh(mesh);
+		for (float screenSize : lodScreenSizes)
+		{
+			uint32_t targetFaceCount = static_cast<uint32_t>(faceCount * screenSize * screenSize);
+			if (targetFaceCount < MinLodFaceCount || targetFaceCount >= faceCount)
+			{
+				continue;
+			}
+
+			// Collapse operations are built by the first lod and reused by the others.
+			cd::Mesh lodMesh = progressiveMesh.GenerateLodMesh(targetFaceCount, &mesh);
+			lodMesh.SetName((std::string(mesh.GetName()) + "_LOD" + std::to_string(meshLods[meshIndex].size() + 1)).c_str());
+			lodMesh.SetMaterialIDs(mesh.GetMaterialIDs());
+			lodMesh.UpdateAABB();
+			meshLods[meshIndex].push_back(cd::MoveTemp(lodMesh));
+			meshLodScreenSizes[meshIndex].push_back(screenSize);
+		}
+	});
+
+	for (uint32_t meshIndex = 0U; meshIndex < sourceMeshCount; ++meshIndex)
+	{
+		for (uint32_t lodIndex = 0U; lodIndex < meshLods[meshIndex].size(); ++lodIndex)
+		{
+			cd::MeshID lodMeshID(m_pCurrentSceneDatabase->GetMeshCount());
+			cd::Mesh& lodMesh = meshLods[meshIndex][lodIndex];
+			lodMesh.SetID(lodMeshID);
+			m_pCurrentSceneDatabase->AddMesh(cd::MoveTemp(lodMesh));
+
+			cd::Mesh& mesh = m_pCurrentSceneDatabase->GetMesh(meshIndex);
+			mesh.AddLodMeshID(lodMeshID);
+			mesh.AddLodScreenSize(meshLodScreenSizes[meshIndex][lodIndex]);
+		}
+	}
+}
+
+void ProcessorImpl::LimitBoneInfluences()
+{
+	for (auto& skin : m_pCurrentSceneDatabase->GetSkins())
+	{
+		cd::SkinOptimizer::LimitInfluences(skin, m_maxBoneInfluenceCount);
+		cd::SkinOptimizer::QuantizeWeights(skin, m_boneWeightValueType);
+	}
+}
+
+void ProcessorImpl::PartitionSkins()
+{
+	// Partitions are added after existing meshes and skins like lod meshes. The first partition replaces the source mesh
+	// and skin so that their ids stay valid. Nodes which reference the source mesh reference all of its partitions.
+	// Blend shapes and morphs of the source mesh are split the same way.
+	const uint32_t sourceMeshCount = m_pCurrentSceneDatabase->GetMeshCount();
+	for (uint32_t meshIndex = 0U; meshIndex < sourceMeshCount; ++meshIndex)
+	{
+		const cd::Mesh& mesh = m_pCurrentSceneDatabase->GetMesh(meshIndex);
+		if (mesh.GetSkinIDCount() != 1U)
+		{
+			continue;
+		}
+
+		const cd::SkinID skinID = mesh.GetSkinID(0U);
+		const cd::Skin& skin = m_pCurrentSceneDatabase->GetSkin(skinID.Data());
+		if (mesh.GetLodMeshIDCount() > 0U)
+		{
+			// Lod meshes don't have skins to split by the same palettes.
+			if (skin.GetInfluenceBoneNameCount() > m_maxSkinPaletteBoneCount)
+			{
+				printf("PartitionSkins : skip mesh %s because it has lod meshes.\n", mesh.GetName());
+			}
+			continue;
+		}
+
+		std::vector<cd::SkinPartition> partitions = cd::SkinOptimizer::Partition(mesh, skin, m_maxSkinPaletteBoneCount);
+		if (partitions.empty())
+		{
+			continue;
+		}
+
+		const cd::MeshID meshID = mesh.GetID();
+		const std::string meshName = mesh.GetName();
+		const uint32_t vertexCount = mesh.GetVertexCount();
+		const std::vector<cd::BlendShapeID> blendShapeIDs = mesh.GetBlendShapeIDs();
+
+		// Morphs of all partitions are built before the source morphs are replaced by the first partition.
+		std::vector<std::vector<cd::Morph>> partitionMorphs(partitions.size());
+		for (uint32_t partitionIndex = 0U; partitionIndex < partitions.size(); ++partitionIndex)
+		{
+			const std::vector<uint32_t>& sourceVertexIndices = partitions[partitionIndex].sourceVertexIndices;
+			std::vector<uint32_t> partitionVertexIndices(vertexCount, cd::VertexID::InvalidID);
+			for (uint32_t vertexIndex = 0U; vertexIndex < sourceVertexIndices.size(); ++vertexIndex)
+			{
+				partitionVertexIndices[sourceVertexIndices[vertexIndex]] = vertexIndex;
+			}
+
+			for (cd::BlendShapeID blendShapeID : blendShapeIDs)
+			{
+				for (cd::MorphID morphID : m_pCurrentSceneDatabase->GetBlendShape(blendShapeID.Data()).GetMorphIDs())
+				{
+					details::PartitionMorph(m_pCurrentSceneDatabase->GetMorph(morphID.Data()), partitionVertexIndices,
+						partitionMorphs[partitionIndex].emplace_back());
+				}
+			}
+		}
+
+		std::vector<cd::MeshID> partitionMeshIDs;
+		for (uint32_t partitionIndex = 0U; partitionIndex < partitions.size(); ++partitionIndex)
+		{
+			const bool isSource = 0U == partitionIndex;
+			cd::MeshID partitionMeshID = isSource ? meshID : cd::MeshID(m_pCurrentSceneDatabase->GetMeshCount());
+			cd::SkinID partitionSkinID = isSource ? skinID : cd::SkinID(m_pCurrentSceneDatabase->GetSkinCount());
+
+			cd::Mesh& partitionMesh = partitions[partitionIndex].mesh;
+			partitionMesh.SetID(partitionMeshID);
+			partitionMesh.AddSkinID(partitionSkinID);
+			if (!isSource)
+			{
+				partitionMesh.SetName((meshName + "_Part" + std::to_string(partitionIndex)).c_str());
+				partitionMeshIDs.push_back(partitionMeshID);
+			}
+
+			cd::Skin& partitionSkin = partitions[partitionIndex].skin;
+			partitionSkin.SetID(partitionSkinID);
+			partitionSkin.SetMeshID(partitionMeshID);
+
+			uint32_t morphIndex = 0U;
+			for (cd::BlendShapeID blendShapeID : blendShapeIDs)
+			{
+				if (isSource)
+				{
+					partitionMesh.AddBlendShapeID(blendShapeID);
+					for (cd::MorphID morphID : m_pCurrentSceneDatabase->GetBlendShape(blendShapeID.Data()).GetMorphIDs())
+					{
+						cd::Morph& partitionMorph = partitionMorphs[partitionIndex][morphIndex++];
+						partitionMorph.SetID(morphID);
+						partitionMorph.SetBlendShapeID(blendShapeID);
+						m_pCurrentSceneDatabase->GetMorph(morphID.Data()) = cd::MoveTemp(partitionMorph);
+					}
+					continue;
+				}
+
+				const cd::BlendShape& sourceBlendShape = m_pCurrentSceneDatabase->GetBlendShape(blendShapeID.Data());
+				cd::BlendShape partitionBlendShape;
+				partitionBlendShape.SetID(cd::BlendShapeID(m_pCurrentSceneDatabase->GetBlendShapeCount()));
+				partitionBlendShape.SetMeshID(partitionMeshID);
+				partitionBlendShape.SetName(sourceBlendShape.GetName());
+				for (uint32_t sourceMorphIndex = 0U; sourceMorphIndex < sourceBlendShape.GetMorphIDCount(); ++sourceMorphIndex)
+				{
+					cd::Morph& partitionMorph = partitionMorphs[partitionIndex][morphIndex++];
+					partitionMorph.SetID(cd::MorphID(m_pCurrentSceneDatabase->GetMorphCount()));
+					partitionMorph.SetBlendShapeID(partitionBlendShape.GetID());
+					partitionBlendShape.AddMorphID(partitionMorph.GetID());
+					m_pCurrentSceneDatabase->AddMorph(cd::MoveTemp(partitionMorph));
+				}
+				partitionMesh.AddBlendShapeID(partitionBlendShape.GetID());
+				m_pCurrentSceneDatabase->AddBlendShape(cd::MoveTemp(partitionBlendShape));
+			}
+
+			if (isSource)
+			{
+				m_pCurrentSceneDatabase->GetMesh(meshIndex) = cd::MoveTemp(partitionMesh);
+				m_pCurrentSceneDatabase->GetSkin(skinID.Data()) = cd::MoveTemp(partitionSkin);
+			}
+			else
+			{
+				m_pCurrentSceneDatabase->AddMesh(cd::MoveTemp(partitionMesh));
+				m_pCurrentSceneDatabase->AddSkin(cd::MoveTemp(partitionSkin));
+			}
+		}
+
+		for (auto& node : m_pCurrentSceneDatabase->GetNodes())
+		{
+			const auto& nodeMeshIDs = node.GetMeshIDs();
+			if (std::find(nodeMeshIDs.begin(), nodeMeshIDs.end(), meshID) != nodeMeshIDs.end())
+			{
+				for (cd::MeshID partitionMeshID : partitionMeshIDs)
+				{
+					node.AddMeshID(partitionMeshID);
+				}
+			}
+		}
+	}
+}
+
+void ProcessorImpl::CompressAnimations()
+{
+	// Keys are reduced by float values first. Quantized keys are checked against the same tolerances,
+	// so sampled values stay within about twice the tolerances. Tracks which fail the check keep float keys.
+	for (auto& track : m_pCurrentSceneDatabase->GetTracks())
+	{
+		cd::TrackCompressor::ReduceKeys(track, m_translationKeyTolerance, m_rotationKeyTolerance, m_scaleKeyTolerance);
+		cd::TrackCompressor::QuantizeKeys(track, m_translationKeyTolerance, m_rotationKeyTolerance, m_scaleKeyTolerance);
+	}
+}
+
+void ProcessorImpl::CompressMorphs()
+{
+	for (auto& morph : m_pCurrentSceneDatabase->GetMorphs())
+	{
+		const cd::BlendShape& blendShape = m_pCurrentSceneDatabase->GetBlendShape(morph.GetBlendShapeID().Data());
+		const cd::Mesh& sourceMesh = m_pCurrentSceneDatabase->GetMesh(blendShape.GetMeshID().Data());
+		cd::MorphCompressor::SparsifyDeltas(morph, sourceMesh, m_morphDeltaThreshold);
+		cd::MorphCompressor::QuantizeDeltas(morph);
+	}
+}
+
 }
\ No newline at end of file
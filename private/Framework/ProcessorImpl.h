@@ -4,7 +4,11 @@
 #include "Base/Template.h"
 #include "Framework/ProcessorOptions.h"
 #include "Math/AxisSystem.hpp"
+#include "Scene/TextureCompressor.h"
+#include "Scene/TextureMipGenerator.h"
+#include "Scene/VertexAttribute.h"
 
+#include <cmath>
 #include <memory>
 #include <string>
 #include <vector>
@@ -46,6 +50,25 @@ public:
 	void AddExtraTextureSearchFolder(const char* pFolderPath) { m_textureSearchFolders.push_back(pFolderPath); }
 	bool IsSearchMissingTexturesEnabled() const { return !m_textureSearchFolders.empty(); }
 
+	// LOD targets are stored as screen sizes. Face budget of a lod is screenSize^2 of the source face count.
+	void AddLodPercentTarget(float percent) { m_lodScreenSizes.push_back(std::sqrt(percent)); }
+	void AddLodScreenSizeTarget(float screenSize) { m_lodScreenSizes.push_back(screenSize); }
+
+	void SetMaxBoneInfluenceCount(uint32_t count) { m_maxBoneInfluenceCount = count; }
+	void SetBoneWeightValueType(cd::AttributeValueType valueType) { m_boneWeightValueType = valueType; }
+	void SetMaxSkinPaletteBoneCount(uint32_t count) { m_maxSkinPaletteBoneCount = count; }
+
+	void SetAnimationKeyTolerances(float translationTolerance, float rotationToleranceDegree, float scaleTolerance)
+	{
+		m_translationKeyTolerance = translationTolerance;
+		m_rotationKeyTolerance = cd::Math::DegreeToRadian<float>(rotationToleranceDegree);
+		m_scaleKeyTolerance = scaleTolerance;
+	}
+
+	void SetMorphDeltaThreshold(float threshold) { m_morphDeltaThreshold = threshold; }
+	void SetTextureMipFilter(cd::TextureMipFilter filter) { m_textureMipFilter = filter; }
+	void SetTextureCompressionQuality(cd::TextureCompressionQuality quality) { m_textureCompressionQuality = quality; }
+
 	cd::BitFlags<ProcessorOptions>& GetOptions() { return m_options; }
 	const cd::BitFlags<ProcessorOptions>& GetOptions() const { return m_options; }
 	bool IsOptionEnabled(ProcessorOptions option) const { return m_options.IsEnabled(option); }
@@ -54,6 +77,13 @@ public:
 	void FlattenSceneDatabase();
 	void SearchMissingTextures();
 	void EmbedTextureFiles();
+	void DecodeTextures();
+	void CompressTextures();
+	void GenerateLODs();
+	void LimitBoneInfluences();
+	void PartitionSkins();
+	void CompressAnimations();
+	void CompressMorphs();
 
 private:
 	IProducer* m_pProducer = nullptr;
@@ -64,6 +94,21 @@ private:
 	cd::SceneDatabase* m_pCurrentSceneDatabase;
 	std::unique_ptr<cd::SceneDatabase> m_pLocalSceneDatabase;
 	std::vector<std::string> m_textureSearchFolders;
+	std::vector<float> m_lodScreenSizes;
+
+	// 4 influences with unorm8 weights and 64 palette bones fit common skinning shaders.
+	uint32_t m_maxBoneInfluenceCount = 4U;
+	cd::AttributeValueType m_boneWeightValueType = cd::AttributeValueType::Uint8;
+	uint32_t m_maxSkinPaletteBoneCount = 64U;
+
+	float m_translationKeyTolerance = 0.001f;
+	float m_rotationKeyTolerance = cd::Math::DegreeToRadian<float>(0.05f);
+	float m_scaleKeyTolerance = 0.001f;
+
+	float m_morphDeltaThreshold = 0.0001f;
+
+	cd::TextureMipFilter m_textureMipFilter = cd::TextureMipFilter::Box;
+	cd::TextureCompressionQuality m_textureCompressionQuality = cd::TextureCompressionQuality::Normal;
 };
 
 }
\ No newline at end of file
@@ -1,5 +1,28 @@
 #include "Math/NoiseGenerator.h"
 
+#include "Base/Platform.h"
+
+#include <algorithm>
+
+// Batch noise uses SSE on x86 and switches to AVX at runtime if the CPU supports it.
+// Other platforms evaluate lanes one by one.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CD_NOISE_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CD_NOISE_AVX_FUNCTION CD_FORCEINLINE
+#define CD_NOISE_AVX_ENTRY
+#else
+#define CD_NOISE_AVX_FUNCTION inline __attribute__((target("avx")))
+#define CD_NOISE_AVX_ENTRY __attribute__((target("avx"), flatten))
+#if defined(__GNUC__) && !defined(__clang__)
+// AVX kernels are only inlined into the AVX entry function so the ABI of __m256 values passed between them doesn't matter.
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+#endif
+#endif
+
 // Adopted from https://github.com/KdotJPG/OpenSimplex2/blob/master/java/OpenSimplex2S.java
 namespace {
 
@@ -125,6 +148,208 @@ namespace {
         return value;
     }
 
+    /**
+     * Batch 2D Simplex noise. It uses the same math as SimplexNoise2D and Noise2D_UnskewedBase.
+     * Lattice hashes and gradients are fetched per lane first. Then all three vertices are evaluated for all lanes
+     * without branches. Vertices out of radius get zero weight so the floating point math runs in SIMD registers.
+     */
+    int32_t GradientIndex(int64_t seed, int64_t xsvp, int64_t ysvp) {
+        int64_t hash = static_cast<int64_t>(static_cast<uint64_t>(seed ^ xsvp ^ ysvp) * static_cast<uint64_t>(HASH_MULTIPLIER));
+        hash ^= hash >> (64 - N_GRADS_2D_EXPONENT + 1);
+        return static_cast<int32_t>(hash) & ((N_GRADS_2D - 1) << 1);
+    }
+
+    template<typename T>
+    int32_t FastFloorT(T i) {
+        int32_t iAsInt = static_cast<int32_t>(i);
+        return i < iAsInt ? iAsInt - 1 : iAsInt;
+    }
+
+    constexpr uint32_t MAX_NOISE_LANES = 8;
+
+    struct NoiseLanes {
+        alignas(32) int32_t xsb[MAX_NOISE_LANES];
+        alignas(32) int32_t ysb[MAX_NOISE_LANES];
+        alignas(32) float xi[MAX_NOISE_LANES];
+        alignas(32) float yi[MAX_NOISE_LANES];
+        alignas(32) float g0x[MAX_NOISE_LANES];
+        alignas(32) float g0y[MAX_NOISE_LANES];
+        alignas(32) float g1x[MAX_NOISE_LANES];
+        alignas(32) float g1y[MAX_NOISE_LANES];
+        alignas(32) float g2x[MAX_NOISE_LANES];
+        alignas(32) float g2y[MAX_NOISE_LANES];
+        alignas(32) float values[MAX_NOISE_LANES];
+    };
+
+    // Padding lanes repeat the last sample and are not written back.
+    template<typename T>
+    CD_FORCEINLINE void SkewLanes(NoiseLanes& lanes, T x, T y, T stepX, uint32_t firstIndex, uint32_t laneCount, uint32_t lanesPerBatch) {
+        for (uint32_t lane = 0; lane < lanesPerBatch; ++lane) {
+            T sx = x + static_cast<T>(firstIndex + std::min(lane, laneCount - 1)) * stepX;
+            T s = static_cast<T>(SKEW_2D) * (sx + y);
+            T xs = sx + s, ys = y + s;
+            int32_t xsb = FastFloorT(xs), ysb = FastFloorT(ys);
+            lanes.xsb[lane] = xsb;
+            lanes.ysb[lane] = ysb;
+            lanes.xi[lane] = static_cast<float>(xs - xsb);
+            lanes.yi[lane] = static_cast<float>(ys - ysb);
+        }
+    }
+
+    CD_FORCEINLINE void FetchGradientLanes(NoiseLanes& lanes, int64_t seed, uint32_t lanesPerBatch) {
+        for (uint32_t lane = 0; lane < lanesPerBatch; ++lane) {
+            int64_t xsbp = static_cast<int64_t>(static_cast<uint64_t>(lanes.xsb[lane]) * static_cast<uint64_t>(PRIME_X));
+            int64_t ysbp = static_cast<int64_t>(static_cast<uint64_t>(lanes.ysb[lane]) * static_cast<uint64_t>(PRIME_Y));
+            int64_t xsbp1 = static_cast<int64_t>(static_cast<uint64_t>(xsbp) + static_cast<uint64_t>(PRIME_X));
+            int64_t ysbp1 = static_cast<int64_t>(static_cast<uint64_t>(ysbp) + static_cast<uint64_t>(PRIME_Y));
+            int32_t gi0 = GradientIndex(seed, xsbp, ysbp);
+            int32_t gi1 = GradientIndex(seed, xsbp1, ysbp1);
+            // dy0 > dx0 is the same as yi > xi.
+            int32_t gi2 = lanes.yi[lane] > lanes.xi[lane] ? GradientIndex(seed, xsbp, ysbp1) : GradientIndex(seed, xsbp1, ysbp);
+            lanes.g0x[lane] = GRADIENTS_2D[gi0 | 0]; lanes.g0y[lane] = GRADIENTS_2D[gi0 | 1];
+            lanes.g1x[lane] = GRADIENTS_2D[gi1 | 0]; lanes.g1y[lane] = GRADIENTS_2D[gi1 | 1];
+            lanes.g2x[lane] = GRADIENTS_2D[gi2 | 0]; lanes.g2y[lane] = GRADIENTS_2D[gi2 | 1];
+        }
+    }
+
+    // Vertex contributions for Ops::Count lanes starting at lane. Ops wraps one float or a SIMD register.
+    template<typename Ops>
+    CD_FORCEINLINE void EvaluateLanes(NoiseLanes& lanes, uint32_t lane, float scale, float bias) {
+        using F = typename Ops::Float;
+        const F zero = Ops::Set(0.0f);
+        const F rSquared = Ops::Set(RSQUARED_2D);
+        F xi = Ops::Load(lanes.xi + lane), yi = Ops::Load(lanes.yi + lane);
+        F t = Ops::Mul(Ops::Add(xi, yi), Ops::Set(static_cast<float>(UNSKEW_2D)));
+        F dx0 = Ops::Add(xi, t), dy0 = Ops::Add(yi, t);
+        // First vertex.
+        F a0 = Ops::Sub(Ops::Sub(rSquared, Ops::Mul(dx0, dx0)), Ops::Mul(dy0, dy0));
+        F b0 = Ops::Max(a0, zero);
+        F grad0 = Ops::Add(Ops::Mul(Ops::Load(lanes.g0x + lane), dx0), Ops::Mul(Ops::Load(lanes.g0y + lane), dy0));
+        F value = Ops::Mul(Ops::Mul(Ops::Mul(b0, b0), Ops::Mul(b0, b0)), grad0);
+        // Second vertex.
+        F a1 = Ops::Add(Ops::Mul(Ops::Set(static_cast<float>(2 * (1 + 2 * UNSKEW_2D) * (1 / UNSKEW_2D + 2))), t),
+            Ops::Add(Ops::Set(static_cast<float>(-2 * (1 + 2 * UNSKEW_2D) * (1 + 2 * UNSKEW_2D))), a0));
+        F dx1 = Ops::Sub(dx0, Ops::Set(static_cast<float>(1 + 2 * UNSKEW_2D)));
+        F dy1 = Ops::Sub(dy0, Ops::Set(static_cast<float>(1 + 2 * UNSKEW_2D)));
+        F b1 = Ops::Max(a1, zero);
+        F grad1 = Ops::Add(Ops::Mul(Ops::Load(lanes.g1x + lane), dx1), Ops::Mul(Ops::Load(lanes.g1y + lane), dy1));
+        value = Ops::Add(value, Ops::Mul(Ops::Mul(Ops::Mul(b1, b1), Ops::Mul(b1, b1)), grad1));
+        // Third vertex.
+        auto isUpper = Ops::Greater(dy0, dx0);
+        F dx2 = Ops::Sub(dx0, Ops::Select(isUpper, Ops::Set(static_cast<float>(UNSKEW_2D)), Ops::Set(static_cast<float>(UNSKEW_2D + 1))));
+        F dy2 = Ops::Sub(dy0, Ops::Select(isUpper, Ops::Set(static_cast<float>(UNSKEW_2D + 1)), Ops::Set(static_cast<float>(UNSKEW_2D))));
+        F a2 = Ops::Sub(Ops::Sub(rSquared, Ops::Mul(dx2, dx2)), Ops::Mul(dy2, dy2));
+        F b2 = Ops::Max(a2, zero);
+        F grad2 = Ops::Add(Ops::Mul(Ops::Load(lanes.g2x + lane), dx2), Ops::Mul(Ops::Load(lanes.g2y + lane), dy2));
+        value = Ops::Add(value, Ops::Mul(Ops::Mul(Ops::Mul(b2, b2), Ops::Mul(b2, b2)), grad2));
+        // Same as value / 2 + 0.5 when normalized.
+        Ops::Store(lanes.values + lane, Ops::Add(Ops::Mul(value, Ops::Set(scale)), Ops::Set(bias)));
+    }
+
+    struct ScalarOps {
+        using Float = float;
+        static constexpr uint32_t Count = 1;
+        static CD_FORCEINLINE Float Set(float v) { return v; }
+        static CD_FORCEINLINE Float Load(const float* p) { return *p; }
+        static CD_FORCEINLINE void Store(float* p, Float v) { *p = v; }
+        static CD_FORCEINLINE Float Add(Float a, Float b) { return a + b; }
+        static CD_FORCEINLINE Float Sub(Float a, Float b) { return a - b; }
+        static CD_FORCEINLINE Float Mul(Float a, Float b) { return a * b; }
+        static CD_FORCEINLINE Float Max(Float a, Float b) { return a > b ? a : b; }
+        static CD_FORCEINLINE bool Greater(Float a, Float b) { return a > b; }
+        static CD_FORCEINLINE Float Select(bool mask, Float a, Float b) { return mask ? a : b; }
+    };
+
+#ifdef CD_NOISE_X86
+    struct SSEOps {
+        using Float = __m128;
+        static constexpr uint32_t Count = 4;
+        static CD_FORCEINLINE Float Set(float v) { return _mm_set1_ps(v); }
+        static CD_FORCEINLINE Float Load(const float* p) { return _mm_load_ps(p); }
+        static CD_FORCEINLINE void Store(float* p, Float v) { _mm_store_ps(p, v); }
+        static CD_FORCEINLINE Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+        static CD_FORCEINLINE Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+        static CD_FORCEINLINE Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+        static CD_FORCEINLINE Float Max(Float a, Float b) { return _mm_max_ps(a, b); }
+        static CD_FORCEINLINE Float Greater(Float a, Float b) { return _mm_cmpgt_ps(a, b); }
+        static CD_FORCEINLINE Float Select(Float mask, Float a, Float b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    };
+
+    // AVX functions can't be force inlined into default target functions on GCC/Clang.
+    // The AVX entry function is flattened instead so everything is still inlined into it.
+    struct AVXOps {
+        using Float = __m256;
+        static constexpr uint32_t Count = 8;
+        static CD_NOISE_AVX_FUNCTION Float Set(float v) { return _mm256_set1_ps(v); }
+        static CD_NOISE_AVX_FUNCTION Float Load(const float* p) { return _mm256_load_ps(p); }
+        static CD_NOISE_AVX_FUNCTION void Store(float* p, Float v) { _mm256_store_ps(p, v); }
+        static CD_NOISE_AVX_FUNCTION Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+        static CD_NOISE_AVX_FUNCTION Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+        static CD_NOISE_AVX_FUNCTION Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+        static CD_NOISE_AVX_FUNCTION Float Max(Float a, Float b) { return _mm256_max_ps(a, b); }
+        static CD_NOISE_AVX_FUNCTION Float Greater(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+        static CD_NOISE_AVX_FUNCTION Float Select(Float mask, Float a, Float b) { return _mm256_blendv_ps(b, a, mask); }
+    };
+
+    bool IsAVXSupported() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        // CPU supports AVX and OS saves YMM registers on context switch.
+        int cpuInfo[4];
+        __cpuid(cpuInfo, 1);
+        bool hasOSXSAVE = (cpuInfo[2] & (1 << 27)) != 0;
+        bool hasAVX = (cpuInfo[2] & (1 << 28)) != 0;
+        static const bool isSupported = hasOSXSAVE && hasAVX && (_xgetbv(0) & 0x6) == 0x6;
+#else
+        static const bool isSupported = __builtin_cpu_supports("avx");
+#endif
+        return isSupported;
+    }
+#endif
+
+    template<typename T, typename Ops>
+    CD_FORCEINLINE void SimplexNoise2DRowKernel(int64_t seed, T x, T y, T stepX, uint32_t count, float* pOutput, bool normalize) {
+        constexpr uint32_t LanesPerBatch = Ops::Count < 4 ? 4 : Ops::Count;
+        const float scale = normalize ? 0.5f : 1.0f;
+        const float bias = normalize ? 0.5f : 0.0f;
+        NoiseLanes lanes;
+        for (uint32_t index = 0; index < count; index += LanesPerBatch) {
+            uint32_t laneCount = std::min(LanesPerBatch, count - index);
+            SkewLanes<T>(lanes, x, y, stepX, index, laneCount, LanesPerBatch);
+            FetchGradientLanes(lanes, seed, LanesPerBatch);
+            for (uint32_t lane = 0; lane < LanesPerBatch; lane += Ops::Count) {
+                EvaluateLanes<Ops>(lanes, lane, scale, bias);
+            }
+            std::copy(lanes.values, lanes.values + laneCount, pOutput + index);
+        }
+    }
+
+    template<typename T>
+    void SimplexNoise2DRowDefault(int64_t seed, T x, T y, T stepX, uint32_t count, float* pOutput, bool normalize) {
+#ifdef CD_NOISE_X86
+        SimplexNoise2DRowKernel<T, SSEOps>(seed, x, y, stepX, count, pOutput, normalize);
+#else
+        SimplexNoise2DRowKernel<T, ScalarOps>(seed, x, y, stepX, count, pOutput, normalize);
+#endif
+    }
+
+#ifdef CD_NOISE_X86
+    template<typename T>
+    CD_NOISE_AVX_ENTRY void SimplexNoise2DRowAVX(int64_t seed, T x, T y, T stepX, uint32_t count, float* pOutput, bool normalize) {
+        SimplexNoise2DRowKernel<T, AVXOps>(seed, x, y, stepX, count, pOutput, normalize);
+    }
+#endif
+
+    template<typename T>
+    void SimplexNoise2DRowDispatch(int64_t seed, T x, T y, T stepX, uint32_t count, float* pOutput, bool normalize) {
+#ifdef CD_NOISE_X86
+        if (IsAVXSupported()) {
+            SimplexNoise2DRowAVX<T>(seed, x, y, stepX, count, pOutput, normalize);
+            return;
+        }
+#endif
+        SimplexNoise2DRowDefault<T>(seed, x, y, stepX, count, pOutput, normalize);
+    }
+
 }
 
 namespace cd {
@@ -140,4 +365,12 @@ namespace cd {
         return Noise2D_UnskewedBase(seed, xs, ys);
     }
 
+    void NoiseGenerator::SimplexNoise2DRow(int64_t seed, double x, double y, double stepX, uint32_t count, float* pOutput, bool normalize /* = true */) {
+        SimplexNoise2DRowDispatch<double>(seed, x, y, stepX, count, pOutput, normalize);
+    }
+
+    void NoiseGenerator::SimplexNoise2DRow(int64_t seed, float x, float y, float stepX, uint32_t count, float* pOutput, bool normalize /* = true */) {
+        SimplexNoise2DRowDispatch<float>(seed, x, y, stepX, count, pOutput, normalize);
+    }
+
 }	// namespace cdtools
\ No newline at end of file
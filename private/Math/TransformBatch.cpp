@@ -0,0 +1,243 @@
+#include "Math/TransformBatch.h"
+
+#include "Math/SIMD.hpp"
+#include "Utilities/ParallelFor.h"
+
+#include <cassert>
+#include <cfloat>
+#include <vector>
+
+namespace
+{
+
+// Merging is cheap so only large arrays are worth to start threads.
+constexpr std::size_t ParallelMergeBoxCount = 16384U;
+
+CD_FORCEINLINE cd::Vec3f TransformPoint(const cd::Matrix4x4& matrix, const cd::Vec3f& point)
+{
+	cd::Vec4f result = matrix * cd::Vec4f(point.x(), point.y(), point.z(), 1.0f);
+	return cd::Vec3f(result.x(), result.y(), result.z());
+}
+
+cd::AABB MergeAABBRange(std::span<const cd::AABB> boxes)
+{
+	if (boxes.empty())
+	{
+		return cd::AABB::Empty();
+	}
+
+	std::size_t boxIndex = 0U;
+	const std::size_t boxCount = boxes.size();
+	cd::AABB result(FLT_MAX, -FLT_MAX);
+
+#if defined(CD_SIMD_SSE)
+	// Lanes are (minX, minY, minZ, maxX) and (minZ, maxX, maxY, maxZ) in the same way as SIMD::AABBTransform.
+	__m128 resultMin = _mm_set1_ps(FLT_MAX);
+	__m128 resultMax = _mm_set1_ps(-FLT_MAX);
+	for (; boxIndex < boxCount; ++boxIndex)
+	{
+		const float* pInput = boxes[boxIndex].Min().begin();
+		resultMin = _mm_min_ps(resultMin, _mm_loadu_ps(pInput));
+		resultMax = _mm_max_ps(resultMax, _mm_loadu_ps(pInput + 2));
+	}
+
+	float minLanes[4];
+	float maxLanes[4];
+	_mm_storeu_ps(minLanes, resultMin);
+	_mm_storeu_ps(maxLanes, resultMax);
+	result = cd::AABB(cd::Vec3f(minLanes[0], minLanes[1], minLanes[2]), cd::Vec3f(maxLanes[1], maxLanes[2], maxLanes[3]));
+#elif defined(CD_SIMD_NEON)
+	float32x4_t resultMin = vdupq_n_f32(FLT_MAX);
+	float32x4_t resultMax = vdupq_n_f32(-FLT_MAX);
+	for (; boxIndex < boxCount; ++boxIndex)
+	{
+		const float* pInput = boxes[boxIndex].Min().begin();
+		resultMin = vminq_f32(resultMin, vld1q_f32(pInput));
+		resultMax = vmaxq_f32(resultMax, vld1q_f32(pInput + 2));
+	}
+
+	float minLanes[4];
+	float maxLanes[4];
+	vst1q_f32(minLanes, resultMin);
+	vst1q_f32(maxLanes, resultMax);
+	result = cd::AABB(cd::Vec3f(minLanes[0], minLanes[1], minLanes[2]), cd::Vec3f(maxLanes[1], maxLanes[2], maxLanes[3]));
+#endif
+
+	for (; boxIndex < boxCount; ++boxIndex)
+	{
+		result.Merge(boxes[boxIndex]);
+	}
+
+	return result;
+}
+
+}
+
+namespace cd
+{
+
+void TransformBatch::TransformPoints(const Matrix4x4& matrix, std::span<const Vec3f> points, std::span<Vec3f> outPoints)
+{
+	assert(outPoints.size() >= points.size());
+	static_assert(3 * sizeof(float) == sizeof(Vec3f));
+
+	std::size_t pointIndex = 0U;
+	const std::size_t pointCount = points.size();
+
+#if defined(CD_SIMD_SSE)
+	const float* pMatrix = matrix.begin();
+	const __m128 m00 = _mm_set1_ps(pMatrix[0]);
+	const __m128 m10 = _mm_set1_ps(pMatrix[1]);
+	const __m128 m20 = _mm_set1_ps(pMatrix[2]);
+	const __m128 m01 = _mm_set1_ps(pMatrix[4]);
+	const __m128 m11 = _mm_set1_ps(pMatrix[5]);
+	const __m128 m21 = _mm_set1_ps(pMatrix[6]);
+	const __m128 m02 = _mm_set1_ps(pMatrix[8]);
+	const __m128 m12 = _mm_set1_ps(pMatrix[9]);
+	const __m128 m22 = _mm_set1_ps(pMatrix[10]);
+	const __m128 m03 = _mm_set1_ps(pMatrix[12]);
+	const __m128 m13 = _mm_set1_ps(pMatrix[13]);
+	const __m128 m23 = _mm_set1_ps(pMatrix[14]);
+	for (; pointIndex + 4U <= pointCount; pointIndex += 4U)
+	{
+		// (x0, y0, z0, x1), (y1, z1, x2, y2), (z2, x3, y3, z3) to (x0, x1, x2, x3), (y0, y1, y2, y3), (z0, z1, z2, z3).
+		const float* pInput = points[pointIndex].begin();
+		const __m128 v0 = _mm_loadu_ps(pInput);
+		const __m128 v1 = _mm_loadu_ps(pInput + 4);
+		const __m128 v2 = _mm_loadu_ps(pInput + 8);
+		const __m128 x = _mm_shuffle_ps(v0, _mm_shuffle_ps(v1, v2, CD_SIMD_SHUFFLE(2, 2, 1, 1)), CD_SIMD_SHUFFLE(0, 3, 0, 2));
+		const __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, CD_SIMD_SHUFFLE(1, 1, 0, 0)), _mm_shuffle_ps(v1, v2, CD_SIMD_SHUFFLE(3, 3, 2, 2)), CD_SIMD_SHUFFLE(0, 2, 0, 2));
+		const __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, CD_SIMD_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(v2, v2, CD_SIMD_SHUFFLE(0, 0, 3, 3)), CD_SIMD_SHUFFLE(0, 2, 0, 2));
+
+		// Same summation order as Matrix4x4 * Vec4f.
+		const __m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m01, y)), _mm_mul_ps(m02, z)), m03);
+		const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, x), _mm_mul_ps(m11, y)), _mm_mul_ps(m12, z)), m13);
+		const __m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, x), _mm_mul_ps(m21, y)), _mm_mul_ps(m22, z)), m23);
+
+		// Back to interleaved layout.
+		float* pOutput = outPoints[pointIndex].begin();
+		_mm_storeu_ps(pOutput, _mm_shuffle_ps(_mm_shuffle_ps(rx, ry, CD_SIMD_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(rz, rx, CD_SIMD_SHUFFLE(0, 0, 1, 1)), CD_SIMD_SHUFFLE(0, 2, 0, 2)));
+		_mm_storeu_ps(pOutput + 4, _mm_shuffle_ps(_mm_shuffle_ps(ry, rz, CD_SIMD_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(rx, ry, CD_SIMD_SHUFFLE(2, 2, 2, 2)), CD_SIMD_SHUFFLE(0, 2, 0, 2)));
+		_mm_storeu_ps(pOutput + 8, _mm_shuffle_ps(_mm_shuffle_ps(rz, rx, CD_SIMD_SHUFFLE(2, 2, 3, 3)), _mm_shuffle_ps(ry, rz, CD_SIMD_SHUFFLE(3, 3, 3, 3)), CD_SIMD_SHUFFLE(0, 2, 0, 2)));
+	}
+#elif defined(CD_SIMD_NEON)
+	const float* pMatrix = matrix.begin();
+	for (; pointIndex + 4U <= pointCount; pointIndex += 4U)
+	{
+		const float32x4x3_t xyz = vld3q_f32(points[pointIndex].begin());
+		float32x4x3_t result;
+		for (int row = 0; row < 3; ++row)
+		{
+			float32x4_t sum = vmulq_n_f32(xyz.val[0], pMatrix[row]);
+			sum = vaddq_f32(sum, vmulq_n_f32(xyz.val[1], pMatrix[4 + row]));
+			sum = vaddq_f32(sum, vmulq_n_f32(xyz.val[2], pMatrix[8 + row]));
+			result.val[row] = vaddq_f32(sum, vdupq_n_f32(pMatrix[12 + row]));
+		}
+		vst3q_f32(outPoints[pointIndex].begin(), result);
+	}
+#endif
+
+	for (; pointIndex < pointCount; ++pointIndex)
+	{
+		outPoints[pointIndex] = TransformPoint(matrix, points[pointIndex]);
+	}
+}
+
+void TransformBatch::TransformAABBs(const Matrix4x4& matrix, std::span<const AABB> boxes, std::span<AABB> outBoxes)
+{
+	assert(outBoxes.size() >= boxes.size());
+	static_assert(6 * sizeof(float) == sizeof(AABB));
+
+	std::size_t boxIndex = 0U;
+	const std::size_t boxCount = boxes.size();
+
+#if defined(CD_SIMD_SSE)
+	const float* pMatrix = matrix.begin();
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	const __m128 col0 = _mm_loadu_ps(pMatrix);
+	const __m128 col1 = _mm_loadu_ps(pMatrix + 4);
+	const __m128 col2 = _mm_loadu_ps(pMatrix + 8);
+	const __m128 col3 = _mm_loadu_ps(pMatrix + 12);
+	const __m128 absCol0 = _mm_and_ps(col0, absMask);
+	const __m128 absCol1 = _mm_and_ps(col1, absMask);
+	const __m128 absCol2 = _mm_and_ps(col2, absMask);
+	const __m128 half = _mm_set1_ps(0.5f);
+	for (; boxIndex < boxCount; ++boxIndex)
+	{
+		// Both loads stay inside 6 floats of the box. Last lane is unused.
+		const float* pInput = boxes[boxIndex].Min().begin();
+		const __m128 boxMin = _mm_loadu_ps(pInput);
+		const __m128 boxMax = CD_SIMD_SWIZZLE(_mm_loadu_ps(pInput + 2), 1, 2, 3, 3);
+
+		// Center and half extent in the same way as AABB::Transform.
+		const __m128 extent = _mm_mul_ps(_mm_sub_ps(boxMax, boxMin), half);
+		const __m128 center = _mm_add_ps(boxMin, extent);
+
+		__m128 newCenter = _mm_mul_ps(col0, CD_SIMD_SWIZZLE(center, 0, 0, 0, 0));
+		newCenter = _mm_add_ps(newCenter, _mm_mul_ps(col1, CD_SIMD_SWIZZLE(center, 1, 1, 1, 1)));
+		newCenter = _mm_add_ps(newCenter, _mm_mul_ps(col2, CD_SIMD_SWIZZLE(center, 2, 2, 2, 2)));
+		newCenter = _mm_add_ps(newCenter, col3);
+
+		__m128 newExtent = _mm_mul_ps(absCol0, CD_SIMD_SWIZZLE(extent, 0, 0, 0, 0));
+		newExtent = _mm_add_ps(newExtent, _mm_mul_ps(absCol1, CD_SIMD_SWIZZLE(extent, 1, 1, 1, 1)));
+		newExtent = _mm_add_ps(newExtent, _mm_mul_ps(absCol2, CD_SIMD_SWIZZLE(extent, 2, 2, 2, 2)));
+
+		const __m128 newMin = _mm_sub_ps(newCenter, newExtent);
+		const __m128 newMax = _mm_add_ps(newCenter, newExtent);
+
+		// Second store writes (minZ, maxX, maxY, maxZ) over the unused lane of the first one.
+		float* pOutput = outBoxes[boxIndex].Min().begin();
+		_mm_storeu_ps(pOutput, newMin);
+		_mm_storeu_ps(pOutput + 2, _mm_shuffle_ps(_mm_shuffle_ps(newMax, newMin, CD_SIMD_SHUFFLE(0, 0, 2, 2)), newMax, CD_SIMD_SHUFFLE(2, 0, 1, 2)));
+	}
+#endif
+
+	for (; boxIndex < boxCount; ++boxIndex)
+	{
+		outBoxes[boxIndex] = boxes[boxIndex].Transform(matrix);
+	}
+}
+
+void TransformBatch::TransformAABBs(std::span<const Matrix4x4> matrices, std::span<const AABB> boxes, std::span<AABB> outBoxes)
+{
+	assert(matrices.size() == boxes.size());
+	assert(outBoxes.size() >= boxes.size());
+
+	// AABB::Transform goes through SIMD::AABBTransform for float boxes.
+	for (std::size_t boxIndex = 0U; boxIndex < boxes.size(); ++boxIndex)
+	{
+		outBoxes[boxIndex] = boxes[boxIndex].Transform(matrices[boxIndex]);
+	}
+}
+
+AABB TransformBatch::MergeAABBs(std::span<const AABB> boxes, uint32_t maxThreadCount)
+{
+	const std::size_t blockCount = (boxes.size() + ParallelMergeBoxCount - 1U) / ParallelMergeBoxCount;
+	if (blockCount <= 1U)
+	{
+		return MergeAABBRange(boxes);
+	}
+
+	// Min and max don't depend on merge order so results are the same for any thread count.
+	std::vector<AABB> blockBoxes(blockCount);
+	ParallelFor(static_cast<uint32_t>(blockCount), [&boxes, &blockBoxes](uint32_t blockIndex)
+	{
+		const std::size_t blockBegin = blockIndex * ParallelMergeBoxCount;
+		const std::size_t blockSize = std::min(ParallelMergeBoxCount, boxes.size() - blockBegin);
+		blockBoxes[blockIndex] = MergeAABBRange(boxes.subspan(blockBegin, blockSize));
+	}, maxThreadCount);
+
+	return MergeAABBRange(blockBoxes);
+}
+
+void TransformBatch::MultiplyMatrices(const Matrix4x4& lhs, std::span<const Matrix4x4> rhsMatrices, std::span<Matrix4x4> outMatrices)
+{
+	assert(outMatrices.size() >= rhsMatrices.size());
+
+	for (std::size_t matrixIndex = 0U; matrixIndex < rhsMatrices.size(); ++matrixIndex)
+	{
+		outMatrices[matrixIndex] = lhs * rhsMatrices[matrixIndex];
+	}
+}
+
+}
\ No newline at end of file
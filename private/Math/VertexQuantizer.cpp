@@ -0,0 +1,425 @@
+#include "Math/VertexQuantizer.h"
+
+#include "Math/SIMD.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace
+{
+
+using namespace cd;
+
+// Elements are quantized in chunks on the stack before they are scattered to strided outputs.
+constexpr uint32_t ChunkElementCount = 256U;
+constexpr uint32_t MaxComponentCount = 4U;
+
+template<QuantizedValueFormat Format>
+struct QuantizedValueTraits;
+
+template<> struct QuantizedValueTraits<QuantizedValueFormat::Half> { using ValueType = uint16_t; };
+template<> struct QuantizedValueTraits<QuantizedValueFormat::Unorm8> { using ValueType = uint8_t; static constexpr float Low = 0.0f; static constexpr float High = 1.0f; static constexpr float Scale = 255.0f; };
+template<> struct QuantizedValueTraits<QuantizedValueFormat::BiasedUnorm8> { using ValueType = uint8_t; static constexpr float Low = 0.0f; static constexpr float High = 1.0f; static constexpr float Scale = 255.0f; };
+template<> struct QuantizedValueTraits<QuantizedValueFormat::Unorm16> { using ValueType = uint16_t; static constexpr float Low = 0.0f; static constexpr float High = 1.0f; static constexpr float Scale = 65535.0f; };
+template<> struct QuantizedValueTraits<QuantizedValueFormat::Snorm16> { using ValueType = int16_t; static constexpr float Low = -1.0f; static constexpr float High = 1.0f; static constexpr float Scale = 32767.0f; };
+template<> struct QuantizedValueTraits<QuantizedValueFormat::Uint8> { using ValueType = uint8_t; static constexpr float Low = 0.0f; static constexpr float High = 255.0f; static constexpr float Scale = 1.0f; };
+template<> struct QuantizedValueTraits<QuantizedValueFormat::Uint16> { using ValueType = uint16_t; static constexpr float Low = 0.0f; static constexpr float High = 65535.0f; static constexpr float Scale = 1.0f; };
+
+// Scalar kernel. Operations are in the same order as SIMD kernels so results are the same.
+// Clamp takes low bound as first argument of std::max so NaN becomes low bound as _mm_max_ps does.
+template<QuantizedValueFormat Format>
+CD_FORCEINLINE typename QuantizedValueTraits<Format>::ValueType QuantizeValue(float value)
+{
+	using Traits = QuantizedValueTraits<Format>;
+	if constexpr (QuantizedValueFormat::Half == Format)
+	{
+		return VertexQuantizer::FloatToHalf(value);
+	}
+	else
+	{
+		if constexpr (QuantizedValueFormat::BiasedUnorm8 == Format)
+		{
+			value = value * 0.5f + 0.5f;
+		}
+		const float clamped = std::min(std::max(Traits::Low, value), Traits::High);
+		return static_cast<typename Traits::ValueType>(static_cast<int32_t>(std::nearbyint(clamped * Traits::Scale)));
+	}
+}
+
+#if defined(CD_SIMD_SSE)
+CD_FORCEINLINE __m128i Select(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// Same steps as VertexQuantizer::FloatToHalf in four lanes. Results are in low 16 bits of every lane.
+CD_FORCEINLINE __m128i FloatToHalf(__m128 value)
+{
+	const __m128i bits = _mm_castps_si128(value);
+	const __m128i sign = _mm_srli_epi32(_mm_and_si128(bits, _mm_set1_epi32(static_cast<int32_t>(0x80000000U))), 16);
+	const __m128i absBits = _mm_and_si128(bits, _mm_set1_epi32(0x7FFFFFFF));
+
+	const __m128i isNaN = _mm_cmpgt_epi32(absBits, _mm_set1_epi32(0x7F800000));
+	const __m128i infinityOrNaN = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(isNaN, _mm_set1_epi32(0x0200)));
+	const __m128i isOverflow = _mm_cmpgt_epi32(absBits, _mm_set1_epi32(0x477FFFFF));
+	const __m128i isDenormal = _mm_cmplt_epi32(absBits, _mm_set1_epi32(0x38800000));
+
+	const __m128i denormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(absBits), _mm_set1_ps(0.5f))), _mm_set1_epi32(0x3F000000));
+	const __m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(absBits, 13), _mm_set1_epi32(1));
+	const __m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(absBits, _mm_set1_epi32(static_cast<int32_t>(0xC8000FFFU))), mantissaOdd), 13);
+
+	return _mm_or_si128(Select(isOverflow, infinityOrNaN, Select(isDenormal, denormal, normal)), sign);
+}
+
+template<QuantizedValueFormat Format>
+CD_FORCEINLINE void QuantizeFour(const float* pValues, std::byte* pOutput)
+{
+	using Traits = QuantizedValueTraits<Format>;
+	__m128 value = _mm_loadu_ps(pValues);
+	if constexpr (QuantizedValueFormat::Half == Format)
+	{
+		// Sign extension keeps 16 bits patterns through signed saturation.
+		const __m128i halfs = _mm_srai_epi32(_mm_slli_epi32(FloatToHalf(value), 16), 16);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(pOutput), _mm_packs_epi32(halfs, halfs));
+	}
+	else
+	{
+		if constexpr (QuantizedValueFormat::BiasedUnorm8 == Format)
+		{
+			value = _mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(0.5f)), _mm_set1_ps(0.5f));
+		}
+		const __m128 clamped = _mm_min_ps(_mm_max_ps(value, _mm_set1_ps(Traits::Low)), _mm_set1_ps(Traits::High));
+		// Default MXCSR rounding mode is round to nearest even as std::nearbyint.
+		const __m128i integers = _mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(Traits::Scale)));
+		if constexpr (sizeof(typename Traits::ValueType) == 1U)
+		{
+			const __m128i words = _mm_packs_epi32(integers, integers);
+			const int32_t bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+			std::memcpy(pOutput, &bytes, sizeof(bytes));
+		}
+		else if constexpr (std::is_same_v<typename Traits::ValueType, uint16_t>)
+		{
+			const __m128i words = _mm_srai_epi32(_mm_slli_epi32(integers, 16), 16);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(pOutput), _mm_packs_epi32(words, words));
+		}
+		else
+		{
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(pOutput), _mm_packs_epi32(integers, integers));
+		}
+	}
+}
+#elif defined(CD_SIMD_NEON)
+template<QuantizedValueFormat Format>
+CD_FORCEINLINE void QuantizeFour(const float* pValues, std::byte* pOutput)
+{
+	using Traits = QuantizedValueTraits<Format>;
+	float32x4_t value = vld1q_f32(pValues);
+	if constexpr (QuantizedValueFormat::Half == Format)
+	{
+		vst1_u16(reinterpret_cast<uint16_t*>(pOutput), vreinterpret_u16_f16(vcvt_f16_f32(value)));
+	}
+	else
+	{
+		if constexpr (QuantizedValueFormat::BiasedUnorm8 == Format)
+		{
+			value = vaddq_f32(vmulq_n_f32(value, 0.5f), vdupq_n_f32(0.5f));
+		}
+		const float32x4_t clamped = vminq_f32(vmaxq_f32(value, vdupq_n_f32(Traits::Low)), vdupq_n_f32(Traits::High));
+		const int32x4_t integers = vcvtnq_s32_f32(vmulq_n_f32(clamped, Traits::Scale));
+		if constexpr (sizeof(typename Traits::ValueType) == 1U)
+		{
+			const uint16x4_t words = vqmovun_s32(integers);
+			const uint8x8_t bytes = vqmovn_u16(vcombine_u16(words, words));
+			vst1_lane_u32(reinterpret_cast<uint32_t*>(pOutput), vreinterpret_u32_u8(bytes), 0);
+		}
+		else if constexpr (std::is_same_v<typename Traits::ValueType, uint16_t>)
+		{
+			vst1_u16(reinterpret_cast<uint16_t*>(pOutput), vqmovun_s32(integers));
+		}
+		else
+		{
+			vst1_s16(reinterpret_cast<int16_t*>(pOutput), vqmovn_s32(integers));
+		}
+	}
+}
+#endif
+
+template<QuantizedValueFormat Format>
+void QuantizeValues(const float* pValues, std::size_t valueCount, std::byte* pOutput)
+{
+	using ValueType = typename QuantizedValueTraits<Format>::ValueType;
+
+	std::size_t valueIndex = 0U;
+#if defined(CD_SIMD)
+	for (; valueIndex + 4U <= valueCount; valueIndex += 4U)
+	{
+		QuantizeFour<Format>(pValues + valueIndex, pOutput + valueIndex * sizeof(ValueType));
+	}
+#endif
+
+	for (; valueIndex < valueCount; ++valueIndex)
+	{
+		const ValueType value = QuantizeValue<Format>(pValues[valueIndex]);
+		std::memcpy(pOutput + valueIndex * sizeof(ValueType), &value, sizeof(value));
+	}
+}
+
+CD_FORCEINLINE float SignNotZero(float value)
+{
+	return std::copysign(1.0f, value);
+}
+
+CD_FORCEINLINE Vec2f EncodeOctahedral(const Vec3f& direction)
+{
+	const float l1Norm = std::max(std::abs(direction.x()) + std::abs(direction.y()) + std::abs(direction.z()), FLT_MIN);
+	const float invL1Norm = 1.0f / l1Norm;
+	const float x = direction.x() * invL1Norm;
+	const float y = direction.y() * invL1Norm;
+	if (direction.z() < 0.0f)
+	{
+		// Lower hemisphere is folded over the diagonals.
+		return Vec2f((1.0f - std::abs(y)) * SignNotZero(x), (1.0f - std::abs(x)) * SignNotZero(y));
+	}
+	return Vec2f(x, y);
+}
+
+}
+
+namespace cd
+{
+
+uint32_t VertexQuantizer::GetValueSize(QuantizedValueFormat format)
+{
+	switch (format)
+	{
+	case QuantizedValueFormat::Float:
+		return sizeof(float);
+	case QuantizedValueFormat::Half:
+	case QuantizedValueFormat::Unorm16:
+	case QuantizedValueFormat::Snorm16:
+		return sizeof(uint16_t);
+	case QuantizedValueFormat::Uint16:
+		return sizeof(uint16_t);
+	case QuantizedValueFormat::Unorm8:
+	case QuantizedValueFormat::BiasedUnorm8:
+	case QuantizedValueFormat::Uint8:
+		return sizeof(uint8_t);
+	default:
+		assert(false);
+		return 0U;
+	}
+}
+
+void VertexQuantizer::Quantize(QuantizedValueFormat format, std::span<const float> values, std::byte* pOutput)
+{
+	// Specialize kernels by format so the inner loop has no branches.
+	switch (format)
+	{
+	case QuantizedValueFormat::Float:
+		std::memcpy(pOutput, values.data(), values.size_bytes());
+		break;
+	case QuantizedValueFormat::Half:
+		QuantizeValues<QuantizedValueFormat::Half>(values.data(), values.size(), pOutput);
+		break;
+	case QuantizedValueFormat::Unorm8:
+		QuantizeValues<QuantizedValueFormat::Unorm8>(values.data(), values.size(), pOutput);
+		break;
+	case QuantizedValueFormat::BiasedUnorm8:
+		QuantizeValues<QuantizedValueFormat::BiasedUnorm8>(values.data(), values.size(), pOutput);
+		break;
+	case QuantizedValueFormat::Unorm16:
+		QuantizeValues<QuantizedValueFormat::Unorm16>(values.data(), values.size(), pOutput);
+		break;
+	case QuantizedValueFormat::Snorm16:
+		QuantizeValues<QuantizedValueFormat::Snorm16>(values.data(), values.size(), pOutput);
+		break;
+	case QuantizedValueFormat::Uint8:
+		QuantizeValues<QuantizedValueFormat::Uint8>(values.data(), values.size(), pOutput);
+		break;
+	case QuantizedValueFormat::Uint16:
+		QuantizeValues<QuantizedValueFormat::Uint16>(values.data(), values.size(), pOutput);
+		break;
+	default:
+		assert(false);
+	}
+}
+
+void VertexQuantizer::QuantizeStrided(QuantizedValueFormat format, const float* pSource, uint32_t sourceComponentCount, uint32_t elementCount,
+	std::byte* pOutput, uint32_t outputComponentCount, uint32_t outputStride)
+{
+	assert(sourceComponentCount > 0U && outputComponentCount > 0U && outputComponentCount <= MaxComponentCount);
+
+	const uint32_t elementSize = outputComponentCount * GetValueSize(format);
+	assert(outputStride >= elementSize);
+	if (sourceComponentCount == outputComponentCount && outputStride == elementSize)
+	{
+		// Packed output doesn't need to scatter.
+		Quantize(format, std::span<const float>(pSource, static_cast<std::size_t>(elementCount) * sourceComponentCount), pOutput);
+		return;
+	}
+
+	float paddedValues[ChunkElementCount * MaxComponentCount];
+	std::byte quantizedValues[ChunkElementCount * MaxComponentCount * sizeof(float)];
+	const uint32_t copyComponentCount = std::min(sourceComponentCount, outputComponentCount);
+	for (uint32_t chunkBegin = 0U; chunkBegin < elementCount; chunkBegin += ChunkElementCount)
+	{
+		const uint32_t chunkElementCount = std::min(ChunkElementCount, elementCount - chunkBegin);
+		const float* pChunkSource = pSource + static_cast<std::size_t>(chunkBegin) * sourceComponentCount;
+		const float* pValues = pChunkSource;
+		if (sourceComponentCount != outputComponentCount)
+		{
+			std::fill(paddedValues, paddedValues + chunkElementCount * outputComponentCount, 0.0f);
+			for (uint32_t elementIndex = 0U; elementIndex < chunkElementCount; ++elementIndex)
+			{
+				std::memcpy(&paddedValues[elementIndex * outputComponentCount], pChunkSource + elementIndex * sourceComponentCount, copyComponentCount * sizeof(float));
+			}
+			pValues = paddedValues;
+		}
+
+		Quantize(format, std::span<const float>(pValues, chunkElementCount * outputComponentCount), quantizedValues);
+
+		std::byte* pChunkOutput = pOutput + static_cast<std::size_t>(chunkBegin) * outputStride;
+		for (uint32_t elementIndex = 0U; elementIndex < chunkElementCount; ++elementIndex)
+		{
+			std::memcpy(pChunkOutput + static_cast<std::size_t>(elementIndex) * outputStride, &quantizedValues[elementIndex * elementSize], elementSize);
+		}
+	}
+}
+
+void VertexQuantizer::EncodeOctahedral(std::span<const Vec3f> directions, std::span<Vec2f> outValues)
+{
+	assert(outValues.size() >= directions.size());
+	static_assert(3 * sizeof(float) == sizeof(Vec3f) && 2 * sizeof(float) == sizeof(Vec2f));
+
+	std::size_t directionIndex = 0U;
+	const std::size_t directionCount = directions.size();
+
+#if defined(CD_SIMD_SSE)
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int32_t>(0x80000000U)));
+	const __m128 one = _mm_set1_ps(1.0f);
+	for (; directionIndex + 4U <= directionCount; directionIndex += 4U)
+	{
+		// (x0, y0, z0, x1), (y1, z1, x2, y2), (z2, x3, y3, z3) to (x0, x1, x2, x3), (y0, y1, y2, y3), (z0, z1, z2, z3).
+		const float* pInput = directions[directionIndex].begin();
+		const __m128 v0 = _mm_loadu_ps(pInput);
+		const __m128 v1 = _mm_loadu_ps(pInput + 4);
+		const __m128 v2 = _mm_loadu_ps(pInput + 8);
+		const __m128 x = _mm_shuffle_ps(v0, _mm_shuffle_ps(v1, v2, CD_SIMD_SHUFFLE(2, 2, 1, 1)), CD_SIMD_SHUFFLE(0, 3, 0, 2));
+		const __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, CD_SIMD_SHUFFLE(1, 1, 0, 0)), _mm_shuffle_ps(v1, v2, CD_SIMD_SHUFFLE(3, 3, 2, 2)), CD_SIMD_SHUFFLE(0, 2, 0, 2));
+		const __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, CD_SIMD_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(v2, v2, CD_SIMD_SHUFFLE(0, 0, 3, 3)), CD_SIMD_SHUFFLE(0, 2, 0, 2));
+
+		const __m128 l1Norm = _mm_max_ps(_mm_add_ps(_mm_add_ps(_mm_and_ps(x, absMask), _mm_and_ps(y, absMask)), _mm_and_ps(z, absMask)), _mm_set1_ps(FLT_MIN));
+		const __m128 invL1Norm = _mm_div_ps(one, l1Norm);
+		const __m128 octX = _mm_mul_ps(x, invL1Norm);
+		const __m128 octY = _mm_mul_ps(y, invL1Norm);
+		const __m128 foldedX = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(octY, absMask)), _mm_or_ps(_mm_and_ps(octX, signMask), one));
+		const __m128 foldedY = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(octX, absMask)), _mm_or_ps(_mm_and_ps(octY, signMask), one));
+		const __m128 isLowerHemisphere = _mm_cmplt_ps(z, _mm_setzero_ps());
+		const __m128 resultX = _mm_or_ps(_mm_and_ps(isLowerHemisphere, foldedX), _mm_andnot_ps(isLowerHemisphere, octX));
+		const __m128 resultY = _mm_or_ps(_mm_and_ps(isLowerHemisphere, foldedY), _mm_andnot_ps(isLowerHemisphere, octY));
+
+		float* pOutput = outValues[directionIndex].begin();
+		_mm_storeu_ps(pOutput, _mm_unpacklo_ps(resultX, resultY));
+		_mm_storeu_ps(pOutput + 4, _mm_unpackhi_ps(resultX, resultY));
+	}
+#elif defined(CD_SIMD_NEON)
+	const uint32x4_t signMask = vdupq_n_u32(0x80000000U);
+	const float32x4_t one = vdupq_n_f32(1.0f);
+	for (; directionIndex + 4U <= directionCount; directionIndex += 4U)
+	{
+		const float32x4x3_t xyz = vld3q_f32(directions[directionIndex].begin());
+		const float32x4_t l1Norm = vmaxq_f32(vaddq_f32(vaddq_f32(vabsq_f32(xyz.val[0]), vabsq_f32(xyz.val[1])), vabsq_f32(xyz.val[2])), vdupq_n_f32(FLT_MIN));
+		const float32x4_t invL1Norm = vdivq_f32(one, l1Norm);
+		const float32x4_t octX = vmulq_f32(xyz.val[0], invL1Norm);
+		const float32x4_t octY = vmulq_f32(xyz.val[1], invL1Norm);
+		const float32x4_t foldedX = vmulq_f32(vsubq_f32(one, vabsq_f32(octY)), vbslq_f32(signMask, octX, one));
+		const float32x4_t foldedY = vmulq_f32(vsubq_f32(one, vabsq_f32(octX)), vbslq_f32(signMask, octY, one));
+		const uint32x4_t isLowerHemisphere = vcltq_f32(xyz.val[2], vdupq_n_f32(0.0f));
+		float32x4x2_t result;
+		result.val[0] = vbslq_f32(isLowerHemisphere, foldedX, octX);
+		result.val[1] = vbslq_f32(isLowerHemisphere, foldedY, octY);
+		vst2q_f32(outValues[directionIndex].begin(), result);
+	}
+#endif
+
+	for (; directionIndex < directionCount; ++directionIndex)
+	{
+		outValues[directionIndex] = ::EncodeOctahedral(directions[directionIndex]);
+	}
+}
+
+Vec3f VertexQuantizer::DecodeOctahedral(const Vec2f& value)
+{
+	Vec3f direction(value.x(), value.y(), 1.0f - std::abs(value.x()) - std::abs(value.y()));
+	if (direction.z() < 0.0f)
+	{
+		direction.x() = (1.0f - std::abs(value.y())) * SignNotZero(value.x());
+		direction.y() = (1.0f - std::abs(value.x())) * SignNotZero(value.y());
+	}
+	return direction.Normalize();
+}
+
+uint16_t VertexQuantizer::FloatToHalf(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	const uint32_t sign = (bits >> 16U) & 0x8000U;
+	bits &= 0x7FFFFFFFU;
+
+	uint32_t result;
+	if (bits > 0x477FFFFFU)
+	{
+		// Out of half range, infinity or NaN.
+		result = bits > 0x7F800000U ? 0x7E00U : 0x7C00U;
+	}
+	else if (bits < 0x38800000U)
+	{
+		// Half denormal. Float addition rounds the mantissa to nearest even.
+		float denormal;
+		std::memcpy(&denormal, &bits, sizeof(denormal));
+		denormal += 0.5f;
+		std::memcpy(&result, &denormal, sizeof(result));
+		result -= 0x3F000000U;
+	}
+	else
+	{
+		// Rebias exponent and round to nearest even. Carry into exponent rounds up to infinity.
+		result = (bits + 0xC8000FFFU + ((bits >> 13U) & 1U)) >> 13U;
+	}
+
+	return static_cast<uint16_t>(sign | result);
+}
+
+float VertexQuantizer::HalfToFloat(uint16_t value)
+{
+	const uint32_t sign = static_cast<uint32_t>(value & 0x8000U) << 16U;
+	const uint32_t exponent = (value >> 10U) & 0x1FU;
+	const uint32_t mantissa = value & 0x3FFU;
+
+	uint32_t bits;
+	if (0U == exponent)
+	{
+		const float denormal = static_cast<float>(mantissa) * 5.9604644775390625e-8f;
+		std::memcpy(&bits, &denormal, sizeof(bits));
+		bits |= sign;
+	}
+	else if (0x1FU == exponent)
+	{
+		bits = sign | 0x7F800000U | (mantissa << 13U);
+	}
+	else
+	{
+		bits = sign | ((exponent + 112U) << 23U) | (mantissa << 13U);
+	}
+
+	float result;
+	std::memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+}
\ No newline at end of file
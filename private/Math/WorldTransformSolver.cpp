@@ -0,0 +1,116 @@
+#include "Math/WorldTransformSolver.h"
+
+#include "Utilities/ParallelFor.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace
+{
+
+// Small levels are solved on the calling thread as starting threads costs more than multiplying matrices.
+constexpr uint32_t ParallelLevelNodeCount = 4096U;
+constexpr uint32_t ParallelBlockNodeCount = 1024U;
+
+}
+
+namespace cd
+{
+
+void WorldTransformSolver::Solve(std::span<const uint32_t> parentIndices, std::span<const Matrix4x4> localTransforms,
+	std::span<Matrix4x4> worldTransforms, uint32_t maxThreadCount)
+{
+	assert(parentIndices.size() == localTransforms.size());
+	assert(worldTransforms.size() >= localTransforms.size());
+
+	const uint32_t nodeCount = static_cast<uint32_t>(parentIndices.size());
+	if (0U == nodeCount)
+	{
+		return;
+	}
+
+	// Child lists in compressed layout : children of node i are childIndices[childOffsets[i], childOffsets[i + 1]).
+	std::vector<uint32_t> childOffsets(nodeCount + 1U, 0U);
+	for (uint32_t nodeIndex = 0U; nodeIndex < nodeCount; ++nodeIndex)
+	{
+		uint32_t parentIndex = parentIndices[nodeIndex];
+		if (InvalidParentIndex != parentIndex)
+		{
+			assert(parentIndex < nodeCount);
+			++childOffsets[parentIndex + 1U];
+		}
+	}
+
+	for (uint32_t nodeIndex = 0U; nodeIndex < nodeCount; ++nodeIndex)
+	{
+		childOffsets[nodeIndex + 1U] += childOffsets[nodeIndex];
+	}
+
+	std::vector<uint32_t> childIndices(childOffsets[nodeCount]);
+	std::vector<uint32_t> childCursors(childOffsets.begin(), childOffsets.end() - 1);
+	for (uint32_t nodeIndex = 0U; nodeIndex < nodeCount; ++nodeIndex)
+	{
+		uint32_t parentIndex = parentIndices[nodeIndex];
+		if (InvalidParentIndex != parentIndex)
+		{
+			childIndices[childCursors[parentIndex]++] = nodeIndex;
+		}
+	}
+
+	// Breadth first order. Nodes in [levelOffsets[i], levelOffsets[i + 1]) have depth i.
+	std::vector<uint32_t> sortedNodeIndices;
+	sortedNodeIndices.reserve(nodeCount);
+	for (uint32_t nodeIndex = 0U; nodeIndex < nodeCount; ++nodeIndex)
+	{
+		if (InvalidParentIndex == parentIndices[nodeIndex])
+		{
+			sortedNodeIndices.push_back(nodeIndex);
+		}
+	}
+
+	std::vector<uint32_t> levelOffsets{ 0U, static_cast<uint32_t>(sortedNodeIndices.size()) };
+	for (std::size_t levelIndex = 0U; levelOffsets[levelIndex] < levelOffsets[levelIndex + 1U]; ++levelIndex)
+	{
+		for (uint32_t sortedIndex = levelOffsets[levelIndex]; sortedIndex < levelOffsets[levelIndex + 1U]; ++sortedIndex)
+		{
+			uint32_t nodeIndex = sortedNodeIndices[sortedIndex];
+			sortedNodeIndices.insert(sortedNodeIndices.end(), childIndices.begin() + childOffsets[nodeIndex], childIndices.begin() + childOffsets[nodeIndex + 1U]);
+		}
+		levelOffsets.push_back(static_cast<uint32_t>(sortedNodeIndices.size()));
+	}
+
+	// Nodes in cycles are unreachable from roots.
+	assert(sortedNodeIndices.size() == nodeCount);
+
+	auto SolveNodes = [&](uint32_t beginIndex, uint32_t endIndex)
+	{
+		for (uint32_t sortedIndex = beginIndex; sortedIndex < endIndex; ++sortedIndex)
+		{
+			uint32_t nodeIndex = sortedNodeIndices[sortedIndex];
+			uint32_t parentIndex = parentIndices[nodeIndex];
+			worldTransforms[nodeIndex] = InvalidParentIndex == parentIndex ? localTransforms[nodeIndex] : worldTransforms[parentIndex] * localTransforms[nodeIndex];
+		}
+	};
+
+	for (std::size_t levelIndex = 0U; levelIndex + 1U < levelOffsets.size(); ++levelIndex)
+	{
+		uint32_t levelBegin = levelOffsets[levelIndex];
+		uint32_t levelEnd = levelOffsets[levelIndex + 1U];
+		uint32_t levelNodeCount = levelEnd - levelBegin;
+		if (levelNodeCount < ParallelLevelNodeCount)
+		{
+			SolveNodes(levelBegin, levelEnd);
+			continue;
+		}
+
+		uint32_t blockCount = (levelNodeCount + ParallelBlockNodeCount - 1U) / ParallelBlockNodeCount;
+		ParallelFor(blockCount, [&](uint32_t blockIndex)
+		{
+			uint32_t blockBegin = levelBegin + blockIndex * ParallelBlockNodeCount;
+			SolveNodes(blockBegin, std::min(blockBegin + ParallelBlockNodeCount, levelEnd));
+		}, maxThreadCount);
+	}
+}
+
+}
\ No newline at end of file
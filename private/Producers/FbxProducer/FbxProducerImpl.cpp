@@ -1443,12 +1443,10 @@ cd::SkinID FbxProducerImpl::ImportSkin(const fbxsdk::FbxSkin* pSkin, const cd::M
 	assert(pSkin);
 	assert(fbxsdk::FbxSkin::eLinear == pSkin->GetSkinningType() || fbxsdk::FbxSkin::eRigid == pSkin->GetSkinningType());
 
-	cd::SkinID skinID = m_skinIDGenerator.AllocateID();
 	uint32_t influenceBoneCount = pSkin->GetClusterCount();
 	uint32_t meshVertexCount = sourceMesh.GetVertexPositionCount();
 
 	cd::Skin skin;
-	skin.SetID(skinID);
 	skin.SetMeshID(sourceMesh.GetID());
 	skin.SetName(pSkin->GetName());
 	skin.SetVertexBoneNameArrayCount(meshVertexCount);
@@ -1499,23 +1497,20 @@ cd::SkinID FbxProducerImpl::ImportSkin(const fbxsdk::FbxSkin* pSkin, const cd::M
 		}
 	}
 
-	uint32_t maxVertexInfluenceCount = 0U;
-	for (uint32_t vertexIndex = 0U; vertexIndex < meshVertexCount; ++vertexIndex)
-	{
-		uint32_t arraySize = static_cast<uint32_t>(skin.GetVertexBoneNameArray(vertexIndex).size());
-		if (arraySize > maxVertexInfluenceCount)
-		{
-			maxVertexInfluenceCount = arraySize;
-		}
-	}
-	skin.SetMaxVertexInfluenceCount(maxVertexInfluenceCount);
+	// Bone names are resolved to influence bone indices once here so that building skinned vertex buffers is a linear copy.
+	skin.BuildVertexInfluences();
 
-	if (skin.GetInfluenceBoneNameCount() > 0U)
+	if (0U == skin.GetInfluenceBoneNameCount())
 	{
-		pSceneDatabase->AddSkin(cd::MoveTemp(skin));
+		return cd::SkinID::InvalidID;
 	}
-	
-	return cd::SkinID::InvalidID;
+
+	// Skin id is allocated only for added skins so that it stays the same as the index in SceneDatabase.
+	cd::SkinID skinID = m_skinIDGenerator.AllocateID();
+	skin.SetID(skinID);
+	pSceneDatabase->AddSkin(cd::MoveTemp(skin));
+
+	return skinID;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,394 @@
+#include "GltfJson.h"
+
+#include <charconv>
+
+namespace cdtools
+{
+
+namespace
+{
+
+// Values are parsed recursively. Deeper documents are rejected instead of overflowing the stack.
+constexpr uint32_t MaxValueDepth = 128U;
+
+bool IsSurrogate(uint32_t codeUnit, uint32_t firstCodeUnit)
+{
+	return codeUnit >= firstCodeUnit && codeUnit < firstCodeUnit + 0x400U;
+}
+
+void SkipWhitespace(std::string_view text, std::size_t& position)
+{
+	while (position < text.size() && (' ' == text[position] || '\n' == text[position] || '\r' == text[position] || '\t' == text[position]))
+	{
+		++position;
+	}
+}
+
+// Reads the 4 hex digits of an \u escape. Returns false if there are fewer hex digits.
+bool ParseHexDigits(std::string_view text, uint32_t& outValue)
+{
+	if (text.size() < 4U)
+	{
+		return false;
+	}
+
+	auto [pEnd, errorCode] = std::from_chars(text.data(), text.data() + 4U, outValue, 16);
+	return errorCode == std::errc() && pEnd == text.data() + 4U;
+}
+
+void AppendUTF8(std::string& output, uint32_t codePoint)
+{
+	if (codePoint < 0x80U)
+	{
+		output.push_back(static_cast<char>(codePoint));
+	}
+	else if (codePoint < 0x800U)
+	{
+		output.push_back(static_cast<char>(0xC0U | (codePoint >> 6U)));
+		output.push_back(static_cast<char>(0x80U | (codePoint & 0x3FU)));
+	}
+	else if (codePoint < 0x10000U)
+	{
+		output.push_back(static_cast<char>(0xE0U | (codePoint >> 12U)));
+		output.push_back(static_cast<char>(0x80U | ((codePoint >> 6U) & 0x3FU)));
+		output.push_back(static_cast<char>(0x80U | (codePoint & 0x3FU)));
+	}
+	else
+	{
+		output.push_back(static_cast<char>(0xF0U | (codePoint >> 18U)));
+		output.push_back(static_cast<char>(0x80U | ((codePoint >> 12U) & 0x3FU)));
+		output.push_back(static_cast<char>(0x80U | ((codePoint >> 6U) & 0x3FU)));
+		output.push_back(static_cast<char>(0x80U | (codePoint & 0x3FU)));
+	}
+}
+
+}
+
+bool JsonDocument::Parse(std::string_view text)
+{
+	m_values.clear();
+
+	// Average glTF value takes more than 8 characters so it is enough to avoid most reallocations.
+	m_values.reserve(text.size() / 8U);
+
+	// Only whitespace can follow the root value.
+	std::size_t position = 0U;
+	bool succeeded = ParseValue(text, position, 0U);
+	SkipWhitespace(text, position);
+	if (!succeeded || position != text.size())
+	{
+		m_values.clear();
+		return false;
+	}
+
+	return true;
+}
+
+JsonView JsonDocument::GetRoot() const
+{
+	return m_values.empty() ? JsonView() : JsonView(this, 0U);
+}
+
+bool JsonDocument::ParseString(std::string_view text, std::size_t& position)
+{
+	// position is at the opening quote. Escapes are decoded by JsonView::GetString, \u escapes are validated here
+	// so that surrogates are always a high half followed by a low half.
+	const std::size_t begin = ++position;
+	while (position < text.size() && text[position] != '"')
+	{
+		if (text[position] != '\\' || position + 1U >= text.size() || text[position + 1U] != 'u')
+		{
+			position += '\\' == text[position] ? 2U : 1U;
+			continue;
+		}
+
+		uint32_t codeUnit = 0U;
+		if (!ParseHexDigits(text.substr(position + 2U), codeUnit) || IsSurrogate(codeUnit, 0xDC00U))
+		{
+			return false;
+		}
+		position += 6U;
+
+		if (IsSurrogate(codeUnit, 0xD800U))
+		{
+			uint32_t lowSurrogate = 0U;
+			if (text.compare(position, 2U, "\\u") != 0 || !ParseHexDigits(text.substr(position + 2U), lowSurrogate) || !IsSurrogate(lowSurrogate, 0xDC00U))
+			{
+				return false;
+			}
+			position += 6U;
+		}
+	}
+
+	if (position >= text.size())
+	{
+		return false;
+	}
+
+	JsonValue& value = m_values.emplace_back();
+	value.type = JsonType::String;
+	value.text = text.substr(begin, position - begin);
+	value.endIndex = static_cast<uint32_t>(m_values.size());
+	++position;
+
+	return true;
+}
+
+bool JsonDocument::ParseValue(std::string_view text, std::size_t& position, uint32_t depth)
+{
+	SkipWhitespace(text, position);
+	if (position >= text.size() || depth >= MaxValueDepth)
+	{
+		return false;
+	}
+
+	const char firstChar = text[position];
+	if ('"' == firstChar)
+	{
+		return ParseString(text, position);
+	}
+
+	if ('{' == firstChar || '[' == firstChar)
+	{
+		const bool isObject = '{' == firstChar;
+		const char endChar = isObject ? '}' : ']';
+
+		// Index instead of reference as children may reallocate values.
+		const uint32_t valueIndex = static_cast<uint32_t>(m_values.size());
+		m_values.emplace_back().type = isObject ? JsonType::Object : JsonType::Array;
+		++position;
+
+		uint32_t childCount = 0U;
+		SkipWhitespace(text, position);
+		if (position < text.size() && endChar == text[position])
+		{
+			++position;
+		}
+		else
+		{
+			while (true)
+			{
+				if (isObject)
+				{
+					SkipWhitespace(text, position);
+					if (position >= text.size() || text[position] != '"' || !ParseString(text, position))
+					{
+						return false;
+					}
+
+					SkipWhitespace(text, position);
+					if (position >= text.size() || text[position] != ':')
+					{
+						return false;
+					}
+					++position;
+				}
+
+				if (!ParseValue(text, position, depth + 1U))
+				{
+					return false;
+				}
+				++childCount;
+
+				SkipWhitespace(text, position);
+				if (position >= text.size())
+				{
+					return false;
+				}
+
+				if (',' == text[position])
+				{
+					++position;
+				}
+				else if (endChar == text[position])
+				{
+					++position;
+					break;
+				}
+				else
+				{
+					return false;
+				}
+			}
+		}
+
+		m_values[valueIndex].childCount = childCount;
+		m_values[valueIndex].endIndex = static_cast<uint32_t>(m_values.size());
+		return true;
+	}
+
+	JsonValue value;
+	if (text.compare(position, 4U, "true") == 0)
+	{
+		value.type = JsonType::Boolean;
+		value.boolean = true;
+		position += 4U;
+	}
+	else if (text.compare(position, 5U, "false") == 0)
+	{
+		value.type = JsonType::Boolean;
+		position += 5U;
+	}
+	else if (text.compare(position, 4U, "null") == 0)
+	{
+		position += 4U;
+	}
+	else
+	{
+		const char* pBegin = text.data() + position;
+		auto [pEnd, errorCode] = std::from_chars(pBegin, text.data() + text.size(), value.number);
+		if (errorCode != std::errc())
+		{
+			return false;
+		}
+
+		value.type = JsonType::Number;
+		position += static_cast<std::size_t>(pEnd - pBegin);
+	}
+
+	value.endIndex = static_cast<uint32_t>(m_values.size() + 1U);
+	m_values.push_back(value);
+
+	return true;
+}
+
+uint32_t JsonView::GetCount() const
+{
+	return IsObject() || IsArray() ? GetValue().childCount : 0U;
+}
+
+JsonView JsonView::Get(std::string_view key) const
+{
+	JsonView result;
+	ForEachMember([&result, key](std::string_view memberKey, JsonView memberValue)
+	{
+		if (!result.IsValid() && memberKey == key)
+		{
+			result = memberValue;
+		}
+	});
+
+	return result;
+}
+
+std::vector<JsonView> JsonView::GetElements() const
+{
+	std::vector<JsonView> elements;
+	if (IsArray())
+	{
+		elements.reserve(GetValue().childCount);
+		for (uint32_t elementIndex = m_index + 1U; elementIndex < GetValue().endIndex; elementIndex = m_pDocument->GetValue(elementIndex).endIndex)
+		{
+			elements.emplace_back(m_pDocument, elementIndex);
+		}
+	}
+	else if (IsObject())
+	{
+		elements.reserve(GetValue().childCount);
+		ForEachMember([&elements](std::string_view, JsonView memberValue)
+		{
+			elements.push_back(memberValue);
+		});
+	}
+
+	return elements;
+}
+
+bool JsonView::GetBool(bool defaultValue) const
+{
+	return JsonType::Boolean == GetType() ? GetValue().boolean : defaultValue;
+}
+
+double JsonView::GetNumber(double defaultValue) const
+{
+	return JsonType::Number == GetType() ? GetValue().number : defaultValue;
+}
+
+uint32_t JsonView::GetUInt(uint32_t defaultValue) const
+{
+	return JsonType::Number == GetType() && GetValue().number >= 0.0 ? static_cast<uint32_t>(GetValue().number) : defaultValue;
+}
+
+std::string JsonView::GetString(std::string_view defaultValue) const
+{
+	if (GetType() != JsonType::String)
+	{
+		return std::string(defaultValue);
+	}
+
+	std::string_view rawText = GetValue().text;
+	if (std::string_view::npos == rawText.find('\\'))
+	{
+		return std::string(rawText);
+	}
+
+	std::string result;
+	result.reserve(rawText.size());
+	for (std::size_t charIndex = 0U; charIndex < rawText.size(); ++charIndex)
+	{
+		if (rawText[charIndex] != '\\' || charIndex + 1U >= rawText.size())
+		{
+			result.push_back(rawText[charIndex]);
+			continue;
+		}
+
+		const char escapeChar = rawText[++charIndex];
+		switch (escapeChar)
+		{
+		case 'b':
+			result.push_back('\b');
+			break;
+		case 'f':
+			result.push_back('\f');
+			break;
+		case 'n':
+			result.push_back('\n');
+			break;
+		case 'r':
+			result.push_back('\r');
+			break;
+		case 't':
+			result.push_back('\t');
+			break;
+		case 'u':
+		{
+			// Surrogate pairs are validated by JsonDocument::ParseString.
+			uint32_t codePoint = 0U;
+			ParseHexDigits(rawText.substr(charIndex + 1U), codePoint);
+			charIndex += 4U;
+			if (IsSurrogate(codePoint, 0xD800U))
+			{
+				uint32_t lowSurrogate = 0U;
+				ParseHexDigits(rawText.substr(charIndex + 3U), lowSurrogate);
+				codePoint = 0x10000U + ((codePoint - 0xD800U) << 10U) + (lowSurrogate - 0xDC00U);
+				charIndex += 6U;
+			}
+			AppendUTF8(result, codePoint);
+			break;
+		}
+		default:
+			result.push_back(escapeChar);
+			break;
+		}
+	}
+
+	return result;
+}
+
+uint32_t JsonView::GetFloats(float* pOutput, uint32_t count) const
+{
+	if (!IsArray())
+	{
+		return 0U;
+	}
+
+	uint32_t readCount = 0U;
+	for (uint32_t elementIndex = m_index + 1U; elementIndex < GetValue().endIndex && readCount < count; elementIndex = m_pDocument->GetValue(elementIndex).endIndex)
+	{
+		pOutput[readCount++] = static_cast<float>(m_pDocument->GetValue(elementIndex).number);
+	}
+
+	return readCount;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cdtools
+{
+
+enum class JsonType : uint8_t
+{
+	Null,
+	Boolean,
+	Number,
+	String,
+	Array,
+	Object
+};
+
+struct JsonValue
+{
+	JsonType type = JsonType::Null;
+	bool boolean = false;
+	uint32_t childCount = 0U;
+	// One past the last value of the subtree so that siblings are reached without walking children.
+	uint32_t endIndex = 0U;
+	double number = 0.0;
+	// Raw string contents which still have escape sequences.
+	std::string_view text;
+};
+
+class JsonView;
+
+// Flat JSON DOM built in one pass. Values are stored in document order and every object member is a key string
+// followed by its value. Strings are views into the source text which needs to outlive the document.
+class JsonDocument final
+{
+public:
+	JsonDocument() = default;
+	JsonDocument(const JsonDocument&) = delete;
+	JsonDocument& operator=(const JsonDocument&) = delete;
+	JsonDocument(JsonDocument&&) = default;
+	JsonDocument& operator=(JsonDocument&&) = default;
+	~JsonDocument() = default;
+
+	bool Parse(std::string_view text);
+
+	JsonView GetRoot() const;
+	const JsonValue& GetValue(uint32_t index) const { return m_values[index]; }
+
+private:
+	bool ParseValue(std::string_view text, std::size_t& position, uint32_t depth);
+	bool ParseString(std::string_view text, std::size_t& position);
+
+private:
+	std::vector<JsonValue> m_values;
+};
+
+// Lightweight handle to a value in JsonDocument. Missing members and wrong types return default values.
+class JsonView final
+{
+public:
+	JsonView() = default;
+	explicit JsonView(const JsonDocument* pDocument, uint32_t index) : m_pDocument(pDocument), m_index(index) {}
+	JsonView(const JsonView&) = default;
+	JsonView& operator=(const JsonView&) = default;
+	JsonView(JsonView&&) = default;
+	JsonView& operator=(JsonView&&) = default;
+	~JsonView() = default;
+
+	bool IsValid() const { return m_pDocument != nullptr; }
+	JsonType GetType() const { return IsValid() ? GetValue().type : JsonType::Null; }
+	bool IsObject() const { return JsonType::Object == GetType(); }
+	bool IsArray() const { return JsonType::Array == GetType(); }
+	uint32_t GetCount() const;
+
+	JsonView Get(std::string_view key) const;
+	JsonView operator[](std::string_view key) const { return Get(key); }
+	bool Contains(std::string_view key) const { return Get(key).IsValid(); }
+
+	// Elements of an array or member values of an object. Indexing an array repeatedly should go through it.
+	std::vector<JsonView> GetElements() const;
+
+	template<typename Func>
+	void ForEachMember(Func&& func) const
+	{
+		if (!IsObject())
+		{
+			return;
+		}
+
+		for (uint32_t keyIndex = m_index + 1U; keyIndex < GetValue().endIndex; keyIndex = m_pDocument->GetValue(keyIndex + 1U).endIndex)
+		{
+			func(m_pDocument->GetValue(keyIndex).text, JsonView(m_pDocument, keyIndex + 1U));
+		}
+	}
+
+	bool GetBool(bool defaultValue = false) const;
+	double GetNumber(double defaultValue = 0.0) const;
+	float GetFloat(float defaultValue = 0.0f) const { return static_cast<float>(GetNumber(defaultValue)); }
+	uint32_t GetUInt(uint32_t defaultValue = 0U) const;
+	std::string GetString(std::string_view defaultValue = {}) const;
+
+	// Reads up to count numbers of an array. Returns the count of read numbers.
+	uint32_t GetFloats(float* pOutput, uint32_t count) const;
+
+private:
+	const JsonValue& GetValue() const { return m_pDocument->GetValue(m_index); }
+
+private:
+	const JsonDocument* m_pDocument = nullptr;
+	uint32_t m_index = 0U;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#include "Producers/GltfProducer/GltfProducer.h"
+#include "GltfProducerImpl.h"
+
+namespace cdtools
+{
+
+GltfProducer::GltfProducer(const char* pFilePath)
+{
+	m_pGltfProducerImpl = new GltfProducerImpl(pFilePath);
+}
+
+GltfProducer::~GltfProducer()
+{
+	if (m_pGltfProducerImpl)
+	{
+		delete m_pGltfProducerImpl;
+		m_pGltfProducerImpl = nullptr;
+	}
+}
+
+void GltfProducer::Execute(cd::SceneDatabase* pSceneDatabase)
+{
+	m_pGltfProducerImpl->Execute(pSceneDatabase);
+}
+
+void GltfProducer::EnableOption(GltfProducerOptions option)
+{
+	m_pGltfProducerImpl->GetOptions().Enable(option);
+}
+
+void GltfProducer::DisableOption(GltfProducerOptions option)
+{
+	m_pGltfProducerImpl->GetOptions().Disable(option);
+}
+
+bool GltfProducer::IsOptionEnabled(GltfProducerOptions option) const
+{
+	return m_pGltfProducerImpl->GetOptions().IsEnabled(option);
+}
+
+}
\ No newline at end of file
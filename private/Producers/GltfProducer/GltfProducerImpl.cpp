@@ -0,0 +1,1415 @@
+#include "GltfProducerImpl.h"
+
+#include "Math/Transform.hpp"
+#include "Scene/SceneDatabase.h"
+#include "Scene/VertexFormat.h"
+#include "Utilities/ParallelFor.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+#include <optional>
+#include <unordered_map>
+
+namespace
+{
+
+constexpr uint32_t InvalidIndex = 0xFFFFFFFFU;
+
+// GLB header and chunk types.
+constexpr uint32_t GlbMagic = 0x46546C67U;
+constexpr uint32_t GlbHeaderSize = 12U;
+constexpr uint32_t GlbChunkTypeJson = 0x4E4F534AU;
+constexpr uint32_t GlbChunkTypeBin = 0x004E4942U;
+
+// Accessor component types.
+constexpr uint32_t ComponentTypeByte = 5120U;
+constexpr uint32_t ComponentTypeUnsignedByte = 5121U;
+constexpr uint32_t ComponentTypeShort = 5122U;
+constexpr uint32_t ComponentTypeUnsignedShort = 5123U;
+constexpr uint32_t ComponentTypeUnsignedInt = 5125U;
+constexpr uint32_t ComponentTypeFloat = 5126U;
+
+// Primitive modes.
+constexpr uint32_t PrimitiveModeTriangles = 4U;
+constexpr uint32_t PrimitiveModeTriangleStrip = 5U;
+constexpr uint32_t PrimitiveModeTriangleFan = 6U;
+
+// Sampler wrap modes.
+constexpr uint32_t WrapModeClampToEdge = 33071U;
+constexpr uint32_t WrapModeMirroredRepeat = 33648U;
+
+uint32_t GetComponentSize(uint32_t componentType)
+{
+	switch (componentType)
+	{
+	case ComponentTypeByte:
+	case ComponentTypeUnsignedByte:
+		return 1U;
+	case ComponentTypeShort:
+	case ComponentTypeUnsignedShort:
+		return 2U;
+	case ComponentTypeUnsignedInt:
+	case ComponentTypeFloat:
+		return 4U;
+	default:
+		return 0U;
+	}
+}
+
+uint32_t GetComponentCount(std::string_view accessorType)
+{
+	if ("SCALAR" == accessorType)
+	{
+		return 1U;
+	}
+	else if ("VEC2" == accessorType)
+	{
+		return 2U;
+	}
+	else if ("VEC3" == accessorType)
+	{
+		return 3U;
+	}
+	else if ("VEC4" == accessorType || "MAT2" == accessorType)
+	{
+		return 4U;
+	}
+	else if ("MAT3" == accessorType)
+	{
+		return 9U;
+	}
+	else if ("MAT4" == accessorType)
+	{
+		return 16U;
+	}
+
+	return 0U;
+}
+
+template<typename T>
+T ReadValue(const std::byte* pData)
+{
+	T value;
+	std::memcpy(&value, pData, sizeof(T));
+	return value;
+}
+
+float ReadComponent(const std::byte* pData, uint32_t componentType, bool normalized)
+{
+	switch (componentType)
+	{
+	case ComponentTypeFloat:
+		return ReadValue<float>(pData);
+	case ComponentTypeUnsignedByte:
+		return normalized ? static_cast<float>(ReadValue<uint8_t>(pData)) / 255.0f : static_cast<float>(ReadValue<uint8_t>(pData));
+	case ComponentTypeByte:
+		return normalized ? std::max(static_cast<float>(ReadValue<int8_t>(pData)) / 127.0f, -1.0f) : static_cast<float>(ReadValue<int8_t>(pData));
+	case ComponentTypeUnsignedShort:
+		return normalized ? static_cast<float>(ReadValue<uint16_t>(pData)) / 65535.0f : static_cast<float>(ReadValue<uint16_t>(pData));
+	case ComponentTypeShort:
+		return normalized ? std::max(static_cast<float>(ReadValue<int16_t>(pData)) / 32767.0f, -1.0f) : static_cast<float>(ReadValue<int16_t>(pData));
+	case ComponentTypeUnsignedInt:
+		return static_cast<float>(ReadValue<uint32_t>(pData));
+	default:
+		return 0.0f;
+	}
+}
+
+uint32_t ReadUnsignedComponent(const std::byte* pData, uint32_t componentType)
+{
+	switch (componentType)
+	{
+	case ComponentTypeUnsignedByte:
+		return ReadValue<uint8_t>(pData);
+	case ComponentTypeUnsignedShort:
+		return ReadValue<uint16_t>(pData);
+	case ComponentTypeUnsignedInt:
+		return ReadValue<uint32_t>(pData);
+	default:
+		return InvalidIndex;
+	}
+}
+
+// Reads accessor.count elements to outputComponentCount floats per element which pOutput needs room for.
+// Extra output components keep their values.
+void ReadFloats(const cdtools::GltfAccessor& accessor, float* pOutput, uint32_t outputComponentCount)
+{
+	if (nullptr == accessor.pData || 0U == accessor.count)
+	{
+		return;
+	}
+
+	if (ComponentTypeFloat == accessor.componentType && accessor.componentCount == outputComponentCount &&
+		accessor.byteStride == outputComponentCount * sizeof(float))
+	{
+		// Tightly packed float data has the same layout as attribute vectors so it is adopted by one copy.
+		std::memcpy(pOutput, accessor.pData, static_cast<std::size_t>(accessor.count) * outputComponentCount * sizeof(float));
+		return;
+	}
+
+	const uint32_t componentSize = GetComponentSize(accessor.componentType);
+	const uint32_t componentCount = std::min(accessor.componentCount, outputComponentCount);
+	for (uint32_t elementIndex = 0U; elementIndex < accessor.count; ++elementIndex)
+	{
+		const std::byte* pElement = accessor.pData + static_cast<std::size_t>(elementIndex) * accessor.byteStride;
+		float* pElementOutput = pOutput + static_cast<std::size_t>(elementIndex) * outputComponentCount;
+		for (uint32_t componentIndex = 0U; componentIndex < componentCount; ++componentIndex)
+		{
+			pElementOutput[componentIndex] = ReadComponent(pElement + componentIndex * componentSize, accessor.componentType, accessor.normalized);
+		}
+	}
+}
+
+// Reads all components of unsigned integer accessors such as indices and joints.
+void ReadUnsignedInts(const cdtools::GltfAccessor& accessor, uint32_t* pOutput)
+{
+	if (0U == accessor.count)
+	{
+		return;
+	}
+
+	if (nullptr == accessor.pData)
+	{
+		std::fill(pOutput, pOutput + static_cast<std::size_t>(accessor.count) * accessor.componentCount, 0U);
+		return;
+	}
+
+	if (ComponentTypeUnsignedInt == accessor.componentType && accessor.byteStride == accessor.componentCount * sizeof(uint32_t))
+	{
+		std::memcpy(pOutput, accessor.pData, static_cast<std::size_t>(accessor.count) * accessor.componentCount * sizeof(uint32_t));
+		return;
+	}
+
+	const uint32_t componentSize = GetComponentSize(accessor.componentType);
+	for (uint32_t elementIndex = 0U; elementIndex < accessor.count; ++elementIndex)
+	{
+		const std::byte* pElement = accessor.pData + static_cast<std::size_t>(elementIndex) * accessor.byteStride;
+		for (uint32_t componentIndex = 0U; componentIndex < accessor.componentCount; ++componentIndex)
+		{
+			*pOutput++ = ReadUnsignedComponent(pElement + componentIndex * componentSize, accessor.componentType);
+		}
+	}
+}
+
+template<typename T>
+float* GetFloatData(std::vector<T>& values)
+{
+	static_assert(sizeof(T) == T::Size * sizeof(float));
+	return reinterpret_cast<float*>(values.data());
+}
+
+std::vector<std::byte> DecodeBase64(std::string_view text)
+{
+	auto DecodeChar = [](char c) -> int
+	{
+		if (c >= 'A' && c <= 'Z') return c - 'A';
+		if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+		if (c >= '0' && c <= '9') return c - '0' + 52;
+		if ('+' == c || '-' == c) return 62;
+		if ('/' == c || '_' == c) return 63;
+		return -1;
+	};
+
+	std::vector<std::byte> result;
+	result.reserve(text.size() * 3U / 4U);
+
+	uint32_t bits = 0U;
+	int bitCount = 0;
+	for (char c : text)
+	{
+		int value = DecodeChar(c);
+		if (value < 0)
+		{
+			continue;
+		}
+
+		bits = (bits << 6U) | static_cast<uint32_t>(value);
+		bitCount += 6;
+		if (bitCount >= 8)
+		{
+			bitCount -= 8;
+			result.push_back(static_cast<std::byte>((bits >> bitCount) & 0xFFU));
+		}
+	}
+
+	return result;
+}
+
+// Uris of external files are percent encoded. Returns nothing if an escape isn't followed by two hex digits.
+std::optional<std::string> DecodeUri(std::string_view uri)
+{
+	auto DecodeHexDigit = [](char c) -> int
+	{
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		return -1;
+	};
+
+	std::string result;
+	result.reserve(uri.size());
+	for (std::size_t charIndex = 0U; charIndex < uri.size(); ++charIndex)
+	{
+		if ('%' != uri[charIndex])
+		{
+			result.push_back(uri[charIndex]);
+			continue;
+		}
+
+		const int highDigit = charIndex + 1U < uri.size() ? DecodeHexDigit(uri[charIndex + 1U]) : -1;
+		const int lowDigit = charIndex + 2U < uri.size() ? DecodeHexDigit(uri[charIndex + 2U]) : -1;
+		if (highDigit < 0 || lowDigit < 0)
+		{
+			return std::nullopt;
+		}
+
+		result.push_back(static_cast<char>(highDigit * 16 + lowDigit));
+		charIndex += 2U;
+	}
+
+	return result;
+}
+
+std::vector<std::byte> DecodeDataUri(std::string_view uri)
+{
+	constexpr std::string_view Base64Marker = ";base64,";
+	std::size_t dataOffset = uri.find(Base64Marker);
+	if (std::string_view::npos == dataOffset)
+	{
+		return {};
+	}
+
+	return DecodeBase64(uri.substr(dataOffset + Base64Marker.size()));
+}
+
+// glTF rotation is conjugated as cd::Quaternion::ToMatrix4x4 builds the transposed matrix of the same components.
+// It keeps node matrices the same as the ones of FromMatrix in other producers.
+cd::Quaternion ConvertRotation(const float* pRotation)
+{
+	return cd::Quaternion(pRotation[3], -pRotation[0], -pRotation[1], -pRotation[2]);
+}
+
+cd::Transform GetNodeTransform(const cdtools::JsonView& node)
+{
+	if (cdtools::JsonView matrixValue = node["matrix"]; matrixValue.IsArray())
+	{
+		// Both glTF and cd::Matrix4x4 are column major.
+		cd::Matrix4x4 matrix = cd::Matrix4x4::Identity();
+		matrixValue.GetFloats(matrix.begin(), 16U);
+		return cd::Transform(matrix.GetTranslation(), cd::Quaternion::FromMatrix(matrix.GetRotation()), matrix.GetScale());
+	}
+
+	float translation[3] = { 0.0f, 0.0f, 0.0f };
+	float rotation[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	float scale[3] = { 1.0f, 1.0f, 1.0f };
+	node["translation"].GetFloats(translation, 3U);
+	node["rotation"].GetFloats(rotation, 4U);
+	node["scale"].GetFloats(scale, 3U);
+
+	return cd::Transform(cd::Vec3f(translation[0], translation[1], translation[2]),
+		ConvertRotation(rotation),
+		cd::Vec3f(scale[0], scale[1], scale[2]));
+}
+
+cd::Matrix4x4 GetTransformMatrix(const cd::Transform& transform)
+{
+	cd::Matrix4x4 matrix = transform.GetRotation().ToMatrix4x4();
+	for (int axisIndex = 0; axisIndex < 3; ++axisIndex)
+	{
+		matrix.GetColumn(axisIndex) *= transform.GetScale()[axisIndex];
+		matrix.GetColumn(3)[axisIndex] = transform.GetTranslation()[axisIndex];
+	}
+
+	return matrix;
+}
+
+cd::TextureMapMode ConvertWrapMode(uint32_t wrapMode)
+{
+	switch (wrapMode)
+	{
+	case WrapModeClampToEdge:
+		return cd::TextureMapMode::Clamp;
+	case WrapModeMirroredRepeat:
+		return cd::TextureMapMode::Mirror;
+	default:
+		return cd::TextureMapMode::Wrap;
+	}
+}
+
+}
+
+namespace cdtools
+{
+
+GltfProducerImpl::GltfProducerImpl(std::string filePath) :
+	m_filePath(cd::MoveTemp(filePath))
+{
+	m_folderPath = std::filesystem::path(m_filePath).parent_path().string();
+
+	// Default import options.
+	m_options.Enable(GltfProducerOptions::ImportMaterial);
+	m_options.Enable(GltfProducerOptions::ImportTexture);
+	m_options.Enable(GltfProducerOptions::ImportSkeleton);
+	m_options.Enable(GltfProducerOptions::ImportAnimation);
+	m_options.Enable(GltfProducerOptions::GenerateTangentSpace);
+}
+
+void GltfProducerImpl::Execute(cd::SceneDatabase* pSceneDatabase)
+{
+	if (!LoadDocument())
+	{
+		printf("Failed to load glTF file %s\n", m_filePath.c_str());
+		Release();
+		return;
+	}
+
+	pSceneDatabase->SetName(m_filePath.c_str());
+
+	// glTF is right-handed and +Y up with +Z as the front of assets. Distances are in meters.
+	pSceneDatabase->SetAxisSystem(cd::AxisSystem(cd::Handedness::Right, cd::UpVector::YAxis, cd::FrontVector::ParityOdd));
+	pSceneDatabase->SetUnit(cd::Unit::Meter);
+
+	if (IsOptionEnabled(GltfProducerOptions::ImportMaterial))
+	{
+		ImportMaterials(pSceneDatabase);
+	}
+
+	if (IsOptionEnabled(GltfProducerOptions::ImportSkeleton))
+	{
+		ImportSkeletons(pSceneDatabase);
+	}
+
+	ImportMeshes(pSceneDatabase);
+	ImportNodes(pSceneDatabase);
+
+	if (IsOptionEnabled(GltfProducerOptions::ImportSkeleton) && IsOptionEnabled(GltfProducerOptions::ImportAnimation))
+	{
+		ImportAnimations(pSceneDatabase);
+	}
+
+	Release();
+}
+
+bool GltfProducerImpl::LoadDocument()
+{
+	m_file = MappedFile(m_filePath.c_str());
+	if (!m_file.IsValid())
+	{
+		return false;
+	}
+
+	std::span<const std::byte> fileData = m_file.GetData();
+	std::string_view jsonText(reinterpret_cast<const char*>(fileData.data()), fileData.size());
+	std::span<const std::byte> glbBuffer;
+	if (fileData.size() >= GlbHeaderSize && GlbMagic == ReadValue<uint32_t>(fileData.data()))
+	{
+		// GLB header is followed by chunks of length, type and data. The first chunk is JSON and the optional second one is BIN.
+		jsonText = std::string_view();
+		std::size_t chunkOffset = GlbHeaderSize;
+		while (chunkOffset + 8U <= fileData.size())
+		{
+			const uint32_t chunkLength = ReadValue<uint32_t>(fileData.data() + chunkOffset);
+			const uint32_t chunkType = ReadValue<uint32_t>(fileData.data() + chunkOffset + 4U);
+			chunkOffset += 8U;
+			if (chunkOffset + chunkLength > fileData.size())
+			{
+				break;
+			}
+
+			if (GlbChunkTypeJson == chunkType && jsonText.empty())
+			{
+				jsonText = std::string_view(reinterpret_cast<const char*>(fileData.data() + chunkOffset), chunkLength);
+			}
+			else if (GlbChunkTypeBin == chunkType && glbBuffer.empty())
+			{
+				glbBuffer = fileData.subspan(chunkOffset, chunkLength);
+			}
+			chunkOffset += chunkLength;
+		}
+	}
+
+	if (!m_document.Parse(jsonText) || !m_document.GetRoot().IsObject())
+	{
+		return false;
+	}
+
+	JsonView root = m_document.GetRoot();
+	m_accessors = root["accessors"].GetElements();
+	m_bufferViews = root["bufferViews"].GetElements();
+	m_meshes = root["meshes"].GetElements();
+	m_nodes = root["nodes"].GetElements();
+	m_skins = root["skins"].GetElements();
+	m_textures = root["textures"].GetElements();
+	m_images = root["images"].GetElements();
+	m_samplers = root["samplers"].GetElements();
+
+	m_nodeParents.assign(m_nodes.size(), InvalidIndex);
+	for (uint32_t nodeIndex = 0U; nodeIndex < m_nodes.size(); ++nodeIndex)
+	{
+		for (const JsonView& child : m_nodes[nodeIndex]["children"].GetElements())
+		{
+			if (uint32_t childIndex = child.GetUInt(InvalidIndex); childIndex < m_nodes.size())
+			{
+				m_nodeParents[childIndex] = nodeIndex;
+			}
+		}
+	}
+
+	return LoadBuffers(glbBuffer);
+}
+
+bool GltfProducerImpl::LoadBuffers(std::span<const std::byte> glbBuffer)
+{
+	for (const JsonView& buffer : m_document.GetRoot()["buffers"].GetElements())
+	{
+		std::span<const std::byte> bufferData;
+		if (!buffer.Contains("uri"))
+		{
+			// Only the first buffer can refer to the BIN chunk of GLB.
+			bufferData = glbBuffer;
+		}
+		else if (std::string uri = buffer["uri"].GetString(); uri.starts_with("data:"))
+		{
+			bufferData = m_decodedBuffers.emplace_back(DecodeDataUri(uri));
+		}
+		else
+		{
+			std::optional<std::string> decodedUri = DecodeUri(uri);
+			if (!decodedUri.has_value())
+			{
+				printf("Invalid glTF buffer uri %s\n", uri.c_str());
+				return false;
+			}
+
+			std::filesystem::path bufferFilePath = m_folderPath;
+			bufferFilePath.append(decodedUri.value());
+			MappedFile& bufferFile = m_externalFiles.emplace_back(bufferFilePath.string().c_str());
+			if (!bufferFile.IsValid())
+			{
+				printf("Failed to load glTF buffer %s\n", bufferFilePath.string().c_str());
+				return false;
+			}
+			bufferData = bufferFile.GetData();
+		}
+
+		const std::size_t byteLength = buffer["byteLength"].GetUInt();
+		m_buffers.push_back(bufferData.first(std::min(byteLength, bufferData.size())));
+	}
+
+	return true;
+}
+
+void GltfProducerImpl::Release()
+{
+	m_accessors.clear();
+	m_bufferViews.clear();
+	m_meshes.clear();
+	m_nodes.clear();
+	m_skins.clear();
+	m_textures.clear();
+	m_images.clear();
+	m_samplers.clear();
+	m_document = JsonDocument();
+
+	m_buffers.clear();
+	m_decodedBuffers.clear();
+	m_externalFiles.clear();
+	m_file = MappedFile();
+}
+
+std::span<const std::byte> GltfProducerImpl::GetBufferView(uint32_t bufferViewIndex) const
+{
+	if (bufferViewIndex >= m_bufferViews.size())
+	{
+		return {};
+	}
+
+	const JsonView& bufferView = m_bufferViews[bufferViewIndex];
+	const uint32_t bufferIndex = bufferView["buffer"].GetUInt(InvalidIndex);
+	if (bufferIndex >= m_buffers.size())
+	{
+		return {};
+	}
+
+	const std::span<const std::byte> buffer = m_buffers[bufferIndex];
+	const std::size_t byteOffset = bufferView["byteOffset"].GetUInt();
+	const std::size_t byteLength = bufferView["byteLength"].GetUInt();
+	if (byteOffset + byteLength > buffer.size())
+	{
+		return {};
+	}
+
+	return buffer.subspan(byteOffset, byteLength);
+}
+
+GltfAccessor GltfProducerImpl::GetAccessor(uint32_t accessorIndex) const
+{
+	GltfAccessor accessor;
+	if (accessorIndex >= m_accessors.size())
+	{
+		return accessor;
+	}
+
+	// Sparse substitutions are not applied. Accessors without buffer view are zeros.
+	const JsonView& source = m_accessors[accessorIndex];
+	accessor.count = source["count"].GetUInt();
+	accessor.componentType = source["componentType"].GetUInt();
+	accessor.componentCount = GetComponentCount(source["type"].GetString());
+	accessor.normalized = source["normalized"].GetBool();
+
+	const uint32_t elementSize = accessor.componentCount * GetComponentSize(accessor.componentType);
+	accessor.byteStride = elementSize;
+	if (0U == elementSize || !source.Contains("bufferView"))
+	{
+		return accessor;
+	}
+
+	const uint32_t bufferViewIndex = source["bufferView"].GetUInt(InvalidIndex);
+	if (bufferViewIndex >= m_bufferViews.size())
+	{
+		printf("glTF accessor %u refers to invalid buffer view %u\n", accessorIndex, bufferViewIndex);
+		accessor.count = 0U;
+		return accessor;
+	}
+
+	std::span<const std::byte> bufferView = GetBufferView(bufferViewIndex);
+	accessor.byteStride = std::max(m_bufferViews[bufferViewIndex]["byteStride"].GetUInt(), elementSize);
+
+	const std::size_t byteOffset = source["byteOffset"].GetUInt();
+	if (accessor.count > 0U && byteOffset + static_cast<std::size_t>(accessor.count - 1U) * accessor.byteStride + elementSize > bufferView.size())
+	{
+		printf("glTF accessor %u is out of buffer view range\n", accessorIndex);
+		accessor.count = 0U;
+		return accessor;
+	}
+	accessor.pData = bufferView.data() + byteOffset;
+
+	return accessor;
+}
+
+std::string GltfProducerImpl::GetNodeName(uint32_t nodeIndex) const
+{
+	return m_nodes[nodeIndex]["name"].GetString("Node" + std::to_string(nodeIndex));
+}
+
+void GltfProducerImpl::ImportMaterials(cd::SceneDatabase* pSceneDatabase)
+{
+	m_textureIDs.assign(m_textures.size(), cd::TextureID::Invalid());
+
+	std::vector<JsonView> materials = m_document.GetRoot()["materials"].GetElements();
+	for (uint32_t materialIndex = 0U; materialIndex < materials.size(); ++materialIndex)
+	{
+		const JsonView& source = materials[materialIndex];
+		const JsonView pbr = source["pbrMetallicRoughness"];
+
+		std::string materialName = source["name"].GetString("Material" + std::to_string(materialIndex));
+		cd::Material material(m_materialIDGenerator.AllocateID(), materialName.c_str(), cd::MaterialType::BasePBR);
+
+		float baseColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		pbr["baseColorFactor"].GetFloats(baseColor, 4U);
+		material.SetVec3fProperty(cd::MaterialPropertyGroup::BaseColor, cd::MaterialProperty::Color, cd::Vec3f(baseColor[0], baseColor[1], baseColor[2]));
+		material.SetFloatProperty(cd::MaterialPropertyGroup::Metallic, cd::MaterialProperty::Factor, pbr["metallicFactor"].GetFloat(1.0f));
+		material.SetFloatProperty(cd::MaterialPropertyGroup::Roughness, cd::MaterialProperty::Factor, pbr["roughnessFactor"].GetFloat(1.0f));
+		material.SetBoolProperty(cd::MaterialPropertyGroup::General, cd::MaterialProperty::TwoSided, source["doubleSided"].GetBool());
+
+		cd::BlendMode blendMode = cd::BlendMode::Opaque;
+		if (std::string alphaMode = source["alphaMode"].GetString("OPAQUE"); "MASK" == alphaMode)
+		{
+			blendMode = cd::BlendMode::Mask;
+			material.SetFloatProperty(cd::MaterialPropertyGroup::General, cd::MaterialProperty::OpacityMaskClipValue, source["alphaCutoff"].GetFloat(0.5f));
+		}
+		else if ("BLEND" == alphaMode)
+		{
+			blendMode = cd::BlendMode::Blend;
+		}
+		material.SetI32Property(cd::MaterialPropertyGroup::General, cd::MaterialProperty::BlendMode, static_cast<int>(blendMode));
+
+		auto SetupTexture = [this, pSceneDatabase, &material](cd::MaterialTextureType textureType, const JsonView& textureInfo)
+		{
+			cd::TextureID textureID = cd::TextureID::Invalid();
+			if (textureInfo.IsValid() && IsOptionEnabled(GltfProducerOptions::ImportTexture))
+			{
+				textureID = ImportTexture(pSceneDatabase, textureInfo["index"].GetUInt(InvalidIndex));
+			}
+
+			if (!textureID.IsValid())
+			{
+				material.SetBoolProperty(textureType, cd::MaterialProperty::UseTexture, false);
+				return;
+			}
+
+			material.SetBoolProperty(textureType, cd::MaterialProperty::UseTexture, true);
+			material.SetTextureID(textureType, textureID);
+
+			float uvScale[2] = { 1.0f, 1.0f };
+			float uvOffset[2] = { 0.0f, 0.0f };
+			const JsonView textureTransform = textureInfo["extensions"]["KHR_texture_transform"];
+			textureTransform["scale"].GetFloats(uvScale, 2U);
+			textureTransform["offset"].GetFloats(uvOffset, 2U);
+			material.SetVec2fProperty(textureType, cd::MaterialProperty::UVScale, cd::Vec2f(uvScale[0], uvScale[1]));
+			material.SetVec2fProperty(textureType, cd::MaterialProperty::UVOffset, cd::Vec2f(uvOffset[0], uvOffset[1]));
+		};
+
+		// Metallic and roughness share one texture in blue and green channels.
+		SetupTexture(cd::MaterialTextureType::BaseColor, pbr["baseColorTexture"]);
+		SetupTexture(cd::MaterialTextureType::Metallic, pbr["metallicRoughnessTexture"]);
+		SetupTexture(cd::MaterialTextureType::Roughness, pbr["metallicRoughnessTexture"]);
+		SetupTexture(cd::MaterialTextureType::Normal, source["normalTexture"]);
+		SetupTexture(cd::MaterialTextureType::Occlusion, source["occlusionTexture"]);
+		SetupTexture(cd::MaterialTextureType::Emissive, source["emissiveTexture"]);
+
+		pSceneDatabase->AddMaterial(cd::MoveTemp(material));
+	}
+}
+
+cd::TextureID GltfProducerImpl::ImportTexture(cd::SceneDatabase* pSceneDatabase, uint32_t textureIndex)
+{
+	if (textureIndex >= m_textures.size())
+	{
+		return cd::TextureID::Invalid();
+	}
+
+	if (m_textureIDs[textureIndex].IsValid())
+	{
+		return m_textureIDs[textureIndex];
+	}
+
+	const JsonView& source = m_textures[textureIndex];
+	const uint32_t imageIndex = source["source"].GetUInt(InvalidIndex);
+	if (imageIndex >= m_images.size())
+	{
+		return cd::TextureID::Invalid();
+	}
+
+	const JsonView& image = m_images[imageIndex];
+	std::string textureName = image["name"].GetString();
+	std::string filePath;
+	std::vector<std::byte> rawData;
+	if (std::string uri = image["uri"].GetString(); uri.empty())
+	{
+		// Embedded image keeps its encoded file bytes.
+		std::span<const std::byte> bufferView = GetBufferView(image["bufferView"].GetUInt(InvalidIndex));
+		rawData.assign(bufferView.begin(), bufferView.end());
+	}
+	else if (uri.starts_with("data:"))
+	{
+		rawData = DecodeDataUri(uri);
+	}
+	else
+	{
+		std::optional<std::string> decodedUri = DecodeUri(uri);
+		if (!decodedUri.has_value())
+		{
+			printf("Invalid glTF image uri %s\n", uri.c_str());
+			return cd::TextureID::Invalid();
+		}
+
+		std::filesystem::path textureFilePath = m_folderPath;
+		textureFilePath.append(decodedUri.value());
+		filePath = textureFilePath.string();
+		if (textureName.empty())
+		{
+			textureName = textureFilePath.filename().string();
+		}
+	}
+
+	if (textureName.empty())
+	{
+		textureName = "Image" + std::to_string(imageIndex);
+	}
+
+	cd::TextureID textureID = m_textureIDGenerator.AllocateID();
+	cd::Texture texture(textureID, textureName.c_str());
+	texture.SetPath(filePath.c_str());
+	texture.SetRawData(cd::MoveTemp(rawData));
+
+	const JsonView sampler = source.Contains("sampler") && source["sampler"].GetUInt() < m_samplers.size() ? m_samplers[source["sampler"].GetUInt()] : JsonView();
+	texture.SetUMapMode(ConvertWrapMode(sampler["wrapS"].GetUInt()));
+	texture.SetVMapMode(ConvertWrapMode(sampler["wrapT"].GetUInt()));
+	pSceneDatabase->AddTexture(cd::MoveTemp(texture));
+
+	m_textureIDs[textureIndex] = textureID;
+	return textureID;
+}
+
+void GltfProducerImpl::ImportSkeletons(cd::SceneDatabase* pSceneDatabase)
+{
+	m_nodeBoneIDs.assign(m_nodes.size(), cd::BoneID::Invalid());
+	m_skinSkeletonIDs.assign(m_skins.size(), cd::SkeletonID::Invalid());
+
+	for (uint32_t skinIndex = 0U; skinIndex < m_skins.size(); ++skinIndex)
+	{
+		const JsonView& source = m_skins[skinIndex];
+
+		// A joint used by multiple skins belongs to the skeleton of the first skin.
+		std::vector<uint32_t> jointNodeIndices;
+		std::vector<uint32_t> jointIndices;
+		std::vector<JsonView> joints = source["joints"].GetElements();
+		for (uint32_t jointIndex = 0U; jointIndex < joints.size(); ++jointIndex)
+		{
+			uint32_t nodeIndex = joints[jointIndex].GetUInt(InvalidIndex);
+			if (nodeIndex < m_nodes.size() && !m_nodeBoneIDs[nodeIndex].IsValid())
+			{
+				jointNodeIndices.push_back(nodeIndex);
+				jointIndices.push_back(jointIndex);
+			}
+		}
+
+		if (jointNodeIndices.empty())
+		{
+			if (!joints.empty() && joints[0].GetUInt(InvalidIndex) < m_nodes.size())
+			{
+				m_skinSkeletonIDs[skinIndex] = pSceneDatabase->GetBone(m_nodeBoneIDs[joints[0].GetUInt()].Data()).GetSkeletonID();
+			}
+			continue;
+		}
+
+		std::vector<cd::Matrix4x4> inverseBindMatrices(joints.size(), cd::Matrix4x4::Identity());
+		if (GltfAccessor accessor = GetAccessor(source["inverseBindMatrices"].GetUInt(InvalidIndex)); accessor.count >= joints.size())
+		{
+			static_assert(sizeof(cd::Matrix4x4) == 16U * sizeof(float));
+			accessor.count = static_cast<uint32_t>(joints.size());
+			ReadFloats(accessor, reinterpret_cast<float*>(inverseBindMatrices.data()), 16U);
+		}
+
+		cd::Skeleton skeleton;
+		skeleton.SetID(m_skeletonIDGenerator.AllocateID());
+		skeleton.SetName(source["name"].GetString("Skeleton" + std::to_string(skinIndex)).c_str());
+		m_skinSkeletonIDs[skinIndex] = skeleton.GetID();
+
+		std::vector<cd::Bone> bones(jointNodeIndices.size());
+		const uint32_t firstBoneID = m_boneIDGenerator.GetCurrentID();
+		for (uint32_t boneIndex = 0U; boneIndex < bones.size(); ++boneIndex)
+		{
+			const uint32_t nodeIndex = jointNodeIndices[boneIndex];
+			cd::Bone& bone = bones[boneIndex];
+			bone.SetID(m_boneIDGenerator.AllocateID());
+			bone.SetName(GetNodeName(nodeIndex).c_str());
+			bone.SetSkeletonID(skeleton.GetID());
+			bone.SetOffset(inverseBindMatrices[jointIndices[boneIndex]]);
+			bone.SetTransform(GetNodeTransform(m_nodes[nodeIndex]));
+			bone.SetLimbLength(1.0f);
+			bone.SetLimbSize(cd::Vec3f(100.0f));
+			skeleton.AddBoneID(bone.GetID());
+			m_nodeBoneIDs[nodeIndex] = bone.GetID();
+		}
+
+		for (uint32_t boneIndex = 0U; boneIndex < bones.size(); ++boneIndex)
+		{
+			// Parent bone is the nearest ancestor node which is a joint of the same skeleton.
+			cd::Bone& bone = bones[boneIndex];
+			uint32_t ancestorIndex = m_nodeParents[jointNodeIndices[boneIndex]];
+			while (ancestorIndex != InvalidIndex && !m_nodeBoneIDs[ancestorIndex].IsValid())
+			{
+				ancestorIndex = m_nodeParents[ancestorIndex];
+			}
+
+			if (ancestorIndex != InvalidIndex && m_nodeBoneIDs[ancestorIndex].Data() >= firstBoneID)
+			{
+				cd::Bone& parentBone = bones[m_nodeBoneIDs[ancestorIndex].Data() - firstBoneID];
+				bone.SetParentID(parentBone.GetID());
+				parentBone.AddChildID(bone.GetID());
+				continue;
+			}
+
+			// Root bones are in world space as other producers so transforms of their ancestor nodes are applied.
+			cd::Matrix4x4 parentMatrix = cd::Matrix4x4::Identity();
+			for (uint32_t nodeIndex = m_nodeParents[jointNodeIndices[boneIndex]]; nodeIndex != InvalidIndex; nodeIndex = m_nodeParents[nodeIndex])
+			{
+				parentMatrix = GetTransformMatrix(GetNodeTransform(m_nodes[nodeIndex])) * parentMatrix;
+			}
+			bone.SetParentID(cd::BoneID::Invalid());
+			cd::Matrix4x4 rootMatrix = parentMatrix * GetTransformMatrix(bone.GetTransform());
+			bone.SetTransform(cd::Transform(rootMatrix.GetTranslation(), cd::Quaternion::FromMatrix(rootMatrix.GetRotation()), rootMatrix.GetScale()));
+			m_rootBoneParentMatrices.emplace(jointNodeIndices[boneIndex], parentMatrix);
+
+			if (!skeleton.GetRootBoneID().IsValid())
+			{
+				skeleton.SetRootBoneID(bone.GetID());
+			}
+		}
+
+		pSceneDatabase->AddSkeleton(cd::MoveTemp(skeleton));
+		for (auto& bone : bones)
+		{
+			pSceneDatabase->AddBone(cd::MoveTemp(bone));
+		}
+	}
+}
+
+void GltfProducerImpl::ImportMeshes(cd::SceneDatabase* pSceneDatabase)
+{
+	// Skin is referenced by nodes instead of meshes. Take the first one for every mesh.
+	std::vector<uint32_t> meshSkinIndices(m_meshes.size(), InvalidIndex);
+	if (IsOptionEnabled(GltfProducerOptions::ImportSkeleton))
+	{
+		for (const JsonView& node : m_nodes)
+		{
+			const uint32_t meshIndex = node["mesh"].GetUInt(InvalidIndex);
+			const uint32_t skinIndex = node["skin"].GetUInt(InvalidIndex);
+			if (meshIndex < m_meshes.size() && skinIndex < m_skins.size() && InvalidIndex == meshSkinIndices[meshIndex] &&
+				m_skinSkeletonIDs[skinIndex].IsValid())
+			{
+				meshSkinIndices[meshIndex] = skinIndex;
+			}
+		}
+	}
+
+	// Every triangle primitive is converted to a cd::Mesh as primitives don't share vertices.
+	struct PrimitiveTask
+	{
+		JsonView primitive;
+		uint32_t skinIndex;
+		cd::MaterialID materialID;
+	};
+	std::vector<PrimitiveTask> tasks;
+	std::vector<cd::Mesh> meshes;
+	m_meshFirstIDs.assign(m_meshes.size() + 1U, m_meshIDGenerator.GetCurrentID());
+	for (uint32_t meshIndex = 0U; meshIndex < m_meshes.size(); ++meshIndex)
+	{
+		std::string meshName = m_meshes[meshIndex]["name"].GetString("Mesh" + std::to_string(meshIndex));
+		std::vector<JsonView> primitives = m_meshes[meshIndex]["primitives"].GetElements();
+		for (uint32_t primitiveIndex = 0U; primitiveIndex < primitives.size(); ++primitiveIndex)
+		{
+			const JsonView& primitive = primitives[primitiveIndex];
+			const uint32_t mode = primitive["mode"].GetUInt(PrimitiveModeTriangles);
+			const uint32_t positionAccessorIndex = primitive["attributes"]["POSITION"].GetUInt(InvalidIndex);
+			if ((mode != PrimitiveModeTriangles && mode != PrimitiveModeTriangleStrip && mode != PrimitiveModeTriangleFan) ||
+				positionAccessorIndex >= m_accessors.size() || 0U == m_accessors[positionAccessorIndex]["count"].GetUInt())
+			{
+				continue;
+			}
+
+			const uint32_t materialIndex = primitive["material"].GetUInt(InvalidIndex);
+			const cd::MaterialID materialID = materialIndex < pSceneDatabase->GetMaterialCount() ? cd::MaterialID(materialIndex) : cd::MaterialID::Invalid();
+			tasks.push_back(PrimitiveTask{ primitive, meshSkinIndices[meshIndex], materialID });
+
+			cd::Mesh& mesh = meshes.emplace_back();
+			mesh.SetID(m_meshIDGenerator.AllocateID());
+			mesh.SetName(primitives.size() > 1U ? (meshName + "_" + std::to_string(primitiveIndex)).c_str() : meshName.c_str());
+		}
+		m_meshFirstIDs[meshIndex + 1U] = m_meshIDGenerator.GetCurrentID();
+	}
+
+	std::vector<cd::Skin> skins(tasks.size());
+	cd::ParallelFor(static_cast<uint32_t>(tasks.size()), [this, &tasks, &meshes, &skins](uint32_t taskIndex)
+	{
+		const PrimitiveTask& task = tasks[taskIndex];
+		ConvertPrimitive(task.primitive, task.materialID, meshes[taskIndex]);
+		if (task.skinIndex != InvalidIndex)
+		{
+			ConvertPrimitiveSkin(task.primitive, meshes[taskIndex].GetVertexCount(), task.skinIndex, skins[taskIndex]);
+		}
+	});
+
+	for (uint32_t taskIndex = 0U; taskIndex < tasks.size(); ++taskIndex)
+	{
+		cd::Mesh& mesh = meshes[taskIndex];
+		cd::Skin& skin = skins[taskIndex];
+		if (skin.GetInfluenceBoneNameCount() > 0U)
+		{
+			// Skin id is allocated only for added skins so that it stays the same as the index in SceneDatabase.
+			cd::SkinID skinID = m_skinIDGenerator.AllocateID();
+			skin.SetID(skinID);
+			skin.SetMeshID(mesh.GetID());
+			skin.SetName(mesh.GetName());
+			mesh.AddSkinID(skinID);
+			pSceneDatabase->AddSkin(cd::MoveTemp(skin));
+		}
+		pSceneDatabase->AddMesh(cd::MoveTemp(mesh));
+	}
+}
+
+void GltfProducerImpl::ConvertPrimitive(const JsonView& primitive, cd::MaterialID materialID, cd::Mesh& mesh) const
+{
+	const JsonView attributes = primitive["attributes"];
+	const uint32_t positionAccessorIndex = attributes["POSITION"].GetUInt(InvalidIndex);
+	const GltfAccessor positions = GetAccessor(positionAccessorIndex);
+	const uint32_t vertexCount = positions.count;
+
+	// Attributes are read to arrays of vertexCount elements. Accessors of other counts are ignored as skin sets are.
+	auto HasVertexAttribute = [this, &attributes, vertexCount](const std::string& attributeName)
+	{
+		if (!attributes.Contains(attributeName))
+		{
+			return false;
+		}
+
+		const uint32_t attributeCount = GetAccessor(attributes[attributeName].GetUInt(InvalidIndex)).count;
+		if (attributeCount != vertexCount)
+		{
+			printf("glTF attribute %s has %u elements but POSITION has %u, it is ignored\n", attributeName.c_str(), attributeCount, vertexCount);
+			return false;
+		}
+
+		return true;
+	};
+
+	uint32_t uvSetCount = 0U;
+	while (uvSetCount < cd::MaxUVSetCount && HasVertexAttribute("TEXCOORD_" + std::to_string(uvSetCount)))
+	{
+		++uvSetCount;
+	}
+
+	uint32_t colorSetCount = 0U;
+	while (colorSetCount < cd::MaxColorSetCount && HasVertexAttribute("COLOR_" + std::to_string(colorSetCount)))
+	{
+		++colorSetCount;
+	}
+
+	mesh.Init(vertexCount);
+	mesh.SetVertexUVSetCount(uvSetCount);
+	mesh.SetVertexColorSetCount(colorSetCount);
+
+	cd::VertexFormat vertexFormat;
+	ReadFloats(positions, GetFloatData(mesh.GetVertexPositions()), cd::Point::Size);
+	vertexFormat.AddVertexAttributeLayout(cd::VertexAttributeType::Position, cd::GetAttributeValueType<cd::Point::ValueType>(), cd::Point::Size);
+
+	// Position accessor always has bounds.
+	float minPosition[3];
+	float maxPosition[3];
+	if (3U == m_accessors[positionAccessorIndex]["min"].GetFloats(minPosition, 3U) && 3U == m_accessors[positionAccessorIndex]["max"].GetFloats(maxPosition, 3U))
+	{
+		mesh.SetAABB(cd::AABB(cd::Point(minPosition[0], minPosition[1], minPosition[2]), cd::Point(maxPosition[0], maxPosition[1], maxPosition[2])));
+	}
+
+	std::vector<uint32_t> indices;
+	if (const uint32_t indexAccessorIndex = primitive["indices"].GetUInt(InvalidIndex); indexAccessorIndex != InvalidIndex)
+	{
+		const GltfAccessor indexAccessor = GetAccessor(indexAccessorIndex);
+		indices.resize(indexAccessor.count);
+		ReadUnsignedInts(indexAccessor, indices.data());
+	}
+	else
+	{
+		indices.resize(vertexCount);
+		std::iota(indices.begin(), indices.end(), 0U);
+	}
+
+	cd::PolygonGroup polygonGroup;
+	auto AddTriangle = [&polygonGroup, vertexCount](uint32_t index0, uint32_t index1, uint32_t index2)
+	{
+		if (index0 < vertexCount && index1 < vertexCount && index2 < vertexCount)
+		{
+			polygonGroup.push_back(cd::Polygon{ cd::VertexID(index0), cd::VertexID(index1), cd::VertexID(index2) });
+		}
+	};
+
+	const uint32_t indexCount = static_cast<uint32_t>(indices.size());
+	switch (primitive["mode"].GetUInt(PrimitiveModeTriangles))
+	{
+	case PrimitiveModeTriangleStrip:
+		polygonGroup.reserve(indexCount > 2U ? indexCount - 2U : 0U);
+		for (uint32_t index = 0U; index + 2U < indexCount; ++index)
+		{
+			// Odd triangles swap the first two vertices to keep the same winding.
+			const uint32_t parity = index & 1U;
+			AddTriangle(indices[index + parity], indices[index + 1U - parity], indices[index + 2U]);
+		}
+		break;
+	case PrimitiveModeTriangleFan:
+		polygonGroup.reserve(indexCount > 2U ? indexCount - 2U : 0U);
+		for (uint32_t index = 1U; index + 1U < indexCount; ++index)
+		{
+			AddTriangle(indices[0], indices[index], indices[index + 1U]);
+		}
+		break;
+	default:
+		polygonGroup.reserve(indexCount / 3U);
+		for (uint32_t index = 0U; index + 2U < indexCount; index += 3U)
+		{
+			AddTriangle(indices[index], indices[index + 1U], indices[index + 2U]);
+		}
+		break;
+	}
+	mesh.AddMaterialID(materialID);
+	mesh.AddPolygonGroup(cd::MoveTemp(polygonGroup));
+
+	if (HasVertexAttribute("NORMAL"))
+	{
+		ReadFloats(GetAccessor(attributes["NORMAL"].GetUInt()), GetFloatData(mesh.GetVertexNormals()), cd::Direction::Size);
+	}
+	else
+	{
+		mesh.ComputeVertexNormals();
+	}
+	vertexFormat.AddVertexAttributeLayout(cd::VertexAttributeType::Normal, cd::GetAttributeValueType<cd::Direction::ValueType>(), cd::Direction::Size);
+
+	for (uint32_t uvSetIndex = 0U; uvSetIndex < uvSetCount; ++uvSetIndex)
+	{
+		ReadFloats(GetAccessor(attributes["TEXCOORD_" + std::to_string(uvSetIndex)].GetUInt()), GetFloatData(mesh.GetVertexUVs(uvSetIndex)), cd::UV::Size);
+		vertexFormat.AddVertexAttributeLayout(cd::VertexAttributeType::UV, cd::GetAttributeValueType<cd::UV::ValueType>(), cd::UV::Size);
+	}
+
+	for (uint32_t colorSetIndex = 0U; colorSetIndex < colorSetCount; ++colorSetIndex)
+	{
+		const GltfAccessor colors = GetAccessor(attributes["COLOR_" + std::to_string(colorSetIndex)].GetUInt());
+		std::vector<cd::Color>& vertexColors = mesh.GetVertexColors(colorSetIndex);
+		if (colors.componentCount < cd::Color::Size)
+		{
+			std::fill(vertexColors.begin(), vertexColors.end(), cd::Color(1.0f, 1.0f, 1.0f, 1.0f));
+		}
+		ReadFloats(colors, GetFloatData(vertexColors), cd::Color::Size);
+		vertexFormat.AddVertexAttributeLayout(cd::VertexAttributeType::Color, cd::GetAttributeValueType<cd::Color::ValueType>(), cd::Color::Size);
+	}
+
+	// Bitangent = cross(normal, tangent.xyz) * tangent.w in glTF.
+	std::vector<cd::Vec4f> tangents;
+	if (HasVertexAttribute("TANGENT"))
+	{
+		tangents.resize(vertexCount, cd::Vec4f(1.0f, 0.0f, 0.0f, 1.0f));
+		ReadFloats(GetAccessor(attributes["TANGENT"].GetUInt()), GetFloatData(tangents), 4U);
+	}
+	else if (uvSetCount > 0U && IsOptionEnabled(GltfProducerOptions::GenerateTangentSpace))
+	{
+		mesh.ComputeVertexTangents();
+		tangents.reserve(vertexCount);
+		for (const cd::Direction& tangent : mesh.GetVertexTangents())
+		{
+			tangents.emplace_back(tangent.x(), tangent.y(), tangent.z(), 1.0f);
+		}
+	}
+
+	if (!tangents.empty())
+	{
+		for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+		{
+			const cd::Vec4f& tangent = tangents[vertexIndex];
+			const cd::Direction tangentDirection(tangent.x(), tangent.y(), tangent.z());
+			mesh.SetVertexTangent(vertexIndex, tangentDirection);
+			mesh.SetVertexBiTangent(vertexIndex, mesh.GetVertexNormal(vertexIndex).Cross(tangentDirection) * tangent.w());
+		}
+		vertexFormat.AddVertexAttributeLayout(cd::VertexAttributeType::Tangent, cd::GetAttributeValueType<cd::Direction::ValueType>(), cd::Direction::Size);
+		vertexFormat.AddVertexAttributeLayout(cd::VertexAttributeType::Bitangent, cd::GetAttributeValueType<cd::Direction::ValueType>(), cd::Direction::Size);
+	}
+
+	mesh.SetVertexFormat(cd::MoveTemp(vertexFormat));
+}
+
+void GltfProducerImpl::ConvertPrimitiveSkin(const JsonView& primitive, uint32_t vertexCount, uint32_t skinIndex, cd::Skin& skin) const
+{
+	const JsonView attributes = primitive["attributes"];
+	std::vector<uint32_t> joints;
+	std::vector<float> weights;
+	uint32_t slotCount = 0U;
+	for (uint32_t setIndex = 0U; attributes.Contains("JOINTS_" + std::to_string(setIndex)) && attributes.Contains("WEIGHTS_" + std::to_string(setIndex)); ++setIndex)
+	{
+		const GltfAccessor jointAccessor = GetAccessor(attributes["JOINTS_" + std::to_string(setIndex)].GetUInt());
+		const GltfAccessor weightAccessor = GetAccessor(attributes["WEIGHTS_" + std::to_string(setIndex)].GetUInt());
+		if (jointAccessor.count != vertexCount || weightAccessor.count != vertexCount || jointAccessor.componentCount != 4U || weightAccessor.componentCount != 4U)
+		{
+			break;
+		}
+
+		// Sets are appended as vertex major arrays of 4 influences.
+		std::vector<uint32_t> setJoints(static_cast<std::size_t>(vertexCount) * 4U);
+		std::vector<float> setWeights(static_cast<std::size_t>(vertexCount) * 4U, 0.0f);
+		ReadUnsignedInts(jointAccessor, setJoints.data());
+		ReadFloats(weightAccessor, setWeights.data(), 4U);
+		if (0U == slotCount)
+		{
+			joints = cd::MoveTemp(setJoints);
+			weights = cd::MoveTemp(setWeights);
+		}
+		else
+		{
+			std::vector<uint32_t> mergedJoints(static_cast<std::size_t>(vertexCount) * (slotCount + 4U));
+			std::vector<float> mergedWeights(mergedJoints.size());
+			for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+			{
+				std::copy_n(&joints[vertexIndex * slotCount], slotCount, &mergedJoints[vertexIndex * (slotCount + 4U)]);
+				std::copy_n(&setJoints[vertexIndex * 4U], 4U, &mergedJoints[vertexIndex * (slotCount + 4U) + slotCount]);
+				std::copy_n(&weights[vertexIndex * slotCount], slotCount, &mergedWeights[vertexIndex * (slotCount + 4U)]);
+				std::copy_n(&setWeights[vertexIndex * 4U], 4U, &mergedWeights[vertexIndex * (slotCount + 4U) + slotCount]);
+			}
+			joints = cd::MoveTemp(mergedJoints);
+			weights = cd::MoveTemp(mergedWeights);
+		}
+		slotCount += 4U;
+	}
+
+	std::vector<JsonView> jointNodes = m_skins[skinIndex]["joints"].GetElements();
+	if (0U == slotCount || jointNodes.empty() || jointNodes.size() >= cd::InvalidInfluenceBoneIndex)
+	{
+		return;
+	}
+
+	// Joint indices are already indices to the influence bone name palette.
+	skin.SetSkeletonID(m_skinSkeletonIDs[skinIndex]);
+	for (const JsonView& jointNode : jointNodes)
+	{
+		const uint32_t nodeIndex = jointNode.GetUInt(InvalidIndex);
+		skin.AddInfluenceBoneName(nodeIndex < m_nodes.size() ? GetNodeName(nodeIndex) : std::string());
+	}
+
+	// Sort influences of every vertex by weight from high to low, drop zero weights and renormalize.
+	const uint32_t paletteSize = static_cast<uint32_t>(jointNodes.size());
+	std::vector<std::pair<float, uint16_t>> influences(static_cast<std::size_t>(vertexCount) * slotCount);
+	std::vector<uint32_t> influenceCounts(vertexCount, 0U);
+	uint32_t maxInfluenceCount = 0U;
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		auto* pVertexInfluences = &influences[vertexIndex * slotCount];
+		uint32_t influenceCount = 0U;
+		float weightSum = 0.0f;
+		for (uint32_t slotIndex = vertexIndex * slotCount; slotIndex < (vertexIndex + 1U) * slotCount; ++slotIndex)
+		{
+			if (weights[slotIndex] > 0.0f && joints[slotIndex] < paletteSize)
+			{
+				pVertexInfluences[influenceCount++] = std::make_pair(weights[slotIndex], static_cast<uint16_t>(joints[slotIndex]));
+				weightSum += weights[slotIndex];
+			}
+		}
+
+		std::stable_sort(pVertexInfluences, pVertexInfluences + influenceCount, [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+		for (uint32_t influenceIndex = 0U; influenceIndex < influenceCount; ++influenceIndex)
+		{
+			pVertexInfluences[influenceIndex].first /= weightSum;
+		}
+		influenceCounts[vertexIndex] = influenceCount;
+		maxInfluenceCount = std::max(maxInfluenceCount, influenceCount);
+	}
+
+	skin.SetMaxVertexInfluenceCount(maxInfluenceCount);
+	std::vector<uint16_t>& vertexInfluenceBones = skin.GetVertexInfluenceBones();
+	std::vector<float>& vertexInfluenceWeights = skin.GetVertexInfluenceWeights();
+	vertexInfluenceBones.assign(static_cast<std::size_t>(vertexCount) * maxInfluenceCount, cd::InvalidInfluenceBoneIndex);
+	vertexInfluenceWeights.assign(static_cast<std::size_t>(vertexCount) * maxInfluenceCount, 0.0f);
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		for (uint32_t influenceIndex = 0U; influenceIndex < influenceCounts[vertexIndex]; ++influenceIndex)
+		{
+			const auto& influence = influences[vertexIndex * slotCount + influenceIndex];
+			vertexInfluenceBones[vertexIndex * maxInfluenceCount + influenceIndex] = influence.second;
+			vertexInfluenceWeights[vertexIndex * maxInfluenceCount + influenceIndex] = influence.first;
+		}
+	}
+}
+
+void GltfProducerImpl::ImportNodes(cd::SceneDatabase* pSceneDatabase)
+{
+	const uint32_t firstNodeID = m_nodeIDGenerator.GetCurrentID();
+	for (uint32_t nodeIndex = 0U; nodeIndex < m_nodes.size(); ++nodeIndex)
+	{
+		const JsonView& source = m_nodes[nodeIndex];
+		cd::Node node(m_nodeIDGenerator.AllocateID(), GetNodeName(nodeIndex));
+		node.SetTransform(GetNodeTransform(source));
+		if (m_nodeParents[nodeIndex] != InvalidIndex)
+		{
+			node.SetParentID(cd::NodeID(firstNodeID + m_nodeParents[nodeIndex]));
+		}
+
+		for (const JsonView& child : source["children"].GetElements())
+		{
+			if (uint32_t childIndex = child.GetUInt(InvalidIndex); childIndex < m_nodes.size())
+			{
+				node.AddChildID(cd::NodeID(firstNodeID + childIndex));
+			}
+		}
+
+		if (uint32_t meshIndex = source["mesh"].GetUInt(InvalidIndex); meshIndex < m_meshes.size())
+		{
+			for (uint32_t meshID = m_meshFirstIDs[meshIndex]; meshID < m_meshFirstIDs[meshIndex + 1U]; ++meshID)
+			{
+				node.AddMeshID(cd::MeshID(meshID));
+			}
+		}
+
+		pSceneDatabase->AddNode(cd::MoveTemp(node));
+	}
+
+	// Root nodes of the default scene, or all nodes without parent if there is no scene.
+	JsonView root = m_document.GetRoot();
+	std::vector<JsonView> scenes = root["scenes"].GetElements();
+	if (!scenes.empty())
+	{
+		const uint32_t sceneIndex = std::min(root["scene"].GetUInt(), static_cast<uint32_t>(scenes.size() - 1U));
+		for (const JsonView& sceneNode : scenes[sceneIndex]["nodes"].GetElements())
+		{
+			if (uint32_t nodeIndex = sceneNode.GetUInt(InvalidIndex); nodeIndex < m_nodes.size())
+			{
+				pSceneDatabase->AddRootNodeID(cd::NodeID(firstNodeID + nodeIndex));
+			}
+		}
+	}
+	else
+	{
+		for (uint32_t nodeIndex = 0U; nodeIndex < m_nodes.size(); ++nodeIndex)
+		{
+			if (InvalidIndex == m_nodeParents[nodeIndex])
+			{
+				pSceneDatabase->AddRootNodeID(cd::NodeID(firstNodeID + nodeIndex));
+			}
+		}
+	}
+}
+
+void GltfProducerImpl::ImportAnimations(cd::SceneDatabase* pSceneDatabase)
+{
+	std::vector<JsonView> sourceAnimations = m_document.GetRoot()["animations"].GetElements();
+	std::vector<cd::Animation> animations(sourceAnimations.size());
+	std::vector<std::vector<cd::Track>> animationTracks(sourceAnimations.size());
+
+	cd::ParallelFor(static_cast<uint32_t>(sourceAnimations.size()), [this, &sourceAnimations, &animations, &animationTracks](uint32_t animationIndex)
+	{
+		const JsonView& source = sourceAnimations[animationIndex];
+		std::string animationName = source["name"].GetString("Animation" + std::to_string(animationIndex));
+		std::vector<JsonView> samplers = source["samplers"].GetElements();
+
+		// One track per animated bone in order of first channel.
+		std::vector<cd::Track>& tracks = animationTracks[animationIndex];
+		std::vector<uint32_t> trackNodeIndices;
+		std::unordered_map<uint32_t, uint32_t> trackIndexByNode;
+		float duration = 0.0f;
+		for (const JsonView& channel : source["channels"].GetElements())
+		{
+			const JsonView target = channel["target"];
+			const uint32_t nodeIndex = target["node"].GetUInt(InvalidIndex);
+			const uint32_t samplerIndex = channel["sampler"].GetUInt(InvalidIndex);
+			if (nodeIndex >= m_nodes.size() || !m_nodeBoneIDs[nodeIndex].IsValid() || samplerIndex >= samplers.size())
+			{
+				continue;
+			}
+
+			const JsonView& sampler = samplers[samplerIndex];
+			const GltfAccessor input = GetAccessor(sampler["input"].GetUInt(InvalidIndex));
+			const GltfAccessor output = GetAccessor(sampler["output"].GetUInt(InvalidIndex));
+			const std::string path = target["path"].GetString();
+			const uint32_t valueSize = "rotation" == path ? 4U : 3U;
+			if (0U == input.count || ("translation" != path && "rotation" != path && "scale" != path))
+			{
+				continue;
+			}
+
+			// Cubic spline keys store in tangent, value and out tangent. Only values are kept and interpolated linearly
+			// as STEP keys are.
+			const uint32_t valueStride = "CUBICSPLINE" == sampler["interpolation"].GetString() ? 3U : 1U;
+			const uint32_t valueOffset = valueStride / 2U;
+			if (output.count < input.count * valueStride)
+			{
+				continue;
+			}
+
+			std::vector<float> times(input.count);
+			std::vector<float> values(static_cast<std::size_t>(output.count) * valueSize);
+			ReadFloats(input, times.data(), 1U);
+			ReadFloats(output, values.data(), valueSize);
+			duration = std::max(duration, times.back());
+
+			auto [itTrack, isNewTrack] = trackIndexByNode.emplace(nodeIndex, static_cast<uint32_t>(tracks.size()));
+			if (isNewTrack)
+			{
+				tracks.emplace_back(cd::TrackID::Invalid(), animationName + GetNodeName(nodeIndex));
+				trackNodeIndices.push_back(nodeIndex);
+			}
+			cd::Track& track = tracks[itTrack->second];
+
+			const uint32_t keyCount = input.count;
+			for (uint32_t keyIndex = 0U; keyIndex < keyCount; ++keyIndex)
+			{
+				const float* pValue = &values[(static_cast<std::size_t>(keyIndex) * valueStride + valueOffset) * valueSize];
+				if ("translation" == path)
+				{
+					auto& key = track.GetTranslationKeys().emplace_back();
+					key.SetTime(times[keyIndex]);
+					key.SetValue(cd::Vec3f(pValue[0], pValue[1], pValue[2]));
+				}
+				else if ("rotation" == path)
+				{
+					auto& key = track.GetRotationKeys().emplace_back();
+					key.SetTime(times[keyIndex]);
+					key.SetValue(ConvertRotation(pValue).Normalize());
+				}
+				else
+				{
+					auto& key = track.GetScaleKeys().emplace_back();
+					key.SetTime(times[keyIndex]);
+					key.SetValue(cd::Vec3f(pValue[0], pValue[1], pValue[2]));
+				}
+			}
+		}
+
+		for (uint32_t trackIndex = 0U; trackIndex < tracks.size(); ++trackIndex)
+		{
+			// Channels which are not animated keep the rest pose of node.
+			cd::Track& track = tracks[trackIndex];
+			const uint32_t nodeIndex = trackNodeIndices[trackIndex];
+			const cd::Transform restTransform = GetNodeTransform(m_nodes[nodeIndex]);
+			if (track.GetTranslationKeys().empty())
+			{
+				auto& key = track.GetTranslationKeys().emplace_back();
+				key.SetTime(0.0f);
+				key.SetValue(restTransform.GetTranslation());
+			}
+			if (track.GetRotationKeys().empty())
+			{
+				auto& key = track.GetRotationKeys().emplace_back();
+				key.SetTime(0.0f);
+				key.SetValue(restTransform.GetRotation());
+			}
+			if (track.GetScaleKeys().empty())
+			{
+				auto& key = track.GetScaleKeys().emplace_back();
+				key.SetTime(0.0f);
+				key.SetValue(restTransform.GetScale());
+			}
+
+			// Root bones are in world space so keys are moved by ancestor node transforms.
+			// Channels are applied separately which is exact unless ancestors have non uniform scale.
+			auto itParentMatrix = m_rootBoneParentMatrices.find(nodeIndex);
+			if (itParentMatrix == m_rootBoneParentMatrices.end())
+			{
+				continue;
+			}
+
+			const cd::Matrix4x4& parentMatrix = itParentMatrix->second;
+			const cd::Vec3f parentScale = parentMatrix.GetScale();
+			for (auto& key : track.GetTranslationKeys())
+			{
+				const cd::Vec3f& translation = key.GetValue();
+				const cd::Vec4f worldTranslation = parentMatrix * cd::Vec4f(translation.x(), translation.y(), translation.z(), 1.0f);
+				key.SetValue(cd::Vec3f(worldTranslation.x(), worldTranslation.y(), worldTranslation.z()));
+			}
+			for (auto& key : track.GetRotationKeys())
+			{
+				key.SetValue(cd::Quaternion::FromMatrix((parentMatrix * key.GetValue().ToMatrix4x4()).GetRotation()));
+			}
+			for (auto& key : track.GetScaleKeys())
+			{
+				const cd::Vec3f& scale = key.GetValue();
+				key.SetValue(cd::Vec3f(parentScale.x() * scale.x(), parentScale.y() * scale.y(), parentScale.z() * scale.z()));
+			}
+		}
+
+		cd::Animation& animation = animations[animationIndex];
+		animation.SetName(animationName.c_str());
+		animation.SetDuration(duration);
+
+		// Key times are in seconds. It is the rate to sample animation frames.
+		animation.SetTicksPerSecond(30.0f);
+	});
+
+	for (uint32_t animationIndex = 0U; animationIndex < animations.size(); ++animationIndex)
+	{
+		cd::Animation& animation = animations[animationIndex];
+		if (animationTracks[animationIndex].empty())
+		{
+			continue;
+		}
+
+		animation.SetID(m_animationIDGenerator.AllocateID());
+		for (auto& track : animationTracks[animationIndex])
+		{
+			cd::TrackID trackID = m_trackIDGenerator.AllocateID();
+			track.SetID(trackID);
+			animation.AddBoneTrackID(trackID);
+			pSceneDatabase->AddTrack(cd::MoveTemp(track));
+		}
+		pSceneDatabase->AddAnimation(cd::MoveTemp(animation));
+	}
+}
+
+}
\ No newline at end of file
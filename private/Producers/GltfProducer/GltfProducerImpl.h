@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Base/BitFlags.h"
+#include "Base/Template.h"
+#include "GltfJson.h"
+#include "MappedFile.h"
+#include "Math/Matrix.hpp"
+#include "Producers/GltfProducer/GltfProducerOptions.h"
+#include "Scene/ObjectIDGenerator.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cd
+{
+
+class Mesh;
+class SceneDatabase;
+class Skin;
+
+}
+
+namespace cdtools
+{
+
+// Typed view of accessor data in a mapped or decoded buffer.
+struct GltfAccessor
+{
+	const std::byte* pData = nullptr;
+	uint32_t count = 0U;
+	uint32_t componentType = 0U;
+	uint32_t componentCount = 0U;
+	uint32_t byteStride = 0U;
+	bool normalized = false;
+};
+
+class GltfProducerImpl final
+{
+public:
+	GltfProducerImpl() = delete;
+	explicit GltfProducerImpl(std::string filePath);
+	GltfProducerImpl(const GltfProducerImpl&) = delete;
+	GltfProducerImpl& operator=(const GltfProducerImpl&) = delete;
+	GltfProducerImpl(GltfProducerImpl&&) = delete;
+	GltfProducerImpl& operator=(GltfProducerImpl&&) = delete;
+	~GltfProducerImpl() = default;
+
+	void Execute(cd::SceneDatabase* pSceneDatabase);
+
+	cd::BitFlags<GltfProducerOptions>& GetOptions() { return m_options; }
+	const cd::BitFlags<GltfProducerOptions>& GetOptions() const { return m_options; }
+	bool IsOptionEnabled(GltfProducerOptions option) const { return m_options.IsEnabled(option); }
+
+private:
+	bool LoadDocument();
+	bool LoadBuffers(std::span<const std::byte> glbBuffer);
+	void Release();
+
+	GltfAccessor GetAccessor(uint32_t accessorIndex) const;
+	std::span<const std::byte> GetBufferView(uint32_t bufferViewIndex) const;
+	std::string GetNodeName(uint32_t nodeIndex) const;
+
+	void ImportMaterials(cd::SceneDatabase* pSceneDatabase);
+	cd::TextureID ImportTexture(cd::SceneDatabase* pSceneDatabase, uint32_t textureIndex);
+	void ImportSkeletons(cd::SceneDatabase* pSceneDatabase);
+	void ImportMeshes(cd::SceneDatabase* pSceneDatabase);
+	void ImportNodes(cd::SceneDatabase* pSceneDatabase);
+	void ImportAnimations(cd::SceneDatabase* pSceneDatabase);
+
+	void ConvertPrimitive(const JsonView& primitive, cd::MaterialID materialID, cd::Mesh& mesh) const;
+	void ConvertPrimitiveSkin(const JsonView& primitive, uint32_t vertexCount, uint32_t skinIndex, cd::Skin& skin) const;
+
+private:
+	std::string m_filePath;
+	std::string m_folderPath;
+	cd::BitFlags<GltfProducerOptions> m_options;
+
+	// Source file and external .bin files stay mapped until import finishes as accessors point into them.
+	MappedFile m_file;
+	std::vector<MappedFile> m_externalFiles;
+	std::vector<std::vector<std::byte>> m_decodedBuffers;
+	std::vector<std::span<const std::byte>> m_buffers;
+
+	JsonDocument m_document;
+	std::vector<JsonView> m_accessors;
+	std::vector<JsonView> m_bufferViews;
+	std::vector<JsonView> m_meshes;
+	std::vector<JsonView> m_nodes;
+	std::vector<JsonView> m_skins;
+	std::vector<JsonView> m_textures;
+	std::vector<JsonView> m_images;
+	std::vector<JsonView> m_samplers;
+
+	// Lookups by glTF node, texture and skin indices.
+	std::vector<uint32_t> m_nodeParents;
+	std::vector<cd::BoneID> m_nodeBoneIDs;
+	std::vector<cd::TextureID> m_textureIDs;
+	std::vector<cd::SkeletonID> m_skinSkeletonIDs;
+
+	// World transforms of ancestor nodes of root bones which are applied to root bone poses.
+	std::unordered_map<uint32_t, cd::Matrix4x4> m_rootBoneParentMatrices;
+
+	// Converted meshes of a glTF mesh are [m_meshFirstIDs[i], m_meshFirstIDs[i + 1]).
+	std::vector<uint32_t> m_meshFirstIDs;
+
+	cd::ObjectIDGenerator<cd::NodeID> m_nodeIDGenerator;
+	cd::ObjectIDGenerator<cd::MeshID> m_meshIDGenerator;
+	cd::ObjectIDGenerator<cd::MaterialID> m_materialIDGenerator;
+	cd::ObjectIDGenerator<cd::TextureID> m_textureIDGenerator;
+	cd::ObjectIDGenerator<cd::SkeletonID> m_skeletonIDGenerator;
+	cd::ObjectIDGenerator<cd::BoneID> m_boneIDGenerator;
+	cd::ObjectIDGenerator<cd::SkinID> m_skinIDGenerator;
+	cd::ObjectIDGenerator<cd::AnimationID> m_animationIDGenerator;
+	cd::ObjectIDGenerator<cd::TrackID> m_trackIDGenerator;
+};
+
+}
\ No newline at end of file
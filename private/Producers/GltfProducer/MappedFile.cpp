@@ -0,0 +1,125 @@
+#include "MappedFile.h"
+
+#include "Base/Template.h"
+
+#ifdef _WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace cdtools
+{
+
+MappedFile::MappedFile(const char* pFilePath)
+{
+#ifdef _WIN32
+	HANDLE fileHandle = ::CreateFileA(pFilePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (INVALID_HANDLE_VALUE == fileHandle)
+	{
+		return;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!::GetFileSizeEx(fileHandle, &fileSize) || 0 == fileSize.QuadPart)
+	{
+		::CloseHandle(fileHandle);
+		return;
+	}
+
+	HANDLE mappingHandle = ::CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (nullptr == mappingHandle)
+	{
+		::CloseHandle(fileHandle);
+		return;
+	}
+
+	void* pView = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (nullptr == pView)
+	{
+		::CloseHandle(mappingHandle);
+		::CloseHandle(fileHandle);
+		return;
+	}
+
+	m_fileHandle = fileHandle;
+	m_mappingHandle = mappingHandle;
+	m_pData = static_cast<const std::byte*>(pView);
+	m_size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+	int fileDescriptor = ::open(pFilePath, O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		return;
+	}
+
+	struct stat fileStat;
+	if (::fstat(fileDescriptor, &fileStat) != 0 || 0 == fileStat.st_size)
+	{
+		::close(fileDescriptor);
+		return;
+	}
+
+	void* pView = ::mmap(nullptr, static_cast<std::size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+	// The mapping keeps its own reference to the file.
+	::close(fileDescriptor);
+	if (MAP_FAILED == pView)
+	{
+		return;
+	}
+
+	m_pData = static_cast<const std::byte*>(pView);
+	m_size = static_cast<std::size_t>(fileStat.st_size);
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& rhs)
+{
+	*this = cd::MoveTemp(rhs);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs)
+{
+	std::swap(m_pData, rhs.m_pData);
+	std::swap(m_size, rhs.m_size);
+#ifdef _WIN32
+	std::swap(m_fileHandle, rhs.m_fileHandle);
+	std::swap(m_mappingHandle, rhs.m_mappingHandle);
+#endif
+	return *this;
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+void MappedFile::Close()
+{
+	if (nullptr == m_pData)
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	::UnmapViewOfFile(m_pData);
+	::CloseHandle(m_mappingHandle);
+	::CloseHandle(m_fileHandle);
+	m_fileHandle = nullptr;
+	m_mappingHandle = nullptr;
+#else
+	::munmap(const_cast<std::byte*>(m_pData), m_size);
+#endif
+	m_pData = nullptr;
+	m_size = 0U;
+}
+
+}
\ No newline at end of file
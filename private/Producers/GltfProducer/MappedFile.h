@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+namespace cdtools
+{
+
+// Read only memory mapping of a whole file. Pages are loaded by the OS on first access so that
+// only referenced buffer data is read from disk.
+class MappedFile final
+{
+public:
+	MappedFile() = default;
+	explicit MappedFile(const char* pFilePath);
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& rhs);
+	MappedFile& operator=(MappedFile&& rhs);
+	~MappedFile();
+
+	bool IsValid() const { return m_pData != nullptr; }
+	std::span<const std::byte> GetData() const { return std::span<const std::byte>(m_pData, m_size); }
+
+private:
+	void Close();
+
+private:
+	const std::byte* m_pData = nullptr;
+	std::size_t m_size = 0U;
+
+#ifdef _WIN32
+	void* m_fileHandle = nullptr;
+	void* m_mappingHandle = nullptr;
+#endif
+};
+
+}
\ No newline at end of file
@@ -1,7 +1,8 @@
 #include "AlphaMap.h"
 
-#include "Math/Math.hpp"
-#include "Utilities/Utils.h"
+#include "Producers/TerrainProducer/AlphaMapBlend.h"
+
+#include <cstring>
 
 namespace cdtools
 {
@@ -53,136 +54,18 @@ void AlphaMap::CreateFromElevation(
 	AlphaMapBlendRegion<int32_t> alphaBlendRegion,
 	AlphaMapBlendFunction blendFuncType) 
 {
-	assert(greenBlendRegion.blendStart <= greenBlendRegion.blendEnd);
-	assert(blueBlendRegion.blendStart <= blueBlendRegion.blendEnd);
-	assert(alphaBlendRegion.blendStart <= alphaBlendRegion.blendEnd);
-	assert(greenBlendRegion.blendEnd <= blueBlendRegion.blendStart);
-	assert(blueBlendRegion.blendEnd <= alphaBlendRegion.blendStart);
+	ElevationAlphaMapDef alphaMapDef;
+	alphaMapDef.blendFunction = blendFuncType;
+	alphaMapDef.redGreenBlendRegion = greenBlendRegion;
+	alphaMapDef.greenBlueBlendRegion = blueBlendRegion;
+	alphaMapDef.blueAlphaBlendRegion = alphaBlendRegion;
 
 	m_mapType = AlphaMapType::Elevation;
-	m_alphaMap.clear();
 	// We will use RGBA8U here
 	// 1 byte per channel; 4 channels per pixel
-	m_alphaMap.resize(sizeof(std::byte) * 4 * elevationMap.size());
-	size_t j = 0;
-	for (size_t i = 0; i < elevationMap.size(); ++i)
-	{
-		const size_t redChannelIndex = j + 0;
-		const size_t greenChannelIndex = j + 1;
-		const size_t blueChannelIndex = j + 2;
-		const size_t alphaChannelIndex = j + 3;
-		const int32_t elevation = elevationMap[i];
-		j += 4;	// skip 4 bytes each iteration
-		
-		// Clear old values
-		m_alphaMap[redChannelIndex] = static_cast<std::byte>(0x0);
-		m_alphaMap[greenChannelIndex] = static_cast<std::byte>(0x0);
-		m_alphaMap[blueChannelIndex] = static_cast<std::byte>(0x0);
-		m_alphaMap[alphaChannelIndex] = static_cast<std::byte>(0x0);
-
-		// Calculate alpha map
-		const float greenBlendRange = static_cast<float>(greenBlendRegion.blendEnd - greenBlendRegion.blendStart);
-		const float blueBlendRange = static_cast<float>(blueBlendRegion.blendEnd - blueBlendRegion.blendStart);
-		const float alphaBlendRange = static_cast<float>(alphaBlendRegion.blendEnd - alphaBlendRegion.blendStart);
-		if (elevation < greenBlendRegion.blendStart)
-		{
-			// All red
-			m_alphaMap[redChannelIndex] = static_cast<std::byte>(0xFF);
-		}
-		else if (elevation < greenBlendRegion.blendEnd)
-		{
-			// Blend between red and green channel textures
-			const float t = (elevation - greenBlendRegion.blendStart) / greenBlendRange;
-			uint8_t redChannelRatio;
-			switch (blendFuncType)
-			{
-			case cdtools::AlphaMapBlendFunction::Step:
-				// no blend since we are stepping
-				redChannelRatio = 0xFF;
-				break;
-			case cdtools::AlphaMapBlendFunction::Linear:
-				redChannelRatio = static_cast<uint8_t>(std::ceil(cdtools::lerp<float>(0x0, 0xFF, t)));
-				break;
-			case cdtools::AlphaMapBlendFunction::SmoothStep:
-				redChannelRatio = static_cast<uint8_t>(std::ceil(cdtools::smoothstep<float>(0.0f, 255.0f, t)));
-				break;
-			case cdtools::AlphaMapBlendFunction::SmoothStepHigh:
-				redChannelRatio = static_cast<uint8_t>(std::ceil(cdtools::smoothstep_high<float>(0.0f, 255.0f, t)));
-				break;
-			default:
-				assert(false);
-			}
-			m_alphaMap[redChannelIndex] = static_cast<std::byte>(redChannelRatio);
-			m_alphaMap[greenChannelIndex] = static_cast<std::byte>(0xFF - redChannelRatio);
-		}
-		else if (elevation < blueBlendRegion.blendStart)
-		{
-			// All green
-			m_alphaMap[greenChannelIndex] = static_cast<std::byte>(0xFF);
-		}
-		else if (elevation < blueBlendRegion.blendEnd)
-		{
-			// Blend between green and blue channel textures
-			const float t = (elevation - blueBlendRegion.blendStart) / blueBlendRange;
-			uint8_t greenChannelRatio;
-			switch (blendFuncType)
-			{
-			case cdtools::AlphaMapBlendFunction::Step:
-				// no blend since we are stepping
-				greenChannelRatio = 0xFF;
-				break;
-			case cdtools::AlphaMapBlendFunction::Linear:
-				greenChannelRatio = static_cast<uint8_t>(std::ceil(cdtools::lerp<float>(0x0, 0xFF, t)));
-				break;
-			case cdtools::AlphaMapBlendFunction::SmoothStep:
-				greenChannelRatio = static_cast<uint8_t>(std::ceil(cdtools::smoothstep<float>(0.0f, 255.0f, t)));
-				break;
-			case cdtools::AlphaMapBlendFunction::SmoothStepHigh:
-				greenChannelRatio = static_cast<uint8_t>(std::ceil(cdtools::smoothstep_high<float>(0.0f, 255.0f, t)));
-				break;
-			default:
-				assert(false);
-			}
-			m_alphaMap[greenChannelIndex] = static_cast<std::byte>(greenChannelRatio);
-			m_alphaMap[blueChannelIndex] = static_cast<std::byte>(0xFF - greenChannelRatio);
-		}
-		else if (elevation < alphaBlendRegion.blendStart)
-		{
-			// All blue
-			m_alphaMap[blueChannelIndex] = static_cast<std::byte>(0xFF);
-		}
-		else if (elevation < alphaBlendRegion.blendEnd)
-		{
-			// Blend between blue and alpha channel textures
-			const float t = (elevation - alphaBlendRegion.blendStart) / alphaBlendRange;
-			uint8_t blueChannelRatio;
-			switch (blendFuncType)
-			{
-			case cdtools::AlphaMapBlendFunction::Step:
-				// no blend since we are stepping
-				blueChannelRatio = 0xFF;
-				break;
-			case cdtools::AlphaMapBlendFunction::Linear:
-				blueChannelRatio = static_cast<uint8_t>(std::ceil(cdtools::lerp<float>(0x0, 0xFF, t)));
-				break;
-			case cdtools::AlphaMapBlendFunction::SmoothStep:
-				blueChannelRatio = static_cast<uint8_t>(std::ceil(cdtools::smoothstep<float>(0.0f, 255.0f, t)));
-				break;
-			case cdtools::AlphaMapBlendFunction::SmoothStepHigh:
-				blueChannelRatio = static_cast<uint8_t>(std::ceil(cdtools::smoothstep_high<float>(0.0f, 255.0f, t)));
-				break;
-			default:
-				assert(false);
-			}
-			m_alphaMap[blueChannelIndex] = static_cast<std::byte>(blueChannelRatio);
-			m_alphaMap[alphaChannelIndex] = static_cast<std::byte>(0xFF - blueChannelRatio);
-		}
-		else
-		{
-			// all alpha
-			m_alphaMap[alphaChannelIndex] = static_cast<std::byte>(0xFF);
-		}
-	}
+	m_alphaMap.resize(sizeof(int32_t) * elevationMap.size());
+	std::memcpy(m_alphaMap.data(), elevationMap.data(), m_alphaMap.size());
+	ConvertElevationToAlphaMap(m_alphaMap.data(), static_cast<uint32_t>(elevationMap.size()), alphaMapDef);
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "Producers/TerrainProducer/AlphaMapBlend.h"
+
+#include "Base/Platform.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CD_ALPHA_MAP_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+
+using namespace cdtools;
+
+struct BlendRegion
+{
+	float start;
+	float end;
+	float invRange;
+};
+
+BlendRegion MakeBlendRegion(const AlphaMapBlendRegion<int32_t>& region)
+{
+	assert(region.blendStart <= region.blendEnd);
+	const float range = static_cast<float>(region.blendEnd - region.blendStart);
+	// Empty region works as a hard switch.
+	return BlendRegion{ static_cast<float>(region.blendStart), static_cast<float>(region.blendEnd), range > 0.0f ? 1.0f / range : FLT_MAX };
+}
+
+// Scalar kernel. Operations are in the same order as SSE2 kernel so results are the same.
+template<AlphaMapBlendFunction Blend>
+CD_FORCEINLINE int32_t BlendWeight255(float elevation, const BlendRegion& region)
+{
+	float weight;
+	if constexpr (AlphaMapBlendFunction::Step == Blend)
+	{
+		weight = elevation >= region.end ? 1.0f : 0.0f;
+	}
+	else
+	{
+		const float t = std::min(std::max((elevation - region.start) * region.invRange, 0.0f), 1.0f);
+		if constexpr (AlphaMapBlendFunction::Linear == Blend)
+		{
+			weight = t;
+		}
+		else if constexpr (AlphaMapBlendFunction::SmoothStep == Blend)
+		{
+			weight = t * t * (3.0f - 2.0f * t);
+		}
+		else
+		{
+			weight = t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+		}
+	}
+	return static_cast<int32_t>(weight * 255.0f + 0.5f);
+}
+
+template<AlphaMapBlendFunction Blend>
+CD_FORCEINLINE uint32_t ElevationToRGBA8(int32_t elevation, const BlendRegion* pRegions)
+{
+	const float elevationValue = static_cast<float>(elevation);
+	const int32_t w0 = BlendWeight255<Blend>(elevationValue, pRegions[0]);
+	const int32_t w1 = BlendWeight255<Blend>(elevationValue, pRegions[1]);
+	const int32_t w2 = BlendWeight255<Blend>(elevationValue, pRegions[2]);
+	// RGBA in LSB order.
+	return static_cast<uint32_t>((0xFF - w0) | ((w0 - w1) << 8) | ((w1 - w2) << 16) | (w2 << 24));
+}
+
+#ifdef CD_ALPHA_MAP_SSE2
+template<AlphaMapBlendFunction Blend>
+CD_FORCEINLINE __m128i BlendWeight255(__m128 elevation, const BlendRegion& region)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	__m128 weight;
+	if constexpr (AlphaMapBlendFunction::Step == Blend)
+	{
+		weight = _mm_and_ps(_mm_cmpge_ps(elevation, _mm_set1_ps(region.end)), one);
+	}
+	else
+	{
+		const __m128 t = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(elevation, _mm_set1_ps(region.start)), _mm_set1_ps(region.invRange)), _mm_setzero_ps()), one);
+		if constexpr (AlphaMapBlendFunction::Linear == Blend)
+		{
+			weight = t;
+		}
+		else if constexpr (AlphaMapBlendFunction::SmoothStep == Blend)
+		{
+			weight = _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(_mm_set1_ps(2.0f), t)));
+		}
+		else
+		{
+			const __m128 polynomial = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))), _mm_set1_ps(10.0f));
+			weight = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), polynomial);
+		}
+	}
+	return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(weight, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+}
+
+template<AlphaMapBlendFunction Blend>
+CD_FORCEINLINE __m128i ElevationToRGBA8(__m128i elevation, const BlendRegion* pRegions)
+{
+	const __m128 elevationValue = _mm_cvtepi32_ps(elevation);
+	const __m128i w0 = BlendWeight255<Blend>(elevationValue, pRegions[0]);
+	const __m128i w1 = BlendWeight255<Blend>(elevationValue, pRegions[1]);
+	const __m128i w2 = BlendWeight255<Blend>(elevationValue, pRegions[2]);
+	const __m128i red = _mm_sub_epi32(_mm_set1_epi32(0xFF), w0);
+	const __m128i green = _mm_slli_epi32(_mm_sub_epi32(w0, w1), 8);
+	const __m128i blue = _mm_slli_epi32(_mm_sub_epi32(w1, w2), 16);
+	const __m128i alpha = _mm_slli_epi32(w2, 24);
+	return _mm_or_si128(_mm_or_si128(red, green), _mm_or_si128(blue, alpha));
+}
+#endif
+
+template<AlphaMapBlendFunction Blend>
+void ConvertElevationToAlphaMapImpl(std::byte* pTexels, uint32_t texelCount, const BlendRegion* pRegions)
+{
+	uint32_t texelIndex = 0U;
+#ifdef CD_ALPHA_MAP_SSE2
+	for (; texelIndex + 4U <= texelCount; texelIndex += 4U)
+	{
+		__m128i* pData = reinterpret_cast<__m128i*>(pTexels + texelIndex * sizeof(int32_t));
+		_mm_storeu_si128(pData, ElevationToRGBA8<Blend>(_mm_loadu_si128(pData), pRegions));
+	}
+#endif
+
+	for (; texelIndex < texelCount; ++texelIndex)
+	{
+		std::byte* pData = pTexels + texelIndex * sizeof(int32_t);
+		int32_t elevation;
+		std::memcpy(&elevation, pData, sizeof(elevation));
+		const uint32_t rgba = ElevationToRGBA8<Blend>(elevation, pRegions);
+		std::memcpy(pData, &rgba, sizeof(rgba));
+	}
+}
+
+}
+
+namespace cdtools
+{
+
+void ConvertElevationToAlphaMap(std::byte* pTexels, uint32_t texelCount, const ElevationAlphaMapDef& alphaMapDef)
+{
+	assert(alphaMapDef.redGreenBlendRegion.blendEnd <= alphaMapDef.greenBlueBlendRegion.blendStart);
+	assert(alphaMapDef.greenBlueBlendRegion.blendEnd <= alphaMapDef.blueAlphaBlendRegion.blendStart);
+
+	const BlendRegion regions[3] = {
+		MakeBlendRegion(alphaMapDef.redGreenBlendRegion),
+		MakeBlendRegion(alphaMapDef.greenBlueBlendRegion),
+		MakeBlendRegion(alphaMapDef.blueAlphaBlendRegion),
+	};
+
+	// Specialize kernels by blend function so the inner loop has no branches.
+	switch (alphaMapDef.blendFunction)
+	{
+	case AlphaMapBlendFunction::Step:
+		ConvertElevationToAlphaMapImpl<AlphaMapBlendFunction::Step>(pTexels, texelCount, regions);
+		break;
+	case AlphaMapBlendFunction::Linear:
+		ConvertElevationToAlphaMapImpl<AlphaMapBlendFunction::Linear>(pTexels, texelCount, regions);
+		break;
+	case AlphaMapBlendFunction::SmoothStep:
+		ConvertElevationToAlphaMapImpl<AlphaMapBlendFunction::SmoothStep>(pTexels, texelCount, regions);
+		break;
+	case AlphaMapBlendFunction::SmoothStepHigh:
+		ConvertElevationToAlphaMapImpl<AlphaMapBlendFunction::SmoothStepHigh>(pTexels, texelCount, regions);
+		break;
+	default:
+		assert(false);
+	}
+}
+
+}
\ No newline at end of file
@@ -36,6 +36,16 @@ void TerrainProducer::SetSectorMetadata(const TerrainSectorMetadata& metadata)
 	m_pTerrainProducerImpl->SetSectorMetadata(metadata);
 }
 
+void TerrainProducer::SetMeshLayout(TerrainMeshLayout layout)
+{
+	m_pTerrainProducerImpl->SetMeshLayout(layout);
+}
+
+void TerrainProducer::SetLodLevelCount(uint32_t levelCount)
+{
+	m_pTerrainProducerImpl->SetLodLevelCount(levelCount);
+}
+
 void TerrainProducer::SetAlphaMapTextureName(cdtools::AlphaMapChannel channel, const std::string_view textureName)
 {
 	m_pTerrainProducerImpl->SetAlphaMapTextureName(channel, textureName);
@@ -86,6 +96,11 @@ uint32_t TerrainProducer::GetVertsPerSector() const
 	return m_pTerrainProducerImpl->GetVertsPerSector();
 }
 
+uint32_t TerrainProducer::GetLodLevelCount() const
+{
+	return m_pTerrainProducerImpl->GetLodLevelCount();
+}
+
 const std::string_view TerrainProducer::GetAlphaMapTextureName(cdtools::AlphaMapChannel channel) const
 {
 	return m_pTerrainProducerImpl->GetAlphaMapTextureName(channel);
@@ -109,4 +124,9 @@ void TerrainProducer::Execute(cd::SceneDatabase* pSceneDatabase)
 	m_pTerrainProducerImpl->Execute(pSceneDatabase);
 }
 
+bool TerrainProducer::ExecuteStreaming(const char* pOutputFolder, uint32_t windowSectorCount)
+{
+	return m_pTerrainProducerImpl->ExecuteStreaming(pOutputFolder, windowSectorCount);
+}
+
 }	// namespace cdtools
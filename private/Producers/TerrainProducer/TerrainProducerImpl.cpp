@@ -1,19 +1,26 @@
 #include "TerrainProducerImpl.h"
 
+#include "Base/Endian.h"
 #include "Hashers/StringHash.hpp"
 #include "Math/Math.hpp"
 #include "Math/NoiseGenerator.h"
+#include "Producers/TerrainProducer/AlphaMapBlend.h"
 #include "Scene/Material.h"
 #include "Scene/Mesh.h"
 #include "Scene/SceneDatabase.h"
 #include "Scene/Texture.h"
 #include "Scene/VertexFormat.h"
+#include "Utilities/ParallelFor.h"
 #include "Utilities/StringUtils.h"
 #include "Utilities/Utils.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cfloat>
 #include <cinttypes>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
 
 using namespace cd;
 using namespace cdtools;
@@ -21,54 +28,91 @@ using namespace cdtools;
 namespace
 {
 
-float GetNoiseAt(
+// Fill heights of count samples starting at (x, z) along x axis. Octaves are evaluated by rows in SIMD lanes.
+void GetNoiseRow(
 	const uint32_t x,
 	const uint32_t z,
+	const uint32_t count,
 	const uint32_t terrainLenInX,
 	const uint32_t terrainLenInZ,
 	const float redistPower,
-	const std::vector<ElevationOctave>& octaves)
+	const std::vector<ElevationOctave>& octaves,
+	std::vector<float>& octaveNoises,
+	float* pHeights)
 {
 	const double nx = x / static_cast<double>(terrainLenInX);
 	const double nz = z / static_cast<double>(terrainLenInZ);
-	float height = 0.0f;
+	const double stepX = 1.0 / static_cast<double>(terrainLenInX);
+	octaveNoises.resize(count);
+	std::fill(pHeights, pHeights + count, 0.0f);
 	float totalWeight = 0.0f;
 	for (uint32_t i = 0; i < octaves.size(); ++i)
 	{
 		const ElevationOctave& octave = octaves[i];
-		height += octave.weight * NoiseGenerator::SimplexNoise2D(octave.seed, octave.frequency * nx, octave.frequency * nz);
+		NoiseGenerator::SimplexNoise2DRow(octave.seed, octave.frequency * nx, octave.frequency * nz, octave.frequency * stepX, count, octaveNoises.data());
+		for (uint32_t sampleIndex = 0; sampleIndex < count; ++sampleIndex)
+		{
+			pHeights[sampleIndex] += octave.weight * octaveNoises[sampleIndex];
+		}
 		totalWeight += octave.weight;
 	}
-	if (totalWeight != 0.0f)
+	for (uint32_t sampleIndex = 0; sampleIndex < count; ++sampleIndex)
 	{
-		height /= totalWeight;
+		float height = pHeights[sampleIndex];
+		if (totalWeight != 0.0f)
+		{
+			height /= totalWeight;
+		}
+		pHeights[sampleIndex] = pow(height, redistPower);
 	}
-	height = pow(height, redistPower);
-	return height;
 }
 
-uint8_t GetChannelValue(uint32_t pixel, cdtools::AlphaMapChannel channel)
+// Height at grid vertex (x, z) of the surface made by grid quads which are stride times larger.
+// Triangles use the same diagonal as sector meshes : (bottomLeft, topLeft, bottomRight) and (bottomRight, topLeft, topRight).
+float SampleGridHeight(
+	const std::vector<float>& gridHeights,
+	const uint32_t quadsInX,
+	const uint32_t quadsInZ,
+	const uint32_t x,
+	const uint32_t z,
+	const uint32_t stride)
 {
-	// We assume the packing is RGBA in LSB order
-	switch (channel)
-	{
-	case AlphaMapChannel::Red:
-		return static_cast<uint8_t>(pixel & 0xFF);
-	case AlphaMapChannel::Green:
-		return static_cast<uint8_t>((pixel >> 8) & 0xFF);
-	case AlphaMapChannel::Blue:
-		return static_cast<uint8_t>((pixel >> 16) & 0xFF);
-	case AlphaMapChannel::Alpha:
-		return static_cast<uint8_t>((pixel >> 24) & 0xFF);
-	default:
-		assert(false);
+	const uint32_t verticesInX = quadsInX + 1;
+	const uint32_t left = std::min(x / stride, quadsInX / stride - 1) * stride;
+	const uint32_t bottom = std::min(z / stride, quadsInZ / stride - 1) * stride;
+	const float fx = static_cast<float>(x - left) / static_cast<float>(stride);
+	const float fz = static_cast<float>(z - bottom) / static_cast<float>(stride);
+
+	const float bottomLeft = gridHeights[bottom * verticesInX + left];
+	const float bottomRight = gridHeights[bottom * verticesInX + left + stride];
+	const float topLeft = gridHeights[(bottom + stride) * verticesInX + left];
+	const float topRight = gridHeights[(bottom + stride) * verticesInX + left + stride];
+	if (fx + fz <= 1.0f)
+	{
+		return bottomLeft + fx * (bottomRight - bottomLeft) + fz * (topLeft - bottomLeft);
 	}
+	return topRight + (1.0f - fx) * (topLeft - topRight) + (1.0f - fz) * (bottomRight - topRight);
 }
 
-uint32_t PackAsRGBA8U(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha)
+// Same layout as CDConsumer binary files : endian byte followed by SceneDatabase archive.
+bool SaveSceneDatabase(const std::filesystem::path& filePath, const SceneDatabase& sceneDatabase)
 {
-	// Assume RGBA in LSB order
-	return static_cast<uint32_t>(red | (green << 8) | (blue << 16) | (alpha << 24));
+	std::ofstream fout(filePath, std::ios::out | std::ios::binary);
+	if (!fout.is_open())
+	{
+		return false;
+	}
+
+	const uint8_t endian = static_cast<uint8_t>(Endian::GetNative());
+	fout.write(reinterpret_cast<const char*>(&endian), sizeof(uint8_t));
+	OutputArchive outputArchive(&fout);
+	sceneDatabase >> outputArchive;
+	return fout.good();
+}
+
+std::string GetQuadtreeObjectName(const char* pTypeName, uint32_t sector_x, uint32_t sector_z, uint32_t level, uint32_t node_x, uint32_t node_z)
+{
+	return string_format("%s(%u, %u, %u, %u, %u)", pTypeName, sector_x, sector_z, level, node_x, node_z);
 }
 
 }
@@ -98,6 +142,7 @@ void TerrainProducerImpl::SetSceneDatabaseIDs(const SceneDatabase* pSceneDatabas
 	m_nodeIDGenerator.SetCurrentID(pSceneDatabase->GetNodeCount());
 	m_meshIDGenerator.SetCurrentID(pSceneDatabase->GetMeshCount());
 	m_materialIDGenerator.SetCurrentID(pSceneDatabase->GetMaterialCount());
+	m_textureIDGenerator.SetCurrentID(pSceneDatabase->GetTextureCount());
 }
 
 void TerrainProducerImpl::SetTerrainMetadata(const TerrainMetadata& metadata)
@@ -110,6 +155,21 @@ void TerrainProducerImpl::SetSectorMetadata(const TerrainSectorMetadata& metadat
 	m_sectorMetadata = metadata;
 }
 
+void TerrainProducerImpl::SetMeshLayout(TerrainMeshLayout layout)
+{
+	assert(layout != TerrainMeshLayout::Count);
+	m_meshLayout = layout;
+	// Vertex count per sector depends on mesh layout.
+	Initialize();
+}
+
+void TerrainProducerImpl::SetLodLevelCount(uint32_t levelCount)
+{
+	assert(levelCount >= 1U && levelCount <= 8U);
+	m_maxLodLevelCount = levelCount;
+	Initialize();
+}
+
 void TerrainProducerImpl::SetAlphaMapTextureName(AlphaMapChannel channel, const std::string_view textureName)
 {
 	assert(channel != AlphaMapChannel::Count);
@@ -130,8 +190,20 @@ void TerrainProducerImpl::Initialize()
 	m_terrainLenInX = m_terrainMetadata.numSectorsInX * m_sectorLenInX;
 	m_terrainLenInZ = m_terrainMetadata.numSectorsInZ * m_sectorLenInZ;
 	m_quadsPerSector = m_sectorMetadata.numQuadsInX * m_sectorMetadata.numQuadsInZ;
-	m_verticesPerSector = m_quadsPerSector * 4;
+	m_verticesPerSector = TerrainMeshLayout::Quads == m_meshLayout
+		? m_quadsPerSector * 4
+		: (m_sectorMetadata.numQuadsInX + 1) * (m_sectorMetadata.numQuadsInZ + 1);
 	m_trianglesPerSector = m_quadsPerSector * 2;
+
+	// Every level halves patch quads of its parent so the level count is limited by how many times sector quads can be halved.
+	m_lodLevelCount = m_maxLodLevelCount;
+	while (m_lodLevelCount > 1U &&
+		((m_sectorMetadata.numQuadsInX % (1U << (m_lodLevelCount - 1U))) != 0U || (m_sectorMetadata.numQuadsInZ % (1U << (m_lodLevelCount - 1U))) != 0U))
+	{
+		--m_lodLevelCount;
+	}
+	m_patchQuadsInX = m_sectorMetadata.numQuadsInX >> (m_lodLevelCount - 1U);
+	m_patchQuadsInZ = m_sectorMetadata.numQuadsInZ >> (m_lodLevelCount - 1U);
 }
 
 void TerrainProducerImpl::GenerateAlphaMapWithElevation(
@@ -154,28 +226,105 @@ void TerrainProducerImpl::Execute(SceneDatabase* pSceneDatabase)
 	GenerateAllSectors(pSceneDatabase);
 }
 
-cd::Vec2f TerrainProducerImpl::GenerateElevationMap(uint32_t sector_x, uint32_t sector_z)
+bool TerrainProducerImpl::ExecuteStreaming(const char* pOutputFolder, uint32_t windowSectorCount)
 {
-	const size_t elevationMapSize = (m_sectorLenInX + 1) * (m_sectorLenInZ + 1) * sizeof(float);
-	m_elevationMap.resize(elevationMapSize);
+	const std::filesystem::path outputFolderPath(pOutputFolder);
+	std::error_code errorCode;
+	std::filesystem::create_directories(outputFolderPath, errorCode);
+
+	std::ofstream indexFile(outputFolderPath / "TerrainWorld.cdworld", std::ios::out | std::ios::binary);
+	if (!indexFile.is_open())
+	{
+		return false;
+	}
+
+	// Index header. Sector entries are appended after every window so nothing grows with sector count.
+	const uint8_t endian = static_cast<uint8_t>(Endian::GetNative());
+	indexFile.write(reinterpret_cast<const char*>(&endian), sizeof(uint8_t));
+	OutputArchive indexArchive(&indexFile);
+	m_terrainMetadata >> indexArchive;
+	m_sectorMetadata >> indexArchive;
+	indexArchive << m_sectorCount;
+
+	if (0U == windowSectorCount)
+	{
+		windowSectorCount = cd::GetParallelThreadCount();
+	}
+
+	std::atomic<bool> isSucceeded = true;
+	std::vector<TerrainSector> sectors;
+	for (uint32_t windowStart = 0; windowStart < m_sectorCount; windowStart += windowSectorCount)
+	{
+		const uint32_t windowSize = std::min(windowSectorCount, m_sectorCount - windowStart);
+		sectors.clear();
+		sectors.resize(windowSize);
+		for (uint32_t windowIndex = 0; windowIndex < windowSize; ++windowIndex)
+		{
+			TerrainSector& sector = sectors[windowIndex];
+			sector.x = (windowStart + windowIndex) % m_terrainMetadata.numSectorsInX;
+			sector.z = (windowStart + windowIndex) / m_terrainMetadata.numSectorsInX;
+			// Every sector file is a standalone SceneDatabase so object ids restart from 0.
+			m_nodeIDGenerator.Reset();
+			m_meshIDGenerator.Reset();
+			m_materialIDGenerator.Reset();
+			m_textureIDGenerator.Reset();
+			AllocateSectorIDs(sector);
+		}
+
+		cd::ParallelFor(windowSize, [this, &sectors, &outputFolderPath, &isSucceeded](uint32_t windowIndex)
+		{
+			TerrainSector& sector = sectors[windowIndex];
+			GenerateSector(sector);
+
+			const std::string sectorName = string_format("TerrainSector_%u_%u", sector.x, sector.z);
+			SceneDatabase sceneDatabase;
+			sceneDatabase.SetName(sectorName.c_str());
+			AddSectorToSceneDatabase(sector, &sceneDatabase);
+			if (!SaveSceneDatabase(outputFolderPath / (sectorName + ".cd"), sceneDatabase))
+			{
+				isSucceeded = false;
+			}
+		});
+
+		for (const TerrainSector& sector : sectors)
+		{
+			TerrainSectorChunk(static_cast<uint16_t>(sector.x), static_cast<uint16_t>(sector.z), sector.elevationMinMax.x(), sector.elevationMinMax.y(),
+				string_format("TerrainSector_%u_%u.cd", sector.x, sector.z)) >> indexArchive;
+		}
+	}
+
+	return isSucceeded && indexFile.good();
+}
+
+cd::Vec2f TerrainProducerImpl::GenerateElevationMap(uint32_t sector_x, uint32_t sector_z, std::vector<std::byte>& elevationMap) const
+{
+	// Elevations are rounded to integers and stored as R32I.
+	const size_t elevationMapSize = (m_sectorLenInX + 1) * (m_sectorLenInZ + 1) * sizeof(int32_t);
+	elevationMap.resize(elevationMapSize);
 
 	float minElevation = std::numeric_limits<float>::max();
-	float maxElevation = std::numeric_limits<float>::min();
+	float maxElevation = std::numeric_limits<float>::lowest();
 	size_t elevationMapByteMemIndex = 0;
+	std::vector<float> rowHeights(m_sectorLenInX + 1);
+	std::vector<float> octaveNoises;
 	for (uint32_t row = 0; row <= m_sectorLenInZ; ++row)
 	{
+		const uint32_t x = sector_x * m_sectorLenInX;
+		const uint32_t z = (sector_z * m_sectorLenInZ) + row;
+		GetNoiseRow(x, z, m_sectorLenInX + 1, m_terrainLenInX, m_terrainLenInZ, m_terrainMetadata.redistPow, m_terrainMetadata.octaves,
+			octaveNoises, rowHeights.data());
+
 		for (uint32_t col = 0; col <= m_sectorLenInX; ++col)
 		{
-			const uint32_t x = (sector_x * m_sectorLenInX) + col;
-			const uint32_t z = (sector_z * m_sectorLenInZ) + row;
-			float elevation = std::round(std::lerp(
+			const float elevation = std::round(std::lerp(
 				static_cast<float>(m_terrainMetadata.minElevation),
 				static_cast<float>(m_terrainMetadata.maxElevation),
-				GetNoiseAt(x, z, m_terrainLenInX, m_terrainLenInZ, m_terrainMetadata.redistPow, m_terrainMetadata.octaves)));
-			
+				rowHeights[col]));
+
 			assert(elevationMapByteMemIndex < elevationMapSize);
-			std::memcpy(&elevation, m_elevationMap.data() + elevationMapByteMemIndex, sizeof(elevation));
-			elevationMapByteMemIndex += sizeof(elevation);
+			const int32_t elevationValue = static_cast<int32_t>(elevation);
+			std::memcpy(elevationMap.data() + elevationMapByteMemIndex, &elevationValue, sizeof(elevationValue));
+			elevationMapByteMemIndex += sizeof(elevationValue);
 
 			if (cd::Math::IsLargeThan(elevation, maxElevation))
 			{
@@ -188,168 +337,128 @@ cd::Vec2f TerrainProducerImpl::GenerateElevationMap(uint32_t sector_x, uint32_t
 		}
 	}
 	assert(elevationMapByteMemIndex == elevationMapSize);
-	
+
 	return cd::Vec2f{ minElevation, maxElevation };
 }
 
-void TerrainProducerImpl::GenerateElevationBasedAlphaMap()
+void TerrainProducerImpl::GenerateAllSectors(cd::SceneDatabase* pSceneDatabase)
 {
-	assert(m_pElevationAlphaMapDef != nullptr);
-	assert(m_pElevationAlphaMapDef->redGreenBlendRegion.blendStart <= m_pElevationAlphaMapDef->redGreenBlendRegion.blendEnd);
-	assert(m_pElevationAlphaMapDef->greenBlueBlendRegion.blendStart <= m_pElevationAlphaMapDef->greenBlueBlendRegion.blendEnd);
-	assert(m_pElevationAlphaMapDef->blueAlphaBlendRegion.blendStart <= m_pElevationAlphaMapDef->blueAlphaBlendRegion.blendEnd);
-
-	size_t mapSize = m_elevationMap.size();
-	assert(0 == mapSize % sizeof(int32_t));
-	std::vector<std::byte> outAlphaMap;
-	outAlphaMap.resize(mapSize);
-
-	for (size_t elevationIndex = 0; elevationIndex < mapSize / sizeof(int32_t); ++elevationIndex)
+	std::vector<TerrainSector> sectors(m_sectorCount);
+	for (uint32_t sector_row = 0; sector_row < m_terrainMetadata.numSectorsInZ; ++sector_row)
 	{
-		int32_t elevation = 0;
-		const std::byte* pElevationByteData = &m_elevationMap[elevationIndex];
-		for (std::size_t byteIndex = 0; byteIndex < sizeof(int32_t); ++byteIndex)
+		for (uint32_t sector_col = 0; sector_col < m_terrainMetadata.numSectorsInX; ++sector_col)
 		{
-			elevation |= static_cast<int32_t>(pElevationByteData[byteIndex]) << (byteIndex * 8);
+			TerrainSector& sector = sectors[sector_row * m_terrainMetadata.numSectorsInX + sector_col];
+			sector.x = sector_col;
+			sector.z = sector_row;
+			// IDs are allocated in sector order before generation so they don't depend on thread scheduling.
+			AllocateSectorIDs(sector);
 		}
+	}
 
-		uint8_t red = 0;
-		uint8_t green = 0;
-		uint8_t blue = 0;
-		uint8_t alpha = 0;
-
-		// Calculate alpha map
-		const float greenBlendRange = static_cast<float>(
-			m_pElevationAlphaMapDef->redGreenBlendRegion.blendEnd - m_pElevationAlphaMapDef->redGreenBlendRegion.blendStart);
-		const float blueBlendRange = static_cast<float>(
-			m_pElevationAlphaMapDef->greenBlueBlendRegion.blendEnd - m_pElevationAlphaMapDef->greenBlueBlendRegion.blendStart);
-		const float alphaBlendRange = static_cast<float>(
-			m_pElevationAlphaMapDef->blueAlphaBlendRegion.blendEnd - m_pElevationAlphaMapDef->blueAlphaBlendRegion.blendStart);
-		if (elevation < m_pElevationAlphaMapDef->redGreenBlendRegion.blendStart)
-		{
-			// All red
-			red = 0xFF;
-		}
-		else if (elevation < m_pElevationAlphaMapDef->redGreenBlendRegion.blendEnd)
-		{
-			// Blend between red and green channel textures
-			const float t = (elevation - m_pElevationAlphaMapDef->redGreenBlendRegion.blendStart) / greenBlendRange;
-			switch (m_pElevationAlphaMapDef->blendFunction)
-			{
-			case cdtools::AlphaMapBlendFunction::Step:
-				// no blend since we are stepping
-				red = 0xFF;
-				break;
-			case cdtools::AlphaMapBlendFunction::Linear:
-				red = static_cast<uint8_t>(std::ceil(cdtools::lerp<float>(0x0, 0xFF, t)));
-				break;
-			case cdtools::AlphaMapBlendFunction::SmoothStep:
-				red = static_cast<uint8_t>(std::ceil(cdtools::smoothstep<float>(0.0f, 255.0f, t)));
-				break;
-			case cdtools::AlphaMapBlendFunction::SmoothStepHigh:
-				red = static_cast<uint8_t>(std::ceil(cdtools::smoothstep_high<float>(0.0f, 255.0f, t)));
-				break;
-			default:
-				assert(false);
-			}
-			green = static_cast<uint8_t>(0xFF - red);
-		}
-		else if (elevation < m_pElevationAlphaMapDef->greenBlueBlendRegion.blendStart)
-		{
-			// All green
-			green = 0xFF;
-		}
-		else if (elevation < m_pElevationAlphaMapDef->greenBlueBlendRegion.blendEnd)
+	cd::ParallelFor(m_sectorCount, [this, &sectors](uint32_t sectorIndex)
+	{
+		GenerateSector(sectors[sectorIndex]);
+	});
+
+	for (TerrainSector& sector : sectors)
+	{
+		AddSectorToSceneDatabase(sector, pSceneDatabase);
+	}
+}
+
+void TerrainProducerImpl::AddSectorToSceneDatabase(TerrainSector& sector, cd::SceneDatabase* pSceneDatabase) const
+{
+	if (!sector.isTextureReused)
+	{
+		pSceneDatabase->AddTexture(cd::MoveTemp(sector.texture));
+	}
+	pSceneDatabase->AddMaterial(cd::MoveTemp(sector.material));
+	if (TerrainMeshLayout::ChunkedQuadtree == m_meshLayout)
+	{
+		pSceneDatabase->AddRootNodeID(sector.nodeIDs.front());
+		for (Node& node : sector.nodes)
 		{
-			// Blend between green and blue channel textures
-			const float t = (elevation - m_pElevationAlphaMapDef->greenBlueBlendRegion.blendStart) / blueBlendRange;
-			switch (m_pElevationAlphaMapDef->blendFunction)
-			{
-			case cdtools::AlphaMapBlendFunction::Step:
-				// no blend since we are stepping
-				green = 0xFF;
-				break;
-			case cdtools::AlphaMapBlendFunction::Linear:
-				green = static_cast<uint8_t>(std::ceil(cdtools::lerp<float>(0x0, 0xFF, t)));
-				break;
-			case cdtools::AlphaMapBlendFunction::SmoothStep:
-				green = static_cast<uint8_t>(std::ceil(cdtools::smoothstep<float>(0.0f, 255.0f, t)));
-				break;
-			case cdtools::AlphaMapBlendFunction::SmoothStepHigh:
-				green = static_cast<uint8_t>(std::ceil(cdtools::smoothstep_high<float>(0.0f, 255.0f, t)));
-				break;
-			default:
-				assert(false);
-			}
-			blue = static_cast<uint8_t>(0xFF - green);
+			pSceneDatabase->AddNode(cd::MoveTemp(node));
 		}
-		else if (elevation < m_pElevationAlphaMapDef->blueAlphaBlendRegion.blendStart)
+		for (Mesh& patchMesh : sector.patchMeshes)
 		{
-			// All blue
-			blue = 0xFF;
+			pSceneDatabase->AddMesh(cd::MoveTemp(patchMesh));
 		}
-		else if (elevation < m_pElevationAlphaMapDef->blueAlphaBlendRegion.blendEnd)
+	}
+	else
+	{
+		pSceneDatabase->AddMesh(cd::MoveTemp(sector.mesh));
+	}
+}
+
+void TerrainProducerImpl::AllocateSectorIDs(TerrainSector& sector)
+{
+	if (TerrainMeshLayout::ChunkedQuadtree == m_meshLayout)
+	{
+		sector.nodeIDs.resize(GetQuadtreeNodeCount());
+		sector.patchMeshIDs.resize(GetQuadtreeNodeCount());
+		for (uint32_t level = 0; level < m_lodLevelCount; ++level)
 		{
-			// Blend between blue and alpha channel textures
-			const float t = (elevation - m_pElevationAlphaMapDef->blueAlphaBlendRegion.blendStart) / alphaBlendRange;
-			switch (m_pElevationAlphaMapDef->blendFunction)
+			for (uint32_t node_z = 0; node_z < (1U << level); ++node_z)
 			{
-			case cdtools::AlphaMapBlendFunction::Step:
-				// no blend since we are stepping
-				blue = 0xFF;
-				break;
-			case cdtools::AlphaMapBlendFunction::Linear:
-				blue = static_cast<uint8_t>(std::ceil(cdtools::lerp<float>(0x0, 0xFF, t)));
-				break;
-			case cdtools::AlphaMapBlendFunction::SmoothStep:
-				blue = static_cast<uint8_t>(std::ceil(cdtools::smoothstep<float>(0.0f, 255.0f, t)));
-				break;
-			case cdtools::AlphaMapBlendFunction::SmoothStepHigh:
-				blue = static_cast<uint8_t>(std::ceil(cdtools::smoothstep_high<float>(0.0f, 255.0f, t)));
-				break;
-			default:
-				assert(false);
+				for (uint32_t node_x = 0; node_x < (1U << level); ++node_x)
+				{
+					const uint32_t nodeIndex = GetQuadtreeNodeIndex(level, node_x, node_z);
+					const std::string nodeName = GetQuadtreeObjectName("TerrainNode", sector.x, sector.z, level, node_x, node_z);
+					sector.nodeIDs[nodeIndex] = m_nodeIDGenerator.AllocateID(StringHash<NodeID::ValueType>(nodeName));
+					const std::string patchMeshName = GetQuadtreeObjectName("TerrainPatch", sector.x, sector.z, level, node_x, node_z);
+					sector.patchMeshIDs[nodeIndex] = m_meshIDGenerator.AllocateID(StringHash<MeshID::ValueType>(patchMeshName));
+				}
 			}
-			alpha = static_cast<uint8_t>(0xFF - blue);
 		}
-		else
-		{
-			// all alpha
-			alpha = 0xFF;
-		}
-		// Write the value
-		uint32_t rgba = PackAsRGBA8U(red, green, blue, alpha);
-		std::memcpy(&rgba, outAlphaMap.data() + elevationIndex * sizeof(rgba), sizeof(rgba));
 	}
+	else
+	{
+		const std::string terrainMeshName = string_format("TerrainSector(%d, %d)", sector.x, sector.z);
+		sector.meshID = m_meshIDGenerator.AllocateID(StringHash<MeshID::ValueType>(terrainMeshName));
+	}
+
+	const std::string materialName = string_format("TerrainMaterial(%d, %d)", sector.x, sector.z);
+	sector.materialID = m_materialIDGenerator.AllocateID(StringHash<MaterialID::ValueType>(materialName));
 
-	m_elevationMap = cd::MoveTemp(outAlphaMap);
+	const std::string textureName = m_pElevationAlphaMapDef
+		? string_format("TerrainAlphaMap(%d, %d)", sector.x, sector.z)
+		: string_format("TerrainElevationMap(%d, %d)", sector.x, sector.z);
+	sector.textureID = m_textureIDGenerator.AllocateID(StringHash<TextureID::ValueType>(textureName), &sector.isTextureReused);
 }
 
-void TerrainProducerImpl::GenerateAllSectors(cd::SceneDatabase* pSceneDatabase)
+void TerrainProducerImpl::GenerateSector(TerrainSector& sector) const
 {
-	for (uint32_t sector_row = 0; sector_row < m_terrainMetadata.numSectorsInZ; ++sector_row)
+	std::vector<std::byte> elevationMap;
+	sector.elevationMinMax = GenerateElevationMap(sector.x, sector.z, elevationMap);
+	if (TerrainMeshLayout::ChunkedQuadtree == m_meshLayout)
 	{
-		for (uint32_t sector_col = 0; sector_col < m_terrainMetadata.numSectorsInX; ++sector_col)
-		{
-			cd::Vec2f elevationMinMax = GenerateElevationMap(sector_col, sector_row);
-			Mesh generatedTerrain = GenerateSectorAt(sector_col, sector_row, elevationMinMax);
-			MaterialID meshMaterialID = GenerateMaterialAndTextures(pSceneDatabase, sector_col, sector_row);
-			generatedTerrain.SetMaterialID(meshMaterialID);
-			pSceneDatabase->AddMesh(cd::MoveTemp(generatedTerrain));
-		}
+		GenerateQuadtreeSector(sector, elevationMap);
+	}
+	else
+	{
+		sector.mesh = TerrainMeshLayout::IndexedGrid == m_meshLayout
+			? GenerateGridSectorAt(sector.x, sector.z, sector.elevationMinMax, elevationMap, sector.meshID)
+			: GenerateSectorAt(sector.x, sector.z, sector.elevationMinMax, sector.meshID);
+		sector.mesh.AddMaterialID(sector.materialID);
 	}
+	GenerateMaterialAndTextures(sector, cd::MoveTemp(elevationMap));
 }
 
-Mesh TerrainProducerImpl::GenerateSectorAt(uint32_t sector_x, uint32_t sector_z, const cd::Vec2f& elevationMinMax)
+Mesh TerrainProducerImpl::GenerateSectorAt(uint32_t sector_x, uint32_t sector_z, const cd::Vec2f& elevationMinMax, cd::MeshID meshID) const
 {
 	const std::string terrainMeshName = string_format("TerrainSector(%d, %d)", sector_x, sector_z);
-	const MeshID::ValueType meshHash = StringHash<MeshID::ValueType>(terrainMeshName);
-	const MeshID terrainMeshID = m_meshIDGenerator.AllocateID(meshHash);
-	Mesh terrain(terrainMeshID, terrainMeshName.c_str(), m_verticesPerSector, m_trianglesPerSector);
+	Mesh terrain;
+	terrain.SetID(meshID);
+	terrain.SetName(terrainMeshName.c_str());
+	terrain.Init(m_verticesPerSector);
 	terrain.SetVertexUVSetCount(1);
 
+	PolygonGroup polygonGroup;
+	polygonGroup.reserve(m_trianglesPerSector);
+
 	uint32_t current_vertex_id = 0;
-	uint32_t current_polygon_id = 0;
 	for (uint32_t z = 0; z < static_cast<uint32_t>(m_sectorMetadata.numQuadsInZ); ++z)
 	{
 		for (uint32_t x = 0; x < static_cast<uint32_t>(m_sectorMetadata.numQuadsInX); ++x)
@@ -389,10 +498,12 @@ Mesh TerrainProducerImpl::GenerateSectorAt(uint32_t sector_x, uint32_t sector_z,
 			terrain.SetVertexUV(0, topRightPointId, UV(1.0f, 1.0f));
 			terrain.SetVertexUV(0, bottomRightPointId, UV(1.0f, 0.0f));
 			// The two triangle indices
-			terrain.SetPolygon(current_polygon_id++, { bottomLeftPointId, topLeftPointId, bottomRightPointId });
-			terrain.SetPolygon(current_polygon_id++, { bottomRightPointId, topLeftPointId, topRightPointId });
+			polygonGroup.push_back({ bottomLeftPointId, topLeftPointId, bottomRightPointId });
+			polygonGroup.push_back({ bottomRightPointId, topLeftPointId, topRightPointId });
 		}
 	}
+	terrain.AddPolygonGroup(cd::MoveTemp(polygonGroup));
+
 	// Set vertex attribute
 	VertexFormat meshVertexFormat;
 	meshVertexFormat.AddVertexAttributeLayout(VertexAttributeType::Position, GetAttributeValueType<Point::ValueType>(), Point::Size);
@@ -412,38 +523,308 @@ Mesh TerrainProducerImpl::GenerateSectorAt(uint32_t sector_x, uint32_t sector_z,
 	return terrain;
 }
 
-MaterialID TerrainProducerImpl::GenerateMaterialAndTextures(cd::SceneDatabase* pSceneDatabase, uint32_t sector_x, uint32_t sector_z)
+Mesh TerrainProducerImpl::GenerateGridSectorAt(uint32_t sector_x, uint32_t sector_z, const cd::Vec2f& elevationMinMax,
+	const std::vector<std::byte>& elevationMap, cd::MeshID meshID) const
+{
+	const std::string terrainMeshName = string_format("TerrainSector(%d, %d)", sector_x, sector_z);
+	Mesh terrain;
+	terrain.SetID(meshID);
+	terrain.SetName(terrainMeshName.c_str());
+	terrain.Init(m_verticesPerSector);
+	terrain.SetVertexUVSetCount(1);
+
+	// Vertices are stored row by row. Every vertex is shared by up to 4 quads.
+	const uint32_t verticesInX = m_sectorMetadata.numQuadsInX + 1;
+	const uint32_t verticesInZ = m_sectorMetadata.numQuadsInZ + 1;
+	const uint32_t elevationMapWidth = m_sectorLenInX + 1;
+	assert(elevationMap.size() == elevationMapWidth * (m_sectorLenInZ + 1) * sizeof(int32_t));
+	for (uint32_t z = 0; z < verticesInZ; ++z)
+	{
+		for (uint32_t x = 0; x < verticesInX; ++x)
+		{
+			const uint32_t col = x * m_sectorMetadata.quadLenInX;
+			const uint32_t row = z * m_sectorMetadata.quadLenInZ;
+			int32_t elevation = 0;
+			std::memcpy(&elevation, elevationMap.data() + (row * elevationMapWidth + col) * sizeof(elevation), sizeof(elevation));
+
+			const uint32_t vertexID = z * verticesInX + x;
+			terrain.SetVertexPosition(vertexID, Point(
+				static_cast<float>(sector_x * m_sectorLenInX + col),
+				static_cast<float>(elevation),
+				static_cast<float>(sector_z * m_sectorLenInZ + row)));
+			terrain.SetVertexUV(0, vertexID, UV(static_cast<float>(x), static_cast<float>(z)));
+		}
+	}
+
+	// Same triangles and winding as Quads layout.
+	PolygonGroup polygonGroup;
+	polygonGroup.reserve(m_trianglesPerSector);
+	for (uint32_t z = 0; z < static_cast<uint32_t>(m_sectorMetadata.numQuadsInZ); ++z)
+	{
+		for (uint32_t x = 0; x < static_cast<uint32_t>(m_sectorMetadata.numQuadsInX); ++x)
+		{
+			const VertexID bottomLeftPointId(z * verticesInX + x);
+			const VertexID bottomRightPointId(bottomLeftPointId.Data() + 1);
+			const VertexID topLeftPointId(bottomLeftPointId.Data() + verticesInX);
+			const VertexID topRightPointId(topLeftPointId.Data() + 1);
+			polygonGroup.push_back({ bottomLeftPointId, topLeftPointId, bottomRightPointId });
+			polygonGroup.push_back({ bottomRightPointId, topLeftPointId, topRightPointId });
+		}
+	}
+	terrain.AddPolygonGroup(cd::MoveTemp(polygonGroup));
+
+	VertexFormat meshVertexFormat;
+	meshVertexFormat.AddVertexAttributeLayout(VertexAttributeType::Position, GetAttributeValueType<Point::ValueType>(), Point::Size);
+	meshVertexFormat.AddVertexAttributeLayout(VertexAttributeType::UV, GetAttributeValueType<UV::ValueType>(), UV::Size);
+	terrain.SetVertexFormat(cd::MoveTemp(meshVertexFormat));
+
+	terrain.SetAABB(AABB(
+		Point(
+			static_cast<float>(sector_x * m_sectorLenInX),
+			elevationMinMax.x(),
+			static_cast<float>(sector_z * m_sectorLenInZ)),
+		Point(
+			static_cast<float>((sector_x + 1) * m_sectorLenInX),
+			elevationMinMax.y(),
+			static_cast<float>((sector_z + 1) * m_sectorLenInZ))));
+	return terrain;
+}
+
+void TerrainProducerImpl::GenerateQuadtreeSector(TerrainSector& sector, const std::vector<std::byte>& elevationMap) const
 {
-	const std::string materialName = string_format("TerrainMaterial(%d, %d)", sector_x, sector_z);
-	MaterialID::ValueType materialHash = cd::StringHash<MaterialID::ValueType>(materialName);
-	MaterialID materialID = m_materialIDGenerator.AllocateID(materialHash);
-	Material terrainSectorMaterial{ materialID, materialName.c_str(), MaterialType::BasePBR };
-
-	std::string textureName = m_pElevationAlphaMapDef
-		? string_format("TerrainAlphaMap(%d, %d)", sector_x, sector_z)
-		: string_format("TerrainElevationMap(%d, %d)", sector_x, sector_z);
-	uint32_t textureHash = cd::StringHash<cd::TextureID::ValueType>(textureName.c_str());
-	bool isTextureReused;
-	TextureID textureID = m_textureIDGenerator.AllocateID(textureHash, &isTextureReused);
-	terrainSectorMaterial.SetTextureID(m_pElevationAlphaMapDef ? MaterialTextureType::AlphaMap : MaterialTextureType::Elevation, textureID);
-	if (!isTextureReused)
-	{
-		Texture texture{ textureID, textureName.c_str() };
-		texture.SetPath(textureName.c_str());
-		texture.SetFormat(m_pElevationAlphaMapDef ? TextureFormat::RGBA8 : TextureFormat::R32I);
-		texture.SetWidth(m_sectorLenInX + 1);
-		texture.SetHeight(m_sectorLenInZ + 1);
-		if (m_pElevationAlphaMapDef)
+	// Heights of full detail grid vertices which are also leaf patch vertices.
+	const uint32_t quadsInX = m_sectorMetadata.numQuadsInX;
+	const uint32_t quadsInZ = m_sectorMetadata.numQuadsInZ;
+	const uint32_t verticesInX = quadsInX + 1;
+	const uint32_t elevationMapWidth = m_sectorLenInX + 1;
+	std::vector<float> gridHeights(verticesInX * (quadsInZ + 1));
+	for (uint32_t z = 0; z <= quadsInZ; ++z)
+	{
+		for (uint32_t x = 0; x <= quadsInX; ++x)
 		{
-			GenerateElevationBasedAlphaMap();
+			const uint32_t col = x * m_sectorMetadata.quadLenInX;
+			const uint32_t row = z * m_sectorMetadata.quadLenInZ;
+			int32_t elevation = 0;
+			std::memcpy(&elevation, elevationMap.data() + (row * elevationMapWidth + col) * sizeof(elevation), sizeof(elevation));
+			gridHeights[z * verticesInX + x] = static_cast<float>(elevation);
 		}
-		texture.SetRawData(cd::MoveTemp(m_elevationMap));
-		pSceneDatabase->AddTexture(cd::MoveTemp(texture));
 	}
 
-	pSceneDatabase->AddMaterial(cd::MoveTemp(terrainSectorMaterial));
+	// Error of a node is the max distance between its patch and full detail grid vertices.
+	// Levels are visited from leaves to root so a node error also covers its children and errors never increase when refining.
+	const uint32_t nodeCount = GetQuadtreeNodeCount();
+	std::vector<float> lodErrors(nodeCount, 0.0f);
+	std::vector<cd::Vec2f> heightMinMaxs(nodeCount);
+	for (uint32_t level = m_lodLevelCount; level-- > 0U;)
+	{
+		const uint32_t stride = 1U << (m_lodLevelCount - 1U - level);
+		const uint32_t nodeQuadsInX = m_patchQuadsInX * stride;
+		const uint32_t nodeQuadsInZ = m_patchQuadsInZ * stride;
+		for (uint32_t node_z = 0; node_z < (1U << level); ++node_z)
+		{
+			for (uint32_t node_x = 0; node_x < (1U << level); ++node_x)
+			{
+				float lodError = 0.0f;
+				float minHeight = std::numeric_limits<float>::max();
+				float maxHeight = std::numeric_limits<float>::lowest();
+				for (uint32_t z = node_z * nodeQuadsInZ; z <= (node_z + 1) * nodeQuadsInZ; ++z)
+				{
+					for (uint32_t x = node_x * nodeQuadsInX; x <= (node_x + 1) * nodeQuadsInX; ++x)
+					{
+						const float height = gridHeights[z * verticesInX + x];
+						minHeight = std::min(minHeight, height);
+						maxHeight = std::max(maxHeight, height);
+						lodError = std::max(lodError, std::abs(SampleGridHeight(gridHeights, quadsInX, quadsInZ, x, z, stride) - height));
+					}
+				}
+
+				if (level + 1U < m_lodLevelCount)
+				{
+					for (uint32_t childIndex = 0; childIndex < 4U; ++childIndex)
+					{
+						const uint32_t childNodeIndex = GetQuadtreeNodeIndex(level + 1U, node_x * 2U + (childIndex & 1U), node_z * 2U + (childIndex >> 1U));
+						lodError = std::max(lodError, lodErrors[childNodeIndex]);
+					}
+				}
+
+				const uint32_t nodeIndex = GetQuadtreeNodeIndex(level, node_x, node_z);
+				lodErrors[nodeIndex] = lodError;
+				heightMinMaxs[nodeIndex] = cd::Vec2f(minHeight, maxHeight);
+			}
+		}
+	}
 
-	return materialID;
+	sector.nodes.resize(nodeCount);
+	sector.patchMeshes.resize(nodeCount);
+	for (uint32_t level = 0; level < m_lodLevelCount; ++level)
+	{
+		for (uint32_t node_z = 0; node_z < (1U << level); ++node_z)
+		{
+			for (uint32_t node_x = 0; node_x < (1U << level); ++node_x)
+			{
+				const uint32_t nodeIndex = GetQuadtreeNodeIndex(level, node_x, node_z);
+				const uint32_t parentNodeIndex = level > 0U ? GetQuadtreeNodeIndex(level - 1U, node_x / 2U, node_z / 2U) : nodeIndex;
+
+				// Skirts hide cracks to neighbors which are at most one level coarser.
+				const float skirtDepth = std::max(lodErrors[nodeIndex] + lodErrors[parentNodeIndex], 1.0f);
+				Mesh& patchMesh = sector.patchMeshes[nodeIndex];
+				patchMesh = GeneratePatchAt(sector, level, node_x, node_z, gridHeights, heightMinMaxs[nodeIndex], skirtDepth);
+				patchMesh.AddMaterialID(sector.materialID);
+
+				Node& node = sector.nodes[nodeIndex];
+				node.Init(sector.nodeIDs[nodeIndex], GetQuadtreeObjectName("TerrainNode", sector.x, sector.z, level, node_x, node_z));
+				node.SetParentID(level > 0U ? sector.nodeIDs[parentNodeIndex] : NodeID::Invalid());
+				node.SetTransform(Transform::Identity());
+				node.SetLodError(lodErrors[nodeIndex]);
+				node.AddMeshID(sector.patchMeshIDs[nodeIndex]);
+				if (level + 1U < m_lodLevelCount)
+				{
+					for (uint32_t childIndex = 0; childIndex < 4U; ++childIndex)
+					{
+						node.AddChildID(sector.nodeIDs[GetQuadtreeNodeIndex(level + 1U, node_x * 2U + (childIndex & 1U), node_z * 2U + (childIndex >> 1U))]);
+					}
+				}
+			}
+		}
+	}
+}
+
+Mesh TerrainProducerImpl::GeneratePatchAt(const TerrainSector& sector, uint32_t level, uint32_t node_x, uint32_t node_z,
+	const std::vector<float>& gridHeights, const cd::Vec2f& heightMinMax, float skirtDepth) const
+{
+	const uint32_t quadsInX = m_sectorMetadata.numQuadsInX;
+	const uint32_t quadsInZ = m_sectorMetadata.numQuadsInZ;
+	const uint32_t stride = 1U << (m_lodLevelCount - 1U - level);
+	const uint32_t originX = node_x * m_patchQuadsInX * stride;
+	const uint32_t originZ = node_z * m_patchQuadsInZ * stride;
+	const uint32_t patchVerticesInX = m_patchQuadsInX + 1;
+	const uint32_t patchVerticesInZ = m_patchQuadsInZ + 1;
+	const uint32_t surfaceVertexCount = patchVerticesInX * patchVerticesInZ;
+	const uint32_t skirtVertexCount = 2U * (m_patchQuadsInX + m_patchQuadsInZ);
+
+	const std::string patchMeshName = GetQuadtreeObjectName("TerrainPatch", sector.x, sector.z, level, node_x, node_z);
+	const uint32_t nodeIndex = GetQuadtreeNodeIndex(level, node_x, node_z);
+	Mesh patch;
+	patch.SetID(sector.patchMeshIDs[nodeIndex]);
+	patch.SetName(patchMeshName.c_str());
+	patch.Init(surfaceVertexCount + skirtVertexCount);
+	patch.SetVertexUVSetCount(2);
+
+	// UV set 0 is in quad units as IndexedGrid. UV set 1 x is the height on parent patch which vertex morphs to.
+	for (uint32_t z = 0; z < patchVerticesInZ; ++z)
+	{
+		for (uint32_t x = 0; x < patchVerticesInX; ++x)
+		{
+			const uint32_t gridX = originX + x * stride;
+			const uint32_t gridZ = originZ + z * stride;
+			const float height = gridHeights[gridZ * (quadsInX + 1) + gridX];
+			const float morphHeight = level > 0U ? SampleGridHeight(gridHeights, quadsInX, quadsInZ, gridX, gridZ, stride * 2U) : height;
+
+			const uint32_t vertexID = z * patchVerticesInX + x;
+			patch.SetVertexPosition(vertexID, Point(
+				static_cast<float>(sector.x * m_sectorLenInX + gridX * m_sectorMetadata.quadLenInX),
+				height,
+				static_cast<float>(sector.z * m_sectorLenInZ + gridZ * m_sectorMetadata.quadLenInZ)));
+			patch.SetVertexUV(0, vertexID, UV(static_cast<float>(gridX), static_cast<float>(gridZ)));
+			patch.SetVertexUV(1, vertexID, UV(morphHeight, 0.0f));
+		}
+	}
+
+	PolygonGroup polygonGroup;
+	polygonGroup.reserve(m_patchQuadsInX * m_patchQuadsInZ * 2U + skirtVertexCount * 2U);
+	for (uint32_t z = 0; z < m_patchQuadsInZ; ++z)
+	{
+		for (uint32_t x = 0; x < m_patchQuadsInX; ++x)
+		{
+			const VertexID bottomLeftPointId(z * patchVerticesInX + x);
+			const VertexID bottomRightPointId(bottomLeftPointId.Data() + 1);
+			const VertexID topLeftPointId(bottomLeftPointId.Data() + patchVerticesInX);
+			const VertexID topRightPointId(topLeftPointId.Data() + 1);
+			polygonGroup.push_back({ bottomLeftPointId, topLeftPointId, bottomRightPointId });
+			polygonGroup.push_back({ bottomRightPointId, topLeftPointId, topRightPointId });
+		}
+	}
+
+	// Skirt walks the border counterclockwise seen from above so its triangles face outwards.
+	std::vector<uint32_t> borderVertexIDs;
+	borderVertexIDs.reserve(skirtVertexCount);
+	for (uint32_t x = 0; x < m_patchQuadsInX; ++x)
+	{
+		borderVertexIDs.push_back(x);
+	}
+	for (uint32_t z = 0; z < m_patchQuadsInZ; ++z)
+	{
+		borderVertexIDs.push_back(z * patchVerticesInX + m_patchQuadsInX);
+	}
+	for (uint32_t x = m_patchQuadsInX; x > 0U; --x)
+	{
+		borderVertexIDs.push_back(m_patchQuadsInZ * patchVerticesInX + x);
+	}
+	for (uint32_t z = m_patchQuadsInZ; z > 0U; --z)
+	{
+		borderVertexIDs.push_back(z * patchVerticesInX);
+	}
+	assert(borderVertexIDs.size() == skirtVertexCount);
+
+	for (uint32_t borderIndex = 0; borderIndex < skirtVertexCount; ++borderIndex)
+	{
+		const uint32_t borderVertexID = borderVertexIDs[borderIndex];
+		const uint32_t skirtVertexID = surfaceVertexCount + borderIndex;
+		const Point& borderPosition = patch.GetVertexPosition(borderVertexID);
+		patch.SetVertexPosition(skirtVertexID, Point(borderPosition.x(), borderPosition.y() - skirtDepth, borderPosition.z()));
+		patch.SetVertexUV(0, skirtVertexID, patch.GetVertexUV(0, borderVertexID));
+		patch.SetVertexUV(1, skirtVertexID, UV(patch.GetVertexUV(1, borderVertexID).x() - skirtDepth, 0.0f));
+
+		const uint32_t nextBorderIndex = (borderIndex + 1U) % skirtVertexCount;
+		const VertexID nextBorderVertexID(borderVertexIDs[nextBorderIndex]);
+		const VertexID nextSkirtVertexID(surfaceVertexCount + nextBorderIndex);
+		polygonGroup.push_back({ VertexID(borderVertexID), nextBorderVertexID, VertexID(skirtVertexID) });
+		polygonGroup.push_back({ nextBorderVertexID, nextSkirtVertexID, VertexID(skirtVertexID) });
+	}
+	patch.AddPolygonGroup(cd::MoveTemp(polygonGroup));
+
+	VertexFormat meshVertexFormat;
+	meshVertexFormat.AddVertexAttributeLayout(VertexAttributeType::Position, GetAttributeValueType<Point::ValueType>(), Point::Size);
+	meshVertexFormat.AddVertexAttributeLayout(VertexAttributeType::UV, GetAttributeValueType<UV::ValueType>(), UV::Size);
+	patch.SetVertexFormat(cd::MoveTemp(meshVertexFormat));
+
+	patch.SetAABB(AABB(
+		Point(
+			static_cast<float>(sector.x * m_sectorLenInX + originX * m_sectorMetadata.quadLenInX),
+			heightMinMax.x() - skirtDepth,
+			static_cast<float>(sector.z * m_sectorLenInZ + originZ * m_sectorMetadata.quadLenInZ)),
+		Point(
+			static_cast<float>(sector.x * m_sectorLenInX + (originX + m_patchQuadsInX * stride) * m_sectorMetadata.quadLenInX),
+			heightMinMax.y(),
+			static_cast<float>(sector.z * m_sectorLenInZ + (originZ + m_patchQuadsInZ * stride) * m_sectorMetadata.quadLenInZ))));
+	return patch;
+}
+
+void TerrainProducerImpl::GenerateMaterialAndTextures(TerrainSector& sector, std::vector<std::byte> elevationMap) const
+{
+	const std::string materialName = string_format("TerrainMaterial(%d, %d)", sector.x, sector.z);
+	sector.material = Material{ sector.materialID, materialName.c_str(), MaterialType::BasePBR };
+	sector.material.SetTextureID(m_pElevationAlphaMapDef ? MaterialTextureType::AlphaMap : MaterialTextureType::Elevation, sector.textureID);
+	if (sector.isTextureReused)
+	{
+		return;
+	}
+
+	const std::string textureName = m_pElevationAlphaMapDef
+		? string_format("TerrainAlphaMap(%d, %d)", sector.x, sector.z)
+		: string_format("TerrainElevationMap(%d, %d)", sector.x, sector.z);
+	Texture texture{ sector.textureID, textureName.c_str() };
+	texture.SetPath(textureName.c_str());
+	texture.SetFormat(m_pElevationAlphaMapDef ? TextureFormat::RGBA8 : TextureFormat::R32I);
+	texture.SetWidth(m_sectorLenInX + 1);
+	texture.SetHeight(m_sectorLenInZ + 1);
+	if (m_pElevationAlphaMapDef)
+	{
+		// Elevation and alpha map texels are both 4 bytes so the conversion happens in place.
+		ConvertElevationToAlphaMap(elevationMap.data(), static_cast<uint32_t>(elevationMap.size() / sizeof(int32_t)), *m_pElevationAlphaMapDef);
+	}
+	texture.SetRawData(cd::MoveTemp(elevationMap));
+	sector.texture = cd::MoveTemp(texture);
 }
 
 }	// namespace cdtools
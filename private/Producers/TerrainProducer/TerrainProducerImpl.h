@@ -3,17 +3,18 @@
 #include "AlphaMap.h"
 #include "Producers/TerrainProducer/AlphaMapTypes.h"
 #include "Producers/TerrainProducer/TerrainTypes.h"
+#include "Scene/Material.h"
+#include "Scene/Mesh.h"
+#include "Scene/Node.h"
 #include "Scene/ObjectIDGenerator.h"
+#include "Scene/Texture.h"
 
 #include <memory>
 
 namespace cd
 {
 
-class Material;
-class Mesh;
 class SceneDatabase;
-class Texture;
 
 }
 
@@ -34,6 +35,8 @@ public:
 	void SetSceneDatabaseIDs(const cd::SceneDatabase* pSceneDatabase);
 	void SetTerrainMetadata(const TerrainMetadata& metadata);
 	void SetSectorMetadata(const TerrainSectorMetadata& metadata);
+	void SetMeshLayout(TerrainMeshLayout layout);
+	void SetLodLevelCount(uint32_t levelCount);
 	void SetAlphaMapTextureName(AlphaMapChannel channel, const std::string_view textureName);
 	void RemoveAlphaMapGeneration();
 	void Initialize();
@@ -45,6 +48,8 @@ public:
 	uint32_t GetSectorLengthInZ() const { return m_sectorLenInZ; }
 	uint32_t GetQuadsPerSector() const { return m_quadsPerSector; }
 	uint32_t GetVertsPerSector() const { return m_verticesPerSector; }
+	TerrainMeshLayout GetMeshLayout() const { return m_meshLayout; }
+	uint32_t GetLodLevelCount() const { return m_lodLevelCount; }
 	const std::string_view GetAlphaMapTextureName(AlphaMapChannel channel) const { return m_alphaMapTextureNames.at(static_cast<uint8_t>(channel)); }
 
 	void GenerateAlphaMapWithElevation(
@@ -54,16 +59,55 @@ public:
 		const AlphaMapBlendFunction& blendFunction);
 
 	void Execute(cd::SceneDatabase* pSceneDatabase);
+	bool ExecuteStreaming(const char* pOutputFolder, uint32_t windowSectorCount);
 
 private:
-	cd::Vec2f GenerateElevationMap(uint32_t sector_x, uint32_t sector_z);
-	void GenerateElevationBasedAlphaMap();
+	// Objects generated for one sector. Sectors don't share any data so they can be generated on different threads.
+	struct TerrainSector
+	{
+		uint32_t x;
+		uint32_t z;
+		cd::MeshID meshID;
+		cd::MaterialID materialID;
+		cd::TextureID textureID;
+		bool isTextureReused;
+		cd::Vec2f elevationMinMax;
+		cd::Mesh mesh;
+		cd::Material material;
+		cd::Texture texture;
+
+		// ChunkedQuadtree layout only. Quadtree nodes are stored level by level, see GetQuadtreeNodeIndex.
+		std::vector<cd::NodeID> nodeIDs;
+		std::vector<cd::MeshID> patchMeshIDs;
+		std::vector<cd::Node> nodes;
+		std::vector<cd::Mesh> patchMeshes;
+	};
+
+	uint32_t GetQuadtreeNodeCount() const { return ((1U << (2U * m_lodLevelCount)) - 1U) / 3U; }
+	static uint32_t GetQuadtreeNodeIndex(uint32_t level, uint32_t node_x, uint32_t node_z)
+	{
+		return ((1U << (2U * level)) - 1U) / 3U + node_z * (1U << level) + node_x;
+	}
+
+	cd::Vec2f GenerateElevationMap(uint32_t sector_x, uint32_t sector_z, std::vector<std::byte>& elevationMap) const;
 	void GenerateAllSectors(cd::SceneDatabase* pSceneDatabase);
-	cd::Mesh GenerateSectorAt(uint32_t sector_x, uint32_t sector_z, const cd::Vec2f& elevationMinMax);
-	cd::MaterialID GenerateMaterialAndTextures(cd::SceneDatabase* pSceneDatabase, uint32_t sector_x, uint32_t sector_z);
+	void AllocateSectorIDs(TerrainSector& sector);
+	void GenerateSector(TerrainSector& sector) const;
+	void AddSectorToSceneDatabase(TerrainSector& sector, cd::SceneDatabase* pSceneDatabase) const;
+	cd::Mesh GenerateSectorAt(uint32_t sector_x, uint32_t sector_z, const cd::Vec2f& elevationMinMax, cd::MeshID meshID) const;
+	cd::Mesh GenerateGridSectorAt(uint32_t sector_x, uint32_t sector_z, const cd::Vec2f& elevationMinMax, const std::vector<std::byte>& elevationMap, cd::MeshID meshID) const;
+	void GenerateQuadtreeSector(TerrainSector& sector, const std::vector<std::byte>& elevationMap) const;
+	cd::Mesh GeneratePatchAt(const TerrainSector& sector, uint32_t level, uint32_t node_x, uint32_t node_z,
+		const std::vector<float>& gridHeights, const cd::Vec2f& heightMinMax, float skirtDepth) const;
+	void GenerateMaterialAndTextures(TerrainSector& sector, std::vector<std::byte> elevationMap) const;
 
 	cdtools::TerrainMetadata m_terrainMetadata;
 	cdtools::TerrainSectorMetadata m_sectorMetadata;
+	TerrainMeshLayout m_meshLayout = TerrainMeshLayout::Quads;
+	uint32_t m_maxLodLevelCount = 4U;
+	uint32_t m_lodLevelCount;
+	uint32_t m_patchQuadsInX;
+	uint32_t m_patchQuadsInZ;
 	uint32_t m_terrainLenInX;
 	uint32_t m_terrainLenInZ;
 	uint32_t m_sectorCount;
@@ -76,9 +120,6 @@ private:
 	std::unique_ptr<ElevationAlphaMapDef> m_pElevationAlphaMapDef = nullptr;
 	std::unique_ptr<NoiseAlphaMapDef> m_pNoiseAlphaMapDef = nullptr;
 
-	// We use RGBA8 here, 1 byte per channel, 4 channels per pixel.
-	std::vector<std::byte> m_elevationMap;
-
 	cd::ObjectIDGenerator<cd::NodeID> m_nodeIDGenerator;
 	cd::ObjectIDGenerator<cd::MeshID> m_meshIDGenerator;
 	cd::ObjectIDGenerator<cd::MaterialID> m_materialIDGenerator;
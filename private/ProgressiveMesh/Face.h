@@ -17,8 +17,8 @@ public:
 	explicit Face(cd::FaceID id) : m_id(id) { }
 	Face(const Face&) = default;
 	Face& operator=(const Face&) = default;
-	Face(Face&&) = default;
-	Face& operator=(Face&&) = default;
+	Face(Face&&) noexcept = default;
+	Face& operator=(Face&&) noexcept = default;
 	~Face() = default;
 
 	void SetID(cd::FaceID id) { m_id = id; }
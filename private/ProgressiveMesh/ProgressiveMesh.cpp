@@ -74,4 +74,19 @@ cd::Mesh ProgressiveMesh::GenerateLodMesh(uint32_t targetFaceCount, const cd::Me
 	return m_pProgressiveMeshImpl->GenerateLodMesh(targetFaceCount, pSourceMesh);
 }
 
+std::vector<cd::Mesh> ProgressiveMesh::GenerateLodChain(std::span<const float> percents, const cd::Mesh* pSourceMesh)
+{
+	return m_pProgressiveMeshImpl->GenerateLodChain(percents, 0U, pSourceMesh);
+}
+
+std::vector<cd::Mesh> ProgressiveMesh::GenerateLodChain(std::span<const float> percents, uint32_t minFaceCount, const cd::Mesh* pSourceMesh)
+{
+	return m_pProgressiveMeshImpl->GenerateLodChain(percents, minFaceCount, pSourceMesh);
+}
+
+std::vector<cd::Mesh> ProgressiveMesh::GenerateLodChain(std::span<const uint32_t> targetFaceCounts, const cd::Mesh* pSourceMesh)
+{
+	return m_pProgressiveMeshImpl->GenerateLodChain(targetFaceCounts, pSourceMesh);
+}
+
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Hashers/HashCombine.hpp"
 #include "Scene/Mesh.h"
 #include "Scene/VertexFormat.h"
+#include "Utilities/ParallelFor.h"
 
 #include <cfloat>
 #include <unordered_map>
@@ -18,6 +19,18 @@ ProgressiveMeshImpl::~ProgressiveMeshImpl() = default;
 void ProgressiveMeshImpl::FromIndexedFaces(const std::vector<cd::Point>& vertices, const std::vector<cd::PolygonGroup>& polygonGroups)
 {
 	uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+	m_vertices.reserve(vertexCount);
+	m_collapseCosts.reserve(vertexCount);
+	m_collapseTargets.reserve(vertexCount);
+	m_collapseVersions.reserve(vertexCount);
+
+	uint32_t faceCount = 0U;
+	for (const auto& polygonGroup : polygonGroups)
+	{
+		faceCount += static_cast<uint32_t>(polygonGroup.size());
+	}
+	m_faces.reserve(faceCount);
+
 	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
 	{
 		AddVertex(vertices[vertexIndex]);
@@ -25,6 +38,7 @@ void ProgressiveMeshImpl::FromIndexedFaces(const std::vector<cd::Point>& vertice
 
 	for (const auto& polygonGroup : polygonGroups)
 	{
+		m_polygonGroupFaceCounts.push_back(static_cast<uint32_t>(polygonGroup.size()));
 		for (const auto& polygon : polygonGroup)
 		{
 			uint32_t v0Index = polygon[0].Data();
@@ -56,6 +70,9 @@ void ProgressiveMeshImpl::FromIndexedFaces(const std::vector<cd::Point>& vertice
 
 void ProgressiveMeshImpl::InitBoundary(const cd::AABB& aabb)
 {
+	// Boundary vertices have different collapse costs so cached operations are out of date.
+	m_collapseOperations = CollapseOperations();
+
 	for (auto& v : m_vertices)
 	{
 		if (v.IsOnBoundary())
@@ -70,6 +87,8 @@ void ProgressiveMeshImpl::InitBoundary(const cd::AABB& aabb)
 
 void ProgressiveMeshImpl::InitBoundary(const std::vector<cd::Point>& vertices, const std::vector<cd::PolygonGroup>& polygonGroups)
 {
+	m_collapseOperations = CollapseOperations();
+
 	auto GetVertexHash = [](const cd::Point& p)
 	{
 		return HashCombine(Math::CastFloatToU32(p.x()), HashCombine(Math::CastFloatToU32(p.y()), Math::CastFloatToU32(p.z())));
@@ -96,20 +115,30 @@ void ProgressiveMeshImpl::InitBoundary(const std::vector<cd::Point>& vertices, c
 	}
 }
 
-std::pair<std::vector<uint32_t>, std::vector<uint32_t>> ProgressiveMeshImpl::BuildCollapseOperations()
+const CollapseOperations& ProgressiveMeshImpl::BuildCollapseOperations()
 {
-	for (const auto& vertex : m_vertices)
+	if (HasCollapseOperations())
 	{
-		ComputeEdgeCollapseCostAtVertex(vertex.GetID());
+		return m_collapseOperations;
 	}
 
-	for (auto& vertex : m_vertices)
+	// Collapse simulation modifies connectivity. Backup it so that lod meshes are generated from original faces
+	// and BuildCollapseOperations can run again after boundary changes.
+	std::vector<Vertex> originVertices = m_vertices;
+	std::vector<Face> originFaces = m_faces;
+
+	uint32_t vertexCount = GetVertexCount();
+	std::vector<CollapseQueueEntry> queueEntries;
+	queueEntries.reserve(vertexCount * 2U);
+	m_minCostVertexQueue = CollapseQueue(CompareCollapseQueueEntry(), cd::MoveTemp(queueEntries));
+
+	for (const auto& vertex : m_vertices)
 	{
 		assert(vertex.GetID().IsValid());
-		m_minCostVertexQueue.insert(&vertex);
+		ComputeEdgeCollapseCostAtVertex(vertex.GetID());
+		PushCollapseQueue(vertex.GetID());
 	}
 
-	uint32_t vertexCount = GetVertexCount();
 	std::vector<uint32_t> permutation;
 	permutation.resize(vertexCount);
 
@@ -118,17 +147,28 @@ std::pair<std::vector<uint32_t>, std::vector<uint32_t>> ProgressiveMeshImpl::Bui
 
 	for (int vertexIndex = static_cast<int>(vertexCount) - 1; vertexIndex >= 0; --vertexIndex)
 	{
-		assert(!m_minCostVertexQueue.empty());
-		auto itMinVertex = m_minCostVertexQueue.begin();
-		Vertex* pCandidate = *itMinVertex;
-		m_minCostVertexQueue.erase(itMinVertex);
+		// Skip stale entries which were pushed before the latest cost update of their vertices.
+		VertexID candidateID;
+		do
+		{
+			assert(!m_minCostVertexQueue.empty());
+			const auto& entry = m_minCostVertexQueue.top();
+			if (entry.version == m_collapseVersions[entry.vertexID.Data()])
+			{
+				candidateID = entry.vertexID;
+			}
+			m_minCostVertexQueue.pop();
+		} while (!candidateID.IsValid());
+
+		// Invalidate all remaining entries of the candidate vertex.
+		++m_collapseVersions[candidateID.Data()];
 
-		assert(pCandidate);
-		permutation[pCandidate->GetID().Data()] = vertexIndex;
-		map[vertexIndex] = pCandidate->GetCollapseTarget().Data();
+		VertexID collapseTarget = GetCollapseTarget(candidateID);
+		permutation[candidateID.Data()] = vertexIndex;
+		map[vertexIndex] = collapseTarget.Data();
 
-		//printf("Collapse [Vertex %d] - [Vertex %d], cost = %f\n", pCandidate->GetID().Data(), pCandidate->GetCollapseTarget().Data(), pCandidate->GetCollapseCost());
-		Collapse(pCandidate->GetID(), pCandidate->GetCollapseTarget());
+		//printf("Collapse [Vertex %d] - [Vertex %d], cost = %f\n", candidateID.Data(), collapseTarget.Data(), GetCollapseCost(candidateID));
+		Collapse(candidateID, collapseTarget);
 	}
 
 	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
@@ -136,15 +176,21 @@ std::pair<std::vector<uint32_t>, std::vector<uint32_t>> ProgressiveMeshImpl::Bui
 		map[vertexIndex] = map[vertexIndex] == cd::VertexID::InvalidID ? 0U : permutation[map[vertexIndex]];
 	}
 
-	return std::make_pair(cd::MoveTemp(permutation), cd::MoveTemp(map));
+	m_vertices = cd::MoveTemp(originVertices);
+	m_faces = cd::MoveTemp(originFaces);
+	m_minCostVertexQueue = CollapseQueue();
+
+	m_collapseOperations = std::make_pair(cd::MoveTemp(permutation), cd::MoveTemp(map));
+	return m_collapseOperations;
 }
 
 Vertex& ProgressiveMeshImpl::AddVertex(Point position)
 {
 	auto& vertex = m_vertices.emplace_back(Vertex(GetVertexCount()));
 	vertex.SetPosition(cd::MoveTemp(position));
-	vertex.SetCollapseCost(FLT_MAX);
-	vertex.SetCollapseTarget(cd::VertexID::InvalidID);
+	m_collapseCosts.push_back(FLT_MAX);
+	m_collapseTargets.push_back(cd::VertexID::InvalidID);
+	m_collapseVersions.push_back(0U);
 	return vertex;
 }
 
@@ -268,6 +314,12 @@ void ProgressiveMeshImpl::ReplaceVertexInFace(FaceID faceID, VertexID v0ID, Vert
 	ComputeNormal(face);
 }
 
+float ProgressiveMeshImpl::GetCollapseCost(VertexID vertexID) const
+{
+	float cost = m_collapseCosts[vertexID.Data()];
+	return GetVertex(vertexID.Data()).IsOnBoundary() ? cost + Vertex::BoundaryVertexCollapseCost : cost;
+}
+
 void ProgressiveMeshImpl::ComputeNormal(cd::pm::Face& face)
 {
 	auto v0Index = face.GetVertexID(0U).Data();
@@ -287,24 +339,27 @@ void ProgressiveMeshImpl::ComputeEdgeCollapseCostAtVertex(VertexID v0ID)
 {
 	uint32_t v0Index = v0ID.Data();
 	auto& v0 = m_vertices[v0Index];
+	float& collapseCost = m_collapseCosts[v0Index];
+	VertexID& collapseTarget = m_collapseTargets[v0Index];
 	if (v0.GetAdjacentVertices().Empty())
 	{
-		v0.SetCollapseCost(-1.0f);
-		v0.SetCollapseTarget(cd::VertexID::InvalidID);
+		collapseCost = -1.0f;
+		collapseTarget = cd::VertexID::InvalidID;
 		return;
 	}
 
 	// Prevent not update after cost becomes 0 after initialization.
-	v0.SetCollapseCost(FLT_MAX);
-	v0.SetCollapseTarget(cd::VertexID::InvalidID);
+	collapseCost = FLT_MAX;
+	collapseTarget = cd::VertexID::InvalidID;
 
+	// Candidates are compared with the boundary penalty but raw edge costs are stored. GetCollapseCost adds the penalty.
 	for (auto v1ID : v0.GetAdjacentVertices())
 	{
 		float cost = ComputeEdgeCollapseCostAtEdge(v0ID, v1ID);
-		if (cost < v0.GetCollapseCost())
+		if (cost < GetCollapseCost(v0ID))
 		{
-			v0.SetCollapseCost(cost);
-			v0.SetCollapseTarget(v1ID);
+			collapseCost = cost;
+			collapseTarget = v1ID;
 		}
 	}
 }
@@ -317,12 +372,12 @@ float ProgressiveMeshImpl::ComputeEdgeCollapseCostAtEdge(VertexID v0ID, VertexID
 	float edgeLength = (v0.GetPosition() - v1.GetPosition()).Length();
 	float curvature = 0.0f;
 
-	std::vector<FaceID> sideFaceIDs;
+	cd::DynamicArray<FaceID> sideFaceIDs;
 	for (auto v0Face : v0.GetAdjacentFaces())
 	{
 		if (GetFace(v0Face.Data()).GetVertexIDs().Contains(v1ID))
 		{
-			sideFaceIDs.push_back(v0Face);
+			sideFaceIDs.Add(v0Face);
 		}
 	}
 
@@ -385,14 +440,19 @@ void ProgressiveMeshImpl::Collapse(VertexID v0ID, VertexID v1ID)
 
 	for (auto vertexID : tmp)
 	{
-		Vertex& v = GetVertex(vertexID.Data());
-		m_minCostVertexQueue.erase(&v);
+		assert(GetVertex(vertexID.Data()).GetID().IsValid());
 		//printf("\t2 ComputeEdgeCostAtVertex [%d]\n", vertexID.Data());
 		ComputeEdgeCollapseCostAtVertex(vertexID);
-		m_minCostVertexQueue.insert(&v);
+		PushCollapseQueue(vertexID);
 	}
 }
 
+void ProgressiveMeshImpl::PushCollapseQueue(VertexID vertexID)
+{
+	uint32_t version = ++m_collapseVersions[vertexID.Data()];
+	m_minCostVertexQueue.push(CollapseQueueEntry{ GetCollapseCost(vertexID), vertexID, version });
+}
+
 cd::Mesh ProgressiveMeshImpl::GenerateLodMesh(float percent, const cd::Mesh* pSourceMesh)
 {
 	assert(percent >= 0.0f && percent <= 1.0f);
@@ -409,11 +469,45 @@ cd::Mesh ProgressiveMeshImpl::GenerateLodMesh(float percent, uint32_t minFaceCou
 
 cd::Mesh ProgressiveMeshImpl::GenerateLodMesh(uint32_t targetFaceCount, const cd::Mesh* pSourceMesh)
 {
-	auto collapseInfoPair = BuildCollapseOperations();
-	std::vector<uint32_t> permutation = collapseInfoPair.first;
-	std::vector<uint32_t> map = collapseInfoPair.second;
+	BuildCollapseOperations();
+	return GenerateLodMeshFromCollapseOperations(targetFaceCount, pSourceMesh);
+}
 
-	uint32_t targetVertexCount = targetFaceCount * 3U;
+std::vector<cd::Mesh> ProgressiveMeshImpl::GenerateLodChain(std::span<const float> percents, uint32_t minFaceCount, const cd::Mesh* pSourceMesh)
+{
+	std::vector<uint32_t> targetFaceCounts;
+	targetFaceCounts.reserve(percents.size());
+	for (float percent : percents)
+	{
+		assert(percent >= 0.0f && percent <= 1.0f);
+		targetFaceCounts.push_back(std::max(minFaceCount, static_cast<uint32_t>(GetFaceCount() * percent)));
+	}
+
+	return GenerateLodChain(targetFaceCounts, pSourceMesh);
+}
+
+std::vector<cd::Mesh> ProgressiveMeshImpl::GenerateLodChain(std::span<const uint32_t> targetFaceCounts, const cd::Mesh* pSourceMesh)
+{
+	// All lods share one collapse sequence. Generating a lod mesh only reads it so they can run in parallel.
+	BuildCollapseOperations();
+
+	uint32_t lodCount = static_cast<uint32_t>(targetFaceCounts.size());
+	std::vector<cd::Mesh> lodMeshes(lodCount);
+	cd::ParallelFor(lodCount, [this, &lodMeshes, &targetFaceCounts, pSourceMesh](uint32_t lodIndex)
+	{
+		lodMeshes[lodIndex] = GenerateLodMeshFromCollapseOperations(targetFaceCounts[lodIndex], pSourceMesh);
+	});
+
+	return lodMeshes;
+}
+
+cd::Mesh ProgressiveMeshImpl::GenerateLodMeshFromCollapseOperations(uint32_t targetFaceCount, const cd::Mesh* pSourceMesh) const
+{
+	assert(HasCollapseOperations());
+	const std::vector<uint32_t>& permutation = m_collapseOperations.first;
+	const std::vector<uint32_t>& map = m_collapseOperations.second;
+
+	uint32_t targetVertexCount = std::min(targetFaceCount * 3U, GetVertexCount());
 	cd::Mesh mesh;
 	mesh.Init(targetVertexCount);
 
@@ -482,9 +576,19 @@ cd::Mesh ProgressiveMeshImpl::GenerateLodMesh(uint32_t targetFaceCount, const cd
 		}
 	}
 
-	cd::PolygonGroup polygonGroup;
-	for (uint32_t faceIndex = 0U, totalFaceCount = GetFaceCount(); faceIndex < totalFaceCount; ++faceIndex)
+	// Faces were added by polygon group order so lod faces can be put back to their source polygon groups.
+	uint32_t polygonGroupIndex = 0U;
+	uint32_t polygonGroupFaceEnd = m_polygonGroupFaceCounts.empty() ? GetFaceCount() : m_polygonGroupFaceCounts[0];
+	std::vector<cd::PolygonGroup> polygonGroups(std::max(1U, static_cast<uint32_t>(m_polygonGroupFaceCounts.size())));
+
+	uint32_t lodFaceCount = 0U;
+	for (uint32_t faceIndex = 0U, totalFaceCount = GetFaceCount(); faceIndex < totalFaceCount && lodFaceCount < targetFaceCount; ++faceIndex)
 	{
+		while (faceIndex >= polygonGroupFaceEnd)
+		{
+			polygonGroupFaceEnd += m_polygonGroupFaceCounts[++polygonGroupIndex];
+		}
+
 		const auto& face = GetFace(faceIndex);
 		const auto& faceVertexIDs = face.GetVertexIDs();
 		assert(faceVertexIDs.Size() == 3U);
@@ -494,7 +598,7 @@ cd::Mesh ProgressiveMeshImpl::GenerateLodMesh(uint32_t targetFaceCount, const cd
 		{
 			uint32_t vertexIndex = faceVertexIDs[ii].Data();
 			uint32_t newVertexIndex = permutation[vertexIndex];
-			while (newVertexIndex > targetVertexCount)
+			while (newVertexIndex >= targetVertexCount)
 			{
 				newVertexIndex = map[newVertexIndex];
 			}
@@ -508,13 +612,14 @@ cd::Mesh ProgressiveMeshImpl::GenerateLodMesh(uint32_t targetFaceCount, const cd
 			continue;
 		}
 
-		polygonGroup.push_back(cd::MoveTemp(newFace));
-		if (polygonGroup.size() >= targetFaceCount)
-		{
-			break;
-		}
+		polygonGroups[polygonGroupIndex].push_back(cd::MoveTemp(newFace));
+		++lodFaceCount;
+	}
+
+	for (auto& polygonGroup : polygonGroups)
+	{
+		mesh.AddPolygonGroup(cd::MoveTemp(polygonGroup));
 	}
-	mesh.AddPolygonGroup(cd::MoveTemp(polygonGroup));
 
 	return mesh;
 }
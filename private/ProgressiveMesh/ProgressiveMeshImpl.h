@@ -5,7 +5,8 @@
 #include "Math/Box.hpp"
 #include "Scene/Mesh.h"
 
-#include <set>
+#include <queue>
+#include <span>
 
 namespace cd
 {
@@ -13,19 +14,31 @@ namespace cd
 namespace pm
 {
 
-struct CompareVertexCollapseCost
+// An entry in the collapse queue. Entries are never erased from the heap when a vertex cost changes.
+// Instead, the vertex version is increased and stale entries are skipped when they are popped.
+struct CollapseQueueEntry
 {
-	bool operator()(const Vertex* pV0, const Vertex* pV1) const
+	float cost;
+	VertexID vertexID;
+	uint32_t version;
+};
+
+struct CompareCollapseQueueEntry
+{
+	// std::priority_queue pops the largest element so the comparison is reversed.
+	// Equal costs are ordered by vertex id to keep the collapse sequence deterministic.
+	bool operator()(const CollapseQueueEntry& lhs, const CollapseQueueEntry& rhs) const
 	{
-		float v0Cost = pV0->GetCollapseCost();
-		float v1Cost = pV1->GetCollapseCost();
-		//printf("Compare [Vertex %u] and [Vertex %u]\n", pV0->GetID().Data(), pV1->GetID().Data());
-		//printf("\t[Vertex %u] cost is %f\n", pV0->GetID().Data(), v0Cost);
-		//printf("\t[Vertex %u] cost is %f\n", pV1->GetID().Data(), v1Cost);
-		return v0Cost == v1Cost ? pV0->GetID() < pV1->GetID() : v0Cost < v1Cost;
+		return lhs.cost == rhs.cost ? lhs.vertexID > rhs.vertexID : lhs.cost > rhs.cost;
 	}
 };
 
+using CollapseQueue = std::priority_queue<CollapseQueueEntry, std::vector<CollapseQueueEntry>, CompareCollapseQueueEntry>;
+
+// first : permutation from original vertex index to collapse order.
+// second : map from collapse order to the collapse order of target vertex.
+using CollapseOperations = std::pair<std::vector<uint32_t>, std::vector<uint32_t>>;
+
 class CORE_API ProgressiveMeshImpl
 {
 public:
@@ -39,7 +52,8 @@ public:
 	void FromIndexedFaces(const std::vector<cd::Point>& vertices, const std::vector<cd::PolygonGroup>& polygonGroups);
 	void InitBoundary(const cd::AABB& aabb);
 	void InitBoundary(const std::vector<cd::Point>& vertices, const std::vector<cd::PolygonGroup>& polygonGroups);
-	std::pair<std::vector<uint32_t>, std::vector<uint32_t>> BuildCollapseOperations();
+	const CollapseOperations& BuildCollapseOperations();
+	bool HasCollapseOperations() const { return !m_collapseOperations.first.empty(); }
 
 	uint32_t GetVertexCount() const { return static_cast<uint32_t>(m_vertices.size()); }
 	Vertex& AddVertex(Point position);
@@ -55,19 +69,35 @@ public:
 	Face& GetFace(uint32_t index) { return m_faces[index]; }
 	const Face& GetFace(uint32_t index) const { return m_faces[index]; }
 
+	float GetCollapseCost(VertexID vertexID) const;
+	VertexID GetCollapseTarget(VertexID vertexID) const { return m_collapseTargets[vertexID.Data()]; }
+
 	void ComputeNormal(cd::pm::Face& face);
 	void ComputeEdgeCollapseCostAtVertex(VertexID v0ID);
 	float ComputeEdgeCollapseCostAtEdge(VertexID v0ID, VertexID v1ID);
 	void Collapse(VertexID v0ID, VertexID v1ID);
+	void PushCollapseQueue(VertexID vertexID);
 
 	cd::Mesh GenerateLodMesh(float percent, const cd::Mesh* pSourceMesh);
 	cd::Mesh GenerateLodMesh(float percent, uint32_t minFaceCount, const cd::Mesh* pSourceMesh);
 	cd::Mesh GenerateLodMesh(uint32_t targetFaceCount, const cd::Mesh* pSourceMesh);
+	std::vector<cd::Mesh> GenerateLodChain(std::span<const float> percents, uint32_t minFaceCount, const cd::Mesh* pSourceMesh);
+	std::vector<cd::Mesh> GenerateLodChain(std::span<const uint32_t> targetFaceCounts, const cd::Mesh* pSourceMesh);
+
+private:
+	cd::Mesh GenerateLodMeshFromCollapseOperations(uint32_t targetFaceCount, const cd::Mesh* pSourceMesh) const;
 
 private:
 	std::vector<Vertex> m_vertices;
 	std::vector<Face> m_faces;
-	std::multiset<Vertex*, CompareVertexCollapseCost> m_minCostVertexQueue;
+	std::vector<uint32_t> m_polygonGroupFaceCounts;
+
+	// collapse
+	std::vector<float> m_collapseCosts;
+	std::vector<VertexID> m_collapseTargets;
+	std::vector<uint32_t> m_collapseVersions;
+	CollapseQueue m_minCostVertexQueue;
+	CollapseOperations m_collapseOperations;
 };
 
 }
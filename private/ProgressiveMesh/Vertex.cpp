@@ -19,9 +19,4 @@ void Vertex::AddAdjacentFace(FaceID faceID)
 	}
 }
 
-float Vertex::GetCollapseCost() const
-{
-	return m_isOnBoundary ? m_collapseCost + BoundaryVertexCollapseCost : m_collapseCost;
-}
-
 }
\ No newline at end of file
@@ -21,8 +21,8 @@ public:
 	explicit Vertex(cd::VertexID id) : m_id(id) { }
 	Vertex(const Vertex&) = default;
 	Vertex& operator=(const Vertex&) = default;
-	Vertex(Vertex&&) = default;
-	Vertex& operator=(Vertex&&) = default;
+	Vertex(Vertex&&) noexcept = default;
+	Vertex& operator=(Vertex&&) noexcept = default;
 	~Vertex() = default;
 
 	void SetID(cd::VertexID id) { m_id = id; }
@@ -43,12 +43,6 @@ public:
 	cd::DynamicArray<cd::FaceID>& GetAdjacentFaces() { return m_adjacentFaces; }
 	const cd::DynamicArray<cd::FaceID>& GetAdjacentFaces() const { return m_adjacentFaces; }
 
-	void SetCollapseCost(float cost) { m_collapseCost = cost; }
-	float GetCollapseCost() const;
-
-	void SetCollapseTarget(cd::VertexID target) { m_collapseTarget = target; }
-	cd::VertexID GetCollapseTarget() const { return m_collapseTarget; }
-
 private:
 	// data
 	cd::VertexID m_id;
@@ -60,10 +54,6 @@ private:
 	// connectivity
 	cd::DynamicArray<VertexID> m_adjacentVertices;
 	cd::DynamicArray<FaceID> m_adjacentFaces;
-
-	// collapse
-	float m_collapseCost;
-	cd::VertexID m_collapseTarget;
 };
 
 }
\ No newline at end of file
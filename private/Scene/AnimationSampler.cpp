@@ -0,0 +1,54 @@
+#include "Scene/AnimationSampler.h"
+#include "AnimationSamplerImpl.h"
+
+#include "Base/Template.h"
+
+namespace cd
+{
+
+AnimationSampler::AnimationSampler(const SceneDatabase& sceneDatabase, AnimationID animationID)
+{
+	m_pAnimationSamplerImpl = new AnimationSamplerImpl(sceneDatabase, animationID);
+}
+
+AnimationSampler::AnimationSampler(AnimationSampler&& rhs)
+{
+	*this = cd::MoveTemp(rhs);
+}
+
+AnimationSampler& AnimationSampler::operator=(AnimationSampler&& rhs)
+{
+	std::swap(m_pAnimationSamplerImpl, rhs.m_pAnimationSamplerImpl);
+	return *this;
+}
+
+AnimationSampler::~AnimationSampler()
+{
+	if (m_pAnimationSamplerImpl)
+	{
+		delete m_pAnimationSamplerImpl;
+		m_pAnimationSamplerImpl = nullptr;
+	}
+}
+
+uint32_t AnimationSampler::GetBoneCount() const
+{
+	return m_pAnimationSamplerImpl->GetBoneCount();
+}
+
+float AnimationSampler::GetDuration() const
+{
+	return m_pAnimationSamplerImpl->GetDuration();
+}
+
+void AnimationSampler::Sample(float time, std::span<Transform> outLocalTransforms)
+{
+	m_pAnimationSamplerImpl->Sample(time, outLocalTransforms);
+}
+
+void AnimationSampler::ResetCursors()
+{
+	m_pAnimationSamplerImpl->ResetCursors();
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "AnimationSamplerImpl.h"
+
+#include "Scene/SceneDatabase.h"
+#include "Scene/TrackCompressor.h"
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <unordered_map>
+
+namespace cd
+{
+
+namespace
+{
+
+constexpr uint32_t MaxCursorStepCount = 4U;
+
+// Empty channels get one key of default value.
+template<typename Value, typename KeyFrame>
+void AppendChannelKeys(AnimationSamplerImpl::Channel<Value>& channel, const std::vector<KeyFrame>* pKeyFrames, const Value& defaultValue)
+{
+	channel.valueOffsets.push_back(static_cast<uint32_t>(channel.keyValues.size()));
+	channel.quantizedBones.push_back(0U);
+	channel.minValues.push_back(Vec3f::Zero());
+	channel.extents.push_back(Vec3f::Zero());
+	if (pKeyFrames && !pKeyFrames->empty())
+	{
+		for (const KeyFrame& keyFrame : *pKeyFrames)
+		{
+			channel.keyTimes.push_back(keyFrame.GetTime());
+			channel.keyValues.push_back(keyFrame.GetValue());
+		}
+	}
+	else
+	{
+		channel.keyTimes.push_back(0.0f);
+		channel.keyValues.push_back(defaultValue);
+	}
+	channel.keyOffsets.push_back(static_cast<uint32_t>(channel.keyTimes.size()));
+}
+
+// Quantized keys are copied as they are and decoded while sampling.
+template<typename Value, typename KeyFrame>
+void AppendQuantizedChannelKeys(AnimationSamplerImpl::Channel<Value>& channel, const QuantizedKeyFrames& keyFrames, const Value& defaultValue)
+{
+	if (keyFrames.times.empty())
+	{
+		AppendChannelKeys<Value, KeyFrame>(channel, nullptr, defaultValue);
+		return;
+	}
+
+	channel.valueOffsets.push_back(static_cast<uint32_t>(channel.quantizedKeyValues.size() / 3U));
+	channel.quantizedBones.push_back(1U);
+	channel.minValues.push_back(keyFrames.minValue);
+	channel.extents.push_back(keyFrames.extent);
+	channel.keyTimes.insert(channel.keyTimes.end(), keyFrames.times.begin(), keyFrames.times.end());
+	channel.quantizedKeyValues.insert(channel.quantizedKeyValues.end(), keyFrames.values.begin(), keyFrames.values.end());
+	channel.keyOffsets.push_back(static_cast<uint32_t>(channel.keyTimes.size()));
+}
+
+template<typename Value, typename DecodeFunc, typename LerpFunc, typename OutputFunc>
+void SampleChannel(AnimationSamplerImpl::Channel<Value>& channel, float time, bool stepCursors, std::span<Transform> outLocalTransforms,
+	DecodeFunc&& decode, LerpFunc&& lerp, OutputFunc&& output)
+{
+	const float* pKeyTimes = channel.keyTimes.data();
+	const Value* pKeyValues = channel.keyValues.data();
+	const uint16_t* pQuantizedKeyValues = channel.quantizedKeyValues.data();
+	for (uint32_t boneIndex = 0U; boneIndex < static_cast<uint32_t>(outLocalTransforms.size()); ++boneIndex)
+	{
+		const uint32_t keyBegin = channel.keyOffsets[boneIndex];
+		const uint32_t keyEnd = channel.keyOffsets[boneIndex + 1U];
+
+		// Same as upper_bound of time in key times. Cursors step a few keys forward which covers playback,
+		// the rest of a long jump is binary searched.
+		uint32_t nextKey;
+		if (stepCursors)
+		{
+			nextKey = channel.cursors[boneIndex];
+			const uint32_t stepEnd = std::min(nextKey + MaxCursorStepCount, keyEnd);
+			while (nextKey < stepEnd && pKeyTimes[nextKey] <= time)
+			{
+				++nextKey;
+			}
+
+			if (nextKey < keyEnd && pKeyTimes[nextKey] <= time)
+			{
+				nextKey = static_cast<uint32_t>(std::upper_bound(pKeyTimes + nextKey, pKeyTimes + keyEnd, time) - pKeyTimes);
+			}
+		}
+		else
+		{
+			nextKey = static_cast<uint32_t>(std::upper_bound(pKeyTimes + keyBegin, pKeyTimes + keyEnd, time) - pKeyTimes);
+		}
+		channel.cursors[boneIndex] = nextKey;
+
+		const uint32_t valueOffset = channel.valueOffsets[boneIndex] - keyBegin;
+		const bool isQuantized = 0U != channel.quantizedBones[boneIndex];
+		auto GetKeyValue = [&](uint32_t keyIndex) -> Value
+		{
+			return isQuantized ? decode(pQuantizedKeyValues + (valueOffset + keyIndex) * 3U, boneIndex) : pKeyValues[valueOffset + keyIndex];
+		};
+
+		Value& outValue = output(outLocalTransforms[boneIndex]);
+		if (nextKey == keyBegin)
+		{
+			outValue = GetKeyValue(keyBegin);
+		}
+		else if (nextKey == keyEnd)
+		{
+			outValue = GetKeyValue(keyEnd - 1U);
+		}
+		else
+		{
+			const uint32_t previousKey = nextKey - 1U;
+			const float interval = pKeyTimes[nextKey] - pKeyTimes[previousKey];
+			const float factor = interval > 0.0f ? (time - pKeyTimes[previousKey]) / interval : 0.0f;
+			outValue = lerp(GetKeyValue(previousKey), GetKeyValue(nextKey), factor);
+		}
+	}
+}
+
+}
+
+AnimationSamplerImpl::AnimationSamplerImpl(const SceneDatabase& sceneDatabase, AnimationID animationID)
+{
+	const Animation& animation = sceneDatabase.GetAnimation(animationID.Data());
+	m_duration = animation.GetDuration();
+	m_boneCount = sceneDatabase.GetBoneCount();
+
+	// Bone tracks are named by animation name and bone name.
+	std::unordered_map<std::string, const Track*> tracksByName;
+	for (TrackID trackID : animation.GetBoneTrackIDs())
+	{
+		const Track& track = sceneDatabase.GetTrack(trackID.Data());
+		tracksByName[track.GetName()] = &track;
+	}
+
+	m_translations.keyOffsets.push_back(0U);
+	m_rotations.keyOffsets.push_back(0U);
+	m_scales.keyOffsets.push_back(0U);
+	for (uint32_t boneIndex = 0U; boneIndex < m_boneCount; ++boneIndex)
+	{
+		const Bone& bone = sceneDatabase.GetBone(boneIndex);
+		assert(bone.GetID().Data() == boneIndex);
+
+		auto itTrack = tracksByName.find(std::string(animation.GetName()) + bone.GetName());
+		if (itTrack == tracksByName.end())
+		{
+			const Transform& bindTransform = bone.GetTransform();
+			AppendChannelKeys<Vec3f, TranslationKey>(m_translations, nullptr, bindTransform.GetTranslation());
+			AppendChannelKeys<Quaternion, RotationKey>(m_rotations, nullptr, bindTransform.GetRotation());
+			AppendChannelKeys<Vec3f, ScaleKey>(m_scales, nullptr, bindTransform.GetScale());
+		}
+		else
+		{
+			// Empty channels of a track are sampled as identity like Track keys.
+			const Track* pTrack = itTrack->second;
+			if (KeyFrameEncoding::Quantized == pTrack->GetKeyFrameEncoding())
+			{
+				AppendQuantizedChannelKeys<Vec3f, TranslationKey>(m_translations, pTrack->GetQuantizedTranslationKeys(), TranslationKey::Identitiy());
+				AppendQuantizedChannelKeys<Quaternion, RotationKey>(m_rotations, pTrack->GetQuantizedRotationKeys(), RotationKey::Identitiy());
+				AppendQuantizedChannelKeys<Vec3f, ScaleKey>(m_scales, pTrack->GetQuantizedScaleKeys(), ScaleKey::Identitiy());
+			}
+			else
+			{
+				AppendChannelKeys(m_translations, &pTrack->GetTranslationKeys(), TranslationKey::Identitiy());
+				AppendChannelKeys(m_rotations, &pTrack->GetRotationKeys(), RotationKey::Identitiy());
+				AppendChannelKeys(m_scales, &pTrack->GetScaleKeys(), ScaleKey::Identitiy());
+			}
+		}
+	}
+
+	m_translations.cursors.resize(m_boneCount);
+	m_rotations.cursors.resize(m_boneCount);
+	m_scales.cursors.resize(m_boneCount);
+}
+
+void AnimationSamplerImpl::Sample(float time, std::span<Transform> outLocalTransforms)
+{
+	assert(outLocalTransforms.size() == m_boneCount);
+
+	const bool stepCursors = m_hasCursors && time >= m_lastSampleTime;
+	// Lambdas instead of function pointers so that decodings and interpolations are inlined.
+	auto DecodeTranslation = [this](const uint16_t* pValue, uint32_t boneIndex)
+	{
+		return TrackCompressor::DecodeRange(pValue, m_translations.minValues[boneIndex], m_translations.extents[boneIndex]);
+	};
+	auto DecodeRotation = [](const uint16_t* pValue, uint32_t) { return TrackCompressor::DecodeRotation(pValue); };
+	auto DecodeScale = [this](const uint16_t* pValue, uint32_t boneIndex)
+	{
+		return TrackCompressor::DecodeRange(pValue, m_scales.minValues[boneIndex], m_scales.extents[boneIndex]);
+	};
+	auto LerpVector = [](const Vec3f& a, const Vec3f& b, float factor) { return Vec3f::Lerp(a, b, factor); };
+	auto LerpQuaternion = [](const Quaternion& a, const Quaternion& b, float factor) { return Quaternion::LerpNormalized(a, b, factor); };
+	SampleChannel(m_translations, time, stepCursors, outLocalTransforms, DecodeTranslation, LerpVector,
+		[](Transform& transform) -> Vec3f& { return transform.GetTranslation(); });
+	SampleChannel(m_rotations, time, stepCursors, outLocalTransforms, DecodeRotation, LerpQuaternion,
+		[](Transform& transform) -> Quaternion& { return transform.GetRotation(); });
+	SampleChannel(m_scales, time, stepCursors, outLocalTransforms, DecodeScale, LerpVector,
+		[](Transform& transform) -> Vec3f& { return transform.GetScale(); });
+
+	m_lastSampleTime = time;
+	m_hasCursors = true;
+}
+
+void AnimationSamplerImpl::ResetCursors()
+{
+	m_hasCursors = false;
+}
+
+}
\ No newline at end of file
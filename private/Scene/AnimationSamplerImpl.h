@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Scene/AnimationSampler.h"
+
+#include <vector>
+
+namespace cd
+{
+
+class AnimationSamplerImpl final
+{
+public:
+	// Keys of one channel for all bones. Bone i owns keys [keyOffsets[i], keyOffsets[i + 1]) which are sorted by time.
+	// Every bone has at least one key so that sampling doesn't branch on missing tracks.
+	template<typename Value>
+	struct Channel
+	{
+		std::vector<uint32_t> keyOffsets;
+		std::vector<float> keyTimes;
+		// Key values of bone i start at valueOffsets[i] in keyValues, or in quantizedKeyValues by 3 uint16 per value
+		// if the bone track is quantized. Quantized translations and scales are relative to the bone value range.
+		std::vector<uint32_t> valueOffsets;
+		std::vector<uint8_t> quantizedBones;
+		std::vector<Value> keyValues;
+		std::vector<uint16_t> quantizedKeyValues;
+		std::vector<Vec3f> minValues;
+		std::vector<Vec3f> extents;
+		// Index of the first key after the last sampled time.
+		std::vector<uint32_t> cursors;
+	};
+
+public:
+	AnimationSamplerImpl() = delete;
+	explicit AnimationSamplerImpl(const SceneDatabase& sceneDatabase, AnimationID animationID);
+	AnimationSamplerImpl(const AnimationSamplerImpl&) = default;
+	AnimationSamplerImpl& operator=(const AnimationSamplerImpl&) = default;
+	AnimationSamplerImpl(AnimationSamplerImpl&&) = default;
+	AnimationSamplerImpl& operator=(AnimationSamplerImpl&&) = default;
+	~AnimationSamplerImpl() = default;
+
+	uint32_t GetBoneCount() const { return m_boneCount; }
+	float GetDuration() const { return m_duration; }
+
+	void Sample(float time, std::span<Transform> outLocalTransforms);
+	void ResetCursors();
+
+private:
+	uint32_t m_boneCount = 0U;
+	float m_duration = 0.0f;
+	float m_lastSampleTime = 0.0f;
+	bool m_hasCursors = false;
+
+	Channel<Vec3f> m_translations;
+	Channel<Quaternion> m_rotations;
+	Channel<Vec3f> m_scales;
+};
+
+}
\ No newline at end of file
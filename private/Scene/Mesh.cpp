@@ -21,6 +21,8 @@ PIMPL_VECTOR_TYPE_APIS(Mesh, MaterialID);
 PIMPL_VECTOR_TYPE_APIS(Mesh, PolygonGroup);
 PIMPL_VECTOR_TYPE_APIS(Mesh, BlendShapeID);
 PIMPL_VECTOR_TYPE_APIS(Mesh, SkinID);
+PIMPL_VECTOR_TYPE_APIS(Mesh, LodMeshID);
+PIMPL_VECTOR_TYPE_APIS(Mesh, LodScreenSize);
 
 Mesh Mesh::FromHalfEdgeMesh(const HalfEdgeMesh& halfEdgeMesh, ConvertStrategy strategy)
 {
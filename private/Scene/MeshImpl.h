@@ -39,6 +39,8 @@ public:
 	IMPLEMENT_VECTOR_TYPE_APIS(Mesh, PolygonGroup);
 	IMPLEMENT_VECTOR_TYPE_APIS(Mesh, BlendShapeID);
 	IMPLEMENT_VECTOR_TYPE_APIS(Mesh, SkinID);
+	IMPLEMENT_VECTOR_TYPE_APIS(Mesh, LodMeshID);
+	IMPLEMENT_VECTOR_TYPE_APIS(Mesh, LodScreenSize);
 
 	void Init(uint32_t vertexCount);
 	void Init(uint32_t vertexCount, uint32_t vertexInstanceCount);
@@ -75,6 +77,7 @@ public:
 		uint32_t materialCount;
 		uint32_t blendShapeCount;
 		uint32_t skinCount;
+		uint32_t lodCount;
 		uint32_t vertexCount;
 		uint32_t vertexInstanceCount;
 		uint32_t vertexUVSetCount;
@@ -82,7 +85,7 @@ public:
 		uint32_t polygonGroupCount;
 		
 		inputArchive >> GetName() >> GetID().Data() >> GetAABB()
-			>> materialCount >> blendShapeCount >> skinCount
+			>> materialCount >> blendShapeCount >> skinCount >> lodCount
 			>> vertexCount >> vertexInstanceCount >> vertexUVSetCount >> vertexColorSetCount
 			>> polygonGroupCount;
 
@@ -97,6 +100,13 @@ public:
 		SetSkinIDCount(skinCount);
 		inputArchive.ImportBuffer(GetSkinIDs().data());
 
+		// LOD data is part of SceneFormatVersion 1.
+		SetLodMeshIDCount(lodCount);
+		inputArchive.ImportBuffer(GetLodMeshIDs().data());
+
+		SetLodScreenSizeCount(lodCount);
+		inputArchive.ImportBuffer(GetLodScreenSizes().data());
+
 		Init(vertexCount, vertexInstanceCount);
 		inputArchive.ImportBuffer(GetVertexInstanceToIDs().data());
 		inputArchive.ImportBuffer(GetVertexPositions().data());
@@ -140,7 +150,7 @@ public:
 	const MeshImpl& operator>>(TOutputArchive<SwapBytesOrder>& outputArchive) const
 	{
 		outputArchive << GetName() << GetID().Data() << GetAABB()
-			<< GetMaterialIDCount() << GetBlendShapeIDCount() << GetSkinIDCount()
+			<< GetMaterialIDCount() << GetBlendShapeIDCount() << GetSkinIDCount() << GetLodMeshIDCount()
 			<< GetVertexPositionCount() << GetVertexInstanceToIDCount() << GetVertexUVSetCount() << GetVertexColorSetCount()
 			<< GetPolygonGroupCount();
 
@@ -148,6 +158,8 @@ public:
 		outputArchive.ExportBuffer(GetMaterialIDs().data(), GetMaterialIDs().size());
 		outputArchive.ExportBuffer(GetBlendShapeIDs().data(), GetBlendShapeIDs().size());
 		outputArchive.ExportBuffer(GetSkinIDs().data(), GetSkinIDs().size());
+		outputArchive.ExportBuffer(GetLodMeshIDs().data(), GetLodMeshIDs().size());
+		outputArchive.ExportBuffer(GetLodScreenSizes().data(), GetLodScreenSizes().size());
 		outputArchive.ExportBuffer(GetVertexInstanceToIDs().data(), GetVertexInstanceToIDs().size());
 		outputArchive.ExportBuffer(GetVertexPositions().data(), GetVertexPositions().size());
 		outputArchive.ExportBuffer(GetVertexNormals().data(), GetVertexNormals().size());
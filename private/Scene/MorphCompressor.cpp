@@ -0,0 +1,151 @@
+#include "Scene/MorphCompressor.h"
+
+#include "Math/SIMD.hpp"
+#include "Scene/Mesh.h"
+#include "Scene/Morph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+
+constexpr float Snorm16MaxValue = 32767.0f;
+
+}
+
+namespace cd
+{
+
+void MorphCompressor::SparsifyDeltas(Morph& morph, const Mesh& sourceMesh, float threshold)
+{
+	const bool isPosition = MorphEncoding::Position == morph.GetMorphEncoding();
+	auto& sourceIDs = morph.GetVertexSourceIDs();
+	auto& positions = morph.GetVertexPositions();
+
+	// Compacts kept vertices in place.
+	std::size_t keptCount = 0U;
+	for (std::size_t vertexIndex = 0U; vertexIndex < positions.size(); ++vertexIndex)
+	{
+		Point offset = positions[vertexIndex];
+		if (isPosition)
+		{
+			offset -= sourceMesh.GetVertexPosition(sourceIDs[vertexIndex].Data());
+		}
+
+		if (std::abs(offset.x()) <= threshold && std::abs(offset.y()) <= threshold && std::abs(offset.z()) <= threshold)
+		{
+			continue;
+		}
+
+		sourceIDs[keptCount] = sourceIDs[vertexIndex];
+		positions[keptCount] = offset;
+		++keptCount;
+	}
+
+	sourceIDs.resize(keptCount);
+	positions.resize(keptCount);
+	if (isPosition)
+	{
+		morph.SetMorphEncoding(MorphEncoding::Delta);
+	}
+}
+
+void MorphCompressor::QuantizeDeltas(Morph& morph)
+{
+	assert(morph.GetMorphEncoding() != MorphEncoding::Position);
+
+	auto& offsets = morph.GetVertexPositions();
+	const float maxOffset = GetMaxOffset(offsets);
+	for (Point& offset : offsets)
+	{
+		int16_t encoded[3];
+		EncodeDelta(offset, maxOffset, encoded);
+		offset = DecodeDelta(encoded, maxOffset);
+	}
+
+	morph.SetMorphEncoding(MorphEncoding::QuantizedDelta);
+}
+
+float MorphCompressor::GetMaxOffset(std::span<const Point> offsets)
+{
+	float maxOffset = 0.0f;
+	for (const Point& offset : offsets)
+	{
+		maxOffset = std::max(maxOffset, std::max(std::abs(offset.x()), std::max(std::abs(offset.y()), std::abs(offset.z()))));
+	}
+
+	return maxOffset;
+}
+
+void MorphCompressor::EncodeDelta(const Point& offset, float maxOffset, int16_t* pOutput)
+{
+	const float scale = maxOffset > 0.0f ? Snorm16MaxValue / maxOffset : 0.0f;
+	for (int componentIndex = 0; componentIndex < 3; ++componentIndex)
+	{
+		const float value = std::clamp(offset[componentIndex] * scale, -Snorm16MaxValue, Snorm16MaxValue);
+		pOutput[componentIndex] = static_cast<int16_t>(std::lround(value));
+	}
+}
+
+Point MorphCompressor::DecodeDelta(const int16_t* pInput, float maxOffset)
+{
+	const float scale = maxOffset / Snorm16MaxValue;
+	return Point(static_cast<float>(pInput[0]) * scale, static_cast<float>(pInput[1]) * scale, static_cast<float>(pInput[2]) * scale);
+}
+
+void MorphCompressor::ApplyDeltas(const Morph& morph, float weight, std::span<Point> positions)
+{
+	assert(morph.GetMorphEncoding() != MorphEncoding::Position);
+
+	const uint32_t vertexCount = morph.GetVertexPositionCount();
+	if (0U == vertexCount || positions.empty())
+	{
+		return;
+	}
+
+	static_assert(sizeof(Point) == Point::Size * sizeof(float));
+	const VertexID* pSourceIDs = morph.GetVertexSourceIDs().data();
+	const float* pOffsets = reinterpret_cast<const float*>(morph.GetVertexPositions().data());
+	float* pPositions = reinterpret_cast<float*>(positions.data());
+
+	// Kept vertices of a morph are mostly in runs of consecutive source IDs. Offsets and positions of a run are
+	// both contiguous so they are added as one float array.
+	uint32_t runBegin = 0U;
+	while (runBegin < vertexCount)
+	{
+		const uint32_t firstSourceID = pSourceIDs[runBegin].Data();
+		uint32_t runEnd = runBegin + 1U;
+		while (runEnd < vertexCount && pSourceIDs[runEnd].Data() == firstSourceID + (runEnd - runBegin))
+		{
+			++runEnd;
+		}
+		assert(firstSourceID + (runEnd - runBegin) <= positions.size());
+
+		float* pPosition = pPositions + firstSourceID * 3U;
+		const float* pOffset = pOffsets + runBegin * 3U;
+		const uint32_t floatCount = (runEnd - runBegin) * 3U;
+		uint32_t floatIndex = 0U;
+#if defined(CD_SIMD_SSE)
+		const __m128 scale = _mm_set1_ps(weight);
+		for (; floatIndex + 4U <= floatCount; floatIndex += 4U)
+		{
+			_mm_storeu_ps(pPosition + floatIndex, _mm_add_ps(_mm_loadu_ps(pPosition + floatIndex), _mm_mul_ps(_mm_loadu_ps(pOffset + floatIndex), scale)));
+		}
+#elif defined(CD_SIMD_NEON)
+		for (; floatIndex + 4U <= floatCount; floatIndex += 4U)
+		{
+			vst1q_f32(pPosition + floatIndex, vaddq_f32(vld1q_f32(pPosition + floatIndex), vmulq_n_f32(vld1q_f32(pOffset + floatIndex), weight)));
+		}
+#endif
+		for (; floatIndex < floatCount; ++floatIndex)
+		{
+			pPosition[floatIndex] += pOffset[floatIndex] * weight;
+		}
+
+		runBegin = runEnd;
+	}
+}
+
+}
\ No newline at end of file
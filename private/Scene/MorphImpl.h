@@ -3,6 +3,7 @@
 #include "Base/Template.h"
 #include "IO/InputArchive.hpp"
 #include "IO/OutputArchive.hpp"
+#include "Scene/MorphCompressor.h"
 #include "Scene/Types.h"
 
 #include <array>
@@ -24,17 +25,38 @@ public:
 	IMPLEMENT_VECTOR_TYPE_APIS(Morph, VertexSourceID);
 	IMPLEMENT_VECTOR_TYPE_APIS(Morph, VertexPosition);
 
+	// Morphs are built without Init so encoding has a default value instead of IMPLEMENT_SIMPLE_TYPE_APIS.
+	void SetMorphEncoding(MorphEncoding value) { m_MorphEncoding = value; }
+	MorphEncoding& GetMorphEncoding() { return m_MorphEncoding; }
+	MorphEncoding GetMorphEncoding() const { return m_MorphEncoding; }
+
 	uint32_t GetVertexCount() const { return GetVertexPositionCount(); }
 
 	template<bool SwapBytesOrder>
 	MorphImpl& operator<<(TInputArchive<SwapBytesOrder>& inputArchive)
 	{
+		uint8_t morphEncoding;
 		uint32_t vertexPositionCount;
-		inputArchive >> GetID().Data() >> GetBlendShapeID().Data() >> GetName() >> GetWeight() >> vertexPositionCount;
+		inputArchive >> GetID().Data() >> GetBlendShapeID().Data() >> GetName() >> GetWeight() >> morphEncoding >> vertexPositionCount;
+		SetMorphEncoding(static_cast<MorphEncoding>(morphEncoding));
 		SetVertexSourceIDCount(vertexPositionCount);
 		SetVertexPositionCount(vertexPositionCount);
 		inputArchive.ImportBuffer(GetVertexSourceIDs().data());
-		inputArchive.ImportBuffer(GetVertexPositions().data());
+		if (MorphEncoding::QuantizedDelta == GetMorphEncoding())
+		{
+			float maxOffset;
+			std::vector<int16_t> offsets(vertexPositionCount * 3U);
+			inputArchive >> maxOffset;
+			inputArchive.ImportBuffer(offsets.data());
+			for (uint32_t vertexIndex = 0U; vertexIndex < vertexPositionCount; ++vertexIndex)
+			{
+				GetVertexPosition(vertexIndex) = MorphCompressor::DecodeDelta(&offsets[vertexIndex * 3U], maxOffset);
+			}
+		}
+		else
+		{
+			inputArchive.ImportBuffer(GetVertexPositions().data());
+		}
 
 		return *this;
 	}
@@ -42,12 +64,31 @@ public:
 	template<bool SwapBytesOrder>
 	const MorphImpl& operator>>(TOutputArchive<SwapBytesOrder>& outputArchive) const
 	{
-		outputArchive << GetID().Data() << GetBlendShapeID().Data() << GetName() << GetWeight() << GetVertexPositionCount();
+		outputArchive << GetID().Data() << GetBlendShapeID().Data() << GetName() << GetWeight()
+			<< static_cast<uint8_t>(GetMorphEncoding()) << GetVertexPositionCount();
 		outputArchive.ExportBuffer(GetVertexSourceIDs().data(), GetVertexSourceIDs().size());
-		outputArchive.ExportBuffer(GetVertexPositions().data(), GetVertexPositions().size());
+		if (MorphEncoding::QuantizedDelta == GetMorphEncoding())
+		{
+			// Offsets are stored as 3 int16 per vertex after the max offset component which they are relative to.
+			const float maxOffset = MorphCompressor::GetMaxOffset(GetVertexPositions());
+			std::vector<int16_t> offsets(GetVertexPositionCount() * 3U);
+			for (uint32_t vertexIndex = 0U; vertexIndex < GetVertexPositionCount(); ++vertexIndex)
+			{
+				MorphCompressor::EncodeDelta(GetVertexPosition(vertexIndex), maxOffset, &offsets[vertexIndex * 3U]);
+			}
+			outputArchive << maxOffset;
+			outputArchive.ExportBuffer(offsets.data(), offsets.size());
+		}
+		else
+		{
+			outputArchive.ExportBuffer(GetVertexPositions().data(), GetVertexPositions().size());
+		}
 
 		return *this;
 	}
+
+private:
+	MorphEncoding m_MorphEncoding = MorphEncoding::Position;
 };
 
 }
\ No newline at end of file
@@ -12,6 +12,7 @@ void NodeImpl::Init(NodeID nodeID, std::string name)
 {
 	SetID(nodeID);
 	SetName(cd::MoveTemp(name));
+	SetLodError(0.0f);
 }
 
 }
\ No newline at end of file
@@ -22,6 +22,7 @@ public:
 
 	IMPLEMENT_SIMPLE_TYPE_APIS(Node, ID);
 	IMPLEMENT_SIMPLE_TYPE_APIS(Node, ParentID);
+	IMPLEMENT_SIMPLE_TYPE_APIS(Node, LodError);
 	IMPLEMENT_STRING_TYPE_APIS(Node, Name);
 	IMPLEMENT_COMPLEX_TYPE_APIS(Node, Transform);
 	IMPLEMENT_VECTOR_TYPE_APIS(Node, ChildID);
@@ -34,16 +35,18 @@ public:
 		uint32_t parentID;
 		std::string nodeName;
 		Transform transform;
+		float lodError;
 		uint32_t childCount;
 		uint32_t meshCount;
 
 		inputArchive >> nodeID >> parentID;
-		inputArchive >> nodeName >> transform;
+		inputArchive >> nodeName >> transform >> lodError;
 		inputArchive >> childCount >> meshCount;
 
 		Init(NodeID(nodeID), cd::MoveTemp(nodeName));
 		SetParentID(NodeID(parentID));
 		SetTransform(cd::MoveTemp(transform));
+		SetLodError(lodError);
 
 		GetChildIDs().resize(childCount);
 		inputArchive.ImportBuffer(GetChildIDs().data());
@@ -58,7 +61,7 @@ public:
 	const NodeImpl& operator>>(TOutputArchive<SwapBytesOrder>& outputArchive) const
 	{
 		outputArchive << GetID().Data() << GetParentID().Data();
-		outputArchive << GetName() << GetTransform();
+		outputArchive << GetName() << GetTransform() << GetLodError();
 		outputArchive << GetChildIDCount() << GetMeshIDCount();
 		outputArchive.ExportBuffer(GetChildIDs().data(), GetChildIDs().size());
 		outputArchive.ExportBuffer(GetMeshIDs().data(), GetMeshIDs().size());
@@ -31,6 +31,13 @@ public:
 	Vty GetCurrentID() const { return m_currentID; }
 	void SetCurrentID(Vty id) { m_currentID = id; }
 
+	// Forget allocated ids and restart from min id.
+	void Reset()
+	{
+		m_currentID = m_minID;
+		m_objectIDLUT.clear();
+	}
+
 	// Set generated id range in [min, max]
 	void SetRange(Vty min, Vty max) { m_minID = min; m_maxID = max; }
 
@@ -112,6 +112,16 @@ void SceneDatabase::UpdateAABB()
 	m_pSceneDatabaseImpl->UpdateAABB();
 }
 
+std::vector<Matrix4x4> SceneDatabase::CalculateNodeWorldTransforms() const
+{
+	return m_pSceneDatabaseImpl->CalculateNodeWorldTransforms();
+}
+
+std::vector<AABB> SceneDatabase::CalculateSkinAnimationAABBs(SkinID skinID, AnimationID animationID) const
+{
+	return m_pSceneDatabaseImpl->CalculateSkinAnimationAABBs(skinID, animationID);
+}
+
 ///////////////////////////////////////////////////////////////////
 // Operators
 ///////////////////////////////////////////////////////////////////
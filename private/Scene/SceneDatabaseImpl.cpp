@@ -1,9 +1,16 @@
 #include "SceneDatabaseImpl.h"
 
 #include "Base/NameOf.h"
+#include "Math/TransformBatch.h"
+#include "Math/WorldTransformSolver.h"
+#include "Scene/TrackCompressor.h"
+#include "Utilities/ParallelFor.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cfloat>
+#include <cmath>
+#include <unordered_map>
 
 namespace details
 {
@@ -42,6 +49,72 @@ void Dump(const char* label, const cd::Matrix4x4& matrix)
 	details::Dump(label, matrix.GetScale());
 }
 
+// Linear interpolation between the two keys around time. Keys are sorted by time.
+template<typename KeyFrame, typename LerpFunc>
+auto SampleKeyFrames(const std::vector<KeyFrame>& keyFrames, float time, LerpFunc&& lerp)
+{
+	if (keyFrames.empty())
+	{
+		return KeyFrame::Identitiy();
+	}
+
+	auto itNext = std::upper_bound(keyFrames.begin(), keyFrames.end(), time, [](float value, const KeyFrame& keyFrame) { return value < keyFrame.GetTime(); });
+	if (itNext == keyFrames.begin())
+	{
+		return keyFrames.front().GetValue();
+	}
+	if (itNext == keyFrames.end())
+	{
+		return keyFrames.back().GetValue();
+	}
+
+	const KeyFrame& previous = *(itNext - 1);
+	float interval = itNext->GetTime() - previous.GetTime();
+	float factor = interval > 0.0f ? (time - previous.GetTime()) / interval : 0.0f;
+	return lerp(previous.GetValue(), itNext->GetValue(), factor);
+}
+
+// Same as SampleKeyFrames over a quantized channel. Only the two keys around time are decoded.
+template<typename KeyFrame, typename DecodeFunc, typename LerpFunc>
+auto SampleQuantizedKeyFrames(const cd::QuantizedKeyFrames& keyFrames, float time, DecodeFunc&& decode, LerpFunc&& lerp)
+{
+	const std::vector<float>& times = keyFrames.times;
+	if (times.empty())
+	{
+		return KeyFrame::Identitiy();
+	}
+
+	const uint32_t nextKey = static_cast<uint32_t>(std::upper_bound(times.begin(), times.end(), time) - times.begin());
+	if (0U == nextKey)
+	{
+		return decode(keyFrames, 0U);
+	}
+	if (times.size() == nextKey)
+	{
+		return decode(keyFrames, nextKey - 1U);
+	}
+
+	float interval = times[nextKey] - times[nextKey - 1U];
+	float factor = interval > 0.0f ? (time - times[nextKey - 1U]) / interval : 0.0f;
+	return lerp(decode(keyFrames, nextKey - 1U), decode(keyFrames, nextKey), factor);
+}
+
+cd::Transform SampleTrack(const cd::Track& track, float time)
+{
+	if (cd::KeyFrameEncoding::Quantized == track.GetKeyFrameEncoding())
+	{
+		return cd::Transform(
+			SampleQuantizedKeyFrames<cd::TranslationKey>(track.GetQuantizedTranslationKeys(), time, &cd::TrackCompressor::DecodeRangeKey, &cd::Vec3f::Lerp),
+			SampleQuantizedKeyFrames<cd::RotationKey>(track.GetQuantizedRotationKeys(), time, &cd::TrackCompressor::DecodeRotationKey, &cd::Quaternion::LerpNormalized),
+			SampleQuantizedKeyFrames<cd::ScaleKey>(track.GetQuantizedScaleKeys(), time, &cd::TrackCompressor::DecodeRangeKey, &cd::Vec3f::Lerp));
+	}
+
+	return cd::Transform(
+		SampleKeyFrames(track.GetTranslationKeys(), time, &cd::Vec3f::Lerp),
+		SampleKeyFrames(track.GetRotationKeys(), time, &cd::Quaternion::LerpNormalized),
+		SampleKeyFrames(track.GetScaleKeys(), time, &cd::Vec3f::Lerp));
+}
+
 }
 
 namespace cd
@@ -191,6 +264,10 @@ void SceneDatabaseImpl::Dump() const
 		{
 			printf("[Node %u] ParentID = %u, Name = %s\n", node.GetID().Data(), node.GetParentID().Data(), node.GetName());
 			details::Dump(node.GetTransform());
+			if (node.GetLodError() > 0.0f)
+			{
+				printf("\tLodError = %f\n", node.GetLodError());
+			}
 
 			for (cd::MeshID meshID : node.GetMeshIDs())
 			{
@@ -233,6 +310,12 @@ void SceneDatabaseImpl::Dump() const
 			{
 				printf("\t[Associated Skin %u] Name = %s\n", skinID.Data(), GetSkin(skinID.Data()).GetName());
 			}
+
+			for (uint32_t lodIndex = 0U; lodIndex < mesh.GetLodMeshIDCount(); ++lodIndex)
+			{
+				auto lodMeshID = mesh.GetLodMeshID(lodIndex);
+				printf("\t[Associated LOD Mesh %u] Name = %s, ScreenSize = %f\n", lodMeshID.Data(), GetMesh(lodMeshID.Data()).GetName(), mesh.GetLodScreenSize(lodIndex));
+			}
 		}
 	}
 
@@ -347,6 +430,11 @@ void SceneDatabaseImpl::Dump() const
 			printf("[Texture %u] Name = %s\n", texture.GetID().Data(), texture.GetName());
 			printf("\tPath = %s\n", texture.GetPath());
 			printf("\tUVMapMode = (%s, %s)\n", nameof::nameof_enum(texture.GetUMapMode()).data(), nameof::nameof_enum(texture.GetVMapMode()).data());
+			if (texture.GetFormat() != cd::TextureFormat::Count)
+			{
+				printf("\tFormat = %s, Size = (%u, %u), UseMipMap = %d\n", nameof::nameof_enum(texture.GetFormat()).data(),
+					static_cast<uint32_t>(texture.GetWidth()), static_cast<uint32_t>(texture.GetHeight()), texture.GetUseMipMap());
+			}
 		}
 	}
 
@@ -451,6 +539,29 @@ void SceneDatabaseImpl::Dump() const
 		for (const auto& track : GetTracks())
 		{
 			printf("[Track %u] Name : %s\n", track.GetID().Data(), track.GetName());
+			if (cd::KeyFrameEncoding::Quantized == track.GetKeyFrameEncoding())
+			{
+				const auto& translationKeys = track.GetQuantizedTranslationKeys();
+				const auto& rotationKeys = track.GetQuantizedRotationKeys();
+				const auto& scaleKeys = track.GetQuantizedScaleKeys();
+				printf("\tQuantized TranslationKeyCount : %u, RotationKeyCount : %u, ScaleKeyCount : %u\n",
+					static_cast<uint32_t>(translationKeys.times.size()), static_cast<uint32_t>(rotationKeys.times.size()), static_cast<uint32_t>(scaleKeys.times.size()));
+
+				if (!translationKeys.times.empty())
+				{
+					details::Dump("\tFirstTranslationKey", cd::TrackCompressor::DecodeRangeKey(translationKeys, 0U));
+				}
+				if (!rotationKeys.times.empty())
+				{
+					details::Dump("\tFirstRotationKey", cd::TrackCompressor::DecodeRotationKey(rotationKeys, 0U));
+				}
+				if (!scaleKeys.times.empty())
+				{
+					details::Dump("\tFirstScaleKey", cd::TrackCompressor::DecodeRangeKey(scaleKeys, 0U));
+				}
+				continue;
+			}
+
 			printf("\tTranslationKeyCount : %u, RotationKeyCount : %u, ScaleKeyCount : %u\n",
 				track.GetTranslationKeyCount(), track.GetRotationKeyCount(), track.GetScaleKeyCount());
 
@@ -484,12 +595,22 @@ void SceneDatabaseImpl::Validate() const
 	{
 		const cd::Node& node = GetNode(nodeIndex);
 		assert(nodeIndex == node.GetID().Data());
+		for (auto childID : node.GetChildIDs())
+		{
+			// Children never have less detail than their parent.
+			assert(childID.Data() < GetNodeCount() && GetNode(childID.Data()).GetLodError() <= node.GetLodError());
+		}
 	}
 
 	for (uint32_t meshIndex = 0U; meshIndex < GetMeshCount(); ++meshIndex)
 	{
 		const cd::Mesh& mesh = GetMesh(meshIndex);
 		assert(meshIndex == mesh.GetID().Data());
+		assert(mesh.GetLodMeshIDCount() == mesh.GetLodScreenSizeCount());
+		for (auto lodMeshID : mesh.GetLodMeshIDs())
+		{
+			assert(lodMeshID.Data() < GetMeshCount() && lodMeshID.Data() != meshIndex);
+		}
 	}
 
 	for (uint32_t blendShapeIndex = 0U; blendShapeIndex < GetBlendShapeCount(); ++blendShapeIndex)
@@ -561,13 +682,33 @@ void SceneDatabaseImpl::Validate() const
 		}
 	};
 
+	auto CheckQuantizedKeyFramesTimeOrder = [](const cd::QuantizedKeyFrames& keyFrames)
+	{
+		assert(keyFrames.values.size() == keyFrames.times.size() * 3U);
+		float keyFrameTime = -FLT_MAX;
+		for (float keyTime : keyFrames.times)
+		{
+			assert(keyFrameTime < keyTime);
+			keyFrameTime = keyTime;
+		}
+	};
+
 	for (uint32_t trackIndex = 0U; trackIndex < GetTrackCount(); ++trackIndex)
 	{
 		const cd::Track& track = GetTrack(trackIndex);
 		assert(trackIndex == track.GetID().Data());
-		assert(track.GetTranslationKeyCount() > 0 || track.GetRotationKeyCount() > 0 || track.GetScaleKeyCount() > 0);
-
 		//assert(GetBoneByName(track.GetName()));
+		if (cd::KeyFrameEncoding::Quantized == track.GetKeyFrameEncoding())
+		{
+			assert(!track.GetQuantizedTranslationKeys().times.empty() || !track.GetQuantizedRotationKeys().times.empty() ||
+				!track.GetQuantizedScaleKeys().times.empty());
+			CheckQuantizedKeyFramesTimeOrder(track.GetQuantizedTranslationKeys());
+			CheckQuantizedKeyFramesTimeOrder(track.GetQuantizedRotationKeys());
+			CheckQuantizedKeyFramesTimeOrder(track.GetQuantizedScaleKeys());
+			continue;
+		}
+
+		assert(track.GetTranslationKeyCount() > 0 || track.GetRotationKeyCount() > 0 || track.GetScaleKeyCount() > 0);
 		CheckKeyFramesTimeOrder(track);
 	}
 
@@ -622,6 +763,10 @@ void SceneDatabaseImpl::Merge(cd::SceneDatabaseImpl&& sceneDatabaseImpl)
 		{
 			skinID.Set(skinID.Data() + originSkinCount);
 		}
+		for (auto& lodMeshID : mesh.GetLodMeshIDs())
+		{
+			lodMeshID.Set(lodMeshID.Data() + originMeshCount);
+		}
 
 		AddMesh(cd::MoveTemp(mesh));
 	}
@@ -727,12 +872,165 @@ void SceneDatabaseImpl::Merge(cd::SceneDatabaseImpl&& sceneDatabaseImpl)
 
 void SceneDatabaseImpl::UpdateAABB()
 {
-	cd::AABB sceneAABB(0.0f, 0.0f);
+	std::vector<cd::AABB> meshAABBs;
+	meshAABBs.reserve(GetMeshCount());
 	for (const auto& mesh : GetMeshes())
 	{
-		sceneAABB.Merge(mesh.GetAABB());
+		meshAABBs.push_back(mesh.GetAABB());
 	}
+
+	cd::AABB sceneAABB(0.0f, 0.0f);
+	sceneAABB.Merge(TransformBatch::MergeAABBs(meshAABBs));
 	SetAABB(cd::MoveTemp(sceneAABB));
 }
 
+std::vector<Matrix4x4> SceneDatabaseImpl::CalculateNodeWorldTransforms() const
+{
+	static_assert(cd::NodeID::InvalidID == WorldTransformSolver::InvalidParentIndex);
+
+	uint32_t nodeCount = GetNodeCount();
+	std::vector<uint32_t> parentIndices(nodeCount);
+	std::vector<Matrix4x4> localTransforms(nodeCount);
+	for (uint32_t nodeIndex = 0U; nodeIndex < nodeCount; ++nodeIndex)
+	{
+		const cd::Node& node = GetNode(nodeIndex);
+		assert(node.GetID().Data() == nodeIndex);
+		parentIndices[nodeIndex] = node.GetParentID().Data();
+		localTransforms[nodeIndex] = node.GetTransform().GetMatrix();
+	}
+
+	std::vector<Matrix4x4> worldTransforms(nodeCount);
+	WorldTransformSolver::Solve(parentIndices, localTransforms, worldTransforms);
+	return worldTransforms;
+}
+
+std::vector<AABB> SceneDatabaseImpl::CalculateSkinAnimationAABBs(SkinID skinID, AnimationID animationID) const
+{
+	static_assert(cd::BoneID::InvalidID == WorldTransformSolver::InvalidParentIndex);
+
+	const cd::Skin& skin = GetSkin(skinID.Data());
+	const cd::Animation& animation = GetAnimation(animationID.Data());
+	const cd::Mesh& mesh = GetMesh(skin.GetMeshID().Data());
+
+	// Bind pose AABB of vertices influenced by each bone. Skinned vertex is a weighted average of
+	// vertex positions transformed by bone matrices so it stays inside the union of transformed AABBs.
+	constexpr uint32_t InvalidInfluenceIndex = UINT32_MAX;
+	std::vector<uint32_t> influenceIndexByBone(skin.GetInfluenceBoneNameCount(), InvalidInfluenceIndex);
+	std::vector<uint32_t> influenceBoneIndices;
+	std::vector<cd::AABB> influenceAABBs;
+	for (uint32_t influenceBoneIndex = 0U; influenceBoneIndex < skin.GetInfluenceBoneNameCount(); ++influenceBoneIndex)
+	{
+		const cd::Bone* pBone = GetBoneByName(skin.GetInfluenceBoneName(influenceBoneIndex).c_str());
+		if (!pBone)
+		{
+			continue;
+		}
+
+		influenceIndexByBone[influenceBoneIndex] = static_cast<uint32_t>(influenceBoneIndices.size());
+		influenceBoneIndices.push_back(pBone->GetID().Data());
+		influenceAABBs.emplace_back(FLT_MAX, -FLT_MAX);
+	}
+
+	const uint32_t skinInfluenceCount = skin.GetMaxVertexInfluenceCount();
+	const uint32_t skinVertexCount = skinInfluenceCount > 0U ? skin.GetVertexInfluenceBoneCount() / skinInfluenceCount : 0U;
+	const std::vector<uint16_t>& vertexInfluenceBones = skin.GetVertexInfluenceBones();
+	const std::vector<float>& vertexInfluenceWeights = skin.GetVertexInfluenceWeights();
+	uint32_t vertexCount = std::min(skinVertexCount, mesh.GetVertexPositionCount());
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const cd::Point& position = mesh.GetVertexPosition(vertexIndex);
+		for (uint32_t influenceIndex = 0U; influenceIndex < skinInfluenceCount; ++influenceIndex)
+		{
+			const uint16_t influenceBone = vertexInfluenceBones[vertexIndex * skinInfluenceCount + influenceIndex];
+			if (cd::InvalidInfluenceBoneIndex == influenceBone || InvalidInfluenceIndex == influenceIndexByBone[influenceBone] ||
+				vertexInfluenceWeights[vertexIndex * skinInfluenceCount + influenceIndex] <= 0.0f)
+			{
+				continue;
+			}
+
+			cd::AABB& influenceAABB = influenceAABBs[influenceIndexByBone[influenceBone]];
+			influenceAABB.Merge(cd::AABB(position, position));
+		}
+	}
+
+	// Bones which don't move any vertex are dropped.
+	std::size_t usedInfluenceCount = 0U;
+	for (std::size_t influenceIndex = 0U; influenceIndex < influenceAABBs.size(); ++influenceIndex)
+	{
+		if (influenceAABBs[influenceIndex].Min().x() <= influenceAABBs[influenceIndex].Max().x())
+		{
+			influenceBoneIndices[usedInfluenceCount] = influenceBoneIndices[influenceIndex];
+			influenceAABBs[usedInfluenceCount] = influenceAABBs[influenceIndex];
+			++usedInfluenceCount;
+		}
+	}
+	influenceBoneIndices.resize(usedInfluenceCount);
+	influenceAABBs.resize(usedInfluenceCount);
+
+	// Bone tracks are named by animation name and bone name. Bones without track keep bind pose.
+	std::unordered_map<std::string, const cd::Track*> tracksByName;
+	for (cd::TrackID trackID : animation.GetBoneTrackIDs())
+	{
+		const cd::Track& track = GetTrack(trackID.Data());
+		tracksByName[track.GetName()] = &track;
+	}
+
+	uint32_t boneCount = GetBoneCount();
+	std::vector<uint32_t> parentIndices(boneCount);
+	std::vector<const cd::Track*> boneTracks(boneCount, nullptr);
+	for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+	{
+		const cd::Bone& bone = GetBone(boneIndex);
+		assert(bone.GetID().Data() == boneIndex);
+		parentIndices[boneIndex] = bone.GetParentID().Data();
+
+		auto itTrack = tracksByName.find(std::string(animation.GetName()) + bone.GetName());
+		if (itTrack != tracksByName.end())
+		{
+			boneTracks[boneIndex] = itTrack->second;
+		}
+	}
+
+	// Frame i is sampled at min(i / TicksPerSecond, Duration).
+	float ticksPerSecond = animation.GetTicksPerSecond();
+	float duration = animation.GetDuration();
+	uint32_t frameCount = ticksPerSecond > 0.0f && duration > 0.0f ? static_cast<uint32_t>(std::ceil(duration * ticksPerSecond)) + 1U : 1U;
+
+	std::vector<cd::AABB> frameAABBs(frameCount);
+	ParallelFor(frameCount, [&](uint32_t frameIndex)
+	{
+		float time = std::min(static_cast<float>(frameIndex) / std::max(ticksPerSecond, FLT_MIN), duration);
+
+		std::vector<Matrix4x4> localTransforms(boneCount);
+		for (uint32_t boneIndex = 0U; boneIndex < boneCount; ++boneIndex)
+		{
+			const cd::Track* pTrack = boneTracks[boneIndex];
+			if (!pTrack)
+			{
+				localTransforms[boneIndex] = GetBone(boneIndex).GetTransform().GetMatrix();
+				continue;
+			}
+
+			localTransforms[boneIndex] = details::SampleTrack(*pTrack, time).GetMatrix();
+		}
+
+		// Frames already run in parallel.
+		std::vector<Matrix4x4> worldTransforms(boneCount);
+		WorldTransformSolver::Solve(parentIndices, localTransforms, worldTransforms, 1U);
+
+		std::vector<Matrix4x4> skinTransforms(usedInfluenceCount);
+		for (std::size_t influenceIndex = 0U; influenceIndex < usedInfluenceCount; ++influenceIndex)
+		{
+			uint32_t boneIndex = influenceBoneIndices[influenceIndex];
+			skinTransforms[influenceIndex] = worldTransforms[boneIndex] * GetBone(boneIndex).GetOffset();
+		}
+
+		std::vector<cd::AABB> skinnedAABBs(usedInfluenceCount);
+		TransformBatch::TransformAABBs(skinTransforms, influenceAABBs, skinnedAABBs);
+		frameAABBs[frameIndex] = TransformBatch::MergeAABBs(skinnedAABBs, 1U);
+	});
+
+	return frameAABBs;
+}
+
 }
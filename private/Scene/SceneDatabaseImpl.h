@@ -18,6 +18,7 @@
 #include "Scene/Track.h"
 #include "Scene/ParticleEmitter.h"
 
+#include <cstdio>
 #include <optional>
 #include <unordered_map>
 #include <vector>
@@ -25,6 +26,18 @@
 namespace cd
 {
 
+// Scene archives start with the tag and the format version. Archives written before the tag start with the scene name
+// length which is never this large, so they are rejected as an unknown version instead of being misread.
+static constexpr uint64_t SceneFormatTag = 0x0045'4E45'4353'4443ULL;
+// 1 : Skin vertex influences are stored as bone palette indices and normalized weights.
+//     Tracks store a KeyFrameEncoding byte before their keys. Quantized tracks store unorm16 keys and no float keys.
+//     Meshes store a LOD count after their skin count and LOD mesh IDs and screen sizes after their skin IDs.
+//     Nodes store LodError after their transform.
+//     VertexAttributeLayout stores a streamIndex byte after attributeCount.
+//     Morphs store a MorphEncoding byte after their weight. QuantizedDelta morphs store a max offset and int16 offsets
+//     instead of float positions.
+static constexpr uint32_t SceneFormatVersion = 1U;
+
 class SceneDatabaseImpl
 {
 public:
@@ -74,10 +87,26 @@ public:
 	void Validate() const;
 	void Merge(cd::SceneDatabaseImpl&& sceneDatabaseImpl);
 	void UpdateAABB();
+	std::vector<Matrix4x4> CalculateNodeWorldTransforms() const;
+	std::vector<AABB> CalculateSkinAnimationAABBs(SkinID skinID, AnimationID animationID) const;
 
 	template<bool SwapBytesOrder>
 	SceneDatabaseImpl& operator<<(TInputArchive<SwapBytesOrder>& inputArchive)
 	{
+		uint64_t formatTag;
+		uint32_t formatVersion = 0U;
+		inputArchive >> formatTag;
+		if (SceneFormatTag == formatTag)
+		{
+			inputArchive >> formatVersion;
+		}
+
+		if (formatVersion != SceneFormatVersion)
+		{
+			printf("Unsupported scene format version %u, expected %u. Please export the scene again.\n", formatVersion, SceneFormatVersion);
+			return *this;
+		}
+
 		std::string sceneName;
 		inputArchive >> sceneName;
 		SetName(MoveTemp(sceneName));
@@ -211,6 +240,7 @@ public:
 	template<bool SwapBytesOrder>
 	const SceneDatabaseImpl& operator>>(TOutputArchive<SwapBytesOrder>& outputArchive) const
 	{
+		outputArchive << SceneFormatTag << SceneFormatVersion;
 		outputArchive << GetName() << GetAABB() << GetAxisSystem() << static_cast<uint8_t>(GetUnit())
 			<< GetRootNodeIDCount() << GetNodeCount()
 			<< GetMeshCount() << GetBlendShapeCount() << GetMorphCount()
@@ -13,5 +13,12 @@ PIMPL_STRING_TYPE_APIS(Skin, Name);
 PIMPL_VECTOR_TYPE_APIS(Skin, InfluenceBoneName);
 PIMPL_VECTOR_TYPE_APIS(Skin, VertexBoneNameArray);
 PIMPL_VECTOR_TYPE_APIS(Skin, VertexBoneWeightArray);
+PIMPL_VECTOR_TYPE_APIS(Skin, VertexInfluenceBone);
+PIMPL_VECTOR_TYPE_APIS(Skin, VertexInfluenceWeight);
+
+void Skin::BuildVertexInfluences()
+{
+	m_pSkinImpl->BuildVertexInfluences();
+}
 
 }
\ No newline at end of file
@@ -1,6 +1,82 @@
 #include "SkinImpl.h"
 
+#include "Scene/Skin.h"
+
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
 namespace cd
 {
 
+void SkinImpl::BuildVertexInfluences()
+{
+	// Bone name arrays are released after the first build.
+	if (!GetVertexInfluenceBones().empty())
+	{
+		return;
+	}
+
+	assert(GetVertexBoneNameArrayCount() == GetVertexBoneWeightArrayCount());
+
+	std::unordered_map<std::string_view, uint16_t> influenceBoneIndexByName;
+	for (uint32_t influenceBoneIndex = 0U; influenceBoneIndex < GetInfluenceBoneNameCount(); ++influenceBoneIndex)
+	{
+		assert(influenceBoneIndex < InvalidInfluenceBoneIndex);
+		influenceBoneIndexByName.emplace(GetInfluenceBoneName(influenceBoneIndex), static_cast<uint16_t>(influenceBoneIndex));
+	}
+
+	// Unknown bones and zero weights don't move vertex so they don't take influence slots.
+	const uint32_t vertexCount = GetVertexBoneNameArrayCount();
+	std::vector<uint32_t> vertexInfluenceOffsets(vertexCount + 1U, 0U);
+	std::vector<std::pair<float, uint16_t>> influences;
+	uint32_t maxVertexInfluenceCount = 0U;
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const auto& vertexBoneNameArray = GetVertexBoneNameArray(vertexIndex);
+		const auto& vertexBoneWeightArray = GetVertexBoneWeightArray(vertexIndex);
+		const std::size_t vertexBegin = influences.size();
+		float weightSum = 0.0f;
+		for (std::size_t influenceIndex = 0U; influenceIndex < vertexBoneNameArray.size(); ++influenceIndex)
+		{
+			auto itBoneIndex = influenceBoneIndexByName.find(vertexBoneNameArray[influenceIndex]);
+			if (itBoneIndex == influenceBoneIndexByName.end() || !(vertexBoneWeightArray[influenceIndex] > 0.0f))
+			{
+				continue;
+			}
+
+			influences.emplace_back(vertexBoneWeightArray[influenceIndex], itBoneIndex->second);
+			weightSum += vertexBoneWeightArray[influenceIndex];
+		}
+
+		for (auto itInfluence = influences.begin() + vertexBegin; itInfluence != influences.end(); ++itInfluence)
+		{
+			itInfluence->first /= weightSum;
+		}
+		std::stable_sort(influences.begin() + vertexBegin, influences.end(), [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+		vertexInfluenceOffsets[vertexIndex + 1U] = static_cast<uint32_t>(influences.size());
+		maxVertexInfluenceCount = std::max(maxVertexInfluenceCount, static_cast<uint32_t>(influences.size() - vertexBegin));
+	}
+	SetMaxVertexInfluenceCount(maxVertexInfluenceCount);
+
+	std::vector<uint16_t>& vertexInfluenceBones = GetVertexInfluenceBones();
+	std::vector<float>& vertexInfluenceWeights = GetVertexInfluenceWeights();
+	vertexInfluenceBones.assign(static_cast<std::size_t>(vertexCount) * maxVertexInfluenceCount, InvalidInfluenceBoneIndex);
+	vertexInfluenceWeights.assign(static_cast<std::size_t>(vertexCount) * maxVertexInfluenceCount, 0.0f);
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const std::size_t vertexOffset = static_cast<std::size_t>(vertexIndex) * maxVertexInfluenceCount;
+		for (uint32_t influenceIndex = vertexInfluenceOffsets[vertexIndex]; influenceIndex < vertexInfluenceOffsets[vertexIndex + 1U]; ++influenceIndex)
+		{
+			vertexInfluenceBones[vertexOffset + influenceIndex - vertexInfluenceOffsets[vertexIndex]] = influences[influenceIndex].second;
+			vertexInfluenceWeights[vertexOffset + influenceIndex - vertexInfluenceOffsets[vertexIndex]] = influences[influenceIndex].first;
+		}
+	}
+
+	std::vector<std::vector<std::string>>().swap(GetVertexBoneNameArrays());
+	std::vector<std::vector<float>>().swap(GetVertexBoneWeightArrays());
+}
+
 }
\ No newline at end of file
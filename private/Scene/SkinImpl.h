@@ -5,6 +5,8 @@
 #include "IO/OutputArchive.hpp"
 #include "Scene/Types.h"
 
+#include <cassert>
+
 namespace cd
 {
 
@@ -21,36 +23,30 @@ public:
 	IMPLEMENT_VECTOR_TYPE_APIS(Skin, InfluenceBoneName);
 	IMPLEMENT_VECTOR_TYPE_APIS(Skin, VertexBoneNameArray);
 	IMPLEMENT_VECTOR_TYPE_APIS(Skin, VertexBoneWeightArray);
-	
+	IMPLEMENT_VECTOR_TYPE_APIS(Skin, VertexInfluenceBone);
+	IMPLEMENT_VECTOR_TYPE_APIS(Skin, VertexInfluenceWeight);
+
+	void BuildVertexInfluences();
+
+	// Bone name palette is stored once. Vertex influences are two flat buffers.
 	template<bool SwapBytesOrder>
 	SkinImpl& operator<<(TInputArchive<SwapBytesOrder>& inputArchive)
 	{
 		uint32_t influenceBoneCount;
-		uint32_t influenceVertexCount;
-		inputArchive >> GetID().Data() >> GetMeshID().Data() >> GetName() >> GetMaxVertexInfluenceCount()
-			>> influenceBoneCount >> influenceVertexCount;
-		
+		uint32_t vertexInfluenceCount;
+		inputArchive >> GetID().Data() >> GetMeshID().Data() >> GetSkeletonID().Data() >> GetName() >> GetMaxVertexInfluenceCount()
+			>> influenceBoneCount >> vertexInfluenceCount;
+
 		SetInfluenceBoneNameCount(influenceBoneCount);
 		for (uint32_t influenceBoneIndex = 0U; influenceBoneIndex < influenceBoneCount; ++influenceBoneIndex)
 		{
-			inputArchive.ImportBuffer(GetInfluenceBoneName(influenceBoneIndex).data());
-		}
-
-		SetVertexBoneNameArrayCount(influenceVertexCount);
-		for (uint32_t influenceVertexIndex = 0U; influenceVertexIndex < influenceVertexCount; ++influenceVertexIndex)
-		{
-			auto& vertexBoneNameArray = GetVertexBoneNameArray(influenceVertexIndex);
-			vertexBoneNameArray.resize(GetMaxVertexInfluenceCount());
-			inputArchive.ImportBuffer(vertexBoneNameArray.data());
+			inputArchive >> GetInfluenceBoneName(influenceBoneIndex);
 		}
 
-		SetVertexBoneWeightArrayCount(influenceVertexCount);
-		for (uint32_t influenceVertexIndex = 0U; influenceVertexIndex < influenceVertexCount; ++influenceVertexIndex)
-		{
-			auto& vertexWeightArray = GetVertexBoneWeightArray(influenceVertexIndex);
-			vertexWeightArray.resize(GetMaxVertexInfluenceCount());
-			inputArchive.ImportBuffer(vertexWeightArray.data());
-		}
+		SetVertexInfluenceBoneCount(vertexInfluenceCount);
+		inputArchive.ImportBuffer(GetVertexInfluenceBones().data());
+		SetVertexInfluenceWeightCount(vertexInfluenceCount);
+		inputArchive.ImportBuffer(GetVertexInfluenceWeights().data());
 
 		return *this;
 	}
@@ -58,25 +54,17 @@ public:
 	template<bool SwapBytesOrder>
 	const SkinImpl& operator>>(TOutputArchive<SwapBytesOrder>& outputArchive) const
 	{
-		outputArchive << GetID().Data() << GetMeshID().Data() << GetName() << GetMaxVertexInfluenceCount()
-			<< GetInfluenceBoneNameCount() << GetVertexBoneNameArrayCount();
+		assert(GetVertexInfluenceBoneCount() == GetVertexInfluenceWeightCount());
+		outputArchive << GetID().Data() << GetMeshID().Data() << GetSkeletonID().Data() << GetName() << GetMaxVertexInfluenceCount()
+			<< GetInfluenceBoneNameCount() << GetVertexInfluenceBoneCount();
 
 		for (uint32_t influenceBoneIndex = 0U; influenceBoneIndex < GetInfluenceBoneNameCount(); ++influenceBoneIndex)
 		{
-			outputArchive.ExportBuffer(GetInfluenceBoneName(influenceBoneIndex).data(), GetInfluenceBoneName(influenceBoneIndex).size());
+			outputArchive << GetInfluenceBoneName(influenceBoneIndex);
 		}
 
-		for (uint32_t influenceVertexIndex = 0U; influenceVertexIndex < GetVertexBoneNameArrayCount(); ++influenceVertexIndex)
-		{
-			const auto& vertexBoneNameArray = GetVertexBoneNameArray(influenceVertexIndex);
-			outputArchive.ExportBuffer(vertexBoneNameArray.data(), vertexBoneNameArray.size());
-		}
-
-		for (uint32_t influenceVertexIndex = 0U; influenceVertexIndex < GetVertexBoneNameArrayCount(); ++influenceVertexIndex)
-		{
-			const auto& vertexWeightArray = GetVertexBoneWeightArray(influenceVertexIndex);
-			outputArchive.ExportBuffer(vertexWeightArray.data(), vertexWeightArray.size());
-		}
+		outputArchive.ExportBuffer(GetVertexInfluenceBones().data(), GetVertexInfluenceBones().size());
+		outputArchive.ExportBuffer(GetVertexInfluenceWeights().data(), GetVertexInfluenceWeights().size());
 
 		return *this;
 	}
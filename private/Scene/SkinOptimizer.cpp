@@ -0,0 +1,404 @@
+#include "Scene/SkinOptimizer.h"
+
+#include "Scene/VertexFormat.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace cd
+{
+
+namespace
+{
+
+constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+uint32_t GetSkinVertexCount(const Skin& skin)
+{
+	const uint32_t influenceCount = skin.GetMaxVertexInfluenceCount();
+	return influenceCount > 0U ? skin.GetVertexInfluenceBoneCount() / influenceCount : 0U;
+}
+
+}
+
+void SkinOptimizer::LimitInfluences(Skin& skin, uint32_t maxInfluenceCount)
+{
+	assert(maxInfluenceCount > 0U);
+
+	const uint32_t influenceCount = skin.GetMaxVertexInfluenceCount();
+	if (influenceCount <= maxInfluenceCount)
+	{
+		return;
+	}
+
+	// Slots are sorted by weight so the largest influences are the first ones.
+	const uint32_t vertexCount = GetSkinVertexCount(skin);
+	std::vector<uint16_t> vertexInfluenceBones(vertexCount * maxInfluenceCount, InvalidInfluenceBoneIndex);
+	std::vector<float> vertexInfluenceWeights(vertexCount * maxInfluenceCount, 0.0f);
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const uint32_t sourceBegin = vertexIndex * influenceCount;
+		const uint32_t targetBegin = vertexIndex * maxInfluenceCount;
+		float weightSum = 0.0f;
+		for (uint32_t slotIndex = 0U; slotIndex < maxInfluenceCount; ++slotIndex)
+		{
+			vertexInfluenceBones[targetBegin + slotIndex] = skin.GetVertexInfluenceBone(sourceBegin + slotIndex);
+			vertexInfluenceWeights[targetBegin + slotIndex] = skin.GetVertexInfluenceWeight(sourceBegin + slotIndex);
+			weightSum += vertexInfluenceWeights[targetBegin + slotIndex];
+		}
+
+		if (weightSum > 0.0f)
+		{
+			for (uint32_t slotIndex = 0U; slotIndex < maxInfluenceCount; ++slotIndex)
+			{
+				vertexInfluenceWeights[targetBegin + slotIndex] /= weightSum;
+			}
+		}
+	}
+
+	skin.SetVertexInfluenceBones(cd::MoveTemp(vertexInfluenceBones));
+	skin.SetVertexInfluenceWeights(cd::MoveTemp(vertexInfluenceWeights));
+	skin.SetMaxVertexInfluenceCount(maxInfluenceCount);
+}
+
+void SkinOptimizer::QuantizeWeights(Skin& skin, AttributeValueType valueType)
+{
+	uint32_t scale = 0U;
+	if (AttributeValueType::Uint8 == valueType)
+	{
+		scale = 255U;
+	}
+	else if (AttributeValueType::Int16 == valueType)
+	{
+		scale = 65535U;
+	}
+	else
+	{
+		// Float and Half weights are stored as they are.
+		return;
+	}
+
+	const uint32_t influenceCount = skin.GetMaxVertexInfluenceCount();
+	const uint32_t vertexCount = GetSkinVertexCount(skin);
+	auto& vertexInfluenceBones = skin.GetVertexInfluenceBones();
+	auto& vertexInfluenceWeights = skin.GetVertexInfluenceWeights();
+
+	struct QuantizedInfluence
+	{
+		uint16_t bone;
+		uint32_t value;
+		float remainder;
+	};
+	std::vector<QuantizedInfluence> influences;
+	influences.reserve(influenceCount);
+	for (uint32_t vertexIndex = 0U; vertexIndex < vertexCount; ++vertexIndex)
+	{
+		const uint32_t vertexBegin = vertexIndex * influenceCount;
+		float weightSum = 0.0f;
+		for (uint32_t slotIndex = 0U; slotIndex < influenceCount; ++slotIndex)
+		{
+			if (InvalidInfluenceBoneIndex != vertexInfluenceBones[vertexBegin + slotIndex])
+			{
+				weightSum += vertexInfluenceWeights[vertexBegin + slotIndex];
+			}
+		}
+
+		if (!(weightSum > 0.0f))
+		{
+			continue;
+		}
+
+		influences.clear();
+		uint32_t valueSum = 0U;
+		for (uint32_t slotIndex = 0U; slotIndex < influenceCount; ++slotIndex)
+		{
+			const uint16_t bone = vertexInfluenceBones[vertexBegin + slotIndex];
+			if (InvalidInfluenceBoneIndex == bone)
+			{
+				continue;
+			}
+
+			const float scaledWeight = std::min(vertexInfluenceWeights[vertexBegin + slotIndex] / weightSum, 1.0f) * static_cast<float>(scale);
+			const float value = std::floor(scaledWeight);
+			influences.push_back({ bone, static_cast<uint32_t>(value), scaledWeight - value });
+			valueSum += static_cast<uint32_t>(value);
+		}
+
+		// Largest remainder method. Ties go to the earlier slot which has the larger weight.
+		std::stable_sort(influences.begin(), influences.end(), [](const QuantizedInfluence& lhs, const QuantizedInfluence& rhs)
+		{
+			return lhs.remainder > rhs.remainder;
+		});
+		for (uint32_t influenceIndex = 0U; valueSum < scale; ++valueSum, ++influenceIndex)
+		{
+			++influences[influenceIndex % influences.size()].value;
+		}
+		std::stable_sort(influences.begin(), influences.end(), [](const QuantizedInfluence& lhs, const QuantizedInfluence& rhs)
+		{
+			return lhs.value > rhs.value;
+		});
+
+		for (uint32_t slotIndex = 0U; slotIndex < influenceCount; ++slotIndex)
+		{
+			const bool isValid = slotIndex < influences.size() && influences[slotIndex].value > 0U;
+			vertexInfluenceBones[vertexBegin + slotIndex] = isValid ? influences[slotIndex].bone : InvalidInfluenceBoneIndex;
+			vertexInfluenceWeights[vertexBegin + slotIndex] = isValid ? static_cast<float>(influences[slotIndex].value) / static_cast<float>(scale) : 0.0f;
+		}
+	}
+}
+
+std::vector<SkinPartition> SkinOptimizer::Partition(const Mesh& mesh, const Skin& skin, uint32_t maxPaletteBoneCount)
+{
+	assert(maxPaletteBoneCount > 0U);
+
+	std::vector<SkinPartition> partitions;
+	const uint32_t paletteBoneCount = skin.GetInfluenceBoneNameCount();
+	if (paletteBoneCount <= maxPaletteBoneCount || 0U == mesh.GetPolygonCount())
+	{
+		return partitions;
+	}
+
+	const uint32_t influenceCount = skin.GetMaxVertexInfluenceCount();
+	const uint32_t skinVertexCount = GetSkinVertexCount(skin);
+	const bool mapVertexInstances = mesh.GetVertexInstanceToIDCount() > 0U;
+	auto GetVertexIndex = [&mesh, mapVertexInstances](uint32_t vertexAttributeIndex)
+	{
+		return mapVertexInstances ? mesh.GetVertexInstanceToID(vertexAttributeIndex).Data() : vertexAttributeIndex;
+	};
+
+	// Sorted unique palette bones referenced by every polygon.
+	struct PolygonReference
+	{
+		uint32_t polygonGroupIndex;
+		uint32_t polygonIndex;
+		uint32_t boneBegin;
+		uint32_t boneEnd;
+	};
+	std::vector<PolygonReference> polygons;
+	std::vector<uint16_t> polygonBones;
+	polygons.reserve(mesh.GetPolygonCount());
+	for (uint32_t polygonGroupIndex = 0U; polygonGroupIndex < mesh.GetPolygonGroupCount(); ++polygonGroupIndex)
+	{
+		const auto& polygonGroup = mesh.GetPolygonGroup(polygonGroupIndex);
+		for (uint32_t polygonIndex = 0U; polygonIndex < static_cast<uint32_t>(polygonGroup.size()); ++polygonIndex)
+		{
+			const uint32_t boneBegin = static_cast<uint32_t>(polygonBones.size());
+			for (const VertexID& vertexID : polygonGroup[polygonIndex])
+			{
+				const uint32_t vertexIndex = GetVertexIndex(vertexID.Data());
+				if (vertexIndex >= skinVertexCount)
+				{
+					continue;
+				}
+
+				for (uint32_t slotIndex = 0U; slotIndex < influenceCount; ++slotIndex)
+				{
+					const uint16_t bone = skin.GetVertexInfluenceBone(vertexIndex * influenceCount + slotIndex);
+					if (InvalidInfluenceBoneIndex != bone)
+					{
+						polygonBones.push_back(bone);
+					}
+				}
+			}
+
+			std::sort(polygonBones.begin() + boneBegin, polygonBones.end());
+			polygonBones.erase(std::unique(polygonBones.begin() + boneBegin, polygonBones.end()), polygonBones.end());
+			polygons.push_back({ polygonGroupIndex, polygonIndex, boneBegin, static_cast<uint32_t>(polygonBones.size()) });
+		}
+	}
+
+	// Greedy partitioning: every partition takes unassigned polygons in order as long as their bones still fit in its palette.
+	// The first polygon of a partition is always taken so that a polygon over the limit ends up alone.
+	const uint32_t polygonCount = static_cast<uint32_t>(polygons.size());
+	std::vector<uint32_t> polygonPartitions(polygonCount, InvalidIndex);
+	std::vector<uint32_t> bonePartitions(paletteBoneCount, InvalidIndex);
+	uint32_t partitionCount = 0U;
+	uint32_t firstUnassignedPolygon = 0U;
+	while (firstUnassignedPolygon < polygonCount)
+	{
+		const uint32_t partitionIndex = partitionCount++;
+		uint32_t partitionBoneCount = 0U;
+		for (uint32_t polygonIndex = firstUnassignedPolygon; polygonIndex < polygonCount; ++polygonIndex)
+		{
+			if (InvalidIndex != polygonPartitions[polygonIndex])
+			{
+				continue;
+			}
+
+			const PolygonReference& polygon = polygons[polygonIndex];
+			uint32_t newBoneCount = 0U;
+			for (uint32_t boneIndex = polygon.boneBegin; boneIndex < polygon.boneEnd; ++boneIndex)
+			{
+				newBoneCount += bonePartitions[polygonBones[boneIndex]] != partitionIndex ? 1U : 0U;
+			}
+
+			if (partitionBoneCount > 0U && partitionBoneCount + newBoneCount > maxPaletteBoneCount)
+			{
+				continue;
+			}
+
+			for (uint32_t boneIndex = polygon.boneBegin; boneIndex < polygon.boneEnd; ++boneIndex)
+			{
+				bonePartitions[polygonBones[boneIndex]] = partitionIndex;
+			}
+			partitionBoneCount += newBoneCount;
+			polygonPartitions[polygonIndex] = partitionIndex;
+		}
+
+		while (firstUnassignedPolygon < polygonCount && InvalidIndex != polygonPartitions[firstUnassignedPolygon])
+		{
+			++firstUnassignedPolygon;
+		}
+	}
+
+	const uint32_t vertexAttributeCount = mesh.GetVertexAttributeCount();
+	const uint32_t vertexCount = mesh.GetVertexCount();
+	partitions.reserve(partitionCount);
+	for (uint32_t partitionIndex = 0U; partitionIndex < partitionCount; ++partitionIndex)
+	{
+		// Vertices are numbered in the order of first use by partition polygons.
+		std::vector<uint32_t> vertexAttributeRemap(vertexAttributeCount, InvalidIndex);
+		std::vector<uint32_t> vertexRemap(mapVertexInstances ? vertexCount : 0U, InvalidIndex);
+		std::vector<uint32_t> sourceVertexAttributes;
+		std::vector<uint32_t> sourceVertices;
+		std::vector<PolygonGroup> polygonGroups(mesh.GetPolygonGroupCount());
+		for (uint32_t polygonIndex = 0U; polygonIndex < polygonCount; ++polygonIndex)
+		{
+			if (polygonPartitions[polygonIndex] != partitionIndex)
+			{
+				continue;
+			}
+
+			const PolygonReference& polygonReference = polygons[polygonIndex];
+			const Polygon& sourcePolygon = mesh.GetPolygonGroup(polygonReference.polygonGroupIndex)[polygonReference.polygonIndex];
+			Polygon polygon;
+			polygon.reserve(sourcePolygon.size());
+			for (const VertexID& vertexID : sourcePolygon)
+			{
+				const uint32_t vertexAttributeIndex = vertexID.Data();
+				if (InvalidIndex == vertexAttributeRemap[vertexAttributeIndex])
+				{
+					vertexAttributeRemap[vertexAttributeIndex] = static_cast<uint32_t>(sourceVertexAttributes.size());
+					sourceVertexAttributes.push_back(vertexAttributeIndex);
+
+					const uint32_t vertexIndex = GetVertexIndex(vertexAttributeIndex);
+					if (mapVertexInstances && InvalidIndex == vertexRemap[vertexIndex])
+					{
+						vertexRemap[vertexIndex] = static_cast<uint32_t>(sourceVertices.size());
+						sourceVertices.push_back(vertexIndex);
+					}
+				}
+				polygon.push_back(VertexID(vertexAttributeRemap[vertexAttributeIndex]));
+			}
+			polygonGroups[polygonReference.polygonGroupIndex].push_back(cd::MoveTemp(polygon));
+		}
+
+		if (!mapVertexInstances)
+		{
+			sourceVertices = sourceVertexAttributes;
+		}
+
+		SkinPartition& partition = partitions.emplace_back();
+		Mesh& partitionMesh = partition.mesh;
+		partitionMesh.SetName(mesh.GetName());
+		partitionMesh.SetVertexFormat(mesh.GetVertexFormat());
+		partitionMesh.SetMaterialIDs(mesh.GetMaterialIDs());
+		partitionMesh.SetVertexUVSetCount(mesh.GetVertexUVSetCount());
+		partitionMesh.SetVertexColorSetCount(mesh.GetVertexColorSetCount());
+		if (mapVertexInstances)
+		{
+			partitionMesh.Init(static_cast<uint32_t>(sourceVertices.size()), static_cast<uint32_t>(sourceVertexAttributes.size()));
+		}
+		else
+		{
+			partitionMesh.Init(static_cast<uint32_t>(sourceVertices.size()));
+		}
+
+		for (uint32_t vertexIndex = 0U; vertexIndex < static_cast<uint32_t>(sourceVertices.size()); ++vertexIndex)
+		{
+			partitionMesh.SetVertexPosition(vertexIndex, mesh.GetVertexPosition(sourceVertices[vertexIndex]));
+		}
+
+		for (uint32_t vertexAttributeIndex = 0U; vertexAttributeIndex < static_cast<uint32_t>(sourceVertexAttributes.size()); ++vertexAttributeIndex)
+		{
+			const uint32_t sourceIndex = sourceVertexAttributes[vertexAttributeIndex];
+			if (mapVertexInstances)
+			{
+				partitionMesh.SetVertexInstanceToID(vertexAttributeIndex, VertexID(vertexRemap[GetVertexIndex(sourceIndex)]));
+			}
+			if (sourceIndex < mesh.GetVertexNormalCount())
+			{
+				partitionMesh.SetVertexNormal(vertexAttributeIndex, mesh.GetVertexNormal(sourceIndex));
+			}
+			if (sourceIndex < mesh.GetVertexTangentCount())
+			{
+				partitionMesh.SetVertexTangent(vertexAttributeIndex, mesh.GetVertexTangent(sourceIndex));
+			}
+			if (sourceIndex < mesh.GetVertexBiTangentCount())
+			{
+				partitionMesh.SetVertexBiTangent(vertexAttributeIndex, mesh.GetVertexBiTangent(sourceIndex));
+			}
+			for (uint32_t setIndex = 0U; setIndex < mesh.GetVertexUVSetCount(); ++setIndex)
+			{
+				if (sourceIndex < mesh.GetVertexUV(setIndex).size())
+				{
+					partitionMesh.SetVertexUV(setIndex, vertexAttributeIndex, mesh.GetVertexUV(setIndex, sourceIndex));
+				}
+			}
+			for (uint32_t setIndex = 0U; setIndex < mesh.GetVertexColorSetCount(); ++setIndex)
+			{
+				if (sourceIndex < mesh.GetVertexColor(setIndex).size())
+				{
+					partitionMesh.SetVertexColor(setIndex, vertexAttributeIndex, mesh.GetVertexColor(setIndex, sourceIndex));
+				}
+			}
+		}
+
+		partitionMesh.SetPolygonGroups(cd::MoveTemp(polygonGroups));
+		partitionMesh.UpdateAABB();
+
+		// Palette bones are numbered in the order of first use by partition vertices.
+		Skin& partitionSkin = partition.skin;
+		partitionSkin.SetName(skin.GetName());
+		partitionSkin.SetSkeletonID(skin.GetSkeletonID());
+		partitionSkin.SetMaxVertexInfluenceCount(influenceCount);
+		std::vector<uint16_t> paletteRemap(paletteBoneCount, InvalidInfluenceBoneIndex);
+		std::vector<uint16_t> vertexInfluenceBones(sourceVertices.size() * influenceCount, InvalidInfluenceBoneIndex);
+		std::vector<float> vertexInfluenceWeights(sourceVertices.size() * influenceCount, 0.0f);
+		for (uint32_t vertexIndex = 0U; vertexIndex < static_cast<uint32_t>(sourceVertices.size()); ++vertexIndex)
+		{
+			const uint32_t sourceVertexIndex = sourceVertices[vertexIndex];
+			if (sourceVertexIndex >= skinVertexCount)
+			{
+				continue;
+			}
+
+			for (uint32_t slotIndex = 0U; slotIndex < influenceCount; ++slotIndex)
+			{
+				const uint16_t bone = skin.GetVertexInfluenceBone(sourceVertexIndex * influenceCount + slotIndex);
+				if (InvalidInfluenceBoneIndex == bone)
+				{
+					continue;
+				}
+
+				if (InvalidInfluenceBoneIndex == paletteRemap[bone])
+				{
+					paletteRemap[bone] = static_cast<uint16_t>(partitionSkin.GetInfluenceBoneNameCount());
+					partitionSkin.AddInfluenceBoneName(skin.GetInfluenceBoneName(bone));
+				}
+				vertexInfluenceBones[vertexIndex * influenceCount + slotIndex] = paletteRemap[bone];
+				vertexInfluenceWeights[vertexIndex * influenceCount + slotIndex] = skin.GetVertexInfluenceWeight(sourceVertexIndex * influenceCount + slotIndex);
+			}
+		}
+		partitionSkin.SetVertexInfluenceBones(cd::MoveTemp(vertexInfluenceBones));
+		partitionSkin.SetVertexInfluenceWeights(cd::MoveTemp(vertexInfluenceWeights));
+
+		partition.sourceVertexIndices = cd::MoveTemp(sourceVertices);
+	}
+
+	return partitions;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,897 @@
+#include "Scene/TextureCompressor.h"
+
+#include "Base/Template.h"
+#include "Math/SIMD.hpp"
+#include "Scene/Texture.h"
+#include "Scene/TextureMipGenerator.h"
+#include "Utilities/ParallelFor.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace
+{
+
+using namespace cd;
+
+constexpr uint32_t BlockPixelCount = 16U;
+constexpr uint32_t MaxChannelCount = 4U;
+constexpr uint32_t MaxPaletteCount = 16U;
+
+// 4x4 pixels in channel planes so that SIMD lanes hold 4 pixels of one channel. Values are in [0, 255].
+struct alignas(16) PixelBlock
+{
+	float channels[MaxChannelCount][BlockPixelCount];
+};
+
+struct EncodeSettings
+{
+	uint32_t axisIterationCount;
+	uint32_t refitCount;
+	bool searchHarder;
+};
+
+EncodeSettings GetEncodeSettings(TextureCompressionQuality quality)
+{
+	switch (quality)
+	{
+	case TextureCompressionQuality::Fast:
+		return EncodeSettings{ 2U, 0U, false };
+	case TextureCompressionQuality::Normal:
+		return EncodeSettings{ 4U, 1U, false };
+	default:
+		return EncodeSettings{ 8U, 3U, true };
+	}
+}
+
+void LoadBlock(const std::byte* pPixels, TextureFormat format, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, PixelBlock& block)
+{
+	const uint8_t* pCodes = reinterpret_cast<const uint8_t*>(pPixels);
+	for (uint32_t pixelIndex = 0U; pixelIndex < BlockPixelCount; ++pixelIndex)
+	{
+		// Blocks out of small or odd sized levels repeat edge pixels.
+		const uint32_t x = std::min(blockX * 4U + pixelIndex % 4U, width - 1U);
+		const uint32_t y = std::min(blockY * 4U + pixelIndex / 4U, height - 1U);
+		const std::size_t pixelOffset = static_cast<std::size_t>(y) * width + x;
+		if (TextureFormat::R8 == format)
+		{
+			block.channels[0][pixelIndex] = pCodes[pixelOffset];
+			block.channels[1][pixelIndex] = 0.0f;
+			block.channels[2][pixelIndex] = 0.0f;
+			block.channels[3][pixelIndex] = 255.0f;
+		}
+		else
+		{
+			for (uint32_t channelIndex = 0U; channelIndex < MaxChannelCount; ++channelIndex)
+			{
+				block.channels[channelIndex][pixelIndex] = pCodes[pixelOffset * 4U + channelIndex];
+			}
+		}
+	}
+}
+
+// Mean and the direction of the largest variance of pixels by power iterations on their covariance matrix.
+void ComputePrincipalAxis(const float* const* ppChannels, uint32_t channelCount, uint32_t iterationCount, float* pMean, float* pAxis)
+{
+	for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+	{
+		float sum = 0.0f;
+		for (uint32_t pixelIndex = 0U; pixelIndex < BlockPixelCount; ++pixelIndex)
+		{
+			sum += ppChannels[channelIndex][pixelIndex];
+		}
+		pMean[channelIndex] = sum / static_cast<float>(BlockPixelCount);
+	}
+
+	float covariance[MaxChannelCount][MaxChannelCount] = {};
+	for (uint32_t pixelIndex = 0U; pixelIndex < BlockPixelCount; ++pixelIndex)
+	{
+		float offset[MaxChannelCount];
+		for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+		{
+			offset[channelIndex] = ppChannels[channelIndex][pixelIndex] - pMean[channelIndex];
+		}
+		for (uint32_t rowIndex = 0U; rowIndex < channelCount; ++rowIndex)
+		{
+			for (uint32_t columnIndex = rowIndex; columnIndex < channelCount; ++columnIndex)
+			{
+				covariance[rowIndex][columnIndex] += offset[rowIndex] * offset[columnIndex];
+			}
+		}
+	}
+
+	// Starts from the column of the largest variance which can't be orthogonal to the principal axis.
+	uint32_t largestChannelIndex = 0U;
+	for (uint32_t rowIndex = 0U; rowIndex < channelCount; ++rowIndex)
+	{
+		for (uint32_t columnIndex = 0U; columnIndex < rowIndex; ++columnIndex)
+		{
+			covariance[rowIndex][columnIndex] = covariance[columnIndex][rowIndex];
+		}
+		if (covariance[rowIndex][rowIndex] > covariance[largestChannelIndex][largestChannelIndex])
+		{
+			largestChannelIndex = rowIndex;
+		}
+	}
+
+	float axis[MaxChannelCount];
+	for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+	{
+		axis[channelIndex] = covariance[channelIndex][largestChannelIndex];
+	}
+
+	for (uint32_t iterationIndex = 0U; iterationIndex < iterationCount; ++iterationIndex)
+	{
+		float nextAxis[MaxChannelCount] = {};
+		float largestValue = 0.0f;
+		for (uint32_t rowIndex = 0U; rowIndex < channelCount; ++rowIndex)
+		{
+			for (uint32_t columnIndex = 0U; columnIndex < channelCount; ++columnIndex)
+			{
+				nextAxis[rowIndex] += covariance[rowIndex][columnIndex] * axis[columnIndex];
+			}
+			largestValue = std::max(largestValue, std::abs(nextAxis[rowIndex]));
+		}
+
+		if (0.0f == largestValue)
+		{
+			break;
+		}
+
+		for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+		{
+			axis[channelIndex] = nextAxis[channelIndex] / largestValue;
+		}
+	}
+
+	// Zero axis of a single color block makes both endpoints the mean.
+	float lengthSquared = 0.0f;
+	for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+	{
+		lengthSquared += axis[channelIndex] * axis[channelIndex];
+	}
+	const float inverseLength = lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+	for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+	{
+		pAxis[channelIndex] = axis[channelIndex] * inverseLength;
+	}
+}
+
+// Projections of pixels relative to mean onto axis.
+void ProjectPixels(const float* const* ppChannels, uint32_t channelCount, const float* pMean, const float* pAxis, float* pProjections)
+{
+#if defined(CD_SIMD_SSE)
+	for (uint32_t pixelIndex = 0U; pixelIndex < BlockPixelCount; pixelIndex += 4U)
+	{
+		__m128 sum = _mm_setzero_ps();
+		for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+		{
+			const __m128 offset = _mm_sub_ps(_mm_load_ps(ppChannels[channelIndex] + pixelIndex), _mm_set1_ps(pMean[channelIndex]));
+			sum = _mm_add_ps(sum, _mm_mul_ps(offset, _mm_set1_ps(pAxis[channelIndex])));
+		}
+		_mm_storeu_ps(pProjections + pixelIndex, sum);
+	}
+#elif defined(CD_SIMD_NEON)
+	for (uint32_t pixelIndex = 0U; pixelIndex < BlockPixelCount; pixelIndex += 4U)
+	{
+		float32x4_t sum = vdupq_n_f32(0.0f);
+		for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+		{
+			const float32x4_t offset = vsubq_f32(vld1q_f32(ppChannels[channelIndex] + pixelIndex), vdupq_n_f32(pMean[channelIndex]));
+			sum = vaddq_f32(sum, vmulq_n_f32(offset, pAxis[channelIndex]));
+		}
+		vst1q_f32(pProjections + pixelIndex, sum);
+	}
+#else
+	for (uint32_t pixelIndex = 0U; pixelIndex < BlockPixelCount; ++pixelIndex)
+	{
+		float sum = 0.0f;
+		for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+		{
+			sum += (ppChannels[channelIndex][pixelIndex] - pMean[channelIndex]) * pAxis[channelIndex];
+		}
+		pProjections[pixelIndex] = sum;
+	}
+#endif
+}
+
+// Picks the closest palette entry of every pixel. Returns the sum of squared errors.
+float FindNearestIndices(const float* const* ppChannels, uint32_t channelCount, const float (*pPalette)[MaxChannelCount], uint32_t paletteCount, uint8_t* pIndices)
+{
+	float totalError = 0.0f;
+#if defined(CD_SIMD)
+	alignas(16) float errors[4];
+	alignas(16) float indices[4];
+	for (uint32_t pixelIndex = 0U; pixelIndex < BlockPixelCount; pixelIndex += 4U)
+	{
+#if defined(CD_SIMD_SSE)
+		__m128 bestError = _mm_set1_ps(std::numeric_limits<float>::max());
+		__m128 bestIndex = _mm_setzero_ps();
+		for (uint32_t entryIndex = 0U; entryIndex < paletteCount; ++entryIndex)
+		{
+			__m128 error = _mm_setzero_ps();
+			for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+			{
+				const __m128 difference = _mm_sub_ps(_mm_load_ps(ppChannels[channelIndex] + pixelIndex), _mm_set1_ps(pPalette[entryIndex][channelIndex]));
+				error = _mm_add_ps(error, _mm_mul_ps(difference, difference));
+			}
+			const __m128 closer = _mm_cmplt_ps(error, bestError);
+			bestError = _mm_min_ps(error, bestError);
+			bestIndex = _mm_or_ps(_mm_and_ps(closer, _mm_set1_ps(static_cast<float>(entryIndex))), _mm_andnot_ps(closer, bestIndex));
+		}
+		_mm_store_ps(errors, bestError);
+		_mm_store_ps(indices, bestIndex);
+#else
+		float32x4_t bestError = vdupq_n_f32(std::numeric_limits<float>::max());
+		float32x4_t bestIndex = vdupq_n_f32(0.0f);
+		for (uint32_t entryIndex = 0U; entryIndex < paletteCount; ++entryIndex)
+		{
+			float32x4_t error = vdupq_n_f32(0.0f);
+			for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+			{
+				const float32x4_t difference = vsubq_f32(vld1q_f32(ppChannels[channelIndex] + pixelIndex), vdupq_n_f32(pPalette[entryIndex][channelIndex]));
+				error = vaddq_f32(error, vmulq_f32(difference, difference));
+			}
+			const uint32x4_t closer = vcltq_f32(error, bestError);
+			bestError = vminq_f32(error, bestError);
+			bestIndex = vbslq_f32(closer, vdupq_n_f32(static_cast<float>(entryIndex)), bestIndex);
+		}
+		vst1q_f32(errors, bestError);
+		vst1q_f32(indices, bestIndex);
+#endif
+		for (uint32_t laneIndex = 0U; laneIndex < 4U; ++laneIndex)
+		{
+			pIndices[pixelIndex + laneIndex] = static_cast<uint8_t>(indices[laneIndex]);
+			totalError += errors[laneIndex];
+		}
+	}
+#else
+	for (uint32_t pixelIndex = 0U; pixelIndex < BlockPixelCount; ++pixelIndex)
+	{
+		float bestError = std::numeric_limits<float>::max();
+		for (uint32_t entryIndex = 0U; entryIndex < paletteCount; ++entryIndex)
+		{
+			float error = 0.0f;
+			for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+			{
+				const float difference = ppChannels[channelIndex][pixelIndex] - pPalette[entryIndex][channelIndex];
+				error += difference * difference;
+			}
+			if (error < bestError)
+			{
+				bestError = error;
+				pIndices[pixelIndex] = static_cast<uint8_t>(entryIndex);
+			}
+		}
+		totalError += bestError;
+	}
+#endif
+	return totalError;
+}
+
+// Least squares endpoints for fixed indices. pWeights holds the weight of endpoint 1 for every index.
+bool FitEndpoints(const float* const* ppChannels, uint32_t channelCount, const uint8_t* pIndices, const float* pWeights, float (*pEndpoints)[MaxChannelCount])
+{
+	float weight00 = 0.0f;
+	float weight01 = 0.0f;
+	float weight11 = 0.0f;
+	float sums0[MaxChannelCount] = {};
+	float sums1[MaxChannelCount] = {};
+	for (uint32_t pixelIndex = 0U; pixelIndex < BlockPixelCount; ++pixelIndex)
+	{
+		const float weight1 = pWeights[pIndices[pixelIndex]];
+		const float weight0 = 1.0f - weight1;
+		weight00 += weight0 * weight0;
+		weight01 += weight0 * weight1;
+		weight11 += weight1 * weight1;
+		for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+		{
+			sums0[channelIndex] += weight0 * ppChannels[channelIndex][pixelIndex];
+			sums1[channelIndex] += weight1 * ppChannels[channelIndex][pixelIndex];
+		}
+	}
+
+	// All pixels on one index can't decide two endpoints.
+	const float determinant = weight00 * weight11 - weight01 * weight01;
+	if (std::abs(determinant) < 1e-6f)
+	{
+		return false;
+	}
+
+	const float inverseDeterminant = 1.0f / determinant;
+	for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+	{
+		pEndpoints[0][channelIndex] = std::clamp((weight11 * sums0[channelIndex] - weight01 * sums1[channelIndex]) * inverseDeterminant, 0.0f, 255.0f);
+		pEndpoints[1][channelIndex] = std::clamp((weight00 * sums1[channelIndex] - weight01 * sums0[channelIndex]) * inverseDeterminant, 0.0f, 255.0f);
+	}
+	return true;
+}
+
+// Endpoints at the ends of pixel projections onto the principal axis. Endpoint 0 is at the larger end.
+void GetAxisEndpoints(const float* const* ppChannels, uint32_t channelCount, uint32_t iterationCount, float (*pEndpoints)[MaxChannelCount])
+{
+	float mean[MaxChannelCount];
+	float axis[MaxChannelCount];
+	float projections[BlockPixelCount];
+	ComputePrincipalAxis(ppChannels, channelCount, iterationCount, mean, axis);
+	ProjectPixels(ppChannels, channelCount, mean, axis, projections);
+
+	const auto [pMinProjection, pMaxProjection] = std::minmax_element(projections, projections + BlockPixelCount);
+	for (uint32_t channelIndex = 0U; channelIndex < channelCount; ++channelIndex)
+	{
+		pEndpoints[0][channelIndex] = std::clamp(mean[channelIndex] + axis[channelIndex] * *pMaxProjection, 0.0f, 255.0f);
+		pEndpoints[1][channelIndex] = std::clamp(mean[channelIndex] + axis[channelIndex] * *pMinProjection, 0.0f, 255.0f);
+	}
+}
+
+// Starts from axis endpoints and refits them by least squares while the error drops. evaluateEndpoints quantizes
+// endpoints to state, picks indices and returns the error. pIndexWeights holds the weight of endpoint 1 for every index.
+template<typename State, typename EvaluateFunc>
+float SearchEndpoints(const float* const* ppChannels, uint32_t channelCount, const float* pIndexWeights, const EncodeSettings& settings,
+	EvaluateFunc&& evaluateEndpoints, State& state, uint8_t* pIndices)
+{
+	float endpoints[2][MaxChannelCount];
+	GetAxisEndpoints(ppChannels, channelCount, settings.axisIterationCount, endpoints);
+
+	float bestError = evaluateEndpoints(endpoints, state, pIndices);
+	for (uint32_t refitIndex = 0U; refitIndex < settings.refitCount && bestError > 0.0f; ++refitIndex)
+	{
+		float fittedEndpoints[2][MaxChannelCount];
+		State fittedState;
+		uint8_t fittedIndices[BlockPixelCount];
+		if (!FitEndpoints(ppChannels, channelCount, pIndices, pIndexWeights, fittedEndpoints))
+		{
+			break;
+		}
+
+		const float error = evaluateEndpoints(fittedEndpoints, fittedState, fittedIndices);
+		if (error >= bestError)
+		{
+			break;
+		}
+
+		bestError = error;
+		state = fittedState;
+		std::copy(std::begin(fittedIndices), std::end(fittedIndices), pIndices);
+	}
+	return bestError;
+}
+
+void WriteBits(uint8_t* pOutput, uint64_t bits, uint32_t byteCount)
+{
+	for (uint32_t byteIndex = 0U; byteIndex < byteCount; ++byteIndex)
+	{
+		pOutput[byteIndex] = static_cast<uint8_t>(bits >> (byteIndex * 8U));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// BC1 color blocks which BC3 also uses.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+constexpr float ColorIndexWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+uint16_t ToRGB565(const float* pColor)
+{
+	const uint32_t red = static_cast<uint32_t>(pColor[0] * 31.0f / 255.0f + 0.5f);
+	const uint32_t green = static_cast<uint32_t>(pColor[1] * 63.0f / 255.0f + 0.5f);
+	const uint32_t blue = static_cast<uint32_t>(pColor[2] * 31.0f / 255.0f + 0.5f);
+	return static_cast<uint16_t>((red << 11U) | (green << 5U) | blue);
+}
+
+void GetColorPalette(uint16_t color0, uint16_t color1, float (*pPalette)[MaxChannelCount])
+{
+	for (uint32_t endpointIndex = 0U; endpointIndex < 2U; ++endpointIndex)
+	{
+		const uint32_t color = 0U == endpointIndex ? color0 : color1;
+		const uint32_t red = (color >> 11U) & 0x1FU;
+		const uint32_t green = (color >> 5U) & 0x3FU;
+		const uint32_t blue = color & 0x1FU;
+		pPalette[endpointIndex][0] = static_cast<float>((red << 3U) | (red >> 2U));
+		pPalette[endpointIndex][1] = static_cast<float>((green << 2U) | (green >> 4U));
+		pPalette[endpointIndex][2] = static_cast<float>((blue << 3U) | (blue >> 2U));
+	}
+
+	for (uint32_t channelIndex = 0U; channelIndex < 3U; ++channelIndex)
+	{
+		pPalette[2][channelIndex] = (2.0f * pPalette[0][channelIndex] + pPalette[1][channelIndex]) / 3.0f;
+		pPalette[3][channelIndex] = (pPalette[0][channelIndex] + 2.0f * pPalette[1][channelIndex]) / 3.0f;
+	}
+}
+
+struct ColorEndpoints
+{
+	uint16_t colors[2];
+};
+
+void EncodeColorBlock(const PixelBlock& block, const EncodeSettings& settings, uint8_t* pOutput)
+{
+	const float* ppChannels[3] = { block.channels[0], block.channels[1], block.channels[2] };
+	float palette[4][MaxChannelCount];
+	auto EvaluateEndpoints = [&ppChannels, &palette](const float (*pEndpoints)[MaxChannelCount], ColorEndpoints& endpoints, uint8_t* pIndices)
+	{
+		endpoints.colors[0] = ToRGB565(pEndpoints[0]);
+		endpoints.colors[1] = ToRGB565(pEndpoints[1]);
+		GetColorPalette(endpoints.colors[0], endpoints.colors[1], palette);
+		return FindNearestIndices(ppChannels, 3U, palette, 4U, pIndices);
+	};
+
+	ColorEndpoints endpoints;
+	uint8_t indices[BlockPixelCount];
+	SearchEndpoints(ppChannels, 3U, ColorIndexWeights, settings, EvaluateEndpoints, endpoints, indices);
+
+	// BC1 decodes 4 colors only when color0 > color1. Swapping endpoints swaps indices 0 with 1 and 2 with 3.
+	if (endpoints.colors[0] < endpoints.colors[1])
+	{
+		std::swap(endpoints.colors[0], endpoints.colors[1]);
+		for (uint8_t& index : indices)
+		{
+			index ^= 1U;
+		}
+	}
+	else if (endpoints.colors[0] == endpoints.colors[1])
+	{
+		std::fill(std::begin(indices), std::end(indices), static_cast<uint8_t>(0U));
+	}
+
+	uint64_t indexBits = 0U;
+	for (uint32_t pixelIndex = 0U; pixelIndex < BlockPixelCount; ++pixelIndex)
+	{
+		indexBits |= static_cast<uint64_t>(indices[pixelIndex]) << (pixelIndex * 2U);
+	}
+	WriteBits(pOutput, endpoints.colors[0], 2U);
+	WriteBits(pOutput + 2U, endpoints.colors[1], 2U);
+	WriteBits(pOutput + 4U, indexBits, 4U);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Single channel blocks of BC3 alpha, BC4 and BC5 in 8 values mode.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+constexpr float ChannelIndexWeights[8] = { 0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f };
+
+void GetChannelPalette(uint8_t value0, uint8_t value1, float (*pPalette)[MaxChannelCount])
+{
+	for (uint32_t entryIndex = 0U; entryIndex < 8U; ++entryIndex)
+	{
+		const float weight1 = ChannelIndexWeights[entryIndex];
+		pPalette[entryIndex][0] = std::floor((1.0f - weight1) * value0 + weight1 * value1 + 0.5f);
+	}
+}
+
+void EncodeChannelBlock(const float* pValues, const EncodeSettings& settings, uint8_t* pOutput)
+{
+	const float* ppChannels[1] = { pValues };
+	const auto [pMinValue, pMaxValue] = std::minmax_element(pValues, pValues + BlockPixelCount);
+
+	// 8 values mode needs value0 > value1 so endpoint 0 is always the larger one.
+	float palette[8][MaxChannelCount];
+	auto EvaluateEndpoints = [&ppChannels, &palette](float high, float low, uint8_t* pEndpoints, uint8_t* pIndices)
+	{
+		pEndpoints[0] = static_cast<uint8_t>(std::clamp(std::max(high, low), 0.0f, 255.0f) + 0.5f);
+		pEndpoints[1] = static_cast<uint8_t>(std::clamp(std::min(high, low), 0.0f, 255.0f) + 0.5f);
+		GetChannelPalette(pEndpoints[0], pEndpoints[1], palette);
+		return FindNearestIndices(ppChannels, 1U, palette, 8U, pIndices);
+	};
+
+	uint8_t endpoints[2];
+	uint8_t indices[BlockPixelCount];
+	float bestError = EvaluateEndpoints(*pMaxValue, *pMinValue, endpoints, indices);
+	auto TryEndpoints = [&](float high, float low)
+	{
+		uint8_t candidateEndpoints[2];
+		uint8_t candidateIndices[BlockPixelCount];
+		const float error = EvaluateEndpoints(high, low, candidateEndpoints, candidateIndices);
+		if (error >= bestError)
+		{
+			return false;
+		}
+
+		bestError = error;
+		std::copy(std::begin(candidateEndpoints), std::end(candidateEndpoints), endpoints);
+		std::copy(std::begin(candidateIndices), std::end(candidateIndices), indices);
+		return true;
+	};
+
+	// Range ends are often outliers so shrinking the range can lower the error of other pixels.
+	if (settings.searchHarder)
+	{
+		constexpr float MaxInset = 3.0f;
+		for (float highInset = 0.0f; highInset <= MaxInset; highInset += 1.0f)
+		{
+			for (float lowInset = 0.0f; lowInset <= MaxInset; lowInset += 1.0f)
+			{
+				if (*pMaxValue - highInset > *pMinValue + lowInset)
+				{
+					TryEndpoints(*pMaxValue - highInset, *pMinValue + lowInset);
+				}
+			}
+		}
+	}
+
+	for (uint32_t refitIndex = 0U; refitIndex < settings.refitCount && bestError > 0.0f; ++refitIndex)
+	{
+		float fittedEndpoints[2][MaxChannelCount];
+		if (!FitEndpoints(ppChannels, 1U, indices, ChannelIndexWeights, fittedEndpoints) || !TryEndpoints(fittedEndpoints[0][0], fittedEndpoints[1][0]))
+		{
+			break;
+		}
+	}
+
+	if (endpoints[0] == endpoints[1])
+	{
+		std::fill(std::begin(indices), std::end(indices), static_cast<uint8_t>(0U));
+	}
+
+	uint64_t indexBits = 0U;
+	for (uint32_t pixelIndex = 0U; pixelIndex < BlockPixelCount; ++pixelIndex)
+	{
+		indexBits |= static_cast<uint64_t>(indices[pixelIndex]) << (pixelIndex * 3U);
+	}
+	pOutput[0] = endpoints[0];
+	pOutput[1] = endpoints[1];
+	WriteBits(pOutput + 2U, indexBits, 6U);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// BC7 blocks of one subset. Mode 6 interpolates RGBA endpoints of 7 bits and a p-bit by 4 bits indices. Mode 5 has
+// 7 bits RGB and 8 bits alpha endpoints which are interpolated by separate 2 bits indices.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+constexpr uint32_t BC7IndexWeights[16] = { 0U, 4U, 9U, 13U, 17U, 21U, 26U, 30U, 34U, 38U, 43U, 47U, 51U, 55U, 60U, 64U };
+constexpr float BC7IndexWeightFactors[16] = { 0.0f / 64.0f, 4.0f / 64.0f, 9.0f / 64.0f, 13.0f / 64.0f, 17.0f / 64.0f, 21.0f / 64.0f,
+	26.0f / 64.0f, 30.0f / 64.0f, 34.0f / 64.0f, 38.0f / 64.0f, 43.0f / 64.0f, 47.0f / 64.0f, 51.0f / 64.0f, 55.0f / 64.0f, 60.0f / 64.0f, 64.0f / 64.0f };
+constexpr uint32_t BC7TwoBitsIndexWeights[4] = { 0U, 21U, 43U, 64U };
+constexpr float BC7TwoBitsIndexWeightFactors[4] = { 0.0f / 64.0f, 21.0f / 64.0f, 43.0f / 64.0f, 64.0f / 64.0f };
+
+// Fields of a block are packed from the lowest bit.
+struct BC7BlockBits
+{
+	uint64_t bits[2] = {};
+	uint32_t bitOffset = 0U;
+
+	void Append(uint32_t value, uint32_t bitCount)
+	{
+		for (uint32_t bitIndex = 0U; bitIndex < bitCount; ++bitIndex, ++bitOffset)
+		{
+			bits[bitOffset / 64U] |= static_cast<uint64_t>((value >> bitIndex) & 1U) << (bitOffset % 64U);
+		}
+	}
+
+	void Write(uint8_t* pOutput) const
+	{
+		assert(128U == bitOffset);
+		WriteBits(pOutput, bits[0], 8U);
+		WriteBits(pOutput + 8U, bits[1], 8U);
+	}
+};
+
+struct BC7Endpoints
+{
+	uint8_t values[2][MaxChannelCount];
+	uint8_t pBits[2];
+};
+
+float InterpolateBC7(uint32_t value0, uint32_t value1, uint32_t weight)
+{
+	return static_cast<float>(((64U - weight) * value0 + weight * value1 + 32U) >> 6U);
+}
+
+// Quantizes an endpoint to 7 bits with the given p-bit. Returns the squared error.
+float QuantizeBC7Endpoint(const float* pEndpoint, uint8_t pBit, uint8_t* pValues)
+{
+	float error = 0.0f;
+	for (uint32_t channelIndex = 0U; channelIndex < MaxChannelCount; ++channelIndex)
+	{
+		pValues[channelIndex] = static_cast<uint8_t>(std::clamp((pEndpoint[channelIndex] - pBit) * 0.5f + 0.5f, 0.0f, 127.0f));
+		const float difference = static_cast<float>((pValues[channelIndex] << 1U) | pBit) - pEndpoint[channelIndex];
+		error += difference * difference;
+	}
+	return error;
+}
+
+float EncodeBC7Mode6(const PixelBlock& block, const EncodeSettings& settings, BC7BlockBits& blockBits)
+{
+	const float* ppChannels[MaxChannelCount] = { block.channels[0], block.channels[1], block.channels[2], block.channels[3] };
+	float palette[MaxPaletteCount][MaxChannelCount];
+	auto EvaluateQuantizedEndpoints = [&ppChannels, &palette](const BC7Endpoints& endpoints, uint8_t* pIndices)
+	{
+		for (uint32_t channelIndex = 0U; channelIndex < MaxChannelCount; ++channelIndex)
+		{
+			const uint32_t value0 = (static_cast<uint32_t>(endpoints.values[0][channelIndex]) << 1U) | endpoints.pBits[0];
+			const uint32_t value1 = (static_cast<uint32_t>(endpoints.values[1][channelIndex]) << 1U) | endpoints.pBits[1];
+			for (uint32_t entryIndex = 0U; entryIndex < MaxPaletteCount; ++entryIndex)
+			{
+				palette[entryIndex][channelIndex] = InterpolateBC7(value0, value1, BC7IndexWeights[entryIndex]);
+			}
+		}
+		return FindNearestIndices(ppChannels, MaxChannelCount, palette, MaxPaletteCount, pIndices);
+	};
+
+	// p-bits are shared by all channels of an endpoint. Each one is picked for its endpoint error, or by the error of
+	// whole block for all combinations when searching harder.
+	auto EvaluateEndpoints = [&settings, &EvaluateQuantizedEndpoints](const float (*pEndpoints)[MaxChannelCount], BC7Endpoints& endpoints, uint8_t* pIndices)
+	{
+		if (!settings.searchHarder)
+		{
+			for (uint32_t endpointIndex = 0U; endpointIndex < 2U; ++endpointIndex)
+			{
+				uint8_t oddValues[MaxChannelCount];
+				const float evenError = QuantizeBC7Endpoint(pEndpoints[endpointIndex], 0U, endpoints.values[endpointIndex]);
+				const float oddError = QuantizeBC7Endpoint(pEndpoints[endpointIndex], 1U, oddValues);
+				endpoints.pBits[endpointIndex] = oddError < evenError ? 1U : 0U;
+				if (oddError < evenError)
+				{
+					std::copy(std::begin(oddValues), std::end(oddValues), endpoints.values[endpointIndex]);
+				}
+			}
+			return EvaluateQuantizedEndpoints(endpoints, pIndices);
+		}
+
+		float bestError = std::numeric_limits<float>::max();
+		for (uint8_t pBitCombination = 0U; pBitCombination < 4U; ++pBitCombination)
+		{
+			BC7Endpoints candidateEndpoints;
+			uint8_t candidateIndices[BlockPixelCount];
+			for (uint32_t endpointIndex = 0U; endpointIndex < 2U; ++endpointIndex)
+			{
+				candidateEndpoints.pBits[endpointIndex] = (pBitCombination >> endpointIndex) & 1U;
+				QuantizeBC7Endpoint(pEndpoints[endpointIndex], candidateEndpoints.pBits[endpointIndex], candidateEndpoints.values[endpointIndex]);
+			}
+
+			const float error = EvaluateQuantizedEndpoints(candidateEndpoints, candidateIndices);
+			if (error < bestError)
+			{
+				bestError = error;
+				endpoints = candidateEndpoints;
+				std::copy(std::begin(candidateIndices), std::end(candidateIndices), pIndices);
+			}
+		}
+		return bestError;
+	};
+
+	BC7Endpoints endpoints;
+	uint8_t indices[BlockPixelCount];
+	const float error = SearchEndpoints(ppChannels, MaxChannelCount, BC7IndexWeightFactors, settings, EvaluateEndpoints, endpoints, indices);
+
+	// Highest index bit of the first pixel is implicit 0. Swapping endpoints reverses indices.
+	if (indices[0] & 8U)
+	{
+		std::swap(endpoints.values[0], endpoints.values[1]);
+		std::swap(endpoints.pBits[0], endpoints.pBits[1]);
+		for (uint8_t& index : indices)
+		{
+			index = static_cast<uint8_t>(15U - index);
+		}
+	}
+
+	// Mode 6 is 6 zero bits followed by a one bit.
+	blockBits.Append(1U << 6U, 7U);
+	for (uint32_t channelIndex = 0U; channelIndex < MaxChannelCount; ++channelIndex)
+	{
+		blockBits.Append(endpoints.values[0][channelIndex], 7U);
+		blockBits.Append(endpoints.values[1][channelIndex], 7U);
+	}
+	blockBits.Append(endpoints.pBits[0], 1U);
+	blockBits.Append(endpoints.pBits[1], 1U);
+	blockBits.Append(indices[0], 3U);
+	for (uint32_t pixelIndex = 1U; pixelIndex < BlockPixelCount; ++pixelIndex)
+	{
+		blockBits.Append(indices[pixelIndex], 4U);
+	}
+
+	return error;
+}
+
+float EncodeBC7Mode5(const PixelBlock& block, const EncodeSettings& settings, BC7BlockBits& blockBits)
+{
+	const float* ppColorChannels[3] = { block.channels[0], block.channels[1], block.channels[2] };
+	const float* ppAlphaChannels[1] = { block.channels[3] };
+	float palette[4][MaxChannelCount];
+
+	// Colors keep 7 bits and the highest bit is replicated to the lowest one in decoding. Alpha keeps 8 bits.
+	auto EvaluateColorEndpoints = [&ppColorChannels, &palette](const float (*pEndpoints)[MaxChannelCount], BC7Endpoints& endpoints, uint8_t* pIndices)
+	{
+		for (uint32_t channelIndex = 0U; channelIndex < 3U; ++channelIndex)
+		{
+			uint32_t values[2];
+			for (uint32_t endpointIndex = 0U; endpointIndex < 2U; ++endpointIndex)
+			{
+				endpoints.values[endpointIndex][channelIndex] = static_cast<uint8_t>(std::clamp(pEndpoints[endpointIndex][channelIndex] * 127.0f / 255.0f + 0.5f, 0.0f, 127.0f));
+				values[endpointIndex] = (static_cast<uint32_t>(endpoints.values[endpointIndex][channelIndex]) << 1U) | (endpoints.values[endpointIndex][channelIndex] >> 6U);
+			}
+			for (uint32_t entryIndex = 0U; entryIndex < 4U; ++entryIndex)
+			{
+				palette[entryIndex][channelIndex] = InterpolateBC7(values[0], values[1], BC7TwoBitsIndexWeights[entryIndex]);
+			}
+		}
+		return FindNearestIndices(ppColorChannels, 3U, palette, 4U, pIndices);
+	};
+
+	auto EvaluateAlphaEndpoints = [&ppAlphaChannels, &palette](const float (*pEndpoints)[MaxChannelCount], BC7Endpoints& endpoints, uint8_t* pIndices)
+	{
+		for (uint32_t endpointIndex = 0U; endpointIndex < 2U; ++endpointIndex)
+		{
+			endpoints.values[endpointIndex][0] = static_cast<uint8_t>(std::clamp(pEndpoints[endpointIndex][0], 0.0f, 255.0f) + 0.5f);
+		}
+		for (uint32_t entryIndex = 0U; entryIndex < 4U; ++entryIndex)
+		{
+			palette[entryIndex][0] = InterpolateBC7(endpoints.values[0][0], endpoints.values[1][0], BC7TwoBitsIndexWeights[entryIndex]);
+		}
+		return FindNearestIndices(ppAlphaChannels, 1U, palette, 4U, pIndices);
+	};
+
+	BC7Endpoints colorEndpoints;
+	BC7Endpoints alphaEndpoints;
+	uint8_t colorIndices[BlockPixelCount];
+	uint8_t alphaIndices[BlockPixelCount];
+	const float error = SearchEndpoints(ppColorChannels, 3U, BC7TwoBitsIndexWeightFactors, settings, EvaluateColorEndpoints, colorEndpoints, colorIndices) +
+		SearchEndpoints(ppAlphaChannels, 1U, BC7TwoBitsIndexWeightFactors, settings, EvaluateAlphaEndpoints, alphaEndpoints, alphaIndices);
+
+	// Highest index bits of the first pixel are implicit 0 in both index sets.
+	for (auto [pEndpoints, pIndices] : { std::make_pair(&colorEndpoints, colorIndices), std::make_pair(&alphaEndpoints, alphaIndices) })
+	{
+		if (pIndices[0] & 2U)
+		{
+			std::swap(pEndpoints->values[0], pEndpoints->values[1]);
+			for (uint32_t pixelIndex = 0U; pixelIndex < BlockPixelCount; ++pixelIndex)
+			{
+				pIndices[pixelIndex] = static_cast<uint8_t>(3U - pIndices[pixelIndex]);
+			}
+		}
+	}
+
+	// Mode 5 is 5 zero bits followed by a one bit. Channels are not rotated.
+	blockBits.Append(1U << 5U, 6U);
+	blockBits.Append(0U, 2U);
+	for (uint32_t channelIndex = 0U; channelIndex < 3U; ++channelIndex)
+	{
+		blockBits.Append(colorEndpoints.values[0][channelIndex], 7U);
+		blockBits.Append(colorEndpoints.values[1][channelIndex], 7U);
+	}
+	blockBits.Append(alphaEndpoints.values[0][0], 8U);
+	blockBits.Append(alphaEndpoints.values[1][0], 8U);
+	for (const uint8_t* pIndices : { colorIndices, alphaIndices })
+	{
+		blockBits.Append(pIndices[0], 1U);
+		for (uint32_t pixelIndex = 1U; pixelIndex < BlockPixelCount; ++pixelIndex)
+		{
+			blockBits.Append(pIndices[pixelIndex], 2U);
+		}
+	}
+
+	return error;
+}
+
+void EncodeBC7Block(const PixelBlock& block, const EncodeSettings& settings, uint8_t* pOutput)
+{
+	BC7BlockBits blockBits;
+	const float mode6Error = EncodeBC7Mode6(block, settings, blockBits);
+
+	// Mode 5 only helps blocks which alpha varies independently of colors.
+	const auto [pMinAlpha, pMaxAlpha] = std::minmax_element(block.channels[3], block.channels[3] + BlockPixelCount);
+	if (*pMinAlpha != *pMaxAlpha && mode6Error > 0.0f)
+	{
+		BC7BlockBits mode5BlockBits;
+		if (EncodeBC7Mode5(block, settings, mode5BlockBits) < mode6Error)
+		{
+			blockBits = mode5BlockBits;
+		}
+	}
+
+	blockBits.Write(pOutput);
+}
+
+void EncodeBlock(const PixelBlock& block, TextureFormat format, const EncodeSettings& settings, uint8_t* pOutput)
+{
+	switch (format)
+	{
+	case TextureFormat::BC1:
+		EncodeColorBlock(block, settings, pOutput);
+		break;
+	case TextureFormat::BC3:
+		EncodeChannelBlock(block.channels[3], settings, pOutput);
+		EncodeColorBlock(block, settings, pOutput + 8U);
+		break;
+	case TextureFormat::BC4:
+		EncodeChannelBlock(block.channels[0], settings, pOutput);
+		break;
+	case TextureFormat::BC5:
+		EncodeChannelBlock(block.channels[0], settings, pOutput);
+		EncodeChannelBlock(block.channels[1], settings, pOutput + 8U);
+		break;
+	case TextureFormat::BC7:
+		EncodeBC7Block(block, settings, pOutput);
+		break;
+	default:
+		assert(false);
+		break;
+	}
+}
+
+}
+
+namespace cd
+{
+
+bool TextureCompressor::IsSupported(TextureFormat sourceFormat, TextureFormat targetFormat)
+{
+	if (TextureFormat::R8 == sourceFormat)
+	{
+		return TextureFormat::BC4 == targetFormat;
+	}
+
+	if (TextureFormat::RGBA8 == sourceFormat)
+	{
+		return TextureFormat::BC1 == targetFormat || TextureFormat::BC3 == targetFormat || TextureFormat::BC4 == targetFormat ||
+			TextureFormat::BC5 == targetFormat || TextureFormat::BC7 == targetFormat;
+	}
+
+	return false;
+}
+
+void TextureCompressor::CompressLevel(const std::byte* pPixels, TextureFormat sourceFormat, uint32_t width, uint32_t height,
+	TextureFormat targetFormat, TextureCompressionQuality quality, std::byte* pOutput)
+{
+	assert(IsSupported(sourceFormat, targetFormat));
+
+	const EncodeSettings settings = GetEncodeSettings(quality);
+	const uint32_t blockCountX = (width + 3U) / 4U;
+	const uint32_t blockCountY = (height + 3U) / 4U;
+	const std::size_t blockSize = TextureMipGenerator::GetMipSize(targetFormat, 4U, 4U);
+
+	// Blocks are independent so rows of them are distributed to threads.
+	ParallelFor(blockCountY, [&](uint32_t blockY)
+	{
+		PixelBlock block;
+		uint8_t* pBlockOutput = reinterpret_cast<uint8_t*>(pOutput) + static_cast<std::size_t>(blockY) * blockCountX * blockSize;
+		for (uint32_t blockX = 0U; blockX < blockCountX; ++blockX)
+		{
+			LoadBlock(pPixels, sourceFormat, width, height, blockX, blockY, block);
+			EncodeBlock(block, targetFormat, settings, pBlockOutput);
+			pBlockOutput += blockSize;
+		}
+	});
+}
+
+bool TextureCompressor::Compress(Texture& texture, TextureFormat targetFormat, TextureCompressionQuality quality)
+{
+	const TextureFormat sourceFormat = texture.GetFormat();
+	const uint32_t width = static_cast<uint32_t>(texture.GetWidth());
+	const uint32_t height = static_cast<uint32_t>(texture.GetHeight());
+	if (!IsSupported(sourceFormat, targetFormat) || 0U == width || 0U == height)
+	{
+		return false;
+	}
+
+	// RawData holds either level 0 or the whole mip chain.
+	const std::vector<std::byte>& pixels = texture.GetRawData();
+	uint32_t mipCount = TextureMipGenerator::GetMipCount(width, height);
+	if (pixels.size() != TextureMipGenerator::GetMipChainSize(sourceFormat, width, height, mipCount))
+	{
+		if (pixels.size() != TextureMipGenerator::GetMipSize(sourceFormat, width, height))
+		{
+			return false;
+		}
+		mipCount = 1U;
+	}
+
+	std::vector<std::byte> blocks(TextureMipGenerator::GetMipChainSize(targetFormat, width, height, mipCount));
+	std::size_t pixelOffset = 0U;
+	std::size_t blockOffset = 0U;
+	for (uint32_t mipIndex = 0U; mipIndex < mipCount; ++mipIndex)
+	{
+		const uint32_t mipWidth = TextureMipGenerator::GetMipDimension(width, mipIndex);
+		const uint32_t mipHeight = TextureMipGenerator::GetMipDimension(height, mipIndex);
+		CompressLevel(pixels.data() + pixelOffset, sourceFormat, mipWidth, mipHeight, targetFormat, quality, blocks.data() + blockOffset);
+		pixelOffset += TextureMipGenerator::GetMipSize(sourceFormat, mipWidth, mipHeight);
+		blockOffset += TextureMipGenerator::GetMipSize(targetFormat, mipWidth, mipHeight);
+	}
+
+	texture.SetRawData(MoveTemp(blocks));
+	texture.SetFormat(targetFormat);
+
+	return true;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "Scene/TextureDecoder.h"
+
+#include "Scene/Texture.h"
+
+#include <climits>
+#include <cstring>
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_NO_STDIO
+#include "stb/stb_image.h"
+
+namespace cd
+{
+
+bool TextureDecoder::Decode(Texture& texture)
+{
+	const std::vector<std::byte>& rawData = texture.GetRawData();
+	if (rawData.empty() || rawData.size() > static_cast<std::size_t>(INT_MAX))
+	{
+		return false;
+	}
+
+	const stbi_uc* pBuffer = reinterpret_cast<const stbi_uc*>(rawData.data());
+	const int bufferSize = static_cast<int>(rawData.size());
+	int width;
+	int height;
+	int channelCount;
+	if (!stbi_info_from_memory(pBuffer, bufferSize, &width, &height, &channelCount))
+	{
+		return false;
+	}
+
+	// RGB and grey alpha images are expanded to RGBA8 as GPUs don't sample 3 channels 8 bits formats well.
+	TextureFormat format;
+	std::size_t pixelSize;
+	void* pPixels;
+	if (stbi_is_hdr_from_memory(pBuffer, bufferSize))
+	{
+		format = TextureFormat::RGBA32F;
+		pixelSize = 4U * sizeof(float);
+		pPixels = stbi_loadf_from_memory(pBuffer, bufferSize, &width, &height, &channelCount, 4);
+	}
+	else
+	{
+		const int outputChannelCount = 1 == channelCount ? 1 : 4;
+		format = 1 == outputChannelCount ? TextureFormat::R8 : TextureFormat::RGBA8;
+		pixelSize = static_cast<std::size_t>(outputChannelCount);
+		pPixels = stbi_load_from_memory(pBuffer, bufferSize, &width, &height, &channelCount, outputChannelCount);
+	}
+
+	if (nullptr == pPixels)
+	{
+		return false;
+	}
+
+	std::vector<std::byte> pixels(static_cast<std::size_t>(width) * height * pixelSize);
+	std::memcpy(pixels.data(), pPixels, pixels.size());
+	stbi_image_free(pPixels);
+
+	texture.SetRawData(MoveTemp(pixels));
+	texture.SetFormat(format);
+	texture.SetWidth(static_cast<float>(width));
+	texture.SetHeight(static_cast<float>(height));
+	texture.SetDepth(1.0f);
+
+	return true;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,460 @@
+#include "Scene/TextureMipGenerator.h"
+
+#include "Math/SIMD.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+
+using namespace cd;
+
+// Levels are filtered as RGBA floats so every pixel is one 4 lanes vector.
+constexpr uint32_t FloatChannelCount = 4U;
+constexpr uint32_t MaxTapCount = 6U;
+constexpr uint32_t LinearToSRGBTableSize = 16384U;
+
+struct FilterKernel
+{
+	// Taps of destination pixel x start from source pixel 2x + firstOffset.
+	int32_t firstOffset;
+	uint32_t tapCount;
+	float weights[MaxTapCount];
+};
+
+float SRGBToLinear(float value)
+{
+	return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+float LinearToSRGB(float value)
+{
+	return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+const std::array<float, 256>& GetSRGBToLinearTable()
+{
+	static const std::array<float, 256> table = []()
+	{
+		std::array<float, 256> result;
+		for (uint32_t index = 0U; index < 256U; ++index)
+		{
+			result[index] = SRGBToLinear(static_cast<float>(index) / 255.0f);
+		}
+		return result;
+	}();
+	return table;
+}
+
+// Fine enough to round dark values to the right 8 bits sRGB codes.
+const std::array<uint8_t, LinearToSRGBTableSize>& GetLinearToSRGBTable()
+{
+	static const std::array<uint8_t, LinearToSRGBTableSize> table = []()
+	{
+		std::array<uint8_t, LinearToSRGBTableSize> result;
+		for (uint32_t index = 0U; index < LinearToSRGBTableSize; ++index)
+		{
+			float linear = static_cast<float>(index) / static_cast<float>(LinearToSRGBTableSize - 1U);
+			result[index] = static_cast<uint8_t>(std::lround(LinearToSRGB(linear) * 255.0f));
+		}
+		return result;
+	}();
+	return table;
+}
+
+// Modified Bessel function of the first kind in series.
+double BesselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+	for (int index = 1; index < 32; ++index)
+	{
+		term *= (x * 0.5 / index) * (x * 0.5 / index);
+		sum += term;
+	}
+	return sum;
+}
+
+FilterKernel GetFilterKernel(TextureMipFilter filter)
+{
+	if (TextureMipFilter::Box == filter)
+	{
+		return FilterKernel{ 0, 2U, { 0.5f, 0.5f } };
+	}
+
+	// Sinc cut off at the destination Nyquist frequency, windowed over 3 source pixels on each side with alpha 4.
+	static const FilterKernel kaiserKernel = []()
+	{
+		constexpr double Pi = 3.14159265358979323846;
+		constexpr double Alpha = 4.0;
+		constexpr double HalfWidth = 3.0;
+		FilterKernel kernel{ -2, MaxTapCount, {} };
+		double weightSum = 0.0;
+		double weights[MaxTapCount];
+		for (uint32_t tapIndex = 0U; tapIndex < MaxTapCount; ++tapIndex)
+		{
+			// Distance from the destination pixel center at 2x + 0.5 in source pixels.
+			double distance = std::abs(static_cast<double>(tapIndex) - 2.5);
+			double sinc = std::sin(Pi * distance * 0.5) / (Pi * distance * 0.5);
+			double ratio = distance / HalfWidth;
+			weights[tapIndex] = sinc * BesselI0(Alpha * std::sqrt(1.0 - ratio * ratio)) / BesselI0(Alpha);
+			weightSum += weights[tapIndex];
+		}
+		for (uint32_t tapIndex = 0U; tapIndex < MaxTapCount; ++tapIndex)
+		{
+			kernel.weights[tapIndex] = static_cast<float>(weights[tapIndex] / weightSum);
+		}
+		return kernel;
+	}();
+	return kaiserKernel;
+}
+
+// Tap count is a template argument so that the loop over taps unrolls. GetTap returns the pointer to a tap pixel.
+template<uint32_t TapCount, typename GetTap>
+CD_FORCEINLINE void FilterPixel(GetTap&& getTap, const float* pWeights, float* pOutput)
+{
+#if defined(CD_SIMD_SSE)
+	__m128 sum = _mm_mul_ps(_mm_loadu_ps(getTap(0U)), _mm_set1_ps(pWeights[0]));
+	for (uint32_t tapIndex = 1U; tapIndex < TapCount; ++tapIndex)
+	{
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(getTap(tapIndex)), _mm_set1_ps(pWeights[tapIndex])));
+	}
+	_mm_storeu_ps(pOutput, sum);
+#elif defined(CD_SIMD_NEON)
+	float32x4_t sum = vmulq_n_f32(vld1q_f32(getTap(0U)), pWeights[0]);
+	for (uint32_t tapIndex = 1U; tapIndex < TapCount; ++tapIndex)
+	{
+		sum = vaddq_f32(sum, vmulq_n_f32(vld1q_f32(getTap(tapIndex)), pWeights[tapIndex]));
+	}
+	vst1q_f32(pOutput, sum);
+#else
+	for (uint32_t channelIndex = 0U; channelIndex < FloatChannelCount; ++channelIndex)
+	{
+		float sum = getTap(0U)[channelIndex] * pWeights[0];
+		for (uint32_t tapIndex = 1U; tapIndex < TapCount; ++tapIndex)
+		{
+			sum += getTap(tapIndex)[channelIndex] * pWeights[tapIndex];
+		}
+		pOutput[channelIndex] = sum;
+	}
+#endif
+}
+
+// Halves width of one RGBA float row. Taps out of the row are clamped to edges.
+template<uint32_t TapCount>
+void FilterRow(const float* pSource, uint32_t sourceWidth, float* pDestination, uint32_t destinationWidth, const FilterKernel& kernel)
+{
+	const int32_t lastSourceIndex = static_cast<int32_t>(sourceWidth) - 1;
+	for (uint32_t columnIndex = 0U; columnIndex < destinationWidth; ++columnIndex)
+	{
+		const int32_t firstSourceIndex = static_cast<int32_t>(columnIndex * 2U) + kernel.firstOffset;
+		float* pOutput = pDestination + static_cast<std::size_t>(columnIndex) * FloatChannelCount;
+		if (firstSourceIndex >= 0 && firstSourceIndex + static_cast<int32_t>(TapCount) <= static_cast<int32_t>(sourceWidth))
+		{
+			const float* pFirstTap = pSource + static_cast<std::size_t>(firstSourceIndex) * FloatChannelCount;
+			FilterPixel<TapCount>([pFirstTap](uint32_t tapIndex) { return pFirstTap + tapIndex * FloatChannelCount; }, kernel.weights, pOutput);
+		}
+		else
+		{
+			FilterPixel<TapCount>([pSource, firstSourceIndex, lastSourceIndex](uint32_t tapIndex)
+			{
+				const int32_t sourceIndex = std::clamp(firstSourceIndex + static_cast<int32_t>(tapIndex), 0, lastSourceIndex);
+				return pSource + static_cast<std::size_t>(sourceIndex) * FloatChannelCount;
+			}, kernel.weights, pOutput);
+		}
+	}
+}
+
+// Blends rows which are taps of one destination row.
+template<uint32_t TapCount>
+void FilterColumn(const float* const* ppTapRows, uint32_t width, float* pDestination, const FilterKernel& kernel)
+{
+	const std::size_t rowFloatCount = static_cast<std::size_t>(width) * FloatChannelCount;
+	for (std::size_t pixelOffset = 0U; pixelOffset < rowFloatCount; pixelOffset += FloatChannelCount)
+	{
+		FilterPixel<TapCount>([ppTapRows, pixelOffset](uint32_t tapIndex) { return ppTapRows[tapIndex] + pixelOffset; }, kernel.weights, pDestination + pixelOffset);
+	}
+}
+
+void FilterRow(const float* pSource, uint32_t sourceWidth, float* pDestination, uint32_t destinationWidth, const FilterKernel& kernel)
+{
+	assert(2U == kernel.tapCount || MaxTapCount == kernel.tapCount);
+	if (2U == kernel.tapCount)
+	{
+		FilterRow<2U>(pSource, sourceWidth, pDestination, destinationWidth, kernel);
+	}
+	else
+	{
+		FilterRow<MaxTapCount>(pSource, sourceWidth, pDestination, destinationWidth, kernel);
+	}
+}
+
+void FilterColumn(const float* const* ppTapRows, uint32_t width, float* pDestination, const FilterKernel& kernel)
+{
+	switch (kernel.tapCount)
+	{
+	case 1U:
+		std::memcpy(pDestination, ppTapRows[0], static_cast<std::size_t>(width) * FloatChannelCount * sizeof(float));
+		break;
+	case 2U:
+		FilterColumn<2U>(ppTapRows, width, pDestination, kernel);
+		break;
+	default:
+		assert(MaxTapCount == kernel.tapCount);
+		FilterColumn<MaxTapCount>(ppTapRows, width, pDestination, kernel);
+		break;
+	}
+}
+
+void ToFloatPixels(const std::byte* pPixels, TextureFormat format, uint32_t pixelCount, bool isSRGB, float* pOutput)
+{
+	if (TextureFormat::RGBA32F == format)
+	{
+		std::memcpy(pOutput, pPixels, static_cast<std::size_t>(pixelCount) * FloatChannelCount * sizeof(float));
+		return;
+	}
+
+	// Linear values also go through a table so that color channels don't branch per pixel.
+	std::array<float, 256> linearTable;
+	const std::array<float, 256>* pColorTable = &GetSRGBToLinearTable();
+	for (uint32_t index = 0U; index < 256U; ++index)
+	{
+		linearTable[index] = static_cast<float>(index) / 255.0f;
+	}
+	if (!isSRGB)
+	{
+		pColorTable = &linearTable;
+	}
+	const std::array<float, 256>& colorTable = *pColorTable;
+
+	const uint8_t* pCodes = reinterpret_cast<const uint8_t*>(pPixels);
+	if (TextureFormat::R8 == format)
+	{
+		for (uint32_t pixelIndex = 0U; pixelIndex < pixelCount; ++pixelIndex)
+		{
+			float* pPixel = pOutput + static_cast<std::size_t>(pixelIndex) * FloatChannelCount;
+			pPixel[0] = colorTable[pCodes[pixelIndex]];
+			pPixel[1] = pPixel[2] = pPixel[3] = 0.0f;
+		}
+		return;
+	}
+
+	for (uint32_t pixelIndex = 0U; pixelIndex < pixelCount; ++pixelIndex)
+	{
+		float* pPixel = pOutput + static_cast<std::size_t>(pixelIndex) * FloatChannelCount;
+		const uint8_t* pInput = pCodes + static_cast<std::size_t>(pixelIndex) * 4U;
+		pPixel[0] = colorTable[pInput[0]];
+		pPixel[1] = colorTable[pInput[1]];
+		pPixel[2] = colorTable[pInput[2]];
+		pPixel[3] = linearTable[pInput[3]];
+	}
+}
+
+uint8_t LinearFloatToCode(float value)
+{
+	return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+uint8_t SRGBFloatToCode(float value)
+{
+	return GetLinearToSRGBTable()[static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * (LinearToSRGBTableSize - 1U) + 0.5f)];
+}
+
+void FromFloatPixels(const float* pPixels, TextureFormat format, uint32_t pixelCount, bool isSRGB, std::byte* pOutput)
+{
+	if (TextureFormat::RGBA32F == format)
+	{
+		// Negative lobes of Kaiser filter can't make HDR values negative.
+		const std::size_t valueCount = static_cast<std::size_t>(pixelCount) * FloatChannelCount;
+		float* pResult = reinterpret_cast<float*>(pOutput);
+		for (std::size_t valueIndex = 0U; valueIndex < valueCount; ++valueIndex)
+		{
+			const float value = std::max(pPixels[valueIndex], 0.0f);
+			std::memcpy(pResult + valueIndex, &value, sizeof(float));
+		}
+		return;
+	}
+
+	uint8_t* pCodes = reinterpret_cast<uint8_t*>(pOutput);
+	auto ColorToCode = isSRGB ? SRGBFloatToCode : LinearFloatToCode;
+	if (TextureFormat::R8 == format)
+	{
+		for (uint32_t pixelIndex = 0U; pixelIndex < pixelCount; ++pixelIndex)
+		{
+			pCodes[pixelIndex] = ColorToCode(pPixels[static_cast<std::size_t>(pixelIndex) * FloatChannelCount]);
+		}
+		return;
+	}
+
+	for (uint32_t pixelIndex = 0U; pixelIndex < pixelCount; ++pixelIndex)
+	{
+		const float* pPixel = pPixels + static_cast<std::size_t>(pixelIndex) * FloatChannelCount;
+		uint8_t* pResult = pCodes + static_cast<std::size_t>(pixelIndex) * 4U;
+		pResult[0] = ColorToCode(pPixel[0]);
+		pResult[1] = ColorToCode(pPixel[1]);
+		pResult[2] = ColorToCode(pPixel[2]);
+		pResult[3] = LinearFloatToCode(pPixel[3]);
+	}
+}
+
+}
+
+namespace cd
+{
+
+uint32_t TextureMipGenerator::GetMipCount(uint32_t width, uint32_t height)
+{
+	uint32_t mipCount = 1U;
+	for (uint32_t size = std::max(width, height); size > 1U; size >>= 1U)
+	{
+		++mipCount;
+	}
+	return mipCount;
+}
+
+std::size_t TextureMipGenerator::GetMipSize(TextureFormat format, uint32_t width, uint32_t height)
+{
+	// Block compressed levels are padded to whole 4x4 blocks.
+	const std::size_t blockCount = static_cast<std::size_t>((width + 3U) / 4U) * ((height + 3U) / 4U);
+	switch (format)
+	{
+	case TextureFormat::BC1:
+	case TextureFormat::BC4:
+		return blockCount * 8U;
+	case TextureFormat::BC2:
+	case TextureFormat::BC3:
+	case TextureFormat::BC5:
+	case TextureFormat::BC6H:
+	case TextureFormat::BC7:
+		return blockCount * 16U;
+	case TextureFormat::R8:
+		return static_cast<std::size_t>(width) * height;
+	case TextureFormat::RGBA8:
+		return static_cast<std::size_t>(width) * height * 4U;
+	case TextureFormat::RGBA32F:
+		return static_cast<std::size_t>(width) * height * 16U;
+	default:
+		return 0U;
+	}
+}
+
+std::size_t TextureMipGenerator::GetMipChainSize(TextureFormat format, uint32_t width, uint32_t height, uint32_t mipCount)
+{
+	std::size_t chainSize = 0U;
+	for (uint32_t mipIndex = 0U; mipIndex < mipCount; ++mipIndex)
+	{
+		chainSize += GetMipSize(format, GetMipDimension(width, mipIndex), GetMipDimension(height, mipIndex));
+	}
+	return chainSize;
+}
+
+void TextureMipGenerator::GenerateMipChain(std::vector<std::byte>& pixels, TextureFormat format, uint32_t width, uint32_t height,
+	bool isSRGB, TextureMipFilter filter)
+{
+	if (format != TextureFormat::R8 && format != TextureFormat::RGBA8 && format != TextureFormat::RGBA32F)
+	{
+		return;
+	}
+
+	const uint32_t mipCount = GetMipCount(width, height);
+	const std::size_t levelSize = GetMipSize(format, width, height);
+	if (0U == levelSize || pixels.size() < levelSize || mipCount <= 1U)
+	{
+		return;
+	}
+
+	// HDR pixels are already linear.
+	isSRGB = isSRGB && format != TextureFormat::RGBA32F;
+
+	const FilterKernel kernel = GetFilterKernel(filter);
+	pixels.resize(GetMipChainSize(format, width, height, mipCount));
+
+	// Levels are produced row by row. Source rows are filtered horizontally into a ring which holds the rows of one
+	// vertical kernel window, then a destination row is filtered from the ring. Only level 0 is read from pixels and
+	// other levels are read from the float copy of the previous level so conversions are not accumulated.
+	std::vector<float> sourceLevel;
+	std::vector<float> destinationLevel;
+	std::vector<float> sourceRow(static_cast<std::size_t>(width) * FloatChannelCount);
+	std::vector<float> filteredRows;
+	std::vector<float> destinationRow;
+	int32_t ringRowIndices[MaxTapCount];
+
+	std::size_t levelOffset = levelSize;
+	uint32_t sourceWidth = width;
+	uint32_t sourceHeight = height;
+	for (uint32_t mipIndex = 1U; mipIndex < mipCount; ++mipIndex)
+	{
+		const uint32_t destinationWidth = GetMipDimension(width, mipIndex);
+		const uint32_t destinationHeight = GetMipDimension(height, mipIndex);
+		const std::size_t destinationRowFloatCount = static_cast<std::size_t>(destinationWidth) * FloatChannelCount;
+		const bool isLastLevel = mipIndex + 1U == mipCount;
+
+		// A dimension which is already 1 is copied.
+		const FilterKernel columnKernel = destinationHeight < sourceHeight ? kernel : FilterKernel{ 0, 1U, { 1.0f } };
+		const uint32_t columnStep = destinationHeight < sourceHeight ? 2U : 1U;
+
+		filteredRows.resize(MaxTapCount * destinationRowFloatCount);
+		destinationRow.resize(destinationRowFloatCount);
+		destinationLevel.resize(isLastLevel ? 0U : destinationRowFloatCount * destinationHeight);
+		std::fill(std::begin(ringRowIndices), std::end(ringRowIndices), -1);
+
+		auto GetFilteredRow = [&](int32_t rowIndex)
+		{
+			float* pFilteredRow = filteredRows.data() + static_cast<std::size_t>(rowIndex % MaxTapCount) * destinationRowFloatCount;
+			if (ringRowIndices[rowIndex % MaxTapCount] == rowIndex)
+			{
+				return pFilteredRow;
+			}
+
+			const float* pSourceRow;
+			if (1U == mipIndex)
+			{
+				const std::size_t rowSize = GetMipSize(format, sourceWidth, 1U);
+				ToFloatPixels(pixels.data() + rowSize * static_cast<std::size_t>(rowIndex), format, sourceWidth, isSRGB, sourceRow.data());
+				pSourceRow = sourceRow.data();
+			}
+			else
+			{
+				pSourceRow = sourceLevel.data() + static_cast<std::size_t>(rowIndex) * sourceWidth * FloatChannelCount;
+			}
+
+			if (destinationWidth < sourceWidth)
+			{
+				FilterRow(pSourceRow, sourceWidth, pFilteredRow, destinationWidth, kernel);
+			}
+			else
+			{
+				std::memcpy(pFilteredRow, pSourceRow, destinationRowFloatCount * sizeof(float));
+			}
+			ringRowIndices[rowIndex % MaxTapCount] = rowIndex;
+			return pFilteredRow;
+		};
+
+		const float* pTapRows[MaxTapCount];
+		for (uint32_t rowIndex = 0U; rowIndex < destinationHeight; ++rowIndex)
+		{
+			const int32_t firstSourceIndex = static_cast<int32_t>(rowIndex * columnStep) + columnKernel.firstOffset;
+			for (uint32_t tapIndex = 0U; tapIndex < columnKernel.tapCount; ++tapIndex)
+			{
+				pTapRows[tapIndex] = GetFilteredRow(std::clamp(firstSourceIndex + static_cast<int32_t>(tapIndex), 0, static_cast<int32_t>(sourceHeight) - 1));
+			}
+
+			float* pDestinationRow = isLastLevel ? destinationRow.data() : destinationLevel.data() + rowIndex * destinationRowFloatCount;
+			FilterColumn(pTapRows, destinationWidth, pDestinationRow, columnKernel);
+
+			FromFloatPixels(pDestinationRow, format, destinationWidth, isSRGB, pixels.data() + levelOffset);
+			levelOffset += GetMipSize(format, destinationWidth, 1U);
+		}
+
+		std::swap(sourceLevel, destinationLevel);
+		sourceWidth = destinationWidth;
+		sourceHeight = destinationHeight;
+	}
+	assert(levelOffset == pixels.size());
+}
+
+}
\ No newline at end of file
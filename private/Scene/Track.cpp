@@ -17,9 +17,13 @@ void Track::Init(TrackID id, std::string name)
 }
 
 PIMPL_SIMPLE_TYPE_APIS(Track, ID);
+PIMPL_SIMPLE_TYPE_APIS(Track, KeyFrameEncoding);
 PIMPL_STRING_TYPE_APIS(Track, Name);
 PIMPL_VECTOR_TYPE_APIS(Track, TranslationKey);
 PIMPL_VECTOR_TYPE_APIS(Track, RotationKey);
 PIMPL_VECTOR_TYPE_APIS(Track, ScaleKey);
+PIMPL_COMPLEX_TYPE_APIS(Track, QuantizedTranslationKeys);
+PIMPL_COMPLEX_TYPE_APIS(Track, QuantizedRotationKeys);
+PIMPL_COMPLEX_TYPE_APIS(Track, QuantizedScaleKeys);
 
 }
\ No newline at end of file
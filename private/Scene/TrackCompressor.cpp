@@ -0,0 +1,289 @@
+#include "Scene/TrackCompressor.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace cd
+{
+
+namespace
+{
+
+constexpr float SmallestThreeRange = 0.70710678f;
+constexpr uint32_t SmallestThreeMaxValue = (1U << 15U) - 1U;
+
+// Greedy reduction from the first key. A segment grows as long as every source key inside it is within the tolerance
+// of the interpolated value. Otherwise the last key which fits ends the segment and starts the next one.
+template<typename KeyFrame, typename LerpFunc, typename ErrorFunc>
+void ReduceKeyFrames(std::vector<KeyFrame>& keyFrames, float tolerance, LerpFunc&& lerp, ErrorFunc&& error)
+{
+	if (keyFrames.size() < 2U)
+	{
+		return;
+	}
+
+	std::vector<KeyFrame> keptKeyFrames;
+	keptKeyFrames.push_back(keyFrames.front());
+	std::size_t segmentBegin = 0U;
+	for (std::size_t segmentEnd = 2U; segmentEnd < keyFrames.size(); ++segmentEnd)
+	{
+		const KeyFrame& begin = keyFrames[segmentBegin];
+		const KeyFrame& end = keyFrames[segmentEnd];
+		const float interval = end.GetTime() - begin.GetTime();
+		for (std::size_t keyIndex = segmentBegin + 1U; keyIndex < segmentEnd; ++keyIndex)
+		{
+			const float factor = interval > 0.0f ? (keyFrames[keyIndex].GetTime() - begin.GetTime()) / interval : 0.0f;
+			if (error(lerp(begin.GetValue(), end.GetValue(), factor), keyFrames[keyIndex].GetValue()) > tolerance)
+			{
+				segmentBegin = segmentEnd - 1U;
+				keptKeyFrames.push_back(keyFrames[segmentBegin]);
+				break;
+			}
+		}
+	}
+	keptKeyFrames.push_back(keyFrames.back());
+
+	if (2U == keptKeyFrames.size() && error(keptKeyFrames.front().GetValue(), keptKeyFrames.back().GetValue()) <= tolerance)
+	{
+		keptKeyFrames.pop_back();
+	}
+
+	keyFrames = cd::MoveTemp(keptKeyFrames);
+}
+
+float DistanceError(const Vec3f& lhs, const Vec3f& rhs)
+{
+	return (lhs - rhs).Length();
+}
+
+float ComponentError(const Vec3f& lhs, const Vec3f& rhs)
+{
+	return std::max({ std::abs(lhs.x() - rhs.x()), std::abs(lhs.y() - rhs.y()), std::abs(lhs.z() - rhs.z()) });
+}
+
+float AngleError(const Quaternion& lhs, const Quaternion& rhs)
+{
+	// Rotation angle from the chord between unit quaternions which keeps precision for small angles unlike acos of dot.
+	const Quaternion difference = lhs.Dot(rhs) < 0.0f ? lhs + rhs : lhs - rhs;
+	return 4.0f * std::asin(std::min(difference.Length() * 0.5f, 1.0f));
+}
+
+template<typename KeyFrame>
+QuantizedKeyFrames EncodeRangeKeyFrames(const std::vector<KeyFrame>& keyFrames)
+{
+	QuantizedKeyFrames quantizedKeyFrames;
+	if (keyFrames.empty())
+	{
+		return quantizedKeyFrames;
+	}
+
+	Vec3f minValue = keyFrames.front().GetValue();
+	Vec3f maxValue = minValue;
+	for (const KeyFrame& keyFrame : keyFrames)
+	{
+		for (std::size_t componentIndex = 0U; componentIndex < 3U; ++componentIndex)
+		{
+			minValue[componentIndex] = std::min(minValue[componentIndex], keyFrame.GetValue()[componentIndex]);
+			maxValue[componentIndex] = std::max(maxValue[componentIndex], keyFrame.GetValue()[componentIndex]);
+		}
+	}
+
+	quantizedKeyFrames.minValue = minValue;
+	quantizedKeyFrames.extent = maxValue - minValue;
+	quantizedKeyFrames.times.resize(keyFrames.size());
+	quantizedKeyFrames.values.resize(keyFrames.size() * 3U);
+	for (std::size_t keyIndex = 0U; keyIndex < keyFrames.size(); ++keyIndex)
+	{
+		quantizedKeyFrames.times[keyIndex] = keyFrames[keyIndex].GetTime();
+		TrackCompressor::EncodeRange(keyFrames[keyIndex].GetValue(), quantizedKeyFrames.minValue, quantizedKeyFrames.extent,
+			&quantizedKeyFrames.values[keyIndex * 3U]);
+	}
+
+	return quantizedKeyFrames;
+}
+
+QuantizedKeyFrames EncodeRotationKeyFrames(const std::vector<RotationKey>& keyFrames)
+{
+	QuantizedKeyFrames quantizedKeyFrames;
+	quantizedKeyFrames.times.resize(keyFrames.size());
+	quantizedKeyFrames.values.resize(keyFrames.size() * 3U);
+	for (std::size_t keyIndex = 0U; keyIndex < keyFrames.size(); ++keyIndex)
+	{
+		quantizedKeyFrames.times[keyIndex] = keyFrames[keyIndex].GetTime();
+		TrackCompressor::EncodeRotation(keyFrames[keyIndex].GetValue(), &quantizedKeyFrames.values[keyIndex * 3U]);
+	}
+
+	return quantizedKeyFrames;
+}
+
+template<typename KeyFrame, typename DecodeFunc, typename ErrorFunc>
+bool IsWithinTolerance(const std::vector<KeyFrame>& keyFrames, const QuantizedKeyFrames& quantizedKeyFrames, float tolerance,
+	DecodeFunc&& decode, ErrorFunc&& error)
+{
+	for (uint32_t keyIndex = 0U; keyIndex < static_cast<uint32_t>(keyFrames.size()); ++keyIndex)
+	{
+		if (error(decode(quantizedKeyFrames, keyIndex), keyFrames[keyIndex].GetValue()) > tolerance)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template<typename KeyFrame, typename DecodeFunc>
+void DecodeKeyFrames(const QuantizedKeyFrames& quantizedKeyFrames, std::vector<KeyFrame>& keyFrames, DecodeFunc&& decode)
+{
+	keyFrames.resize(quantizedKeyFrames.times.size());
+	for (uint32_t keyIndex = 0U; keyIndex < static_cast<uint32_t>(keyFrames.size()); ++keyIndex)
+	{
+		keyFrames[keyIndex].SetTime(quantizedKeyFrames.times[keyIndex]);
+		keyFrames[keyIndex].SetValue(decode(quantizedKeyFrames, keyIndex));
+	}
+}
+
+}
+
+void TrackCompressor::ReduceKeys(Track& track, float translationTolerance, float rotationTolerance, float scaleTolerance)
+{
+	assert(KeyFrameEncoding::Float == track.GetKeyFrameEncoding());
+
+	// Interpolations are the same as sampling keys.
+	ReduceKeyFrames(track.GetTranslationKeys(), translationTolerance, &Vec3f::Lerp, &DistanceError);
+	ReduceKeyFrames(track.GetRotationKeys(), rotationTolerance, &Quaternion::LerpNormalized, &AngleError);
+	ReduceKeyFrames(track.GetScaleKeys(), scaleTolerance, &Vec3f::Lerp, &ComponentError);
+}
+
+bool TrackCompressor::QuantizeKeys(Track& track, float translationTolerance, float rotationTolerance, float scaleTolerance)
+{
+	if (KeyFrameEncoding::Quantized == track.GetKeyFrameEncoding())
+	{
+		return true;
+	}
+
+	QuantizedKeyFrames translationKeys = EncodeRangeKeyFrames(track.GetTranslationKeys());
+	QuantizedKeyFrames rotationKeys = EncodeRotationKeyFrames(track.GetRotationKeys());
+	QuantizedKeyFrames scaleKeys = EncodeRangeKeyFrames(track.GetScaleKeys());
+	if (!IsWithinTolerance(track.GetTranslationKeys(), translationKeys, translationTolerance, &DecodeRangeKey, &DistanceError) ||
+		!IsWithinTolerance(track.GetRotationKeys(), rotationKeys, rotationTolerance, &DecodeRotationKey, &AngleError) ||
+		!IsWithinTolerance(track.GetScaleKeys(), scaleKeys, scaleTolerance, &DecodeRangeKey, &ComponentError))
+	{
+		return false;
+	}
+
+	track.SetQuantizedTranslationKeys(cd::MoveTemp(translationKeys));
+	track.SetQuantizedRotationKeys(cd::MoveTemp(rotationKeys));
+	track.SetQuantizedScaleKeys(cd::MoveTemp(scaleKeys));
+	std::vector<TranslationKey>().swap(track.GetTranslationKeys());
+	std::vector<RotationKey>().swap(track.GetRotationKeys());
+	std::vector<ScaleKey>().swap(track.GetScaleKeys());
+	track.SetKeyFrameEncoding(KeyFrameEncoding::Quantized);
+
+	return true;
+}
+
+void TrackCompressor::DecodeKeys(Track& track)
+{
+	if (KeyFrameEncoding::Float == track.GetKeyFrameEncoding())
+	{
+		return;
+	}
+
+	DecodeKeyFrames(track.GetQuantizedTranslationKeys(), track.GetTranslationKeys(), &DecodeRangeKey);
+	DecodeKeyFrames(track.GetQuantizedRotationKeys(), track.GetRotationKeys(), &DecodeRotationKey);
+	DecodeKeyFrames(track.GetQuantizedScaleKeys(), track.GetScaleKeys(), &DecodeRangeKey);
+	track.SetQuantizedTranslationKeys(QuantizedKeyFrames());
+	track.SetQuantizedRotationKeys(QuantizedKeyFrames());
+	track.SetQuantizedScaleKeys(QuantizedKeyFrames());
+	track.SetKeyFrameEncoding(KeyFrameEncoding::Float);
+}
+
+Vec3f TrackCompressor::DecodeRangeKey(const QuantizedKeyFrames& keyFrames, uint32_t keyIndex)
+{
+	return DecodeRange(&keyFrames.values[static_cast<std::size_t>(keyIndex) * 3U], keyFrames.minValue, keyFrames.extent);
+}
+
+Quaternion TrackCompressor::DecodeRotationKey(const QuantizedKeyFrames& keyFrames, uint32_t keyIndex)
+{
+	return DecodeRotation(&keyFrames.values[static_cast<std::size_t>(keyIndex) * 3U]);
+}
+
+void TrackCompressor::EncodeRotation(const Quaternion& rotation, uint16_t* pOutput)
+{
+	int largestIndex = 0;
+	for (int componentIndex = 1; componentIndex < 4; ++componentIndex)
+	{
+		if (std::abs(rotation.Data(componentIndex)) > std::abs(rotation.Data(largestIndex)))
+		{
+			largestIndex = componentIndex;
+		}
+	}
+
+	// q and -q are the same rotation so the largest component is always positive and doesn't need to be stored.
+	const float sign = rotation.Data(largestIndex) < 0.0f ? -1.0f : 1.0f;
+	const float invLength = sign / rotation.Length();
+	uint64_t bits = static_cast<uint64_t>(largestIndex);
+	for (int componentIndex = 0; componentIndex < 4; ++componentIndex)
+	{
+		if (componentIndex == largestIndex)
+		{
+			continue;
+		}
+
+		const float value = std::clamp(rotation.Data(componentIndex) * invLength / SmallestThreeRange * 0.5f + 0.5f, 0.0f, 1.0f);
+		bits = (bits << 15U) | static_cast<uint64_t>(std::lround(value * static_cast<float>(SmallestThreeMaxValue)));
+	}
+
+	pOutput[0] = static_cast<uint16_t>(bits);
+	pOutput[1] = static_cast<uint16_t>(bits >> 16U);
+	pOutput[2] = static_cast<uint16_t>(bits >> 32U);
+}
+
+Quaternion TrackCompressor::DecodeRotation(const uint16_t* pInput)
+{
+	const uint64_t bits = static_cast<uint64_t>(pInput[0]) | (static_cast<uint64_t>(pInput[1]) << 16U) | (static_cast<uint64_t>(pInput[2]) << 32U);
+	const int largestIndex = static_cast<int>((bits >> 45U) & 3U);
+
+	Quaternion rotation;
+	float lengthSquare = 0.0f;
+	uint32_t shift = 30U;
+	for (int componentIndex = 0; componentIndex < 4; ++componentIndex)
+	{
+		if (componentIndex == largestIndex)
+		{
+			continue;
+		}
+
+		const float value = static_cast<float>((bits >> shift) & SmallestThreeMaxValue) / static_cast<float>(SmallestThreeMaxValue);
+		rotation.Data(componentIndex) = (value * 2.0f - 1.0f) * SmallestThreeRange;
+		lengthSquare += rotation.Data(componentIndex) * rotation.Data(componentIndex);
+		shift -= 15U;
+	}
+	rotation.Data(largestIndex) = std::sqrt(std::max(1.0f - lengthSquare, 0.0f));
+
+	return rotation;
+}
+
+void TrackCompressor::EncodeRange(const Vec3f& value, const Vec3f& minValue, const Vec3f& extent, uint16_t* pOutput)
+{
+	for (std::size_t componentIndex = 0U; componentIndex < 3U; ++componentIndex)
+	{
+		const float normalized = extent[componentIndex] > 0.0f ? std::clamp((value[componentIndex] - minValue[componentIndex]) / extent[componentIndex], 0.0f, 1.0f) : 0.0f;
+		pOutput[componentIndex] = static_cast<uint16_t>(std::lround(normalized * 65535.0f));
+	}
+}
+
+Vec3f TrackCompressor::DecodeRange(const uint16_t* pInput, const Vec3f& minValue, const Vec3f& extent)
+{
+	Vec3f value;
+	for (std::size_t componentIndex = 0U; componentIndex < 3U; ++componentIndex)
+	{
+		value[componentIndex] = minValue[componentIndex] + static_cast<float>(pInput[componentIndex]) / 65535.0f * extent[componentIndex];
+	}
+
+	return value;
+}
+
+}
\ No newline at end of file
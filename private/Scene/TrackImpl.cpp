@@ -12,6 +12,7 @@ void TrackImpl::Init(TrackID id, std::string name)
 {
 	SetID(id);
 	SetName(MoveTemp(name));
+	SetKeyFrameEncoding(KeyFrameEncoding::Float);
 }
 
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "Scene/KeyFrame.hpp"
 #include "Scene/Types.h"
 
+#include <cassert>
 #include <vector>
 #include <string>
 
@@ -21,33 +22,47 @@ public:
 	void Init(TrackID id, std::string name);
 
 	IMPLEMENT_SIMPLE_TYPE_APIS(Track, ID);
+	IMPLEMENT_SIMPLE_TYPE_APIS(Track, KeyFrameEncoding);
 	IMPLEMENT_STRING_TYPE_APIS(Track, Name);
 	IMPLEMENT_VECTOR_TYPE_APIS(Track, TranslationKey);
 	IMPLEMENT_VECTOR_TYPE_APIS(Track, RotationKey);
 	IMPLEMENT_VECTOR_TYPE_APIS(Track, ScaleKey);
+	IMPLEMENT_COMPLEX_TYPE_APIS(Track, QuantizedTranslationKeys);
+	IMPLEMENT_COMPLEX_TYPE_APIS(Track, QuantizedRotationKeys);
+	IMPLEMENT_COMPLEX_TYPE_APIS(Track, QuantizedScaleKeys);
 
 	template<bool SwapBytesOrder>
 	TrackImpl& operator<<(TInputArchive<SwapBytesOrder>& inputArchive)
 	{
 		uint32_t trackID;
 		std::string trackName;
+		uint8_t keyFrameEncoding;
 		uint32_t translationKeyCount;
 		uint32_t rotationKeyCount;
 		uint32_t scaleKeyCount;
 
-		inputArchive >> trackID >> trackName
+		inputArchive >> trackID >> trackName >> keyFrameEncoding
 			>> translationKeyCount >> rotationKeyCount >> scaleKeyCount;
 
 		Init(TrackID(trackID), cd::MoveTemp(trackName));
-
-		SetTranslationKeyCount(translationKeyCount);
-		inputArchive.ImportBuffer(GetTranslationKeys().data());
-
-		SetRotationKeyCount(rotationKeyCount);
-		inputArchive.ImportBuffer(GetRotationKeys().data());
-
-		SetScaleKeyCount(scaleKeyCount);
-		inputArchive.ImportBuffer(GetScaleKeys().data());
+		SetKeyFrameEncoding(static_cast<KeyFrameEncoding>(keyFrameEncoding));
+
+		// Quantized keys are loaded as they are stored without decoding.
+		if (KeyFrameEncoding::Quantized == GetKeyFrameEncoding())
+		{
+			ImportQuantizedKeys(inputArchive, GetQuantizedTranslationKeys(), translationKeyCount, true);
+			ImportQuantizedKeys(inputArchive, GetQuantizedRotationKeys(), rotationKeyCount, false);
+			ImportQuantizedKeys(inputArchive, GetQuantizedScaleKeys(), scaleKeyCount, true);
+		}
+		else
+		{
+			SetTranslationKeyCount(translationKeyCount);
+			SetRotationKeyCount(rotationKeyCount);
+			SetScaleKeyCount(scaleKeyCount);
+			inputArchive.ImportBuffer(GetTranslationKeys().data());
+			inputArchive.ImportBuffer(GetRotationKeys().data());
+			inputArchive.ImportBuffer(GetScaleKeys().data());
+		}
 
 		return *this;
 	}
@@ -55,15 +70,56 @@ public:
 	template<bool SwapBytesOrder>
 	const TrackImpl& operator>>(TOutputArchive<SwapBytesOrder>& outputArchive) const
 	{
-		outputArchive << GetID().Data() << GetName()
-			<< GetTranslationKeyCount() << GetRotationKeyCount() << GetScaleKeyCount();
-
-		outputArchive.ExportBuffer(GetTranslationKeys().data(), GetTranslationKeys().size());
-		outputArchive.ExportBuffer(GetRotationKeys().data(), GetRotationKeys().size());
-		outputArchive.ExportBuffer(GetScaleKeys().data(), GetScaleKeys().size());
+		outputArchive << GetID().Data() << GetName() << static_cast<uint8_t>(GetKeyFrameEncoding());
+
+		if (KeyFrameEncoding::Quantized == GetKeyFrameEncoding())
+		{
+			outputArchive << static_cast<uint32_t>(GetQuantizedTranslationKeys().times.size())
+				<< static_cast<uint32_t>(GetQuantizedRotationKeys().times.size())
+				<< static_cast<uint32_t>(GetQuantizedScaleKeys().times.size());
+			ExportQuantizedKeys(outputArchive, GetQuantizedTranslationKeys(), true);
+			ExportQuantizedKeys(outputArchive, GetQuantizedRotationKeys(), false);
+			ExportQuantizedKeys(outputArchive, GetQuantizedScaleKeys(), true);
+		}
+		else
+		{
+			outputArchive << GetTranslationKeyCount() << GetRotationKeyCount() << GetScaleKeyCount();
+			outputArchive.ExportBuffer(GetTranslationKeys().data(), GetTranslationKeys().size());
+			outputArchive.ExportBuffer(GetRotationKeys().data(), GetRotationKeys().size());
+			outputArchive.ExportBuffer(GetScaleKeys().data(), GetScaleKeys().size());
+		}
 
 		return *this;
 	}
+
+private:
+	// Quantized keys are stored as value range for translations and scales, then key times, then 3 uint16 per key value.
+	template<bool SwapBytesOrder>
+	static void ImportQuantizedKeys(TInputArchive<SwapBytesOrder>& inputArchive, QuantizedKeyFrames& keyFrames, uint32_t keyCount, bool hasRange)
+	{
+		if (hasRange)
+		{
+			inputArchive >> keyFrames.minValue >> keyFrames.extent;
+		}
+
+		keyFrames.times.resize(keyCount);
+		keyFrames.values.resize(static_cast<std::size_t>(keyCount) * 3U);
+		inputArchive.ImportBuffer(keyFrames.times.data());
+		inputArchive.ImportBuffer(keyFrames.values.data());
+	}
+
+	template<bool SwapBytesOrder>
+	static void ExportQuantizedKeys(TOutputArchive<SwapBytesOrder>& outputArchive, const QuantizedKeyFrames& keyFrames, bool hasRange)
+	{
+		assert(keyFrames.values.size() == keyFrames.times.size() * 3U);
+		if (hasRange)
+		{
+			outputArchive << keyFrames.minValue << keyFrames.extent;
+		}
+
+		outputArchive.ExportBuffer(keyFrames.times.data(), keyFrames.times.size());
+		outputArchive.ExportBuffer(keyFrames.values.data(), keyFrames.values.size());
+	}
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "Scene/VertexBufferWriter.h"
+#include "VertexBufferWriterImpl.h"
+
+#include "Base/Template.h"
+#include "Scene/Mesh.h"
+
+namespace cd
+{
+
+VertexBufferWriter::VertexBufferWriter(const VertexFormat& vertexFormat)
+{
+	m_pVertexBufferWriterImpl = new VertexBufferWriterImpl(vertexFormat);
+}
+
+VertexBufferWriter::VertexBufferWriter(VertexBufferWriter&& rhs)
+{
+	*this = cd::MoveTemp(rhs);
+}
+
+VertexBufferWriter& VertexBufferWriter::operator=(VertexBufferWriter&& rhs)
+{
+	std::swap(m_pVertexBufferWriterImpl, rhs.m_pVertexBufferWriterImpl);
+	return *this;
+}
+
+VertexBufferWriter::~VertexBufferWriter()
+{
+	if (m_pVertexBufferWriterImpl)
+	{
+		delete m_pVertexBufferWriterImpl;
+		m_pVertexBufferWriterImpl = nullptr;
+	}
+}
+
+uint32_t VertexBufferWriter::GetStride() const
+{
+	return m_pVertexBufferWriterImpl->GetStride();
+}
+
+uint32_t VertexBufferWriter::GetVertexCount(const Mesh& mesh)
+{
+	return mesh.GetVertexInstanceToIDCount() > 0U ? mesh.GetVertexInstanceToIDCount() : mesh.GetVertexCount();
+}
+
+bool VertexBufferWriter::Write(const Mesh& mesh, std::byte* pOutput, const VertexSkinStreams* pSkinStreams, uint32_t maxThreadCount) const
+{
+	return m_pVertexBufferWriterImpl->Write(mesh, pOutput, pSkinStreams, maxThreadCount);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,300 @@
+#include "VertexBufferWriterImpl.h"
+
+#include "Scene/Mesh.h"
+#include "Utilities/ParallelFor.h"
+
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+
+using namespace cd;
+
+// Vertices converted together. Output of a chunk stays in cache until all attributes are written.
+constexpr uint32_t ChunkVertexCount = 256U;
+// Vertices written by one parallel work item. Multiple of ChunkVertexCount.
+constexpr uint32_t BlockVertexCount = 64U * ChunkVertexCount;
+constexpr uint32_t MaxComponentCount = MaxBoneInfluenceCount;
+constexpr uint32_t MaxElementSize = MaxComponentCount * sizeof(float);
+
+template<uint32_t ElementSize>
+void ScatterElements(const std::byte* pSource, uint32_t elementCount, std::byte* pOutput, uint32_t outputStride)
+{
+	for (uint32_t elementIndex = 0U; elementIndex < elementCount; ++elementIndex)
+	{
+		std::memcpy(pOutput, pSource, ElementSize);
+		pSource += ElementSize;
+		pOutput += outputStride;
+	}
+}
+
+template<uint32_t... ElementSizes>
+constexpr auto MakeScatterFunctions(std::integer_sequence<uint32_t, ElementSizes...>)
+{
+	return std::array<VertexBufferWriterImpl::ScatterFunction, sizeof...(ElementSizes)>{ &ScatterElements<ElementSizes>... };
+}
+
+constexpr auto ScatterFunctions = MakeScatterFunctions(std::make_integer_sequence<uint32_t, MaxElementSize + 1U>());
+
+// See AttributeValueType about how float data is encoded.
+QuantizedValueFormat GetQuantizedValueFormat(const VertexAttributeLayout& vertexLayout)
+{
+	if (VertexAttributeType::BoneIndex == vertexLayout.vertexAttributeType)
+	{
+		switch (vertexLayout.attributeValueType)
+		{
+		case AttributeValueType::Uint8:
+			return QuantizedValueFormat::Uint8;
+		case AttributeValueType::Int16:
+			return QuantizedValueFormat::Uint16;
+		case AttributeValueType::Half:
+			return QuantizedValueFormat::Half;
+		default:
+			return QuantizedValueFormat::Float;
+		}
+	}
+
+	switch (vertexLayout.attributeValueType)
+	{
+	case AttributeValueType::Uint8:
+		return IsDirectionVertexAttribute(vertexLayout.vertexAttributeType) ? QuantizedValueFormat::BiasedUnorm8 : QuantizedValueFormat::Unorm8;
+	case AttributeValueType::Int16:
+		return IsDirectionVertexAttribute(vertexLayout.vertexAttributeType) ? QuantizedValueFormat::Snorm16 : QuantizedValueFormat::Unorm16;
+	case AttributeValueType::Half:
+		return QuantizedValueFormat::Half;
+	default:
+		return QuantizedValueFormat::Float;
+	}
+}
+
+// Float data of one copy operation resolved from mesh or skin streams.
+struct AttributeSource
+{
+	const float* pValues = nullptr;
+	const Direction* pDirections = nullptr;
+	uint32_t componentCount = 0U;
+	bool indexedByVertexID = false;
+};
+
+// Temporary buffers of one chunk.
+struct ChunkBuffers
+{
+	alignas(16) float gatheredValues[ChunkVertexCount * MaxComponentCount];
+	alignas(16) float paddedValues[ChunkVertexCount * MaxComponentCount];
+	alignas(16) std::byte quantizedValues[ChunkVertexCount * MaxElementSize];
+	Vec2f octahedralValues[ChunkVertexCount];
+};
+
+template<typename T>
+const float* GetFloatData(const std::vector<T>& elements)
+{
+	return elements.empty() ? nullptr : elements.front().begin();
+}
+
+}
+
+namespace cd
+{
+
+VertexBufferWriterImpl::VertexBufferWriterImpl(const VertexFormat& vertexFormat)
+{
+	m_operations.reserve(vertexFormat.GetVertexAttributeLayouts().size());
+	for (const auto& vertexLayout : vertexFormat.GetVertexAttributeLayouts())
+	{
+		CopyOperation& operation = m_operations.emplace_back();
+		operation.attributeType = vertexLayout.vertexAttributeType;
+		operation.valueFormat = GetQuantizedValueFormat(vertexLayout);
+		operation.componentCount = vertexLayout.attributeCount;
+		operation.offset = m_stride;
+		operation.isOctahedral = IsDirectionVertexAttribute(vertexLayout.vertexAttributeType) && 2U == vertexLayout.attributeCount;
+
+		const uint32_t elementSize = VertexQuantizer::GetValueSize(operation.valueFormat) * operation.componentCount;
+		assert(operation.componentCount <= MaxComponentCount);
+		operation.pScatter = operation.componentCount <= MaxComponentCount ? ScatterFunctions[elementSize] : nullptr;
+		m_stride += elementSize;
+	}
+
+	assert(m_stride == vertexFormat.GetStride());
+}
+
+bool VertexBufferWriterImpl::Write(const Mesh& mesh, std::byte* pOutput, const VertexSkinStreams* pSkinStreams, uint32_t maxThreadCount) const
+{
+	const std::vector<VertexID>& vertexIDs = mesh.GetVertexInstanceToIDs();
+	const bool mappingSurfaceAttributes = !vertexIDs.empty();
+	const uint32_t vertexCount = VertexBufferWriter::GetVertexCount(mesh);
+
+	// Resolve and validate all sources before writing.
+	std::vector<AttributeSource> sources(m_operations.size());
+	for (std::size_t operationIndex = 0U; operationIndex < m_operations.size(); ++operationIndex)
+	{
+		const CopyOperation& operation = m_operations[operationIndex];
+		if (!operation.pScatter)
+		{
+			return false;
+		}
+
+		AttributeSource& source = sources[operationIndex];
+		std::size_t sourceCount = 0U;
+		std::size_t requiredCount = vertexCount;
+		switch (operation.attributeType)
+		{
+		case VertexAttributeType::Position:
+		{
+			source.pValues = GetFloatData(mesh.GetVertexPositions());
+			source.componentCount = Point::Size;
+			source.indexedByVertexID = true;
+			sourceCount = mesh.GetVertexPositionCount();
+			requiredCount = mappingSurfaceAttributes ? mesh.GetVertexCount() : vertexCount;
+			break;
+		}
+		case VertexAttributeType::Normal:
+		case VertexAttributeType::Tangent:
+		case VertexAttributeType::Bitangent:
+		{
+			const std::vector<Direction>& directions = VertexAttributeType::Normal == operation.attributeType ? mesh.GetVertexNormals() :
+				(VertexAttributeType::Tangent == operation.attributeType ? mesh.GetVertexTangents() : mesh.GetVertexBiTangents());
+			source.pValues = GetFloatData(directions);
+			source.pDirections = directions.data();
+			source.componentCount = Direction::Size;
+			sourceCount = directions.size();
+			break;
+		}
+		case VertexAttributeType::UV:
+		{
+			if (mesh.GetVertexUVSetCount() > 0U)
+			{
+				source.pValues = GetFloatData(mesh.GetVertexUV(0));
+				source.componentCount = UV::Size;
+				sourceCount = mesh.GetVertexUV(0).size();
+			}
+			break;
+		}
+		case VertexAttributeType::Color:
+		{
+			if (mesh.GetVertexColorSetCount() > 0U)
+			{
+				source.pValues = GetFloatData(mesh.GetVertexColor(0));
+				source.componentCount = Color::Size;
+				sourceCount = mesh.GetVertexColor(0).size();
+			}
+			break;
+		}
+		case VertexAttributeType::BoneIndex:
+		case VertexAttributeType::BoneWeight:
+		{
+			if (pSkinStreams && pSkinStreams->influenceCount > 0U && pSkinStreams->influenceCount <= MaxComponentCount)
+			{
+				std::span<const float> values = VertexAttributeType::BoneIndex == operation.attributeType ? pSkinStreams->boneIndices : pSkinStreams->boneWeights;
+				source.pValues = values.data();
+				source.componentCount = pSkinStreams->influenceCount;
+				source.indexedByVertexID = true;
+				sourceCount = values.size() / pSkinStreams->influenceCount;
+				requiredCount = mappingSurfaceAttributes ? mesh.GetVertexCount() : vertexCount;
+			}
+			break;
+		}
+		default:
+			break;
+		}
+
+		if (sourceCount < requiredCount || (requiredCount > 0U && !source.pValues))
+		{
+			return false;
+		}
+	}
+
+	const uint32_t stride = m_stride;
+	const uint32_t blockCount = (vertexCount + BlockVertexCount - 1U) / BlockVertexCount;
+
+	// Streams of one float attribute which is stored by vertex instance are the same bytes as mesh data.
+	if (1U == m_operations.size())
+	{
+		const CopyOperation& operation = m_operations.front();
+		const AttributeSource& source = sources.front();
+		if (QuantizedValueFormat::Float == operation.valueFormat && !operation.isOctahedral && source.componentCount == operation.componentCount &&
+			!(source.indexedByVertexID && mappingSurfaceAttributes))
+		{
+			ParallelFor(blockCount, [&source, vertexCount, stride, pOutput](uint32_t blockIndex)
+			{
+				const std::size_t blockBegin = static_cast<std::size_t>(blockIndex) * BlockVertexCount;
+				const std::size_t blockVertexCount = std::min<std::size_t>(BlockVertexCount, vertexCount - blockBegin);
+				std::memcpy(pOutput + blockBegin * stride, source.pValues + blockBegin * source.componentCount, blockVertexCount * stride);
+			}, maxThreadCount);
+			return true;
+		}
+	}
+
+	auto WriteBlock = [this, &sources, &vertexIDs, mappingSurfaceAttributes, vertexCount, stride, pOutput](uint32_t blockIndex)
+	{
+		ChunkBuffers buffers;
+		const uint32_t blockBegin = blockIndex * BlockVertexCount;
+		const uint32_t blockEnd = std::min(blockBegin + BlockVertexCount, vertexCount);
+		for (uint32_t chunkBegin = blockBegin; chunkBegin < blockEnd; chunkBegin += ChunkVertexCount)
+		{
+			const uint32_t chunkVertexCount = std::min(ChunkVertexCount, blockEnd - chunkBegin);
+			std::byte* pChunkOutput = pOutput + static_cast<std::size_t>(chunkBegin) * stride;
+			for (std::size_t operationIndex = 0U; operationIndex < m_operations.size(); ++operationIndex)
+			{
+				const CopyOperation& operation = m_operations[operationIndex];
+				const AttributeSource& source = sources[operationIndex];
+
+				const float* pValues = nullptr;
+				uint32_t componentCount = source.componentCount;
+				if (operation.isOctahedral)
+				{
+					VertexQuantizer::EncodeOctahedral(std::span<const Direction>(source.pDirections + chunkBegin, chunkVertexCount),
+						std::span<Vec2f>(buffers.octahedralValues, chunkVertexCount));
+					pValues = buffers.octahedralValues[0].begin();
+					componentCount = Vec2f::Size;
+				}
+				else if (source.indexedByVertexID && mappingSurfaceAttributes)
+				{
+					float* pGathered = buffers.gatheredValues;
+					for (uint32_t vertexIndex = 0U; vertexIndex < chunkVertexCount; ++vertexIndex)
+					{
+						const uint32_t vertexID = vertexIDs[chunkBegin + vertexIndex].Data();
+						std::memcpy(pGathered, source.pValues + static_cast<std::size_t>(vertexID) * componentCount, componentCount * sizeof(float));
+						pGathered += componentCount;
+					}
+					pValues = buffers.gatheredValues;
+				}
+				else
+				{
+					pValues = source.pValues + static_cast<std::size_t>(chunkBegin) * componentCount;
+				}
+
+				// Missing components are zero. Extra components are dropped.
+				if (componentCount != operation.componentCount)
+				{
+					float* pPadded = buffers.paddedValues;
+					for (uint32_t vertexIndex = 0U; vertexIndex < chunkVertexCount; ++vertexIndex)
+					{
+						for (uint32_t componentIndex = 0U; componentIndex < operation.componentCount; ++componentIndex)
+						{
+							*pPadded++ = componentIndex < componentCount ? pValues[vertexIndex * componentCount + componentIndex] : 0.0f;
+						}
+					}
+					pValues = buffers.paddedValues;
+				}
+
+				const std::byte* pPackedValues = reinterpret_cast<const std::byte*>(pValues);
+				if (QuantizedValueFormat::Float != operation.valueFormat)
+				{
+					VertexQuantizer::Quantize(operation.valueFormat, std::span<const float>(pValues, chunkVertexCount * operation.componentCount), buffers.quantizedValues);
+					pPackedValues = buffers.quantizedValues;
+				}
+
+				operation.pScatter(pPackedValues, chunkVertexCount, pChunkOutput + operation.offset, stride);
+			}
+		}
+	};
+
+	ParallelFor(blockCount, WriteBlock, maxThreadCount);
+
+	return true;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Math/VertexQuantizer.h"
+#include "Scene/VertexBufferWriter.h"
+#include "Scene/VertexFormat.h"
+
+#include <vector>
+
+namespace cd
+{
+
+class VertexBufferWriterImpl final
+{
+public:
+	// Copies elementCount elements of a packed array to a strided buffer.
+	using ScatterFunction = void(*)(const std::byte* pSource, uint32_t elementCount, std::byte* pOutput, uint32_t outputStride);
+
+	struct CopyOperation
+	{
+		VertexAttributeType attributeType;
+		QuantizedValueFormat valueFormat;
+		uint32_t componentCount;
+		uint32_t offset;
+		bool isOctahedral;
+		ScatterFunction pScatter;
+	};
+
+public:
+	VertexBufferWriterImpl() = delete;
+	explicit VertexBufferWriterImpl(const VertexFormat& vertexFormat);
+	VertexBufferWriterImpl(const VertexBufferWriterImpl&) = default;
+	VertexBufferWriterImpl& operator=(const VertexBufferWriterImpl&) = default;
+	VertexBufferWriterImpl(VertexBufferWriterImpl&&) = default;
+	VertexBufferWriterImpl& operator=(VertexBufferWriterImpl&&) = default;
+	~VertexBufferWriterImpl() = default;
+
+	uint32_t GetStride() const { return m_stride; }
+	bool Write(const Mesh& mesh, std::byte* pOutput, const VertexSkinStreams* pSkinStreams, uint32_t maxThreadCount) const;
+
+private:
+	std::vector<CopyOperation> m_operations;
+	uint32_t m_stride = 0U;
+};
+
+}
\ No newline at end of file
@@ -76,6 +76,31 @@ uint32_t VertexFormat::GetStride() const
 	return m_pVertexFormatImpl->GetStride();
 }
 
+void VertexFormat::SetVertexAttributeStream(VertexAttributeType attributeType, uint8_t streamIndex)
+{
+	m_pVertexFormatImpl->SetVertexAttributeStream(attributeType, streamIndex);
+}
+
+uint32_t VertexFormat::GetStreamCount() const
+{
+	return m_pVertexFormatImpl->GetStreamCount();
+}
+
+VertexFormat VertexFormat::GetStreamVertexFormat(uint32_t streamIndex) const
+{
+	VertexFormat streamVertexFormat;
+	for (VertexAttributeLayout vertexLayout : GetVertexAttributeLayouts())
+	{
+		if (streamIndex == vertexLayout.streamIndex)
+		{
+			vertexLayout.streamIndex = 0U;
+			streamVertexFormat.AddVertexAttributeLayout(cd::MoveTemp(vertexLayout));
+		}
+	}
+
+	return streamVertexFormat;
+}
+
 VertexFormat& VertexFormat::operator<<(InputArchive& inputArchive)
 {
 	*m_pVertexFormatImpl << inputArchive;
@@ -1,5 +1,7 @@
 #include "VertexFormatImpl.h"
 
+#include <algorithm>
+
 namespace cd
 {
 
@@ -72,7 +74,7 @@ uint32_t VertexFormatImpl::GetStride() const
 		{
 			valueTypeSize = sizeof(uint8_t);
 		}
-		else if (AttributeValueType::Int16 == vertexLayout.attributeValueType)
+		else if (AttributeValueType::Int16 == vertexLayout.attributeValueType || AttributeValueType::Half == vertexLayout.attributeValueType)
 		{
 			valueTypeSize = sizeof(int16_t);
 		}
@@ -91,4 +93,26 @@ uint32_t VertexFormatImpl::GetStride() const
 	return stride;
 }
 
+void VertexFormatImpl::SetVertexAttributeStream(VertexAttributeType attributeType, uint8_t streamIndex)
+{
+	for (auto& vertexLayout : m_vertexLayouts)
+	{
+		if (attributeType == vertexLayout.vertexAttributeType)
+		{
+			vertexLayout.streamIndex = streamIndex;
+		}
+	}
+}
+
+uint32_t VertexFormatImpl::GetStreamCount() const
+{
+	uint32_t streamCount = 0U;
+	for (const auto& vertexLayout : m_vertexLayouts)
+	{
+		streamCount = std::max(streamCount, vertexLayout.streamIndex + 1U);
+	}
+
+	return streamCount;
+}
+
 }
\ No newline at end of file
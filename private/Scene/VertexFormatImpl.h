@@ -31,6 +31,9 @@ public:
 
 	uint32_t GetStride() const;
 
+	void SetVertexAttributeStream(VertexAttributeType attributeType, uint8_t streamIndex);
+	uint32_t GetStreamCount() const;
+
 	template<bool SwapBytesOrder>
 	VertexFormatImpl& operator<<(TInputArchive<SwapBytesOrder>& inputArchive)
 	{
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Base/Export.h"
+#include "IO/InputArchive.hpp"
+#include "IO/OutputArchive.hpp"
+#include "Math/Box.hpp"
+#include "Math/Ray.hpp"
+
+#include <span>
+#include <vector>
+
+namespace cd
+{
+
+class BVHImpl;
+class Mesh;
+class SceneDatabase;
+
+enum class BVHPrimitiveType : uint8_t
+{
+	Triangle,
+	AABB,
+};
+
+// Flattened node. Children of an inner node are stored next to each other at childIndex and childIndex + 1.
+// A leaf references primitiveCount primitives starting from childIndex in the sorted primitive list.
+struct BVHNode
+{
+	AABB aabb;
+	uint32_t childIndex;
+	uint32_t primitiveCount;
+
+	bool IsLeaf() const { return primitiveCount > 0U; }
+};
+static_assert(32 == sizeof(BVHNode));
+
+struct BVHRayHit
+{
+	// Original primitive index which is passed in to build the BVH.
+	uint32_t primitiveIndex;
+	float distance;
+
+	// Barycentric coordinates of the hit point on triangle (v0 * (1 - u - v) + v1 * u + v2 * v).
+	float u;
+	float v;
+};
+
+/*
+ * Bounding volume hierarchy built by binned SAH. Large subtrees are built in parallel and the result
+ * doesn't depend on thread count.
+ * Triangle BVH stores its own copy of triangle vertices in leaf order so it can be queried and serialized
+ * without the source mesh. AABB BVH stores primitive boxes in the same way.
+ */
+class CORE_API BVH
+{
+public:
+	static constexpr uint32_t DefaultMaxLeafPrimitiveCount = 4U;
+
+	// Polygons are triangulated as fans. Primitive index is the triangle index counted through all polygon groups.
+	static BVH FromMesh(const cd::Mesh& mesh, uint32_t maxLeafPrimitiveCount = DefaultMaxLeafPrimitiveCount);
+	static BVH FromTriangles(std::span<const cd::Vec3f> vertices, std::span<const uint32_t> indices, uint32_t maxLeafPrimitiveCount = DefaultMaxLeafPrimitiveCount);
+	static BVH FromAABBs(std::span<const cd::AABB> aabbs, uint32_t maxLeafPrimitiveCount = DefaultMaxLeafPrimitiveCount);
+
+	// Primitive index is MeshID. Mesh AABBs are transformed to world space by nodes which reference them.
+	static BVH FromSceneDatabase(const cd::SceneDatabase& sceneDatabase, uint32_t maxLeafPrimitiveCount = DefaultMaxLeafPrimitiveCount);
+
+public:
+	explicit BVH();
+	BVH(const BVH&) = delete;
+	BVH& operator=(const BVH&) = delete;
+	BVH(BVH&&);
+	BVH& operator=(BVH&&);
+	~BVH();
+
+	BVHPrimitiveType GetPrimitiveType() const;
+	uint32_t GetPrimitiveCount() const;
+	const std::vector<BVHNode>& GetNodes() const;
+	const std::vector<uint32_t>& GetPrimitiveIndices() const;
+	cd::AABB GetAABB() const;
+
+	// Closest hit in [0, maxDistance]. Ray direction doesn't need to be normalized and distance is in its unit.
+	bool Intersect(const cd::Ray& ray, float maxDistance, BVHRayHit& hit) const;
+	// Any hit in [0, maxDistance] which is enough for occlusion.
+	bool IntersectAny(const cd::Ray& ray, float maxDistance) const;
+	// Appends indices of primitives whose AABBs overlap with the box.
+	void QueryAABB(const cd::AABB& aabb, std::vector<uint32_t>& outPrimitiveIndices) const;
+
+	// Serialization
+	BVH& operator<<(InputArchive& inputArchive);
+	BVH& operator<<(InputArchiveSwapBytes& inputArchive);
+	const BVH& operator>>(OutputArchive& outputArchive) const;
+	const BVH& operator>>(OutputArchiveSwapBytes& outputArchive) const;
+
+private:
+	BVHImpl* m_pBVHImpl = nullptr;
+};
+
+}
\ No newline at end of file
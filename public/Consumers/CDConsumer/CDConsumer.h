@@ -28,6 +28,10 @@ public:
 	cd::EndianType GetTargetEndian() const;
 	void SetTargetEndian(cd::EndianType endian);
 
+	// Bone index of unused influence slots in exported vertex streams. Default is cd::DefaultInvalidVertexBoneIndex.
+	uint32_t GetInvalidVertexBoneIndex() const;
+	void SetInvalidVertexBoneIndex(uint32_t boneIndex);
+
 	void EnableOption(CDConsumerOptions option);
 	void DisableOption(CDConsumerOptions option);
 	bool IsOptionEnabled(CDConsumerOptions option) const;
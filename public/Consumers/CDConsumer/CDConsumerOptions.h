@@ -5,6 +5,13 @@ namespace cdtools
 
 enum class CDConsumerOptions
 {
+	// Export vertex buffers of every mesh stream to <MeshName>_stream<Index>.cdvb files next to the output file.
+	// Streams are configured in mesh vertex format so that runtime reads every stream directly to a GPU buffer.
+	ExportVertexStreams,
+
+	// Vertex bone indices of exported vertex streams index Skin influence bone names instead of skeleton bones.
+	// Skins split by ProcessorOptions::PartitionSkins then only need their own palettes in shader constants.
+	ExportPaletteBoneIndices,
 };
 
 }
\ No newline at end of file
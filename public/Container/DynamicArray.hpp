@@ -3,12 +3,16 @@
 #include "Base/Template.h"
 
 #include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <optional>
 
 namespace cd
 {
 
-// TODO : consider T is not built-in types.
+// DynamicArray stores first N elements in an inline buffer and only allocates heap memory when it grows bigger.
+// Storage is uninitialized until elements are added so growing doesn't default construct the whole capacity.
 template<typename T, std::size_t N = 16>
 class DynamicArray
 {
@@ -21,53 +25,80 @@ public:
 
 	DynamicArray& operator=(const DynamicArray& rhs)
 	{
-		Clear();
-		for (std::size_t i = 0; i < rhs.m_size; ++i)
+		if (this == &rhs)
 		{
-			Add(rhs.Get(i));
+			return *this;
 		}
 
+		Clear();
+		Reserve(rhs.m_size);
+		std::uninitialized_copy(rhs.begin(), rhs.end(), m_pData);
+		m_size = rhs.m_size;
 		return *this;
 	}
 
-	DynamicArray(DynamicArray&& rhs)
+	DynamicArray(DynamicArray&& rhs) noexcept
 	{
-		*this = rhs;
+		*this = MoveTemp(rhs);
 	}
 
-	DynamicArray& operator=(DynamicArray&& rhs)
+	DynamicArray& operator=(DynamicArray&& rhs) noexcept
 	{
-		// TODO : optimize
+		if (this == &rhs)
+		{
+			return *this;
+		}
+
 		Clear();
-		for (std::size_t i = 0; i < rhs.m_size; ++i)
+		if (rhs.IsInline())
 		{
-			Add(rhs.Get(i));
+			// Inline elements can't be stolen so move them one by one. It is at most N elements.
+			Reserve(rhs.m_size);
+			std::uninitialized_move(rhs.begin(), rhs.end(), m_pData);
+			m_size = rhs.m_size;
+			rhs.Clear();
 		}
+		else
+		{
+			// Steal heap memory.
+			FreeHeapData();
+			m_pData = rhs.m_pData;
+			m_size = rhs.m_size;
+			m_capacity = rhs.m_capacity;
+
+			rhs.m_pData = rhs.GetInlineData();
+			rhs.m_size = 0U;
+			rhs.m_capacity = N;
+		}
+
 		return *this;
 	}
 
 	~DynamicArray()
 	{
-		if (m_pData != m_stackData)
-		{
-			delete[] m_pData;
-			m_pData = nullptr;
-		}
+		Clear();
+		FreeHeapData();
 	}
 
 	CD_FORCEINLINE T Get(std::size_t index) const { return m_pData[index]; }
 	CD_FORCEINLINE T operator[](std::size_t index) const { return m_pData[index]; }
 	CD_FORCEINLINE T& operator[](std::size_t index) { return m_pData[index]; }
 	CD_FORCEINLINE std::size_t Size() const { return m_size; }
+	CD_FORCEINLINE std::size_t Capacity() const { return m_capacity; }
 	CD_FORCEINLINE bool Empty() const { return m_size == 0; }
-	CD_FORCEINLINE void Clear() { m_size = 0; }
 
-	CD_FORCEINLINE T* begin() { return &m_pData[0]; }
-	CD_FORCEINLINE T* end() { return &m_pData[m_size]; }
-	CD_FORCEINLINE const T* begin() const { return &m_pData[0]; }
-	CD_FORCEINLINE const T* end() const { return &m_pData[m_size]; }
+	CD_FORCEINLINE T* begin() { return m_pData; }
+	CD_FORCEINLINE T* end() { return m_pData + m_size; }
+	CD_FORCEINLINE const T* begin() const { return m_pData; }
+	CD_FORCEINLINE const T* end() const { return m_pData + m_size; }
+
+	void Clear()
+	{
+		std::destroy_n(m_pData, m_size);
+		m_size = 0U;
+	}
 
-	bool Contains(T value) const
+	bool Contains(const T& value) const
 	{
 		for (std::size_t i = 0; i < m_size; ++i)
 		{
@@ -80,7 +111,7 @@ public:
 		return false;
 	}
 
-	std::optional<std::size_t> GetIndex(T value) const
+	std::optional<std::size_t> GetIndex(const T& value) const
 	{
 		for (std::size_t i = 0; i < m_size; ++i)
 		{
@@ -95,33 +126,44 @@ public:
 
 	void Add(T data)
 	{
-		if (m_size >= m_capcity)
+		if (m_size >= m_capacity)
 		{
-			T* pOld = m_pData;
-			m_capcity *= 2;
-			m_pData = new T[m_capcity];
+			Reallocate(m_capacity * 2);
+		}
 
-			for (std::size_t i = 0; i < m_size; ++i)
-			{
-				m_pData[i] = pOld[i];
-			}
+		std::construct_at(m_pData + m_size, MoveTemp(data));
+		++m_size;
+	}
 
-			if (pOld != m_stackData)
-			{
-				delete[] pOld;
-			}
+	void Reserve(std::size_t capacity)
+	{
+		if (capacity > m_capacity)
+		{
+			Reallocate(capacity);
 		}
+	}
 
-		m_pData[m_size++] = data;
+	// Release unused heap memory. Elements go back to the inline buffer if they fit.
+	void ShrinkToFit()
+	{
+		if (!IsInline() && m_size < m_capacity)
+		{
+			Reallocate(m_size);
+		}
 	}
 
 	void RemoveByIndex(std::size_t index)
 	{
 		assert(index < m_size);
-		m_pData[index] = m_pData[--m_size];
+		--m_size;
+		if (index != m_size)
+		{
+			m_pData[index] = MoveTemp(m_pData[m_size]);
+		}
+		std::destroy_at(m_pData + m_size);
 	}
 
-	void RemoveByValue(T value)
+	void RemoveByValue(const T& value)
 	{
 		for (std::size_t i = 0; i < m_size; ++i)
 		{
@@ -133,11 +175,56 @@ public:
 		}
 	}
 
+private:
+	CD_FORCEINLINE T* GetInlineData() { return reinterpret_cast<T*>(m_stackData); }
+	CD_FORCEINLINE bool IsInline() const { return m_pData == reinterpret_cast<const T*>(m_stackData); }
+
+	void Reallocate(std::size_t capacity)
+	{
+		assert(capacity >= m_size);
+		T* pOld = m_pData;
+		bool isOldInline = IsInline();
+
+		if (capacity <= N)
+		{
+			if (isOldInline)
+			{
+				return;
+			}
+
+			m_pData = GetInlineData();
+			m_capacity = N;
+		}
+		else
+		{
+			m_pData = static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t{ alignof(T) }));
+			m_capacity = capacity;
+		}
+
+		std::uninitialized_move(pOld, pOld + m_size, m_pData);
+		std::destroy_n(pOld, m_size);
+
+		if (!isOldInline)
+		{
+			::operator delete(pOld, std::align_val_t{ alignof(T) });
+		}
+	}
+
+	void FreeHeapData()
+	{
+		if (!IsInline())
+		{
+			::operator delete(m_pData, std::align_val_t{ alignof(T) });
+			m_pData = GetInlineData();
+			m_capacity = N;
+		}
+	}
+
 private:
 	std::size_t m_size = 0U;
-	std::size_t m_capcity = N;
-	T m_stackData[N];
-	T* m_pData = m_stackData;
+	std::size_t m_capacity = N;
+	alignas(T) std::byte m_stackData[N * sizeof(T)];
+	T* m_pData = GetInlineData();
 };
 
 }
\ No newline at end of file
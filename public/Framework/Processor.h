@@ -2,6 +2,9 @@
 
 #include "Base/Export.h"
 #include "Framework/ProcessorOptions.h"
+#include "Scene/TextureCompressor.h"
+#include "Scene/TextureMipGenerator.h"
+#include "Scene/VertexAttribute.h"
 
 #include <memory>
 
@@ -34,6 +37,35 @@ public:
 	void AddExtraTextureSearchFolder(const char* pFolderPath);
 	bool IsSearchMissingTexturesEnabled() const;
 
+	// LOD targets used by ProcessorOptions::GenerateLODs.
+	// A percent target keeps the ratio of source faces. A screen size target is the ratio of the mesh's projected
+	// height to the screen height when it should be used. Its face budget scales with projected area.
+	void AddLodPercentTarget(float percent);
+	void AddLodScreenSizeTarget(float screenSize);
+
+	// Skin settings used by ProcessorOptions::LimitBoneInfluences and ProcessorOptions::PartitionSkins.
+	// Weights are quantized after limiting when the value type is Uint8 or Int16. Skinned meshes whose skins
+	// reference more bones than the palette size are split to sub meshes.
+	void SetMaxBoneInfluenceCount(uint32_t count);
+	void SetBoneWeightValueType(cd::AttributeValueType valueType);
+	void SetMaxSkinPaletteBoneCount(uint32_t count);
+
+	// Error tolerances used by ProcessorOptions::CompressAnimations to remove keys which interpolation can reproduce.
+	// Translation tolerance is a distance in scene unit. Scale tolerance is per component.
+	// Quantized keys are checked against the same tolerances and tracks which exceed them keep float keys.
+	void SetAnimationKeyTolerances(float translationTolerance, float rotationToleranceDegree, float scaleTolerance);
+
+	// Morph vertices whose offset components from source mesh positions are all within the threshold are removed
+	// by ProcessorOptions::CompressMorphs. Threshold is a distance in scene unit.
+	void SetMorphDeltaThreshold(float threshold);
+
+	// Filter of mip chains which ProcessorOptions::DecodeTextures generates for textures using mipmap.
+	void SetTextureMipFilter(cd::TextureMipFilter filter);
+
+	// Quality of block compression which ProcessorOptions::CompressTextures applies to decoded textures.
+	// High quality also picks BC7 instead of BC1 and BC3 for color textures.
+	void SetTextureCompressionQuality(cd::TextureCompressionQuality quality);
+
 	void SetAxisSystem(cd::AxisSystem axisSystem);
 	const cd::SceneDatabase* GetSceneDatabase() const;
 	void Run();
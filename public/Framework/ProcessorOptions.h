@@ -11,6 +11,13 @@ enum class ProcessorOptions
 	FlattenHierarchy,
 	EmbedTextureFiles,
 	ConvertAxisSystem,
+	GenerateLODs,
+	LimitBoneInfluences,
+	PartitionSkins,
+	CompressAnimations,
+	CompressMorphs,
+	DecodeTextures,
+	CompressTextures,
 };
 
 }
\ No newline at end of file
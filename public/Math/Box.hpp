@@ -74,10 +74,20 @@ public:
 		}
 	}
 
-	TBox Transform(const cd::Matrix4x4& transform)
+	TBox Transform(const cd::Matrix4x4& transform) const
 	{
 		static_assert(3 == N);
 
+#ifdef CD_SIMD
+		if constexpr (std::is_same_v<T, float>)
+		{
+			static_assert(sizeof(TBox) == 6 * sizeof(float));
+			TBox result;
+			SIMD::AABBTransform(transform.begin(), m_min.begin(), result.m_min.begin());
+			return result;
+		}
+#endif
+
 		TBox result(*this);
 
 		TVector<T, 4> transformedCenter = transform * cd::TVector<T, 4>(result.Center().x(), result.Center().y(), result.Center().z(), static_cast<T>(1));
@@ -86,9 +96,9 @@ public:
 		oldEdge *= static_cast<T>(0.5);
 
 		TVector<T, 3> newEdge(
-			std::abs(transform.Data(0, 0)) * oldEdge.x() + std::abs(transform.Data(1, 0)) * oldEdge.y() + std::abs(transform.Data(2, 0)) * oldEdge.z(),
-			std::abs(transform.Data(0, 1)) * oldEdge.x() + std::abs(transform.Data(1, 1)) * oldEdge.y() + std::abs(transform.Data(2, 1)) * oldEdge.z(),
-			std::abs(transform.Data(0, 2)) * oldEdge.x() + std::abs(transform.Data(1, 2)) * oldEdge.y() + std::abs(transform.Data(2, 2)) * oldEdge.z());
+			std::abs(transform.Data(0, 0)) * oldEdge.x() + std::abs(transform.Data(0, 1)) * oldEdge.y() + std::abs(transform.Data(0, 2)) * oldEdge.z(),
+			std::abs(transform.Data(1, 0)) * oldEdge.x() + std::abs(transform.Data(1, 1)) * oldEdge.y() + std::abs(transform.Data(1, 2)) * oldEdge.z(),
+			std::abs(transform.Data(2, 0)) * oldEdge.x() + std::abs(transform.Data(2, 1)) * oldEdge.y() + std::abs(transform.Data(2, 2)) * oldEdge.z());
 
 		result.Min() = newCenter - newEdge;
 		result.Max() = newCenter + newEdge;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Math/SIMD.hpp"
 #include "Math/Vector.hpp"
 
 namespace cd
@@ -286,6 +287,15 @@ public:
 	{
 		static_assert(4 == Rows && 4 == Cols);
 
+#ifdef CD_SIMD_SSE
+		if constexpr (std::is_same_v<T, float>)
+		{
+			MatrixType result;
+			SIMD::Matrix4x4Inverse(begin(), result.begin());
+			return result;
+		}
+#endif
+
 		T xx = Data(0);
 		T xy = Data(1);
 		T xz = Data(2);
@@ -473,7 +483,15 @@ public:
 
 	TVector<T, Cols> operator*(const TVector<T, Rows>& v) const
 	{
-		// TODO : glm has a register based optimization on it.
+#ifdef CD_SIMD
+		if constexpr (4 == Rows && 4 == Cols && std::is_same_v<T, float>)
+		{
+			TVector<T, Cols> result;
+			SIMD::Matrix4x4MultiplyVector(begin(), v.begin(), result.begin());
+			return result;
+		}
+#endif
+
 		if constexpr (3 == Rows && 3 == Cols)
 		{
 			return TVector<T, Cols>(
@@ -493,6 +511,15 @@ public:
 
 	MatrixType operator*(const MatrixType& rhs) const
 	{
+#ifdef CD_SIMD
+		if constexpr (4 == Rows && 4 == Cols && std::is_same_v<T, float>)
+		{
+			MatrixType result;
+			SIMD::Matrix4x4Multiply(begin(), rhs.begin(), result.begin());
+			return result;
+		}
+#endif
+
 		if constexpr (3 == Rows && 3 == Cols)
 		{
 			return MatrixType(Data(0) * rhs.Data(0) + Data(3) * rhs.Data(1) + Data(6) * rhs.Data(2),
@@ -24,6 +24,16 @@ public:
 	 */
 	static float SimplexNoise2D(int64_t seed, double x, double y, bool normalize = true);
 
+	/*
+	 * Generate a row of noise samples at (x + i * stepX, y) for i in [0, count) and write them
+	 * to pOutput. Samples are evaluated in 4 or 8 wide SIMD lanes which are selected by the CPU
+	 * at runtime. The double version returns the same values as SimplexNoise2D. The float version
+	 * skews coordinates in single precision so results differ from SimplexNoise2D. Error grows with
+	 * coordinate magnitude: less than 2e-4 when |x| and |y| <= 256, 1e-3 when they are <= 1024.
+	 */
+	static void SimplexNoise2DRow(int64_t seed, double x, double y, double stepX, uint32_t count, float* pOutput, bool normalize = true);
+	static void SimplexNoise2DRow(int64_t seed, float x, float y, float stepX, uint32_t count, float* pOutput, bool normalize = true);
+
 };
 
 }
\ No newline at end of file
@@ -69,8 +69,15 @@ public:
 
 	static TQuaternion<T> Lerp(const TQuaternion<T>& a, const TQuaternion<T>& b, T t)
 	{
-		constexpr T zero = static_cast<T>(0);
 		constexpr T one = static_cast<T>(1);
+#ifdef CD_SIMD
+		if constexpr (std::is_same_v<T, float>)
+		{
+			TQuaternion<T> result;
+			SIMD::QuaternionLerp(a.begin(), b.begin(), t, result.begin());
+			return result;
+		}
+#endif
 		return b * t + a * Math::FloatSelect(a.Dot(b), one, -one) * (one - t);
 	}
 
@@ -311,6 +318,14 @@ public:
 	CD_FORCEINLINE TQuaternion<T> operator*(T scalar) const { return TQuaternion<T>(m_scalar * scalar, m_vector.x() * scalar, m_vector.y() * scalar, m_vector.z() * scalar); }
 	CD_FORCEINLINE TQuaternion<T> operator*(const TQuaternion<T>& rhs) const
 	{
+#ifdef CD_SIMD
+		if constexpr (std::is_same_v<T, float>)
+		{
+			TQuaternion<T> result;
+			SIMD::QuaternionMultiply(begin(), rhs.begin(), result.begin());
+			return result;
+		}
+#endif
 		return TQuaternion<T>(m_scalar * rhs.m_scalar - m_vector.Dot(rhs.m_vector),
 				rhs.m_vector * m_scalar + m_vector * rhs.m_scalar + m_vector.Cross(rhs.m_vector));
 	}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include "Base/Platform.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define CD_SIMD_SSE
+#include <emmintrin.h>
+// Lane indices in memory order which is reversed to _MM_SHUFFLE.
+#define CD_SIMD_SHUFFLE(x, y, z, w) _MM_SHUFFLE(w, z, y, x)
+#define CD_SIMD_SWIZZLE(v, x, y, z, w) _mm_shuffle_ps(v, v, CD_SIMD_SHUFFLE(x, y, z, w))
+#elif defined(_M_ARM64) || defined(__ARM_NEON)
+#define CD_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(CD_SIMD_SSE) || defined(CD_SIMD_NEON)
+#define CD_SIMD
+#endif
+
+namespace cd
+{
+
+// 128 bits kernels for float 4x4 matrices, quaternions and 3D boxes which are used by math templates when T is float.
+// Inputs are unaligned float arrays in the same memory layout as TMatrix (column-major), TQuaternion (x, y, z, w)
+// and TBox (min xyz, max xyz).
+// Matrix products and quaternion Lerp accumulate in the same order as scalar codes so their results are bit-identical.
+// Inverse and quaternion products are summed in other orders and can differ from scalar codes in rounding.
+#ifdef CD_SIMD
+class SIMD final
+{
+public:
+	SIMD() = delete;
+
+	// pOut = pLhs * pRhs. pOut can alias inputs.
+	static CD_FORCEINLINE void Matrix4x4Multiply(const float* pLhs, const float* pRhs, float* pOut)
+	{
+#if defined(CD_SIMD_SSE)
+		const __m128 col0 = _mm_loadu_ps(pLhs);
+		const __m128 col1 = _mm_loadu_ps(pLhs + 4);
+		const __m128 col2 = _mm_loadu_ps(pLhs + 8);
+		const __m128 col3 = _mm_loadu_ps(pLhs + 12);
+		__m128 result[4];
+		for (int colIndex = 0; colIndex < 4; ++colIndex)
+		{
+			const float* pRhsCol = pRhs + colIndex * 4;
+			__m128 sum = _mm_mul_ps(col0, _mm_set1_ps(pRhsCol[0]));
+			sum = _mm_add_ps(sum, _mm_mul_ps(col1, _mm_set1_ps(pRhsCol[1])));
+			sum = _mm_add_ps(sum, _mm_mul_ps(col2, _mm_set1_ps(pRhsCol[2])));
+			result[colIndex] = _mm_add_ps(sum, _mm_mul_ps(col3, _mm_set1_ps(pRhsCol[3])));
+		}
+		for (int colIndex = 0; colIndex < 4; ++colIndex)
+		{
+			_mm_storeu_ps(pOut + colIndex * 4, result[colIndex]);
+		}
+#elif defined(CD_SIMD_NEON)
+		const float32x4_t col0 = vld1q_f32(pLhs);
+		const float32x4_t col1 = vld1q_f32(pLhs + 4);
+		const float32x4_t col2 = vld1q_f32(pLhs + 8);
+		const float32x4_t col3 = vld1q_f32(pLhs + 12);
+		float32x4_t result[4];
+		for (int colIndex = 0; colIndex < 4; ++colIndex)
+		{
+			const float* pRhsCol = pRhs + colIndex * 4;
+			float32x4_t sum = vmulq_n_f32(col0, pRhsCol[0]);
+			sum = vaddq_f32(sum, vmulq_n_f32(col1, pRhsCol[1]));
+			sum = vaddq_f32(sum, vmulq_n_f32(col2, pRhsCol[2]));
+			result[colIndex] = vaddq_f32(sum, vmulq_n_f32(col3, pRhsCol[3]));
+		}
+		for (int colIndex = 0; colIndex < 4; ++colIndex)
+		{
+			vst1q_f32(pOut + colIndex * 4, result[colIndex]);
+		}
+#endif
+	}
+
+	// pOut = pMatrix * pVector. pOut can alias pVector.
+	static CD_FORCEINLINE void Matrix4x4MultiplyVector(const float* pMatrix, const float* pVector, float* pOut)
+	{
+#if defined(CD_SIMD_SSE)
+		__m128 sum = _mm_mul_ps(_mm_loadu_ps(pMatrix), _mm_set1_ps(pVector[0]));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(pMatrix + 4), _mm_set1_ps(pVector[1])));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(pMatrix + 8), _mm_set1_ps(pVector[2])));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(pMatrix + 12), _mm_set1_ps(pVector[3])));
+		_mm_storeu_ps(pOut, sum);
+#elif defined(CD_SIMD_NEON)
+		float32x4_t sum = vmulq_n_f32(vld1q_f32(pMatrix), pVector[0]);
+		sum = vaddq_f32(sum, vmulq_n_f32(vld1q_f32(pMatrix + 4), pVector[1]));
+		sum = vaddq_f32(sum, vmulq_n_f32(vld1q_f32(pMatrix + 8), pVector[2]));
+		sum = vaddq_f32(sum, vmulq_n_f32(vld1q_f32(pMatrix + 12), pVector[3]));
+		vst1q_f32(pOut, sum);
+#endif
+	}
+
+	// Lerp between quaternions a and b in the shortest path without normalization.
+	static CD_FORCEINLINE void QuaternionLerp(const float* pA, const float* pB, float t, float* pOut)
+	{
+		const float dot = pA[3] * pB[3] + pA[0] * pB[0] + pA[1] * pB[1] + pA[2] * pB[2];
+		const float sign = dot >= 0.0f ? 1.0f : -1.0f;
+#if defined(CD_SIMD_SSE)
+		const __m128 a = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(pA), _mm_set1_ps(sign)), _mm_set1_ps(1.0f - t));
+		_mm_storeu_ps(pOut, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pB), _mm_set1_ps(t)), a));
+#elif defined(CD_SIMD_NEON)
+		const float32x4_t a = vmulq_n_f32(vmulq_n_f32(vld1q_f32(pA), sign), 1.0f - t);
+		vst1q_f32(pOut, vaddq_f32(vmulq_n_f32(vld1q_f32(pB), t), a));
+#endif
+	}
+
+	// pOut = pA * pB in Hamilton product. pOut can alias inputs.
+	static CD_FORCEINLINE void QuaternionMultiply(const float* pA, const float* pB, float* pOut)
+	{
+#if defined(CD_SIMD_SSE)
+		const __m128 b = _mm_loadu_ps(pB);
+		__m128 result = _mm_mul_ps(_mm_set1_ps(pA[3]), b);
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(pA[0]), CD_SIMD_SWIZZLE(b, 3, 2, 1, 0)), _mm_setr_ps(1.0f, -1.0f, 1.0f, -1.0f)));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(pA[1]), CD_SIMD_SWIZZLE(b, 2, 3, 0, 1)), _mm_setr_ps(1.0f, 1.0f, -1.0f, -1.0f)));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(pA[2]), CD_SIMD_SWIZZLE(b, 1, 0, 3, 2)), _mm_setr_ps(-1.0f, 1.0f, 1.0f, -1.0f)));
+		_mm_storeu_ps(pOut, result);
+#elif defined(CD_SIMD_NEON)
+		const float32x4_t b = vld1q_f32(pB);
+		const float32x4_t bwzyx = vrev64q_f32(vextq_f32(b, b, 2));
+		const float32x4_t bzwxy = vextq_f32(b, b, 2);
+		const float32x4_t byxwz = vrev64q_f32(b);
+		const float xSigns[4] = { 1.0f, -1.0f, 1.0f, -1.0f };
+		const float ySigns[4] = { 1.0f, 1.0f, -1.0f, -1.0f };
+		const float zSigns[4] = { -1.0f, 1.0f, 1.0f, -1.0f };
+		float32x4_t result = vmulq_n_f32(b, pA[3]);
+		result = vaddq_f32(result, vmulq_f32(vmulq_n_f32(bwzyx, pA[0]), vld1q_f32(xSigns)));
+		result = vaddq_f32(result, vmulq_f32(vmulq_n_f32(bzwxy, pA[1]), vld1q_f32(ySigns)));
+		result = vaddq_f32(result, vmulq_f32(vmulq_n_f32(byxwz, pA[2]), vld1q_f32(zSigns)));
+		vst1q_f32(pOut, result);
+#endif
+	}
+
+	// pOut = AABB of the box pBox transformed by affine matrix pMatrix. pOut can alias pBox.
+	static CD_FORCEINLINE void AABBTransform(const float* pMatrix, const float* pBox, float* pOut)
+	{
+#if defined(CD_SIMD_SSE)
+		// Both loads stay inside 6 floats of the box. Last lane is unused.
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		const __m128 boxMin = _mm_loadu_ps(pBox);
+		const __m128 boxMax = CD_SIMD_SWIZZLE(_mm_loadu_ps(pBox + 2), 1, 2, 3, 3);
+		const __m128 extent = _mm_mul_ps(_mm_sub_ps(boxMax, boxMin), _mm_set1_ps(0.5f));
+		const __m128 center = _mm_add_ps(boxMin, extent);
+
+		const __m128 col0 = _mm_loadu_ps(pMatrix);
+		const __m128 col1 = _mm_loadu_ps(pMatrix + 4);
+		const __m128 col2 = _mm_loadu_ps(pMatrix + 8);
+		__m128 newCenter = _mm_mul_ps(col0, CD_SIMD_SWIZZLE(center, 0, 0, 0, 0));
+		newCenter = _mm_add_ps(newCenter, _mm_mul_ps(col1, CD_SIMD_SWIZZLE(center, 1, 1, 1, 1)));
+		newCenter = _mm_add_ps(newCenter, _mm_mul_ps(col2, CD_SIMD_SWIZZLE(center, 2, 2, 2, 2)));
+		newCenter = _mm_add_ps(newCenter, _mm_loadu_ps(pMatrix + 12));
+
+		__m128 newExtent = _mm_mul_ps(_mm_and_ps(col0, absMask), CD_SIMD_SWIZZLE(extent, 0, 0, 0, 0));
+		newExtent = _mm_add_ps(newExtent, _mm_mul_ps(_mm_and_ps(col1, absMask), CD_SIMD_SWIZZLE(extent, 1, 1, 1, 1)));
+		newExtent = _mm_add_ps(newExtent, _mm_mul_ps(_mm_and_ps(col2, absMask), CD_SIMD_SWIZZLE(extent, 2, 2, 2, 2)));
+
+		// Second store writes (minZ, maxX, maxY, maxZ) over the unused lane of the first one.
+		const __m128 newMin = _mm_sub_ps(newCenter, newExtent);
+		const __m128 newMax = _mm_add_ps(newCenter, newExtent);
+		_mm_storeu_ps(pOut, newMin);
+		_mm_storeu_ps(pOut + 2, _mm_shuffle_ps(_mm_shuffle_ps(newMax, newMin, CD_SIMD_SHUFFLE(0, 0, 2, 2)), newMax, CD_SIMD_SHUFFLE(2, 0, 1, 2)));
+#elif defined(CD_SIMD_NEON)
+		const float32x4_t boxMin = vld1q_f32(pBox);
+		const float32x4_t boxMaxZXY = vld1q_f32(pBox + 2);
+		const float32x4_t boxMax = vextq_f32(boxMaxZXY, boxMaxZXY, 1);
+		const float32x4_t extent = vmulq_n_f32(vsubq_f32(boxMax, boxMin), 0.5f);
+		const float32x4_t center = vaddq_f32(boxMin, extent);
+
+		const float32x4_t col0 = vld1q_f32(pMatrix);
+		const float32x4_t col1 = vld1q_f32(pMatrix + 4);
+		const float32x4_t col2 = vld1q_f32(pMatrix + 8);
+		float32x4_t newCenter = vmulq_n_f32(col0, vgetq_lane_f32(center, 0));
+		newCenter = vaddq_f32(newCenter, vmulq_n_f32(col1, vgetq_lane_f32(center, 1)));
+		newCenter = vaddq_f32(newCenter, vmulq_n_f32(col2, vgetq_lane_f32(center, 2)));
+		newCenter = vaddq_f32(newCenter, vld1q_f32(pMatrix + 12));
+
+		float32x4_t newExtent = vmulq_n_f32(vabsq_f32(col0), vgetq_lane_f32(extent, 0));
+		newExtent = vaddq_f32(newExtent, vmulq_n_f32(vabsq_f32(col1), vgetq_lane_f32(extent, 1)));
+		newExtent = vaddq_f32(newExtent, vmulq_n_f32(vabsq_f32(col2), vgetq_lane_f32(extent, 2)));
+
+		// (minZ, maxX, maxY, maxZ) is stored over the unused lane of newMin.
+		const float32x4_t newMin = vsubq_f32(newCenter, newExtent);
+		const float32x4_t newMax = vaddq_f32(newCenter, newExtent);
+		vst1q_f32(pOut, newMin);
+		vst1q_f32(pOut + 2, vextq_f32(vextq_f32(newMin, newMin, 3), newMax, 3));
+#endif
+	}
+
+#if defined(CD_SIMD_SSE)
+	// Block matrix inverse with 2x2 sub matrices. Singular matrix results in inf/nan as scalar codes.
+	// https://lxjk.github.io/2017/09/03/Fast-4x4-Matrix-Inverse-with-SSE-SIMD-Explained.html
+	static CD_FORCEINLINE void Matrix4x4Inverse(const float* pMatrix, float* pOut)
+	{
+		const __m128 col0 = _mm_loadu_ps(pMatrix);
+		const __m128 col1 = _mm_loadu_ps(pMatrix + 4);
+		const __m128 col2 = _mm_loadu_ps(pMatrix + 8);
+		const __m128 col3 = _mm_loadu_ps(pMatrix + 12);
+
+		// Sub matrices are stored as (m00, m01, m10, m11). Inverse of transpose is transpose of inverse
+		// so column-major layout goes through the same steps as row-major one.
+		const __m128 a = _mm_movelh_ps(col0, col1);
+		const __m128 b = _mm_movehl_ps(col1, col0);
+		const __m128 c = _mm_movelh_ps(col2, col3);
+		const __m128 d = _mm_movehl_ps(col3, col2);
+
+		// (|A|, |B|, |C|, |D|)
+		const __m128 subDeterminants = _mm_sub_ps(
+			_mm_mul_ps(_mm_shuffle_ps(col0, col2, CD_SIMD_SHUFFLE(0, 2, 0, 2)), _mm_shuffle_ps(col1, col3, CD_SIMD_SHUFFLE(1, 3, 1, 3))),
+			_mm_mul_ps(_mm_shuffle_ps(col0, col2, CD_SIMD_SHUFFLE(1, 3, 1, 3)), _mm_shuffle_ps(col1, col3, CD_SIMD_SHUFFLE(0, 2, 0, 2))));
+		const __m128 detA = CD_SIMD_SWIZZLE(subDeterminants, 0, 0, 0, 0);
+		const __m128 detB = CD_SIMD_SWIZZLE(subDeterminants, 1, 1, 1, 1);
+		const __m128 detC = CD_SIMD_SWIZZLE(subDeterminants, 2, 2, 2, 2);
+		const __m128 detD = CD_SIMD_SWIZZLE(subDeterminants, 3, 3, 3, 3);
+
+		const __m128 adjDMulC = Matrix2x2AdjMultiply(d, c);
+		const __m128 adjAMulB = Matrix2x2AdjMultiply(a, b);
+		__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Matrix2x2Multiply(b, adjDMulC));
+		__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Matrix2x2Multiply(c, adjAMulB));
+		__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Matrix2x2MultiplyAdj(d, adjAMulB));
+		__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Matrix2x2MultiplyAdj(a, adjDMulC));
+
+		// |M| = |A| * |D| + |B| * |C| - tr((A#B)(D#C))
+		__m128 trace = _mm_mul_ps(adjAMulB, CD_SIMD_SWIZZLE(adjDMulC, 0, 2, 1, 3));
+		trace = _mm_add_ps(trace, CD_SIMD_SWIZZLE(trace, 2, 3, 0, 1));
+		trace = _mm_add_ps(trace, CD_SIMD_SWIZZLE(trace, 1, 0, 3, 2));
+		const __m128 determinant = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+
+		const __m128 inverseDeterminant = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), determinant);
+		x = _mm_mul_ps(x, inverseDeterminant);
+		y = _mm_mul_ps(y, inverseDeterminant);
+		z = _mm_mul_ps(z, inverseDeterminant);
+		w = _mm_mul_ps(w, inverseDeterminant);
+
+		// Adjugate shuffles are combined with stores.
+		_mm_storeu_ps(pOut, _mm_shuffle_ps(x, y, CD_SIMD_SHUFFLE(3, 1, 3, 1)));
+		_mm_storeu_ps(pOut + 4, _mm_shuffle_ps(x, y, CD_SIMD_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(pOut + 8, _mm_shuffle_ps(z, w, CD_SIMD_SHUFFLE(3, 1, 3, 1)));
+		_mm_storeu_ps(pOut + 12, _mm_shuffle_ps(z, w, CD_SIMD_SHUFFLE(2, 0, 2, 0)));
+	}
+
+private:
+	// A * B
+	static CD_FORCEINLINE __m128 Matrix2x2Multiply(__m128 a, __m128 b)
+	{
+		return _mm_add_ps(_mm_mul_ps(a, CD_SIMD_SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(CD_SIMD_SWIZZLE(a, 1, 0, 3, 2), CD_SIMD_SWIZZLE(b, 2, 1, 2, 1)));
+	}
+
+	// Adj(A) * B
+	static CD_FORCEINLINE __m128 Matrix2x2AdjMultiply(__m128 a, __m128 b)
+	{
+		return _mm_sub_ps(_mm_mul_ps(CD_SIMD_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(CD_SIMD_SWIZZLE(a, 1, 1, 2, 2), CD_SIMD_SWIZZLE(b, 2, 3, 0, 1)));
+	}
+
+	// A * Adj(B)
+	static CD_FORCEINLINE __m128 Matrix2x2MultiplyAdj(__m128 a, __m128 b)
+	{
+		return _mm_sub_ps(_mm_mul_ps(a, CD_SIMD_SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(CD_SIMD_SWIZZLE(a, 1, 0, 3, 2), CD_SIMD_SWIZZLE(b, 2, 1, 2, 1)));
+	}
+#endif
+};
+#endif
+
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Base/Export.h"
+#include "Math/Box.hpp"
+#include "Math/Matrix.hpp"
+
+#include <span>
+
+namespace cd
+{
+
+// Batch transform APIs which process four elements or one box per iteration with SSE or NEON.
+// Outputs can be the same memory as inputs so that data is transformed in place.
+class CORE_API TransformBatch final
+{
+public:
+	// Utility class doesn't allow to construct.
+	explicit TransformBatch() = delete;
+	TransformBatch(const TransformBatch&) = delete;
+	TransformBatch& operator=(const TransformBatch&) = delete;
+	TransformBatch(TransformBatch&&) = delete;
+	TransformBatch& operator=(TransformBatch&&) = delete;
+	~TransformBatch() = delete;
+
+	// outPoints[i] = (matrix * Vec4f(points[i], 1)).xyz. Matrix is expected to be affine so w is dropped.
+	static void TransformPoints(const Matrix4x4& matrix, std::span<const Vec3f> points, std::span<Vec3f> outPoints);
+
+	// outBoxes[i] = boxes[i].Transform(matrix) which is the AABB of transformed box corners.
+	static void TransformAABBs(const Matrix4x4& matrix, std::span<const AABB> boxes, std::span<AABB> outBoxes);
+
+	// outBoxes[i] = boxes[i].Transform(matrices[i]).
+	static void TransformAABBs(std::span<const Matrix4x4> matrices, std::span<const AABB> boxes, std::span<AABB> outBoxes);
+
+	// AABB which contains all boxes. Large arrays are reduced in parallel blocks. Returns AABB::Empty() for no boxes.
+	static AABB MergeAABBs(std::span<const AABB> boxes, uint32_t maxThreadCount = 0U);
+
+	// outMatrices[i] = lhs * rhsMatrices[i].
+	static void MultiplyMatrices(const Matrix4x4& lhs, std::span<const Matrix4x4> rhsMatrices, std::span<Matrix4x4> outMatrices);
+};
+
+}
\ No newline at end of file
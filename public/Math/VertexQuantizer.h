@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Base/Export.h"
+#include "Math/Vector.hpp"
+
+#include <cstddef>
+#include <span>
+#include <stdint.h>
+
+namespace cd
+{
+
+enum class QuantizedValueFormat : uint8_t
+{
+	Float,
+	Half, // IEEE 754 binary16 with round to nearest even.
+	Unorm8, // [0, 1] to [0, 255].
+	BiasedUnorm8, // [-1, 1] to [0, 255] by v * 0.5 + 0.5 as uint8 vertex attributes are unsigned.
+	Unorm16, // [0, 1] to [0, 65535].
+	Snorm16, // [-1, 1] to [-32767, 32767].
+	Uint8, // Integer values such as bone indices clamped to [0, 255].
+	Uint16, // Integer values clamped to [0, 65535].
+};
+
+// Float to compact vertex attribute conversions which process four values per iteration with SSE2 or NEON.
+// Normalized formats clamp inputs and round to nearest so results are the same with or without SIMD.
+class CORE_API VertexQuantizer final
+{
+public:
+	// Utility class doesn't allow to construct.
+	explicit VertexQuantizer() = delete;
+	VertexQuantizer(const VertexQuantizer&) = delete;
+	VertexQuantizer& operator=(const VertexQuantizer&) = delete;
+	VertexQuantizer(VertexQuantizer&&) = delete;
+	VertexQuantizer& operator=(VertexQuantizer&&) = delete;
+	~VertexQuantizer() = delete;
+
+	static uint32_t GetValueSize(QuantizedValueFormat format);
+
+	// Converts values into a packed array. pOutput needs values.size() * GetValueSize(format) bytes.
+	static void Quantize(QuantizedValueFormat format, std::span<const float> values, std::byte* pOutput);
+
+	/*
+	 * Converts elementCount elements of sourceComponentCount floats into a strided buffer such as an interleaved vertex buffer.
+	 * Element i is written to pOutput + i * outputStride with outputComponentCount values. Missing source components are
+	 * written as zero so that attributes can be padded to 4 bytes alignment.
+	 */
+	static void QuantizeStrided(QuantizedValueFormat format, const float* pSource, uint32_t sourceComponentCount, uint32_t elementCount,
+		std::byte* pOutput, uint32_t outputComponentCount, uint32_t outputStride);
+
+	// Octahedral mapping of unit vectors to [-1, 1]^2 which keeps precision better than xyz in the same bits.
+	static void EncodeOctahedral(std::span<const Vec3f> directions, std::span<Vec2f> outValues);
+	static Vec3f DecodeOctahedral(const Vec2f& value);
+
+	static uint16_t FloatToHalf(float value);
+	static float HalfToFloat(uint16_t value);
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Base/Export.h"
+#include "Math/Matrix.hpp"
+
+#include <span>
+#include <stdint.h>
+
+namespace cd
+{
+
+// Calculates world transforms of a hierarchy stored as flat arrays without recursion.
+// Nodes are sorted by depth and every level is solved in parallel as all parents are ready by then.
+class CORE_API WorldTransformSolver final
+{
+public:
+	static constexpr uint32_t InvalidParentIndex = UINT32_MAX;
+
+public:
+	// Utility class doesn't allow to construct.
+	explicit WorldTransformSolver() = delete;
+	WorldTransformSolver(const WorldTransformSolver&) = delete;
+	WorldTransformSolver& operator=(const WorldTransformSolver&) = delete;
+	WorldTransformSolver(WorldTransformSolver&&) = delete;
+	WorldTransformSolver& operator=(WorldTransformSolver&&) = delete;
+	~WorldTransformSolver() = delete;
+
+	/*
+	 * worldTransforms[i] = worldTransforms[parentIndices[i]] * localTransforms[i], or localTransforms[i] for roots
+	 * whose parent index is InvalidParentIndex. Parents can be stored after children in the arrays.
+	 * maxThreadCount is 0 to use all hardware threads.
+	 */
+	static void Solve(std::span<const uint32_t> parentIndices, std::span<const Matrix4x4> localTransforms,
+		std::span<Matrix4x4> worldTransforms, uint32_t maxThreadCount = 0U);
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Framework/IProducer.h"
+#include "Producers/GltfProducer/GltfProducerOptions.h"
+
+namespace cdtools
+{
+
+class GltfProducerImpl;
+
+// Imports glTF 2.0 .gltf and .glb files without third party libraries.
+class TOOL_API GltfProducer final : public IProducer
+{
+public:
+	GltfProducer() = delete;
+	explicit GltfProducer(const char* pFilePath);
+	GltfProducer(const GltfProducer&) = delete;
+	GltfProducer& operator=(const GltfProducer&) = delete;
+	GltfProducer(GltfProducer&&) = delete;
+	GltfProducer& operator=(GltfProducer&&) = delete;
+	virtual ~GltfProducer();
+	virtual void Execute(cd::SceneDatabase* pSceneDatabase) override;
+
+	void EnableOption(GltfProducerOptions option);
+	void DisableOption(GltfProducerOptions option);
+	bool IsOptionEnabled(GltfProducerOptions option) const;
+
+private:
+	GltfProducerImpl* m_pGltfProducerImpl;
+};
+
+}
\ No newline at end of file
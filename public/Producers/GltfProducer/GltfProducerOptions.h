@@ -0,0 +1,15 @@
+#pragma once
+
+namespace cdtools
+{
+
+enum class GltfProducerOptions
+{
+	ImportMaterial,
+	ImportTexture,
+	ImportSkeleton,
+	ImportAnimation,
+	GenerateTangentSpace
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "AlphaMapTypes.h"
+#include "Base/Export.h"
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace cdtools
+{
+
+/*
+ * Convert int32 elevations to RGBA8 alpha map texels in place. Both are 4 bytes per texel so the
+ * elevation map buffer is reused as alpha map buffer without allocations.
+ * Blend regions must be ordered from low to high : redGreen, greenBlue, blueAlpha. Channel weights
+ * are red = 1 - w0, green = w0 - w1, blue = w1 - w2, alpha = w2 where wi is the blend function
+ * applied to the position of elevation in region i. So channels always sum to 0xFF.
+ */
+TOOL_API void ConvertElevationToAlphaMap(std::byte* pTexels, uint32_t texelCount, const ElevationAlphaMapDef& alphaMapDef);
+
+}
\ No newline at end of file
@@ -16,6 +16,7 @@ namespace cdtools
 {
 
 class TerrainProducerImpl;
+enum class TerrainMeshLayout : uint8_t;
 struct TerrainMetadata;
 struct TerrainSectorMetadata;
 
@@ -33,6 +34,8 @@ public:
 	void SetSceneDatabaseIDs(const cd::SceneDatabase* pSceneDatabase);
 	void SetTerrainMetadata(const cdtools::TerrainMetadata& metadata);
 	void SetSectorMetadata(const cdtools::TerrainSectorMetadata& metadata);
+	void SetMeshLayout(cdtools::TerrainMeshLayout layout);
+	void SetLodLevelCount(uint32_t levelCount);
 	void SetAlphaMapTextureName(cdtools::AlphaMapChannel channel, const std::string_view textureName);
 	void RemoveAlphaMapGeneration();
 	void Initialize();
@@ -44,6 +47,7 @@ public:
 	uint32_t GetSectorLengthInZ() const;
 	uint32_t GetQuadsPerSector() const;
 	uint32_t GetVertsPerSector() const;
+	uint32_t GetLodLevelCount() const;
 	const std::string_view GetAlphaMapTextureName(cdtools::AlphaMapChannel channel) const;
 
 	void GenerateAlphaMapWithElevation(
@@ -54,6 +58,11 @@ public:
 
 	virtual void Execute(cd::SceneDatabase* pSceneDatabase) override;
 
+	// Out-of-core baking. Sectors are generated windowSectorCount at a time and every sector is written to its own .cd file
+	// in pOutputFolder together with TerrainWorld.cdworld index file, so peak memory doesn't grow with the terrain size.
+	// 0 window size means one sector per thread. Returns false if any file fails to be written.
+	bool ExecuteStreaming(const char* pOutputFolder, uint32_t windowSectorCount = 0U);
+
 private:
 	TerrainProducerImpl* m_pTerrainProducerImpl;
 };
@@ -1,14 +1,34 @@
 #pragma once
 
+#include "Base/Template.h"
 #include "IO/InputArchive.hpp"
 #include "IO/OutputArchive.hpp"
 
 #include <stdint.h>
+#include <string>
 #include <vector>
 
 namespace cdtools
 {
 
+/*
+ * How sector meshes are generated.
+ * Quads : every quad has its own 4 vertices with per quad UVs and flat elevation.
+ * IndexedGrid : quads share (numQuadsInX + 1) * (numQuadsInZ + 1) vertices whose heights are sampled from
+ * the elevation map. UVs are in quad units so a repeat sampler tiles textures per quad as Quads does.
+ * ChunkedQuadtree : every sector is a quadtree of IndexedGrid patches. All patches have the same quad count
+ * and each level halves the quad size, so leaves are at full detail. Every quadtree node is a cd::Node whose
+ * LodError is the max height error of its patch. Patches have skirts to hide cracks between different levels
+ * and the second UV set stores the height of each vertex on the parent patch for geomorphing.
+ */
+enum class TerrainMeshLayout : uint8_t
+{
+	Quads,
+	IndexedGrid,
+	ChunkedQuadtree,
+	Count
+};
+
 /*
  * Octave data used to feed into Simplex2D noise function to compute the elevation of a
  * Terrain. Seeds are fed into random generator for consistency, frequencies are usually
@@ -280,4 +300,53 @@ struct TerrainMetadata
 	std::vector<ElevationOctave> octaves;	// Set of weights and seeds at powers of 2 frequencies
 };
 
+/*
+ * Entry of a sector written by TerrainProducer::ExecuteStreaming. The world index file starts with the endian byte
+ * as .cd files, followed by TerrainMetadata, TerrainSectorMetadata, sector count and then one entry per sector in
+ * row major order. Elevation range lets runtime place and cull sectors before loading their .cd files.
+ */
+struct TerrainSectorChunk
+{
+	explicit TerrainSectorChunk() = default;
+
+	explicit TerrainSectorChunk(
+		uint16_t _sectorX,
+		uint16_t _sectorZ,
+		float _minElevation,
+		float _maxElevation,
+		std::string _fileName)
+		: sectorX(_sectorX)
+		, sectorZ(_sectorZ)
+		, minElevation(_minElevation)
+		, maxElevation(_maxElevation)
+		, fileName(cd::MoveTemp(_fileName))
+	{}
+
+	template<bool SwapBytesOrder>
+	explicit TerrainSectorChunk(cd::TInputArchive<SwapBytesOrder>& inputArchive)
+	{
+		*this << inputArchive;
+	}
+
+	template<bool SwapBytesOrder>
+	TerrainSectorChunk& operator<<(cd::TInputArchive<SwapBytesOrder>& inputArchive)
+	{
+		inputArchive >> sectorX >> sectorZ >> minElevation >> maxElevation >> fileName;
+		return *this;
+	}
+
+	template<bool SwapBytesOrder>
+	const TerrainSectorChunk& operator>>(cd::TOutputArchive<SwapBytesOrder>& outputArchive) const
+	{
+		outputArchive << sectorX << sectorZ << minElevation << maxElevation << fileName;
+		return *this;
+	}
+
+	uint16_t sectorX;
+	uint16_t sectorZ;
+	float minElevation;
+	float maxElevation;
+	std::string fileName;	// relative to the world index file
+};
+
 }
\ No newline at end of file
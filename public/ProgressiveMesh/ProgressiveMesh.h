@@ -3,6 +3,8 @@
 #include "Math/Box.hpp"
 #include "Scene/Types.h"
 
+#include <span>
+
 namespace cd
 {
 
@@ -37,8 +39,13 @@ public:
 	cd::Mesh GenerateLodMesh(float percent, uint32_t minFaceCount, const cd::Mesh* pSourceMesh = nullptr);
 	cd::Mesh GenerateLodMesh(uint32_t targetFaceCount, const cd::Mesh* pSourceMesh = nullptr);
 
+	// Generate multiple lod meshes from one collapse sequence. Lod meshes are generated in parallel.
+	std::vector<cd::Mesh> GenerateLodChain(std::span<const float> percents, const cd::Mesh* pSourceMesh = nullptr);
+	std::vector<cd::Mesh> GenerateLodChain(std::span<const float> percents, uint32_t minFaceCount, const cd::Mesh* pSourceMesh = nullptr);
+	std::vector<cd::Mesh> GenerateLodChain(std::span<const uint32_t> targetFaceCounts, const cd::Mesh* pSourceMesh = nullptr);
+
 private:
-	pm::ProgressiveMeshImpl* m_pProgressiveMeshImpl;
+	pm::ProgressiveMeshImpl* m_pProgressiveMeshImpl = nullptr;
 };
 
 }
\ No newline at end of file
@@ -175,6 +175,10 @@ struct MeshTypeTraits
 
 	using BlendShapeID = cd::BlendShapeID;
 	using SkinID = cd::SkinID;
+
+	// Lower detail meshes generated from this mesh and the screen sizes to switch to them.
+	using LodMeshID = cd::MeshID;
+	using LodScreenSize = float;
 };
 
 struct MorphTypeTraits
@@ -183,6 +187,7 @@ struct MorphTypeTraits
 	using ID = cd::MorphID;
 	using BlendShapeID = cd::BlendShapeID;
 	using Weight = float;
+	using MorphEncoding = cd::MorphEncoding;
 
 	// String
 	using Name = std::string;
@@ -197,6 +202,8 @@ struct NodeTypeTraits
 	// Simple
 	using ID = cd::NodeID;
 	using ParentID = cd::NodeID;
+	// Max geometric error of associated meshes compared to full detail surface. 0 means full detail.
+	using LodError = float;
 
 	// String
 	using Name = std::string;
@@ -257,6 +264,8 @@ struct SkinTypeTraits
 	using InfluenceBoneName = std::string;
 	using VertexBoneNameArray = std::vector<std::string>;
 	using VertexBoneWeightArray = std::vector<float>;
+	using VertexInfluenceBone = uint16_t;
+	using VertexInfluenceWeight = float;
 };
 
 struct TextureTypeTraits
@@ -286,6 +295,7 @@ struct TrackTypeTraits
 {
 	// Simple
 	using ID = cd::TrackID;
+	using KeyFrameEncoding = cd::KeyFrameEncoding;
 
 	// String
 	using Name = std::string;
@@ -294,6 +304,9 @@ struct TrackTypeTraits
 	using TranslationKey = cd::TranslationKey;
 	using RotationKey = cd::RotationKey;
 	using ScaleKey = cd::ScaleKey;
+	using QuantizedTranslationKeys = cd::QuantizedKeyFrames;
+	using QuantizedRotationKeys = cd::QuantizedKeyFrames;
+	using QuantizedScaleKeys = cd::QuantizedKeyFrames;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Base/Export.h"
+#include "Math/Transform.hpp"
+#include "Scene/Types.h"
+
+#include <span>
+#include <stdint.h>
+
+namespace cd
+{
+
+class AnimationSamplerImpl;
+class SceneDatabase;
+
+/*
+ * Samples local bone transforms of an Animation. Bone tracks are found by animation name + bone name.
+ * Translation, rotation and scale keys of all tracks are repacked to per channel arrays of key times and key values,
+ * so finding key segments only reads dense times. Keys of quantized tracks are copied as unorm16 values and decoded
+ * while sampling. Every bone channel keeps a cursor to its last key segment.
+ * Sampling at increasing times steps cursors forward instead of binary searching.
+ */
+class CORE_API AnimationSampler final
+{
+public:
+	AnimationSampler() = delete;
+	explicit AnimationSampler(const SceneDatabase& sceneDatabase, AnimationID animationID);
+	AnimationSampler(const AnimationSampler&) = delete;
+	AnimationSampler& operator=(const AnimationSampler&) = delete;
+	AnimationSampler(AnimationSampler&&);
+	AnimationSampler& operator=(AnimationSampler&&);
+	~AnimationSampler();
+
+	// Same as SceneDatabase bone count. Output transforms are indexed by BoneID.
+	uint32_t GetBoneCount() const;
+	float GetDuration() const;
+
+	// Writes GetBoneCount() local transforms. Bones without track keep their bind pose transforms.
+	// Sampled values are the same as linear interpolation of Track keys with Quaternion::LerpNormalized for rotations.
+	// Keys of quantized tracks are the values which TrackCompressor::DecodeKeys returns.
+	void Sample(float time, std::span<Transform> outLocalTransforms);
+
+	// Next Sample call binary searches key segments.
+	void ResetCursors();
+
+private:
+	AnimationSamplerImpl* m_pAnimationSamplerImpl = nullptr;
+};
+
+}
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "Math/Quaternion.hpp"
 
+#include <vector>
+
 namespace cd
 {
 
@@ -12,6 +14,23 @@ enum class KeyFrameType
 	Scale
 };
 
+// How track keys are stored in memory and in .cd files.
+enum class KeyFrameEncoding : uint8_t
+{
+	Float,
+	Quantized, // Range relative unorm16 translations and scales, smallest three 48 bits rotations. Times are floats.
+};
+
+// Keys of one channel of a KeyFrameEncoding::Quantized track. Every key value is 3 uint16 which TrackCompressor decodes.
+// Translations and scales are relative to the value range of the channel. Rotations don't use the range.
+struct QuantizedKeyFrames
+{
+	std::vector<float> times;
+	std::vector<uint16_t> values;
+	Vec3f minValue = Vec3f::Zero();
+	Vec3f extent = Vec3f::Zero();
+};
+
 template<typename KeyFrameValue, KeyFrameType KeyType>
 class KeyFrame
 {
@@ -37,6 +37,8 @@ public:
 	EXPORT_VECTOR_TYPE_APIS(Mesh, PolygonGroup);
 	EXPORT_VECTOR_TYPE_APIS(Mesh, BlendShapeID);
 	EXPORT_VECTOR_TYPE_APIS(Mesh, SkinID);
+	EXPORT_VECTOR_TYPE_APIS(Mesh, LodMeshID);
+	EXPORT_VECTOR_TYPE_APIS(Mesh, LodScreenSize);
 
 	void Init(uint32_t vertexCount);
 	void Init(uint32_t vertexCount, uint32_t vertexInstanceCount);
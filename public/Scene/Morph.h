@@ -20,6 +20,7 @@ public:
 	EXPORT_SIMPLE_TYPE_APIS(Morph, ID);
 	EXPORT_SIMPLE_TYPE_APIS(Morph, BlendShapeID);
 	EXPORT_SIMPLE_TYPE_APIS(Morph, Weight);
+	EXPORT_SIMPLE_TYPE_APIS(Morph, MorphEncoding);
 	EXPORT_STRING_TYPE_APIS(Morph, Name);
 	EXPORT_VECTOR_TYPE_APIS(Morph, VertexSourceID);
 	EXPORT_VECTOR_TYPE_APIS(Morph, VertexPosition);
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Base/Export.h"
+#include "Scene/Types.h"
+
+#include <span>
+#include <stdint.h>
+
+namespace cd
+{
+
+class Mesh;
+class Morph;
+
+// Sparse delta storage, MorphEncoding::QuantizedDelta value encoding and evaluation of morph targets.
+class CORE_API MorphCompressor final
+{
+public:
+	// Utility class doesn't allow to construct.
+	explicit MorphCompressor() = delete;
+	MorphCompressor(const MorphCompressor&) = delete;
+	MorphCompressor& operator=(const MorphCompressor&) = delete;
+	MorphCompressor(MorphCompressor&&) = delete;
+	MorphCompressor& operator=(MorphCompressor&&) = delete;
+	~MorphCompressor() = delete;
+
+	// Converts target positions to offsets from source mesh positions and removes vertices whose offset components
+	// are all within the threshold. Already delta encoded morphs are only filtered.
+	static void SparsifyDeltas(Morph& morph, const Mesh& sourceMesh, float threshold);
+
+	// Snaps offsets to the quantized encoding and marks morph to be stored as MorphEncoding::QuantizedDelta.
+	static void QuantizeDeltas(Morph& morph);
+
+	// Snorm16 encoding relative to the max absolute offset component of a morph.
+	static float GetMaxOffset(std::span<const Point> offsets);
+	static void EncodeDelta(const Point& offset, float maxOffset, int16_t* pOutput);
+	static Point DecodeDelta(const int16_t* pInput, float maxOffset);
+
+	// Adds weight * offset to positions of the source vertices of a delta encoded morph.
+	// Positions are indexed by source vertex IDs, so they are usually a copy of source mesh positions.
+	static void ApplyDeltas(const Morph& morph, float weight, std::span<Point> positions);
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Base/Platform.h"
+
+namespace cd
+{
+
+// What morph vertex positions store and how they are stored in .cd files.
+enum class MorphEncoding : uint8_t
+{
+	Position, // Target positions of source vertices.
+	Delta, // Offsets from source vertex positions.
+	QuantizedDelta, // Offsets stored as snorm16 relative to the max offset component of the morph.
+};
+
+}
\ No newline at end of file
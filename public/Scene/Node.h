@@ -23,6 +23,7 @@ public:
 
 	EXPORT_SIMPLE_TYPE_APIS(Node, ID);
 	EXPORT_SIMPLE_TYPE_APIS(Node, ParentID);
+	EXPORT_SIMPLE_TYPE_APIS(Node, LodError);
 	EXPORT_STRING_TYPE_APIS(Node, Name);
 	EXPORT_COMPLEX_TYPE_APIS(Node, Transform);
 	EXPORT_VECTOR_TYPE_APIS(Node, ChildID);
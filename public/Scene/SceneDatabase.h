@@ -77,6 +77,11 @@ public:
 	void Validate() const;
 	void Merge(cd::SceneDatabase&& scene);
 	void UpdateAABB();
+	// World transforms indexed by NodeID. Nodes without parent are roots.
+	std::vector<Matrix4x4> CalculateNodeWorldTransforms() const;
+	// Conservative skinned mesh AABB at each frame of animation which can be precomputed for culling.
+	// Frame i is sampled at min(i / TicksPerSecond, Duration). Bones without track in animation stay in bind pose.
+	std::vector<AABB> CalculateSkinAnimationAABBs(SkinID skinID, AnimationID animationID) const;
 
 	// Serialization
 	SceneDatabase& operator<<(InputArchive& inputArchive);
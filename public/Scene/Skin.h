@@ -10,6 +10,13 @@ namespace cd
 
 class SkinImpl;
 
+// Vertex influence slot which doesn't reference any bone in influence bone name palette.
+static constexpr uint16_t InvalidInfluenceBoneIndex = 0xFFFFU;
+
+// Default bone index of unused influence slots in vertex buffers which shaders skip. Vertex bone indices are often
+// 8 bits so InvalidInfluenceBoneIndex doesn't fit. Vertex buffer builders and CDConsumer can use another value.
+static constexpr uint32_t DefaultInvalidVertexBoneIndex = 127U;
+
 class CORE_API Skin final
 {
 public:
@@ -22,6 +29,14 @@ public:
 	EXPORT_VECTOR_TYPE_APIS(Skin, InfluenceBoneName);
 	EXPORT_VECTOR_TYPE_APIS(Skin, VertexBoneNameArray);
 	EXPORT_VECTOR_TYPE_APIS(Skin, VertexBoneWeightArray);
+	// MaxVertexInfluenceCount slots per vertex sorted by weight from high to low. Bones are indices to InfluenceBoneNames.
+	// Weights of a vertex sum to 1. Unused slots are InvalidInfluenceBoneIndex with weight 0.
+	EXPORT_VECTOR_TYPE_APIS(Skin, VertexInfluenceBone);
+	EXPORT_VECTOR_TYPE_APIS(Skin, VertexInfluenceWeight);
+
+	// Converts per vertex bone name arrays to vertex influences and releases them.
+	// Does nothing if vertex influences are already built, so influences loaded from .cd files or optimized are kept.
+	void BuildVertexInfluences();
 };
 
 }
\ No newline at end of file
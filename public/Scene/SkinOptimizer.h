@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Base/Export.h"
+#include "Scene/Mesh.h"
+#include "Scene/Skin.h"
+#include "Scene/VertexAttribute.h"
+
+#include <vector>
+
+namespace cd
+{
+
+// Part of a skinned mesh whose skin references a smaller bone palette.
+struct SkinPartition
+{
+	Mesh mesh;
+	Skin skin;
+	// Source mesh vertex index of every partition vertex which remaps data indexed by vertices such as morphs.
+	std::vector<uint32_t> sourceVertexIndices;
+};
+
+// Passes over Skin vertex influences built by Skin::BuildVertexInfluences.
+class CORE_API SkinOptimizer final
+{
+public:
+	// Utility class doesn't allow to construct.
+	explicit SkinOptimizer() = delete;
+	SkinOptimizer(const SkinOptimizer&) = delete;
+	SkinOptimizer& operator=(const SkinOptimizer&) = delete;
+	SkinOptimizer(SkinOptimizer&&) = delete;
+	SkinOptimizer& operator=(SkinOptimizer&&) = delete;
+	~SkinOptimizer() = delete;
+
+	// Keeps the maxInfluenceCount largest influences of every vertex and renormalizes weights.
+	static void LimitInfluences(Skin& skin, uint32_t maxInfluenceCount);
+
+	// Rounds weights to multiples of 1 / 255 for Uint8 or 1 / 65535 for Int16. Rounding errors are distributed by
+	// largest remainder so that unorm weights of a vertex sum exactly to 255 or 65535. Influences rounded to 0 are removed.
+	static void QuantizeWeights(Skin& skin, AttributeValueType valueType);
+
+	/*
+	 * Splits mesh polygons to partitions whose skins reference at most maxPaletteBoneCount bones. Every partition is
+	 * a mesh with its own vertices and polygon groups in the same material order, and a skin whose influence bone names
+	 * are the partition palette. A polygon which references more bones than the limit is put in its own partition.
+	 * Returns nothing if skin palette already fits. Blend shapes and lod meshes of the source mesh are not copied.
+	 */
+	static std::vector<SkinPartition> Partition(const Mesh& mesh, const Skin& skin, uint32_t maxPaletteBoneCount);
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Base/Export.h"
+#include "Scene/TextureFormat.h"
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace cd
+{
+
+class Texture;
+
+enum class TextureCompressionQuality : uint8_t
+{
+	Fast, // Endpoints at the ends of the principal axis of block colors.
+	Normal, // Fast and one least squares refit of endpoints.
+	High, // More refits, inset endpoint search for single channel blocks and all p-bit combinations of BC7 mode 6.
+};
+
+// CPU encoders of BC1, BC3, BC4, BC5 and BC7 blocks. BC1 and BC3 always use 4 colors blocks. BC7 uses mode 6 which
+// interpolates RGBA endpoints by 16 values, or mode 5 which has separate indices for alpha when it lowers the error.
+class CORE_API TextureCompressor final
+{
+public:
+	// Utility class doesn't allow to construct.
+	explicit TextureCompressor() = delete;
+	TextureCompressor(const TextureCompressor&) = delete;
+	TextureCompressor& operator=(const TextureCompressor&) = delete;
+	TextureCompressor(TextureCompressor&&) = delete;
+	TextureCompressor& operator=(TextureCompressor&&) = delete;
+	~TextureCompressor() = delete;
+
+	// R8 pixels compress to BC4. RGBA8 pixels compress to BC1, BC3, BC4 from red, BC5 from red and green or BC7.
+	static bool IsSupported(TextureFormat sourceFormat, TextureFormat targetFormat);
+
+	// Encodes one level of tightly packed pixels to rows of 4x4 blocks. Block rows are encoded on multiple threads.
+	// pOutput needs TextureMipGenerator::GetMipSize(targetFormat, width, height) bytes.
+	static void CompressLevel(const std::byte* pPixels, TextureFormat sourceFormat, uint32_t width, uint32_t height,
+		TextureFormat targetFormat, TextureCompressionQuality quality, std::byte* pOutput);
+
+	// Compresses level 0 or the whole mip chain which TextureMipGenerator lays out in RawData and sets Format.
+	// Returns false and keeps texture unchanged if formats are not supported or RawData doesn't match its size.
+	static bool Compress(Texture& texture, TextureFormat targetFormat, TextureCompressionQuality quality);
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Base/Export.h"
+
+namespace cd
+{
+
+class Texture;
+
+// Decodes image files which are embedded in Texture::RawData by stb_image.
+class CORE_API TextureDecoder final
+{
+public:
+	// Utility class doesn't allow to construct.
+	explicit TextureDecoder() = delete;
+	TextureDecoder(const TextureDecoder&) = delete;
+	TextureDecoder& operator=(const TextureDecoder&) = delete;
+	TextureDecoder(TextureDecoder&&) = delete;
+	TextureDecoder& operator=(TextureDecoder&&) = delete;
+	~TextureDecoder() = delete;
+
+	// Replaces file bytes with pixels and sets Format, Width, Height and Depth. Single channel images become R8,
+	// HDR images become RGBA32F and others become RGBA8. Returns false and keeps texture unchanged on failure.
+	static bool Decode(Texture& texture);
+};
+
+}
\ No newline at end of file
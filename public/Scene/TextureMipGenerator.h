@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Base/Export.h"
+#include "Scene/TextureFormat.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+namespace cd
+{
+
+enum class TextureMipFilter : uint8_t
+{
+	Box, // 2x2 average.
+	Kaiser, // 6 taps Kaiser windowed sinc. Keeps more details than box but may ring at hard edges.
+};
+
+// Mip chains of textures. Levels are stored one after another from the largest one to 1x1 in tightly packed rows,
+// or in rows of 4x4 blocks for block compressed formats. Every level is half of the previous one rounded down and
+// at least 1 pixel in both dimensions.
+class CORE_API TextureMipGenerator final
+{
+public:
+	// Utility class doesn't allow to construct.
+	explicit TextureMipGenerator() = delete;
+	TextureMipGenerator(const TextureMipGenerator&) = delete;
+	TextureMipGenerator& operator=(const TextureMipGenerator&) = delete;
+	TextureMipGenerator(TextureMipGenerator&&) = delete;
+	TextureMipGenerator& operator=(TextureMipGenerator&&) = delete;
+	~TextureMipGenerator() = delete;
+
+	static uint32_t GetMipCount(uint32_t width, uint32_t height);
+	static uint32_t GetMipDimension(uint32_t size, uint32_t mipIndex) { return size >> mipIndex > 0U ? size >> mipIndex : 1U; }
+
+	// Byte size of one level. Supports R8, RGBA8, RGBA32F and BC1 to BC7. 0 for other formats.
+	static std::size_t GetMipSize(TextureFormat format, uint32_t width, uint32_t height);
+	static std::size_t GetMipChainSize(TextureFormat format, uint32_t width, uint32_t height, uint32_t mipCount);
+
+	// Appends levels after level 0 which pixels holds. Supported formats are R8, RGBA8 and RGBA32F.
+	// Color channels of sRGB textures are filtered in linear space. Alpha is always linear.
+	static void GenerateMipChain(std::vector<std::byte>& pixels, TextureFormat format, uint32_t width, uint32_t height,
+		bool isSRGB, TextureMipFilter filter);
+};
+
+}
\ No newline at end of file
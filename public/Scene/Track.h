@@ -22,10 +22,16 @@ public:
 	void Init(TrackID id, std::string name);
 
 	EXPORT_SIMPLE_TYPE_APIS(Track, ID);
+	EXPORT_SIMPLE_TYPE_APIS(Track, KeyFrameEncoding);
 	EXPORT_STRING_TYPE_APIS(Track, Name);
+	// Float keys are empty for KeyFrameEncoding::Quantized tracks whose keys stay in the quantized channels.
+	// TrackCompressor::DecodeKeys converts them back to float keys.
 	EXPORT_VECTOR_TYPE_APIS(Track, TranslationKey);
 	EXPORT_VECTOR_TYPE_APIS(Track, RotationKey);
 	EXPORT_VECTOR_TYPE_APIS(Track, ScaleKey);
+	EXPORT_COMPLEX_TYPE_APIS(Track, QuantizedTranslationKeys);
+	EXPORT_COMPLEX_TYPE_APIS(Track, QuantizedRotationKeys);
+	EXPORT_COMPLEX_TYPE_APIS(Track, QuantizedScaleKeys);
 };
 
 }
\ No newline at end of file
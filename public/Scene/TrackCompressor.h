@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Base/Export.h"
+#include "Math/Quaternion.hpp"
+#include "Scene/Track.h"
+
+#include <stdint.h>
+
+namespace cd
+{
+
+// Key reduction and KeyFrameEncoding::Quantized value encodings of Track keys.
+class CORE_API TrackCompressor final
+{
+public:
+	// Utility class doesn't allow to construct.
+	explicit TrackCompressor() = delete;
+	TrackCompressor(const TrackCompressor&) = delete;
+	TrackCompressor& operator=(const TrackCompressor&) = delete;
+	TrackCompressor(TrackCompressor&&) = delete;
+	TrackCompressor& operator=(TrackCompressor&&) = delete;
+	~TrackCompressor() = delete;
+
+	/*
+	 * Removes keys which are reproduced by interpolating their kept neighbours. Every removed key stays within the tolerance
+	 * of the interpolated value : distance for translations, angle in radians for rotations and max component difference
+	 * for scales. Constant channels are reduced to one key.
+	 */
+	static void ReduceKeys(Track& track, float translationTolerance, float rotationTolerance, float scaleTolerance);
+
+	/*
+	 * Encodes keys to quantized channels, releases float keys and marks track as KeyFrameEncoding::Quantized.
+	 * Range relative error grows with the value range, so track stays KeyFrameEncoding::Float if any decoded key
+	 * is out of the tolerances which are measured the same way as ReduceKeys. Returns whether track is quantized.
+	 */
+	static bool QuantizeKeys(Track& track, float translationTolerance, float rotationTolerance, float scaleTolerance);
+
+	// Decodes quantized channels to float keys and marks track as KeyFrameEncoding::Float.
+	static void DecodeKeys(Track& track);
+
+	// Value of the key at keyIndex in a quantized channel.
+	static Vec3f DecodeRangeKey(const QuantizedKeyFrames& keyFrames, uint32_t keyIndex);
+	static Quaternion DecodeRotationKey(const QuantizedKeyFrames& keyFrames, uint32_t keyIndex);
+
+	// Smallest three encoding in 48 bits. Index of the largest component takes 2 bits, the others 15 bits each.
+	static void EncodeRotation(const Quaternion& rotation, uint16_t* pOutput);
+	static Quaternion DecodeRotation(const uint16_t* pInput);
+
+	// Range relative encoding to unorm16 in [minValue, minValue + extent].
+	static void EncodeRange(const Vec3f& value, const Vec3f& minValue, const Vec3f& extent, uint16_t* pOutput);
+	static Vec3f DecodeRange(const uint16_t* pInput, const Vec3f& minValue, const Vec3f& extent);
+};
+
+}
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "Scene/KeyFrame.hpp"
 #include "Scene/LightType.h"
 #include "Scene/MaterialTextureType.h"
+#include "Scene/MorphEncoding.h"
 #include "Scene/ObjectID.h"
 #include "Scene/ParticleEmitterType.h"
 #include "Scene/TextureFormat.h"
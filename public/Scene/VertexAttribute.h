@@ -25,11 +25,23 @@ enum class VertexAttributeType : uint8_t
 	BoneIndex,
 };
 
+static constexpr bool IsDirectionVertexAttribute(VertexAttributeType attributeType)
+{
+	return VertexAttributeType::Normal == attributeType || VertexAttributeType::Tangent == attributeType || VertexAttributeType::Bitangent == attributeType;
+}
+
+// Vertex buffer builders encode float mesh data by value type :
+// Float is copied. Half is IEEE binary16.
+// Uint8 is unorm8. Directions are biased by v * 0.5 + 0.5 before.
+// Int16 is snorm16 for directions and unorm16 for others.
+// Directions (normal, tangent, bitangent) with two components are octahedral encoded.
+// Bone indices are integers in all value types.
 enum class AttributeValueType : uint8_t
 {
 	Uint8,
 	Float,
 	Int16,
+	Half,
 };
 
 template<typename T>
@@ -58,7 +70,8 @@ struct VertexAttributeLayout
 	VertexAttributeType vertexAttributeType;
 	AttributeValueType attributeValueType;
 	uint8_t attributeCount;
-	uint8_t padding;
+	// Vertex buffer which the attribute is written to when building deinterleaved vertex streams.
+	uint8_t streamIndex;
 };
 
 enum class ConvertStrategy
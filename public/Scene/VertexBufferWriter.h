@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Base/Export.h"
+
+#include <cstddef>
+#include <span>
+#include <stdint.h>
+
+namespace cd
+{
+
+class Mesh;
+class VertexFormat;
+class VertexBufferWriterImpl;
+
+// Skin data indexed by VertexID. Every vertex has influenceCount bone indices and influenceCount bone weights.
+struct VertexSkinStreams
+{
+	std::span<const float> boneIndices;
+	std::span<const float> boneWeights;
+	uint32_t influenceCount = 0U;
+};
+
+/*
+ * Compiles a VertexFormat to a list of copy operations once so that building vertex buffers doesn't test attributes per vertex.
+ * Vertices are written in small chunks. Every operation converts one attribute of a chunk in a tight loop and scatters it
+ * with a copy size known at compile time, so output cache lines stay hot. Large meshes are split to blocks written in parallel.
+ * A vertex format of one float attribute matching mesh data, such as a position stream, is written by bulk copy.
+ */
+class CORE_API VertexBufferWriter final
+{
+public:
+	VertexBufferWriter() = delete;
+	explicit VertexBufferWriter(const VertexFormat& vertexFormat);
+	VertexBufferWriter(const VertexBufferWriter&) = delete;
+	VertexBufferWriter& operator=(const VertexBufferWriter&) = delete;
+	VertexBufferWriter(VertexBufferWriter&&);
+	VertexBufferWriter& operator=(VertexBufferWriter&&);
+	~VertexBufferWriter();
+
+	uint32_t GetStride() const;
+
+	// Vertex instance count if mesh maps vertex instances to vertex positions, otherwise vertex count.
+	static uint32_t GetVertexCount(const Mesh& mesh);
+
+	// Writes GetVertexCount(mesh) * GetStride() bytes to pOutput.
+	// Returns false before writing anything if mesh or skin streams miss data required by vertex format.
+	bool Write(const Mesh& mesh, std::byte* pOutput, const VertexSkinStreams* pSkinStreams = nullptr, uint32_t maxThreadCount = 0U) const;
+
+private:
+	VertexBufferWriterImpl* m_pVertexBufferWriterImpl = nullptr;
+};
+
+}
\ No newline at end of file
@@ -35,6 +35,12 @@ public:
 
 	uint32_t GetStride() const;
 
+	// Attributes with the same stream index are interleaved in one vertex stream. All attributes are in stream 0 by default.
+	void SetVertexAttributeStream(VertexAttributeType attributeType, uint8_t streamIndex);
+	uint32_t GetStreamCount() const;
+	// Returns attribute layouts of one stream as a standalone vertex format.
+	VertexFormat GetStreamVertexFormat(uint32_t streamIndex) const;
+
 	VertexFormat& operator<<(InputArchive& inputArchive);
 	VertexFormat& operator<<(InputArchiveSwapBytes& inputArchive);
 	const VertexFormat& operator>>(OutputArchive& outputArchive) const;
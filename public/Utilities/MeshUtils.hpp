@@ -1,6 +1,10 @@
 #pragma once
 
 #include "Scene/SceneDatabase.h"
+#include "Scene/VertexBufferWriter.h"
+
+#include <algorithm>
+#include <numeric>
 
 namespace cd
 {
@@ -8,202 +12,266 @@ namespace cd
 using VertexBuffer = std::vector<std::byte>;
 using IndexBuffer = std::vector<std::byte>;
 
-static std::optional<VertexBuffer> BuildVertexBufferForStaticMesh(const cd::Mesh& mesh, const cd::VertexFormat& requiredVertexFormat)
+enum class GridIndexLayout : uint8_t
+{
+	TriangleList,
+	TriangleStrip, // Rows are joined by degenerate triangles.
+	TriangleStripWithRestart, // Rows are separated by primitive restart index which is the max value of index type.
+};
+
+// Static mesh vertex format with octahedral snorm16 directions, half UVs and unorm8 colors.
+// Positions stay in float. Stride of position, normal, tangent, bitangent, uv and color goes from 72 to 32 bytes.
+static cd::VertexFormat GetCompactVertexFormat(const cd::VertexFormat& vertexFormat)
 {
-	const bool containsPosition = requiredVertexFormat.Contains(cd::VertexAttributeType::Position);
-	const bool containsNormal = requiredVertexFormat.Contains(cd::VertexAttributeType::Normal);
-	const bool containsTangent = requiredVertexFormat.Contains(cd::VertexAttributeType::Tangent);
-	const bool containsBiTangent = requiredVertexFormat.Contains(cd::VertexAttributeType::Bitangent);
-	const bool containsUV = requiredVertexFormat.Contains(cd::VertexAttributeType::UV);
-	const bool containsColor = requiredVertexFormat.Contains(cd::VertexAttributeType::Color);
+	cd::VertexFormat compactVertexFormat;
+	for (cd::VertexAttributeLayout vertexLayout : vertexFormat.GetVertexAttributeLayouts())
+	{
+		if (IsDirectionVertexAttribute(vertexLayout.vertexAttributeType))
+		{
+			vertexLayout.attributeValueType = cd::AttributeValueType::Int16;
+			vertexLayout.attributeCount = 2U;
+		}
+		else if (cd::VertexAttributeType::UV == vertexLayout.vertexAttributeType)
+		{
+			vertexLayout.attributeValueType = cd::AttributeValueType::Half;
+			vertexLayout.attributeCount = cd::UV::Size;
+		}
+		else if (cd::VertexAttributeType::Color == vertexLayout.vertexAttributeType)
+		{
+			vertexLayout.attributeValueType = cd::AttributeValueType::Uint8;
+			vertexLayout.attributeCount = cd::Color::Size;
+		}
+
+		// Stream index is kept.
+		compactVertexFormat.AddVertexAttributeLayout(vertexLayout);
+	}
+
+	return compactVertexFormat;
+}
 
+// Reuse writer to build vertex buffers of many meshes in the same vertex format.
+static std::optional<VertexBuffer> BuildVertexBufferForStaticMesh(const cd::Mesh& mesh, const cd::VertexBufferWriter& vertexBufferWriter)
+{
 	VertexBuffer vertexBuffer;
-	bool mappingSurfaceAttributes = mesh.GetVertexInstanceToIDCount() > 0U;
-	const uint32_t vertexInstanceCount = mappingSurfaceAttributes ? mesh.GetVertexInstanceToIDCount() : mesh.GetVertexCount();
-	const uint32_t vertexFormatStride = requiredVertexFormat.GetStride();
-	vertexBuffer.resize(vertexInstanceCount * vertexFormatStride);
-
-	uint32_t vbDataSize = 0U;
-	auto vbDataPtr = vertexBuffer.data();
-	auto FillVertexBuffer = [&vbDataPtr, &vbDataSize](const void* pData, uint32_t dataSize)
+	vertexBuffer.resize(cd::VertexBufferWriter::GetVertexCount(mesh) * vertexBufferWriter.GetStride());
+	if (!vertexBufferWriter.Write(mesh, vertexBuffer.data()))
 	{
-		std::memcpy(&vbDataPtr[vbDataSize], pData, dataSize);
-		vbDataSize += dataSize;
-	};
+		// Skin data is not available in static mesh.
+		return std::nullopt;
+	}
+
+	return vertexBuffer;
+}
+
+static std::optional<VertexBuffer> BuildVertexBufferForStaticMesh(const cd::Mesh& mesh, const cd::VertexFormat& requiredVertexFormat)
+{
+	return BuildVertexBufferForStaticMesh(mesh, cd::VertexBufferWriter(requiredVertexFormat));
+}
 
-	for (uint32_t vertexInstance = 0; vertexInstance < vertexInstanceCount; ++vertexInstance)
+/*
+ * Maps skin vertex influences to vertex bone indices. Returns influenceCount values per vertex position in both arrays.
+ * Bone indices index pSkeletonBones which is resolved by influence bone names. If pSkeletonBones is nullptr, bone indices
+ * index Skin influence bone names so that palettes of skins split by SkinOptimizer::Partition are kept.
+ * Vertices which have more influences than influenceCount keep the largest ones with renormalized weights.
+ * Unused slots have invalidBoneIndex which needs to be larger than used bone indices.
+ */
+static void BuildVertexSkinData(const cd::Skin& skin, const std::vector<const cd::Bone*>* pSkeletonBones, uint32_t influenceCount,
+	std::vector<float>& vertexBoneIndexes, std::vector<float>& vertexBoneWeights, uint32_t invalidBoneIndex = cd::DefaultInvalidVertexBoneIndex)
+{
+	assert(skin.GetVertexInfluenceBoneCount() == skin.GetVertexInfluenceWeightCount());
+
+	const float defaultVertexBoneIndex = static_cast<float>(invalidBoneIndex);
+	constexpr float defaultVertexBoneWeight = 0.0f;
+
+	std::vector<float> influenceBoneToVertexBone(skin.GetInfluenceBoneNameCount(), defaultVertexBoneIndex);
+	if (pSkeletonBones)
 	{
-		if (containsPosition)
+		// Building a mapping table from skin influence bone to bone index in the skeleton bone tree.
+		std::map<std::string, uint16_t> skeletonBoneNameToIndex;
+		for (size_t boneIndex = 0U; boneIndex < pSkeletonBones->size(); ++boneIndex)
 		{
-			uint32_t vertexID = vertexInstance;
-			if (mappingSurfaceAttributes)
-			{
-				vertexID = mesh.GetVertexInstanceToID(vertexInstance).Data();
-			}
-
-			constexpr uint32_t dataSize = cd::Point::Size * sizeof(cd::Point::ValueType);
-			FillVertexBuffer(mesh.GetVertexPosition(vertexID).begin(), dataSize);
+			const cd::Bone* pBone = (*pSkeletonBones)[boneIndex];
+			skeletonBoneNameToIndex[pBone->GetName()] = static_cast<uint16_t>(boneIndex);
 		}
 
-		if (containsNormal)
+		for (uint32_t influenceBoneIndex = 0U; influenceBoneIndex < skin.GetInfluenceBoneNameCount(); ++influenceBoneIndex)
 		{
-			constexpr uint32_t dataSize = cd::Direction::Size * sizeof(cd::Direction::ValueType);
-			FillVertexBuffer(mesh.GetVertexNormal(vertexInstance).begin(), dataSize);
+			auto itBoneIndex = skeletonBoneNameToIndex.find(skin.GetInfluenceBoneName(influenceBoneIndex));
+			// Skeleton and Skin mismatch.
+			assert(itBoneIndex != skeletonBoneNameToIndex.end());
+			if (itBoneIndex != skeletonBoneNameToIndex.end())
+			{
+				influenceBoneToVertexBone[influenceBoneIndex] = static_cast<float>(itBoneIndex->second);
+			}
 		}
-
-		if (containsTangent)
+	}
+	else
+	{
+		for (uint32_t influenceBoneIndex = 0U; influenceBoneIndex < skin.GetInfluenceBoneNameCount(); ++influenceBoneIndex)
 		{
-			constexpr uint32_t dataSize = cd::Direction::Size * sizeof(cd::Direction::ValueType);
-			FillVertexBuffer(mesh.GetVertexTangent(vertexInstance).begin(), dataSize);
+			influenceBoneToVertexBone[influenceBoneIndex] = static_cast<float>(influenceBoneIndex);
 		}
+	}
 
-		if (containsBiTangent)
+	const uint32_t skinInfluenceCount = skin.GetMaxVertexInfluenceCount();
+	const uint32_t skinVertexCount = skinInfluenceCount > 0U ? skin.GetVertexInfluenceBoneCount() / skinInfluenceCount : 0U;
+	const uint32_t copyInfluenceCount = std::min(skinInfluenceCount, influenceCount);
+	const std::vector<uint16_t>& vertexInfluenceBones = skin.GetVertexInfluenceBones();
+	const std::vector<float>& vertexInfluenceWeights = skin.GetVertexInfluenceWeights();
+	vertexBoneIndexes.assign(skinVertexCount * influenceCount, defaultVertexBoneIndex);
+	vertexBoneWeights.assign(skinVertexCount * influenceCount, defaultVertexBoneWeight);
+	std::vector<uint32_t> influenceSlots(skinInfluenceCount);
+	for (uint32_t vertexID = 0U; vertexID < skinVertexCount; ++vertexID)
+	{
+		const uint32_t influenceBegin = vertexID * skinInfluenceCount;
+		std::iota(influenceSlots.begin(), influenceSlots.end(), influenceBegin);
+		if (skinInfluenceCount > influenceCount)
 		{
-			constexpr uint32_t dataSize = cd::Direction::Size * sizeof(cd::Direction::ValueType);
-			FillVertexBuffer(mesh.GetVertexBiTangent(vertexInstance).begin(), dataSize);
+			// Skins which are not limited by SkinOptimizer::LimitInfluences drop their smallest influences here.
+			std::partial_sort(influenceSlots.begin(), influenceSlots.begin() + copyInfluenceCount, influenceSlots.end(),
+				[&vertexInfluenceBones, &vertexInfluenceWeights](uint32_t lhs, uint32_t rhs)
+				{
+					const float lhsWeight = cd::InvalidInfluenceBoneIndex != vertexInfluenceBones[lhs] ? vertexInfluenceWeights[lhs] : -1.0f;
+					const float rhsWeight = cd::InvalidInfluenceBoneIndex != vertexInfluenceBones[rhs] ? vertexInfluenceWeights[rhs] : -1.0f;
+					return lhsWeight > rhsWeight;
+				});
 		}
 
-		if (containsUV)
+		float weightSum = 0.0f;
+		for (uint32_t influenceIndex = 0U; influenceIndex < copyInfluenceCount; ++influenceIndex)
 		{
-			constexpr uint32_t dataSize = cd::UV::Size * sizeof(cd::UV::ValueType);
-			FillVertexBuffer(mesh.GetVertexUV(0)[vertexInstance].begin(), dataSize);
+			const uint32_t influenceSlot = influenceSlots[influenceIndex];
+			const uint16_t influenceBone = vertexInfluenceBones[influenceSlot];
+			if (cd::InvalidInfluenceBoneIndex != influenceBone)
+			{
+				vertexBoneIndexes[vertexID * influenceCount + influenceIndex] = influenceBoneToVertexBone[influenceBone];
+				vertexBoneWeights[vertexID * influenceCount + influenceIndex] = vertexInfluenceWeights[influenceSlot];
+				weightSum += vertexInfluenceWeights[influenceSlot];
+			}
 		}
 
-		if (containsColor)
+		if (skinInfluenceCount > influenceCount && weightSum > 0.0f)
 		{
-			constexpr uint32_t dataSize = cd::Color::Size * sizeof(cd::Color::ValueType);
-			FillVertexBuffer(mesh.GetVertexColor(0)[vertexInstance].begin(), dataSize);
+			for (uint32_t influenceIndex = 0U; influenceIndex < copyInfluenceCount; ++influenceIndex)
+			{
+				vertexBoneWeights[vertexID * influenceCount + influenceIndex] /= weightSum;
+			}
 		}
 	}
-
-	assert(vbDataSize == vertexBuffer.size());
-	return vertexBuffer;
 }
 
-static std::optional<VertexBuffer> BuildVertexBufferForSkeletalMesh(const cd::Mesh& mesh, const cd::VertexFormat& requiredVertexFormat, const cd::Skin& skin, const std::vector<const cd::Bone*>& skeletonBones)
+static void BuildVertexSkinData(const cd::Skin& skin, const std::vector<const cd::Bone*>& skeletonBones, uint32_t influenceCount,
+	std::vector<float>& vertexBoneIndexes, std::vector<float>& vertexBoneWeights)
 {
-	assert(skin.GetVertexBoneNameArrayCount() == skin.GetVertexBoneWeightArrayCount());
+	BuildVertexSkinData(skin, &skeletonBones, influenceCount, vertexBoneIndexes, vertexBoneWeights);
+}
 
-	const bool containsBoneIndex = requiredVertexFormat.Contains(cd::VertexAttributeType::BoneIndex);
-	const bool containsBoneWeight = requiredVertexFormat.Contains(cd::VertexAttributeType::BoneWeight);
-	if (!containsBoneIndex || !containsBoneWeight)
+// Resolves skin data to per vertex position streams which the writer converts to the required value types.
+// Returns false if vertex format has no bone index or bone weight attribute.
+static bool BuildVertexSkinStreams(const cd::VertexFormat& requiredVertexFormat, const cd::Skin& skin, const std::vector<const cd::Bone*>* pSkeletonBones,
+	uint32_t invalidBoneIndex, std::vector<float>& vertexBoneIndexes, std::vector<float>& vertexBoneWeights, cd::VertexSkinStreams& skinStreams)
+{
+	const cd::VertexAttributeLayout* pBoneIndexLayout = requiredVertexFormat.GetVertexAttributeLayout(cd::VertexAttributeType::BoneIndex);
+	const cd::VertexAttributeLayout* pBoneWeightLayout = requiredVertexFormat.GetVertexAttributeLayout(cd::VertexAttributeType::BoneWeight);
+	if (!pBoneIndexLayout || !pBoneWeightLayout)
 	{
-		return std::nullopt;
+		return false;
 	}
 
-	// TODO : refine hardcoded 4 bones.
-	uint32_t vertexMaxInfluenceCount = 4U;
-	assert(skin.GetMaxVertexInfluenceCount() <= vertexMaxInfluenceCount);
-	std::vector<uint16_t> vertexBoneIndexes;
-	std::vector<cd::VertexWeight> vertexBoneWeights;
-	vertexBoneIndexes.resize(vertexMaxInfluenceCount);
-	vertexBoneWeights.resize(vertexMaxInfluenceCount);
-
-	// TODO : 127 is hardcoded in shader logic which means invalid bone index.
-	uint16_t defaultVertexBoneIndex = 127;
-	float defaultVertexBoneWeight = 0.0f;
-
-	// Building a mapping table from skeleton bone name to bone index in the skeleton bone tree.
-	std::map<std::string, uint16_t> skeletonBoneNameToIndex;
-	for (size_t boneIndex = 0U; boneIndex < skeletonBones.size(); ++boneIndex)
-	{
-		const cd::Bone* pBone = skeletonBones[boneIndex];
-		skeletonBoneNameToIndex[pBone->GetName()] = static_cast<uint16_t>(boneIndex);
-	}
+	const uint32_t vertexMaxInfluenceCount = pBoneIndexLayout->attributeCount;
+	assert(pBoneWeightLayout->attributeCount == vertexMaxInfluenceCount);
 
-	// Build vertex buffer.
-	const bool containsPosition = requiredVertexFormat.Contains(cd::VertexAttributeType::Position);
-	const bool containsNormal = requiredVertexFormat.Contains(cd::VertexAttributeType::Normal);
-	const bool containsTangent = requiredVertexFormat.Contains(cd::VertexAttributeType::Tangent);
-	const bool containsBiTangent = requiredVertexFormat.Contains(cd::VertexAttributeType::Bitangent);
-	const bool containsUV = requiredVertexFormat.Contains(cd::VertexAttributeType::UV);
-	const bool containsColor = requiredVertexFormat.Contains(cd::VertexAttributeType::Color);
+	BuildVertexSkinData(skin, pSkeletonBones, vertexMaxInfluenceCount, vertexBoneIndexes, vertexBoneWeights, invalidBoneIndex);
+	skinStreams.boneIndices = vertexBoneIndexes;
+	skinStreams.boneWeights = vertexBoneWeights;
+	skinStreams.influenceCount = vertexMaxInfluenceCount;
+	return true;
+}
 
-	VertexBuffer vertexBuffer;
-	bool mappingSurfaceAttributes = mesh.GetVertexInstanceToIDCount() > 0U;
-	const uint32_t vertexInstanceCount = mappingSurfaceAttributes ? mesh.GetVertexInstanceToIDCount() : mesh.GetVertexCount();
-	const uint32_t vertexFormatStride = requiredVertexFormat.GetStride();
-	vertexBuffer.resize(vertexInstanceCount * vertexFormatStride);
-
-	uint32_t vbDataSize = 0U;
-	auto vbDataPtr = vertexBuffer.data();
-	auto FillVertexBuffer = [&vbDataPtr, &vbDataSize](const void* pData, uint32_t dataSize)
+// Bone indices index skeletonBones. See BuildVertexSkinData for pSkeletonBones as nullptr.
+static std::optional<VertexBuffer> BuildVertexBufferForSkeletalMesh(const cd::Mesh& mesh, const cd::VertexFormat& requiredVertexFormat, const cd::Skin& skin,
+	const std::vector<const cd::Bone*>* pSkeletonBones, uint32_t invalidBoneIndex = cd::DefaultInvalidVertexBoneIndex)
+{
+	std::vector<float> vertexBoneIndexes;
+	std::vector<float> vertexBoneWeights;
+	cd::VertexSkinStreams skinStreams;
+	if (!BuildVertexSkinStreams(requiredVertexFormat, skin, pSkeletonBones, invalidBoneIndex, vertexBoneIndexes, vertexBoneWeights, skinStreams))
 	{
-		std::memcpy(&vbDataPtr[vbDataSize], pData, dataSize);
-		vbDataSize += dataSize;
-	};
+		return std::nullopt;
+	}
 
-	for (uint32_t vertexInstance = 0; vertexInstance < vertexInstanceCount; ++vertexInstance)
+	cd::VertexBufferWriter vertexBufferWriter(requiredVertexFormat);
+	VertexBuffer vertexBuffer;
+	vertexBuffer.resize(cd::VertexBufferWriter::GetVertexCount(mesh) * vertexBufferWriter.GetStride());
+	if (!vertexBufferWriter.Write(mesh, vertexBuffer.data(), &skinStreams))
 	{
-		uint32_t vertexID = vertexInstance;
-		if (mappingSurfaceAttributes)
-		{
-			vertexID = mesh.GetVertexInstanceToID(vertexInstance).Data();
-		}
-
-		if (containsPosition)
-		{
-			constexpr uint32_t dataSize = cd::Point::Size * sizeof(cd::Point::ValueType);
-			FillVertexBuffer(mesh.GetVertexPosition(vertexID).begin(), dataSize);
-		}
+		return std::nullopt;
+	}
 
-		if (containsNormal)
-		{
-			constexpr uint32_t dataSize = cd::Direction::Size * sizeof(cd::Direction::ValueType);
-			FillVertexBuffer(mesh.GetVertexNormal(vertexInstance).begin(), dataSize);
-		}
+	return vertexBuffer;
+}
 
-		if (containsTangent)
-		{
-			constexpr uint32_t dataSize = cd::Direction::Size * sizeof(cd::Direction::ValueType);
-			FillVertexBuffer(mesh.GetVertexTangent(vertexInstance).begin(), dataSize);
-		}
+static std::optional<VertexBuffer> BuildVertexBufferForSkeletalMesh(const cd::Mesh& mesh, const cd::VertexFormat& requiredVertexFormat, const cd::Skin& skin, const std::vector<const cd::Bone*>& skeletonBones)
+{
+	return BuildVertexBufferForSkeletalMesh(mesh, requiredVertexFormat, skin, &skeletonBones);
+}
 
-		if (containsBiTangent)
-		{
-			constexpr uint32_t dataSize = cd::Direction::Size * sizeof(cd::Direction::ValueType);
-			FillVertexBuffer(mesh.GetVertexBiTangent(vertexInstance).begin(), dataSize);
-		}
+// Vertex format with positions in stream 0 and other attributes in stream 1.
+// Depth prepass and shadow passes only bind stream 0.
+static cd::VertexFormat GetPositionSplitVertexFormat(const cd::VertexFormat& vertexFormat)
+{
+	cd::VertexFormat splitVertexFormat;
+	for (cd::VertexAttributeLayout vertexLayout : vertexFormat.GetVertexAttributeLayouts())
+	{
+		vertexLayout.streamIndex = cd::VertexAttributeType::Position == vertexLayout.vertexAttributeType ? 0U : 1U;
+		splitVertexFormat.AddVertexAttributeLayout(vertexLayout);
+	}
 
-		if (containsUV)
-		{
-			constexpr uint32_t dataSize = cd::UV::Size * sizeof(cd::UV::ValueType);
-			FillVertexBuffer(mesh.GetVertexUV(0)[vertexInstance].begin(), dataSize);
-		}
+	return splitVertexFormat;
+}
 
-		if (containsColor)
+// Builds one vertex buffer per stream of vertex format. Attributes in a stream are interleaved in the order of vertex layouts.
+static std::optional<std::vector<VertexBuffer>> BuildVertexStreams(const cd::Mesh& mesh, const cd::VertexFormat& requiredVertexFormat, const cd::VertexSkinStreams* pSkinStreams = nullptr)
+{
+	const uint32_t vertexCount = cd::VertexBufferWriter::GetVertexCount(mesh);
+	std::vector<VertexBuffer> vertexStreams(requiredVertexFormat.GetStreamCount());
+	for (uint32_t streamIndex = 0U; streamIndex < vertexStreams.size(); ++streamIndex)
+	{
+		cd::VertexBufferWriter vertexBufferWriter(requiredVertexFormat.GetStreamVertexFormat(streamIndex));
+		VertexBuffer& vertexStream = vertexStreams[streamIndex];
+		vertexStream.resize(vertexCount * vertexBufferWriter.GetStride());
+		if (!vertexBufferWriter.Write(mesh, vertexStream.data(), pSkinStreams))
 		{
-			constexpr uint32_t dataSize = cd::Color::Size * sizeof(cd::Color::ValueType);
-			FillVertexBuffer(mesh.GetVertexColor(0)[vertexInstance].begin(), dataSize);
+			return std::nullopt;
 		}
+	}
 
-		auto& vertexBoneNameArray = skin.GetVertexBoneNameArray(vertexID);
-		auto& vertexBoneWeightArray = skin.GetVertexBoneWeightArray(vertexID);
-		for (uint32_t vertexInfluenceIndex = 0U; vertexInfluenceIndex < vertexMaxInfluenceCount; ++vertexInfluenceIndex)
-		{
-			if (vertexInfluenceIndex < vertexBoneNameArray.size())
-			{
-				const std::string& influenceBoneName = vertexBoneNameArray[vertexInfluenceIndex];
-				auto itBoneIndex = skeletonBoneNameToIndex.find(influenceBoneName);
-				// Skeleton and Skin mismatch.
-				assert(itBoneIndex == skeletonBoneNameToIndex.end());
+	return vertexStreams;
+}
 
-				vertexBoneIndexes.push_back(itBoneIndex->second);
-				vertexBoneWeights.push_back(vertexBoneWeightArray[vertexInfluenceIndex]);
-			}
-			else
-			{
-				vertexBoneIndexes.push_back(defaultVertexBoneIndex);
-				vertexBoneWeights.push_back(defaultVertexBoneWeight);
-			}
-		}
+static std::optional<std::vector<VertexBuffer>> BuildVertexStreamsForStaticMesh(const cd::Mesh& mesh, const cd::VertexFormat& requiredVertexFormat)
+{
+	return BuildVertexStreams(mesh, requiredVertexFormat);
+}
 
-		FillVertexBuffer(vertexBoneIndexes.data(), static_cast<uint32_t>(vertexBoneIndexes.size() * sizeof(uint16_t)));
-		FillVertexBuffer(vertexBoneWeights.data(), static_cast<uint32_t>(vertexBoneWeights.size() * sizeof(cd::VertexWeight)));
+// Bone indices index skeletonBones. See BuildVertexSkinData for pSkeletonBones as nullptr.
+static std::optional<std::vector<VertexBuffer>> BuildVertexStreamsForSkeletalMesh(const cd::Mesh& mesh, const cd::VertexFormat& requiredVertexFormat, const cd::Skin& skin,
+	const std::vector<const cd::Bone*>* pSkeletonBones, uint32_t invalidBoneIndex = cd::DefaultInvalidVertexBoneIndex)
+{
+	std::vector<float> vertexBoneIndexes;
+	std::vector<float> vertexBoneWeights;
+	cd::VertexSkinStreams skinStreams;
+	if (!BuildVertexSkinStreams(requiredVertexFormat, skin, pSkeletonBones, invalidBoneIndex, vertexBoneIndexes, vertexBoneWeights, skinStreams))
+	{
+		return std::nullopt;
 	}
 
-	assert(vbDataSize == vertexBuffer.size());
-	return vertexBuffer;
+	return BuildVertexStreams(mesh, requiredVertexFormat, &skinStreams);
+}
+
+static std::optional<std::vector<VertexBuffer>> BuildVertexStreamsForSkeletalMesh(const cd::Mesh& mesh, const cd::VertexFormat& requiredVertexFormat, const cd::Skin& skin, const std::vector<const cd::Bone*>& skeletonBones)
+{
+	return BuildVertexStreamsForSkeletalMesh(mesh, requiredVertexFormat, skin, &skeletonBones);
 }
 
 static std::optional<IndexBuffer> BuildIndexBufferesForPolygonGroup(const cd::Mesh& mesh, uint32_t polygonGroupIndex, bool forceIndex32 = false)
@@ -266,6 +334,78 @@ static std::optional<IndexBuffer> BuildIndexBufferesForPolygonGroup(const cd::Me
 	return indexBuffer;
 }
 
+// Build indices for a regular grid whose (quadsInX + 1) * (quadsInZ + 1) vertices are stored row by row.
+// Triangles and winding are the same as cdtools::TerrainMeshLayout::IndexedGrid polygons.
+// uint16_t indices are used when all vertex indices and the restart index fit in 16 bits.
+static IndexBuffer BuildIndexBufferForGrid(uint32_t quadsInX, uint32_t quadsInZ, GridIndexLayout layout, bool forceIndex32 = false)
+{
+	const uint32_t verticesInX = quadsInX + 1U;
+	const uint32_t vertexCount = verticesInX * (quadsInZ + 1U);
+	const bool useRestartIndex = GridIndexLayout::TriangleStripWithRestart == layout;
+	const uint32_t maxU16VertexCount = static_cast<uint32_t>(std::numeric_limits<uint16_t>::max()) + (useRestartIndex ? 0U : 1U);
+	const bool useU16Index = !forceIndex32 && vertexCount <= maxU16VertexCount;
+	const uint32_t restartIndex = useU16Index ? std::numeric_limits<uint16_t>::max() : std::numeric_limits<uint32_t>::max();
+
+	std::vector<uint32_t> indices;
+	if (GridIndexLayout::TriangleList == layout)
+	{
+		indices.reserve(quadsInX * quadsInZ * 6U);
+		for (uint32_t z = 0U; z < quadsInZ; ++z)
+		{
+			for (uint32_t x = 0U; x < quadsInX; ++x)
+			{
+				uint32_t bottomLeft = z * verticesInX + x;
+				uint32_t topLeft = bottomLeft + verticesInX;
+				indices.insert(indices.end(), { bottomLeft, topLeft, bottomLeft + 1U, bottomLeft + 1U, topLeft, topLeft + 1U });
+			}
+		}
+	}
+	else
+	{
+		// Every row is a strip of bottom and top vertices. Row vertex count is even so winding stays the same in next row.
+		indices.reserve(quadsInZ * (verticesInX * 2U + 2U));
+		for (uint32_t z = 0U; z < quadsInZ; ++z)
+		{
+			if (z > 0U)
+			{
+				if (useRestartIndex)
+				{
+					indices.push_back(restartIndex);
+				}
+				else
+				{
+					indices.push_back(indices.back());
+					indices.push_back(z * verticesInX);
+				}
+			}
+
+			for (uint32_t x = 0U; x < verticesInX; ++x)
+			{
+				indices.push_back(z * verticesInX + x);
+				indices.push_back((z + 1U) * verticesInX + x);
+			}
+		}
+	}
+
+	IndexBuffer indexBuffer;
+	if (useU16Index)
+	{
+		indexBuffer.resize(indices.size() * sizeof(uint16_t));
+		for (size_t index = 0U; index < indices.size(); ++index)
+		{
+			uint16_t index16 = static_cast<uint16_t>(indices[index]);
+			std::memcpy(&indexBuffer[index * sizeof(uint16_t)], &index16, sizeof(uint16_t));
+		}
+	}
+	else
+	{
+		indexBuffer.resize(indices.size() * sizeof(uint32_t));
+		std::memcpy(indexBuffer.data(), indices.data(), indexBuffer.size());
+	}
+
+	return indexBuffer;
+}
+
 static std::vector<std::optional<IndexBuffer>> BuildIndexBufferesForMesh(const cd::Mesh& mesh, bool forceIndex32 = false)
 {
 	std::vector<std::optional<IndexBuffer>> indexBufferes;
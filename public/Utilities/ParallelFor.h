@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace cd
+{
+
+inline uint32_t GetParallelThreadCount(uint32_t maxThreadCount = 0U)
+{
+	uint32_t threadCount = std::max(1U, std::thread::hardware_concurrency());
+	return maxThreadCount > 0U ? std::min(threadCount, maxThreadCount) : threadCount;
+}
+
+// Calls func(index) for every index in [0, count) on multiple threads.
+// Indices are fetched one by one from an atomic counter so work items with different costs still balance.
+// The calling thread also takes part in the work. It returns after all indices are processed.
+template<typename Func>
+void ParallelFor(uint32_t count, Func&& func, uint32_t maxThreadCount = 0U)
+{
+	uint32_t threadCount = std::min(GetParallelThreadCount(maxThreadCount), count);
+	if (threadCount <= 1U)
+	{
+		for (uint32_t index = 0U; index < count; ++index)
+		{
+			func(index);
+		}
+		return;
+	}
+
+	std::atomic<uint32_t> nextIndex = 0U;
+	auto WorkerFunc = [&nextIndex, &func, count]()
+	{
+		for (uint32_t index = nextIndex++; index < count; index = nextIndex++)
+		{
+			func(index);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(threadCount - 1U);
+	for (uint32_t threadIndex = 1U; threadIndex < threadCount; ++threadIndex)
+	{
+		workers.emplace_back(WorkerFunc);
+	}
+
+	WorkerFunc();
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+}
\ No newline at end of file